@@ -6,9 +6,34 @@
 #include <LoRa.h>              // Library untuk komunikasi LoRa
 #include <constant.h>          // File header kustom (kemungkinan berisi definisi konstan)
 #include <EEPROM.h>            // Library untuk membaca dan menulis ke memori EEPROM
+#include "telemetry_frame.h"   // Format frame biner telemetri dari transmitter
+#include "lora_arq.h"          // Nomor urut, ACK selektif dan jendela duplikat ARQ
+#include "spsc_ring.h"         // Ring buffer lock-free antara interrupt LoRa dan task RX
+#include "lora_airtime.h"      // Time-on-air paket untuk batas tunggu listen-before-talk
+#include "report_filter.h"     // Parameter heartbeat mode report-on-change transmitter
+#include "flash_log.h"         // Log cincin di flash untuk spool uplink saat server tidak bisa dihubungi
+#include "node_registry.h"     // Tabel status per transmitter dengan lookup O(1) per alamat pengirim
+#include "lora_schedule.h"     // Beacon dan slot TDMA untuk banyak transmitter
+#include "lora_adr.h"          // Adaptive data rate: SF jaringan dan daya TX per node dari SNR
+#include "lora_packet.h"       // Burst read FIFO radio dan view header/payload paket tanpa alokasi
+#include "json_arena.h"        // Allocator ArduinoJson di buffer statis agar JSON tidak memakai heap
+#include "uplink_json.h"       // Ukuran batch uplink, buffer body dan arena JSON (sama dengan soak test)
+#include <esp_partition.h>     // Partisi data mentah tempat spool uplink
+#include <stdarg.h>            // va_list untuk logPrintf()
+
+// Model KNN hasil ekspor knn_model_training.py; tanpa header ini klasifikasi tetap dilakukan server
+#if __has_include("knn_model.h")
+#include "knn_model.h"
+#define LOCAL_KNN_ENABLED 1
+#else
+#define LOCAL_KNN_ENABLED 0
+#endif
 
 // URL API ke server python
 const String Endpoint = "http://biodrying-server.local:5000/biodrying_data"; // Alamat endpoint server untuk mengirim data
+const char *ServerHost = "biodrying-server.local";                           // Nama mDNS server, di-resolve sekali lalu IP-nya di-cache
+const uint16_t ServerPort = 5000;                                            // Port server Flask
+const char *ServerPath = "/biodrying_data/batch";                            // Path endpoint batch (banyak pembacaan per POST)
 bool wiFiConnected;                                                          // Variabel penanda status koneksi WiFi
 
 // Konfigurasi LoRA
@@ -47,15 +72,9 @@ byte pauseChar[] = { // Custom character untuk simbol pause di LCD
     B00000,
     B00000};
 
-// Parameter tertampil
+// Parameter tertampil (nilai sensor, RSSI dan klasifikasi per transmitter ada di registry node)
 bool paused;          // Status apakah sistem dijeda
-int loraRSSI;         // Menyimpan nilai RSSI (Received Signal Strength Indicator) LoRa
 int connectedDevices; // (Variabel ini dideklarasikan tapi tidak digunakan secara aktif dalam kode yang diberikan)
-bool classification;  // Hasil klasifikasi dari server
-bool buzzerOn;        // Status buzzer dari server
-float humidity;       // Nilai kelembaban
-float temperature;    // Nilai suhu
-float pH;             // Nilai pH
 
 // Definisi Lora Parameter
 struct LoraParameter // Struktur untuk menyimpan parameter LoRa
@@ -63,7 +82,7 @@ struct LoraParameter // Struktur untuk menyimpan parameter LoRa
   byte loraLocalAddress;  // Alamat LoRa perangkat ini
   byte loraDestination;   // Alamat LoRa tujuan
   String outgoingMessage; // Pesan yang akan dikirim (tidak terpakai di kode ini)
-  String incomingMessage; // Pesan yang diterima
+  char incomingMessage[64]; // Pesan yang diterima (pembacaan terakhir yang di-flush ke uplink)
   byte msgCount;          // Penghitung pesan (tidak terpakai di kode ini)
 };
 
@@ -76,27 +95,254 @@ struct ServerResponse // Struktur untuk menyimpan respons dari server
   bool buzzerOn;       // Status buzzer
 };
 
-ServerResponse serverResponse; // Membuat instance dari ServerResponse
+// Paket LoRa mentah yang disalin dari FIFO radio oleh interrupt DIO0
+#define LORA_MAX_PACKET_SIZE 255 // Panjang paket LoRa maksimal
+#define LORA_RX_QUEUE_SIZE 8     // Jumlah slot antrian paket RX (harus pangkat dua)
+#define LBT_THRESHOLD_DBM -100   // RSSI kanal di atas ini: ada frame yang sedang diterima (listen-before-talk)
+#define LBT_POLL_MS 5            // Jarak pengecekan RSSI kanal saat menunggu
+
+struct LoraPacket // Struktur untuk satu paket yang menunggu diproses
+{
+  uint8_t data[LORA_MAX_PACKET_SIZE]; // Isi paket termasuk header (recipient, sender, msgId, length)
+  uint8_t length;                     // Jumlah byte yang valid di data
+  int16_t rssi;                       // RSSI saat paket diterima
+  float snr;                          // SNR saat paket diterima (dB), untuk ADR
+  unsigned long receivedAtUs;         // Waktu paket tiba (micros) untuk metrik latensi
+};
+
+SpscRing<LoraPacket, LORA_RX_QUEUE_SIZE> loraRxQueue; // Antrian paket dari interrupt (producer) ke task RX (consumer)
+
+// Antrian pembacaan sensor dari task RX ke task uplink (HTTP), agar POST tidak menahan penerimaan LoRa
+#define UPLINK_QUEUE_DEPTH 16   // Kedalaman antrian uplink
+#define UPLINK_DROP_OLDEST 0    // Antrian penuh: buang pembacaan tertua
+#define UPLINK_COALESCE 1       // Antrian penuh: ringkas antrian menjadi pembacaan terbaru saja
+#define UPLINK_BACKPRESSURE_POLICY UPLINK_DROP_OLDEST
+// UPLINK_BATCH_SIZE (maksimal pembacaan dalam satu POST batch) ada di uplink_json.h
+#define UPLINK_BATCH_MAX_AGE_MS 250  // Batch dikirim paling lambat selama ini sejak pembacaan pertamanya masuk
+
+// Transmitter dengan report-on-change hanya mengirim saat nilai berubah atau heartbeat. Uplink tetap berupa
+// deret kontinu: selama node belum stale (REPORT_STALE_MS), nilai terakhirnya diulang setiap periode node itu,
+// yaitu jarak frame terpendek yang teramati (node yang mengirim tiap menit tidak diulang tiap 5 detik)
+#define REPORT_HOLD_PERIOD_MS 5000 // Giliran pemeriksaan rekonstruksi dan jarak sampel minimal per node
+
+// Registry node: status terakhir setiap transmitter di jaringan, kunci alamat LoRa pengirim (node_registry.h).
+// Ukuran yang sama dipakai tabel rekonstruksi di uplinkTask; pemakaian RAM keduanya dicetak saat boot
+#define NODE_REGISTRY_SIZE 64 // Transmitter yang dilacak bersamaan, node ke-65 menggusur yang paling lama diam
+
+// MAC slot terjadwal (lora_schedule.h): setiap periode Receiver menyiarkan beacon berisi slot node yang
+// mengirim frame bernomor urut, selebar time-on-air frame terakhirnya pada setting aktif. Node yang sudah
+// tercantum hanya mengirim di slotnya, node baru dan batch backlog memakai jendela kontensi di akhir periode.
+// Tanpa node terjadwal tidak ada beacon, transmitter lama dan transmitter yang belum mendengar beacon tetap ALOHA
+#define SCHEDULE_ENABLED 1
+
+// Adaptive data rate (lora_adr.h): Receiver mencatat SNR frame setiap node dan mengirim perintah daya TX per node
+// serta SF jaringan di belakang ACK. SF dan daya dari LCD/EEPROM menjadi titik awal setelah boot; pergantian
+// SF oleh ADR tidak ditulis ke EEPROM. BW dan coding rate tetap manual
+#define ADR_ENABLED 1
+
+// Spool uplink (flash_log.h): batch yang gagal di-POST (WiFi putus, server restart) disimpan di log cincin pada
+// partisi data mentah beserta umurnya, lalu di-replay dalam POST batch begitu server menjawab lagi. Selama uplink
+// putus, batch baru langsung masuk spool dan POST hanya dicoba ulang setiap SPOOL_RETRY_MS.
+#define SPOOL_ENABLED 1
+#define SPOOL_SECTORS 32       // 32 x 4 KB partisi spiffs: 1953 pembacaan pasti tertampung, lebih dari itu yang tertua ditimpa
+#define SPOOL_RETRY_MS 5000    // Jarak percobaan POST selama uplink putus
+// SPOOL_REPLAY_BATCH (pembacaan spool per POST replay) dan ukuran buffer/arena JSON ada di uplink_json.h
+
+#define LOG_LINE_MAX_SIZE 512 // Baris log logPrintf(), lebih panjang dipotong
+
+struct SensorReading // Pembacaan sensor yang sudah di-decode dari paket LoRa
+{
+  float temperature;          // Nilai suhu (rata-rata probe)
+  float temperatureMin;       // Suhu probe terendah
+  float temperatureMax;       // Suhu probe tertinggi
+  float humidity;             // Nilai kelembaban
+  float ph;                   // Nilai pH
+  uint8_t probeCount;                              // Jumlah probe suhu di frame (0 untuk transmitter lama)
+  uint16_t probeId[TELEMETRY_MAX_PROBES];          // ID tiap probe
+  int16_t probeTemperature[TELEMETRY_MAX_PROBES];  // Suhu tiap probe, 0.01 C (TELEMETRY_PROBE_INVALID jika gagal)
+  int16_t rssi;               // RSSI paket
+  byte sender;                // Alamat LoRa pengirim
+  byte msgId;                 // ID pesan dari header paket, dikembalikan di respons LoRa
+  bool arq;                   // Frame versi 3/kompak dengan nomor urut: dijawab dengan frame ACK, bukan JSON
+  ArqAck ack;                 // ACK selektif saat frame diterima (nomor urut tertinggi + bitmap)
+  bool heartbeat;             // Frame heartbeat report-on-change (nilai tidak berubah)
+  bool held;                  // Sampel rekonstruksi dari nilai terakhir node, bukan paket baru
+  bool backlog;               // Pembacaan lama dari flash transmitter (frame batch), sudah di-ACK saat diterima
+  uint32_t capturedAgeMs;     // Umur saat receivedAtUs: 0 untuk paket baru, umur di flash transmitter/spool (TELEMETRY_AGE_UNKNOWN jika tidak diketahui)
+  bool classification;        // Hasil KNN lokal (jika LOCAL_KNN_ENABLED)
+  bool classifiedLocally;     // classification benar-benar hasil KNN lokal untuk pembacaan ini (bukan backlog/salinan)
+  unsigned long receivedAtUs; // Waktu paket tiba di interrupt
+  unsigned long queuedAtUs;   // Waktu pembacaan masuk antrian uplink
+};
+
+QueueHandle_t uplinkQueue; // Antrian FreeRTOS berisi SensorReading
+
+struct StageLatency // Statistik latensi satu tahap pipeline (mikrodetik)
+{
+  unsigned long lastUs;
+  unsigned long maxUs;
+  unsigned long long totalUs;
+  unsigned long count;
+};
+
+struct PipelineStats // Metrik pipeline RX -> antrian -> uplink
+{
+  StageLatency rx;             // Interrupt sampai pembacaan masuk antrian uplink
+  StageLatency queue;          // Waktu tunggu di antrian uplink
+  StageLatency batch;          // Waktu tunggu di batch sampai POST dimulai
+  StageLatency uplink;         // POST batch ke server sampai semua respons LoRa terkirim
+  StageLatency knn;            // Klasifikasi KNN lokal
+  unsigned long batches;       // Jumlah POST batch
+  unsigned long knnMismatches; // Hasil KNN lokal yang berbeda dari klasifikasi server
+  unsigned long dropped;       // Pembacaan dibuang (drop oldest)
+  unsigned long coalesced;     // Pembacaan digantikan yang lebih baru (coalesce)
+  unsigned long reports;       // Frame perubahan dari transmitter
+  unsigned long heartbeats;    // Frame heartbeat dari transmitter
+  unsigned long held;          // Sampel rekonstruksi yang ditambahkan ke uplink
+  unsigned long staleNodes;    // Node yang berhenti direkonstruksi karena heartbeat terlewat
+  unsigned long duplicates;    // Frame ARQ duplikat (kiriman ulang yang ACK-nya hilang), tidak diteruskan ke server
+  unsigned long backlog;       // Pembacaan backlog dari frame batch transmitter
+};
+
+PipelineStats pipelineStats; // Instance metrik pipeline
+
+struct NodeSeries // Nilai terakhir satu transmitter untuk rekonstruksi deret, hanya dipakai oleh uplinkTask
+{
+  uint8_t address;          // Alamat LoRa transmitter (kunci registry)
+  bool active;              // Node belum stale
+  SensorReading last;       // Pembacaan asli terakhir dari node
+  unsigned long lastSeenMs; // Waktu frame asli terakhir (perubahan atau heartbeat)
+  unsigned long lastEmitMs; // Waktu sampel terakhir node ini masuk uplink (asli atau rekonstruksi)
+  unsigned long periodMs;   // Periode kirim node yang teramati, 0 = belum diketahui (baru satu frame)
+};
+
+NodeRegistry<NodeSeries, NODE_REGISTRY_SIZE> nodeSeries; // Tabel node untuk rekonstruksi
+
+// Status terakhir satu transmitter. Slot dialokasikan dan diisi oleh loraRxTask; lastFlags juga ditulis saat
+// respons dikirim (task uplink, di bawah nodesMutex), LCD hanya membaca. Nilai sensor disimpan 0.01 seperti di frame telemetri
+struct NodeState
+{
+  uint8_t address;          // Alamat LoRa transmitter (kunci registry)
+  uint8_t lastFlags;        // ArqAckClassification/ArqAckBuzzer terakhir yang dikirim ke node (ACK ulang, LCD, buzzer)
+  uint8_t probeCount;       // Jumlah probe suhu di frame terakhir
+  uint8_t frameLength;      // Panjang frame telemetri bernomor urut terakhir (lebar slot TDMA), 0 = tidak dijadwalkan
+  bool hasSeq;              // Node mengirim frame bernomor urut (versi 3, kompak atau batch backlog)
+  int16_t rssi;             // RSSI paket terakhir
+  uint16_t seq;             // Nomor urut frame terakhir
+  int16_t temperature;      // Pembacaan terakhir (rata-rata probe)
+  int16_t temperatureMin;   // Suhu probe terendah
+  int16_t temperatureMax;   // Suhu probe tertinggi
+  int16_t humidity;         // Kelembaban
+  int16_t ph;               // pH
+  ArqWindow window;         // Nomor urut yang sudah diterima (jendela duplikat ARQ)
+  unsigned long lastSeenMs; // Paket terakhir dari node; node paling lama diam digusur saat registry penuh
+  unsigned long packets;    // Paket yang diterima dari node, termasuk duplikat
+  AdrNode adr;              // Riwayat SNR dan perintah ADR; ditulis task RX, dibaca saat ACK dikirim (di bawah loraTxSemaphore)
+};
+
+NodeRegistry<NodeState, NODE_REGISTRY_SIZE> nodes; // Registry node di jaringan
+ScheduleTable scheduleTable;                       // Urutan slot TDMA, hanya dipakai oleh scheduleTask
+AdrController adr;                                 // Keputusan ADR jaringan; diubah task RX di bawah loraTxSemaphore
+uint8_t lcdNode;                                   // Slot registry yang ditampilkan halaman monitoring LCD
+
+struct UplinkSession // Sesi HTTP keep-alive ke server, hanya dipakai oleh uplinkTask
+{
+  WiFiClient client;          // Socket TCP yang dipertahankan antar POST
+  HTTPClient http;            // HTTPClient dengan setReuse(true)
+  IPAddress serverIp;         // Hasil resolusi mDNS ServerHost yang di-cache
+  bool resolved;              // serverIp valid
+  unsigned long connects;     // Jumlah koneksi TCP baru
+  unsigned long resolves;     // Jumlah lookup mDNS
+  unsigned long staleRetries; // POST diulang karena socket keep-alive sudah ditutup server
+  char body[UPLINK_BODY_MAX_SIZE]; // JSON batch yang sedang dikirim (dipakai lagi saat POST diulang)
+};
+
+UplinkSession uplinkSession; // Instance sesi uplink
+
+JsonArena<UPLINK_JSON_ARENA_SIZE> uplinkJsonArena; // Dokumen JSON uplinkTask
+JsonArena<LEGACY_JSON_ARENA_SIZE> loraRxJsonArena; // Payload JSON lama di task RX
+JsonArena<LEGACY_JSON_ARENA_SIZE> loraTxJsonArena; // Respons JSON lama, hanya dipakai di bawah loraTxSemaphore
+
+struct PartitionStorage // Partisi data mentah sebagai Storage flash_log.h
+{
+  const esp_partition_t *partition;
+
+  bool read(uint32_t offset, void *data, size_t size) { return esp_partition_read(partition, offset, data, size) == ESP_OK; }
+  bool write(uint32_t offset, const void *data, size_t size) { return esp_partition_write(partition, offset, data, size) == ESP_OK; }
+  bool eraseSector(uint32_t offset) { return esp_partition_erase_range(partition, offset, FLASH_LOG_SECTOR_SIZE) == ESP_OK; }
+};
+
+enum SpoolFlag // Atribut SensorReading yang ikut disimpan di record spool (byte 1)
+{
+  SpoolHeld = 1 << 0,
+  SpoolBacklog = 1 << 1,
+  SpoolAgeUnknown = 1 << 2,
+  SpoolClassification = 1 << 3,
+  SpoolClassifiedLocally = 1 << 4
+};
+
+struct SpoolStats // Metrik spool uplink
+{
+  unsigned long spooled;       // Pembacaan yang masuk spool
+  unsigned long replayed;      // Pembacaan spool yang diterima server
+  unsigned long replayBatches; // POST replay yang berhasil
+  unsigned long long replayUs; // Total durasi POST replay yang berhasil, untuk throughput
+  unsigned long skippedPosts;  // Batch yang langsung masuk spool tanpa mencoba POST (uplink putus)
+  unsigned long writeErrors;   // Pembacaan yang gagal ditulis ke flash (hilang)
+};
+
+PartitionStorage spoolStorage;          // Partisi spiffs untuk spool
+FlashLog<PartitionStorage> uplinkSpool; // Log spool, hanya dipakai oleh uplinkTask
+SpoolStats spoolStats;                  // Instance metrik spool
+bool uplinkUp = true;                   // POST terakhir dijawab server
+unsigned long lastUplinkAttemptMs;      // POST terakhir dicoba (untuk SPOOL_RETRY_MS saat uplink putus)
 
 // definisi fungsi
 void sendToTransmitter(String data);                      // Deklarasi fungsi (tidak ada definisi di kode ini)
 int getAllConnectedDevices();                             // Deklarasi fungsi (tidak ada definisi di kode ini)
-void onLoraReceiveCallback(int packetSize);               // Deklarasi fungsi callback ketika LoRa menerima paket
+void onLoraReceiveCallback(int packetSize);               // Deklarasi fungsi callback interrupt DIO0 ketika LoRa menerima paket
+void processLoraPacket(const LoraPacket &packet);         // Deklarasi fungsi untuk memproses paket dari antrian RX
+void enqueueReading(SensorReading &reading);              // Deklarasi fungsi untuk memasukkan pembacaan ke antrian uplink
+void processBacklogBatch(const LoraPacket &packet, NodeState &node, byte msgId, const uint8_t *payload, size_t length); // Deklarasi fungsi untuk meneruskan frame batch backlog
+void setProbeRange(SensorReading &reading);               // Deklarasi fungsi untuk menghitung suhu min/max dari probe
+float spoolReplayThroughput();                            // Deklarasi fungsi throughput replay spool
+void recordLatency(StageLatency &stage, unsigned long us); // Deklarasi fungsi untuk mencatat sampel latensi pipeline
+void trackReport(const SensorReading &reading);            // Deklarasi fungsi untuk mencatat pembacaan asli terakhir tiap node
+size_t reconstructHeldReadings(SensorReading *out, size_t capacity); // Deklarasi fungsi untuk membuat sampel sample-and-hold
 void sendLoraMessage(String message);                     // Deklarasi fungsi untuk mengirim pesan LoRa (overload 1)
 void centerText(const char *text, int row);               // Deklarasi fungsi untuk menampilkan teks di tengah LCD
-void sendLoraMessage(const ServerResponse &responseData); // Deklarasi fungsi untuk mengirim pesan LoRa (overload 2, menggunakan struct)
+void logPrintf(const char *format, ...) __attribute__((format(printf, 1, 2))); // Deklarasi fungsi log berformat tanpa heap
+void sendLoraMessage(const ServerResponse &responseData, byte destination, byte msgId, const ArqAck *ack); // Deklarasi fungsi untuk mengirim pesan LoRa (overload 2, menggunakan struct)
+NodeState &nodeFor(byte sender, int16_t rssi);            // Deklarasi fungsi untuk mengambil/mendaftarkan status transmitter
+NodeState *selectedNode();                                // Deklarasi fungsi node yang ditampilkan LCD
+bool nodeBuzzerRequested();                               // Deklarasi fungsi pemeriksa permintaan buzzer dari node aktif
+bool isLatestFromSender(const SensorReading *readings, size_t count, size_t index); // Deklarasi fungsi pemeriksa pembacaan terbaru per node di batch
+bool resultChanged(byte address, uint8_t resultFlags);    // Deklarasi fungsi pemeriksa hasil yang belum dikirim ke node
+size_t encodeUplinkBatch(const SensorReading *readings, size_t count, char *buffer, size_t size); // Deklarasi fungsi serialisasi batch uplink ke buffer tetap
+void waitChannelClear();                                  // Deklarasi fungsi listen-before-talk sebelum mengirim respons
+unsigned long sendScheduleBeacon(const ScheduleBeacon &beacon); // Deklarasi fungsi siaran beacon TDMA
+void adrOnFrame(NodeState &node, uint8_t frameFlags, float snr);  // Deklarasi fungsi pencatat SNR dan keputusan ADR
+void serviceAdrSwitch();                                  // Deklarasi fungsi pergantian SF jaringan yang dijadwalkan ADR
 
 // definisi rtos
 TaskHandle_t taskSendDataToServerHandler; // Handle untuk task mengirim data ke server (di-comment out saat pembuatan task)
 TaskHandle_t taskUpdateLcdHandler;        // Handle untuk task update LCD
 TaskHandle_t taskInputHandler;            // Handle untuk task menangani input
+TaskHandle_t taskLoraRxHandler;           // Handle untuk task yang memproses antrian paket LoRa
+TaskHandle_t taskUplinkHandler;           // Handle untuk task yang mengirim pembacaan ke server
+TaskHandle_t taskScheduleHandler;         // Handle untuk task beacon TDMA
 
 SemaphoreHandle_t serverSemaphore;    // Semaphore untuk sinkronisasi akses ke server (dibuat tapi tidak digunakan dalam task yang aktif)
 SemaphoreHandle_t lcdUpdateSemaphore; // Semaphore untuk sinkronisasi update LCD
+SemaphoreHandle_t loraTxSemaphore;    // Mutex radio: ACK dikirim dari task RX (KNN lokal, duplikat) dan task uplink (hasil server)
+SemaphoreHandle_t nodesMutex;         // Mutex registry node: slot digusur task RX, hasil server ditulis task uplink
 
 void sendToServerTask(void *pvParameter); // Deklarasi fungsi task untuk mengirim data ke server (tidak dibuat tasknya)
 void lcdUpdateTask(void *pvParameter);    // Deklarasi fungsi task untuk update LCD
 void inputUpdateTask(void *pvParameter);  // Deklarasi fungsi task untuk menangani input
+void loraRxTask(void *pvParameter);       // Deklarasi fungsi task untuk memproses paket LoRa
+void uplinkTask(void *pvParameter);       // Deklarasi fungsi task untuk mengirim pembacaan ke server
+void scheduleTask(void *pvParameter);     // Deklarasi fungsi task untuk menyiarkan beacon TDMA
 
 enum LcdScreen // Enumerasi untuk layar-layar menu pada LCD
 {
@@ -110,14 +356,18 @@ enum LcdScreen // Enumerasi untuk layar-layar menu pada LCD
   LoraTxPower,
   LoraSpreadingFactor,
   LoraDenominator,
-  LoraSignalBandwith
+  LoraSignalBandwith,
+  LoraRxQueue,
+  UplinkQueue,
+  UplinkSpool,
+  NodeList
 };
 
 #define EEPROM_SIZE 512     // Ukuran memori EEPROM yang digunakan
 #define DITEKAN LOW         // Mendefinisikan kondisi tombol ditekan (aktif LOW karena PULLUP)
 #define TIDAK_DITEKAN HIGH  // Mendefinisikan kondisi tombol tidak ditekan
 #define ESP_BOOT_DELAY 1500 // Waktu tunda saat boot ESP32 dalam milidetik
-#define LCD_PAGES_COUNT 10  // Jumlah halaman menu pada LCD
+#define LCD_PAGES_COUNT 14  // Jumlah halaman menu pada LCD
 
 bool loraSettingClicked = 0; // Penanda apakah menu setting LoRa sedang dipilih (sepertinya variabel ini bisa digabung atau digantikan lcdClicked)
 int loraSettingSubMenu = 0;  // Variabel untuk submenu setting LoRa (tidak terpakai)
@@ -273,17 +523,20 @@ void setup() // Fungsi setup, dijalankan sekali saat startup
     delay(500);
   }
 
-  // LoRa.setTxPower(loraSettingParameter.txPower); // Komentar: Pengaturan LoRa dipindahkan ke menu, di-load dari EEPROM
-  // LoRa.setSpreadingFactor(loraSettingParameter.spreadingFactor);
-  // LoRa.setCodingRate4(loraSettingParameter.codeDenominator);
-  // LoRa.setSignalBandwidth(loraSettingParameter.signalBandwidth);
-  // Penting: Setelah memuat dari EEPROM, parameter LoRa perlu di-apply ke library LoRa.
-  // Sebaiknya lakukan apply setting LoRa dari EEPROM di sini atau pastikan dilakukan di menu setelah loading.
-  // Contoh:
-  // if (loraSettingParameter.txPower != 0) LoRa.setTxPower(loraSettingParameter.txPower);
-  // if (loraSettingParameter.spreadingFactor != 0) LoRa.setSpreadingFactor(loraSettingParameter.spreadingFactor);
-  // if (loraSettingParameter.codeDenominator != 0) LoRa.setCodingRate4(loraSettingParameter.codeDenominator);
-  // if (loraSettingParameter.signalBandwidth != 0) LoRa.setSignalBandwidth(loraSettingParameter.signalBandwidth);
+  // Pengaturan dari EEPROM diterapkan setelah begin() (begin() me-reset modul); EEPROM kosong memakai default library
+  if (loraSettingParameter.txPower > 0)
+    LoRa.setTxPower(loraSettingParameter.txPower);
+  if (loraSettingParameter.spreadingFactor > 0)
+    LoRa.setSpreadingFactor(loraSettingParameter.spreadingFactor);
+  if (loraSettingParameter.codeDenominator > 0)
+    LoRa.setCodingRate4(loraSettingParameter.codeDenominator);
+  if (loraSettingParameter.signalBandwidth > 0)
+    LoRa.setSignalBandwidth(loraSettingParameter.signalBandwidth);
+#if ADR_ENABLED
+  adr.begin(constrain(loraSettingParameter.spreadingFactor, ADR_SF_MIN, ADR_SF_MAX)); // SF awal jaringan, selanjutnya diatur ADR
+  loraSettingParameter.spreadingFactor = adr.spreadingFactor();
+  LoRa.setSpreadingFactor(adr.spreadingFactor());
+#endif
 
   Lcd.clear();
   centerText("LoRA", 0);
@@ -294,7 +547,14 @@ void setup() // Fungsi setup, dijalankan sekali saat startup
 
   // Konfigurasi Address Lokal dan Destinasi
   loraParameter.loraLocalAddress = 0x02; // Mengatur alamat LoRa lokal
-  loraParameter.loraDestination = 0x01;  // Mengatur alamat LoRa tujuan
+  loraParameter.loraDestination = 0x01;  // Mengatur alamat LoRa tujuan (hanya sendLoraMessage(String), respons dikirim ke alamat pengirim frame)
+
+  nodes.reset();
+  nodeSeries.reset();
+  Serial.printf("[Node] Registry %u node: status %u B + rekonstruksi %u B\n", (unsigned)NODE_REGISTRY_SIZE, (unsigned)sizeof(nodes),
+                (unsigned)sizeof(nodeSeries));
+  Serial.printf("[JSON] Arena uplink %u B + body %u B, LoRa RX/TX %u B\n", (unsigned)uplinkJsonArena.capacity(), (unsigned)UPLINK_BODY_MAX_SIZE,
+                (unsigned)loraRxJsonArena.capacity());
 
   Lcd.clear();
   delay(500);
@@ -302,6 +562,8 @@ void setup() // Fungsi setup, dijalankan sekali saat startup
   // konfigurasi rtos
   serverSemaphore = xSemaphoreCreateBinary();    // Membuat binary semaphore untuk server
   lcdUpdateSemaphore = xSemaphoreCreateBinary(); // Membuat binary semaphore untuk update LCD
+  loraTxSemaphore = xSemaphoreCreateMutex();     // Membuat mutex untuk pengiriman LoRa
+  nodesMutex = xSemaphoreCreateMutex();          // Membuat mutex untuk registry node
 
   xSemaphoreGive(serverSemaphore);    // Memberikan semaphore server (agar bisa diambil pertama kali)
   xSemaphoreGive(lcdUpdateSemaphore); // Memberikan semaphore LCD update (agar bisa diambil pertama kali)
@@ -329,6 +591,38 @@ void setup() // Fungsi setup, dijalankan sekali saat startup
       NULL,
       1,
       &taskInputHandler);
+
+  uplinkQueue = xQueueCreate(UPLINK_QUEUE_DEPTH, sizeof(SensorReading)); // Membuat antrian uplink
+
+  xTaskCreate( // Membuat task untuk mengirim pembacaan ke server (POST HTTP bersifat blocking)
+      uplinkTask,
+      "Uplink Task",
+      8192, // Stack besar karena HTTPClient dan ArduinoJson
+      NULL,
+      1,
+      &taskUplinkHandler);
+
+  xTaskCreate( // Membuat task untuk memproses paket LoRa dari antrian interrupt
+      loraRxTask,
+      "LoRa RX Task",
+      4096,
+      NULL,
+      2, // Prioritas lebih tinggi dari task lain agar antrian interrupt cepat dikosongkan
+      &taskLoraRxHandler);
+
+#if SCHEDULE_ENABLED
+  xTaskCreate( // Membuat task untuk menyiarkan beacon TDMA
+      scheduleTask,
+      "Schedule Task",
+      3072,
+      NULL,
+      2, // Beacon harus tepat waktu: node memproyeksikan slot dari awal beacon
+      &taskScheduleHandler);
+#endif
+
+  // Penerimaan LoRa digerakkan interrupt DIO0, bukan polling di loop()
+  LoRa.onReceive(onLoraReceiveCallback); // Daftarkan callback interrupt
+  LoRa.receive();                        // Masuk ke mode receive kontinu
 }
 
 uint8_t buttonState, lastButtonState; // Variabel untuk menyimpan status tombol saat ini dan sebelumnya
@@ -450,6 +744,10 @@ void inputUpdateTask(void *pvParameter) // Task untuk menangani input tombol
         paused ^= true; // Toggle status pause pada menu monitoring
         break;
 
+      case LcdScreen::NodeList:
+        lcdNode = lcdNode + 1 < nodes.count() ? lcdNode + 1 : 0; // Pilih node berikutnya untuk halaman monitoring
+        break;
+
       case LcdScreen::UpdateRateSetting:
       {
         if (!lcdClicked) // Jika baru saja keluar dari mode edit
@@ -491,6 +789,11 @@ void inputUpdateTask(void *pvParameter) // Task untuk menangani input tombol
           EEPROM.commit();
           Lcd.clear();
           LoRa.setSpreadingFactor(loraSettingParameter.spreadingFactor); // Langsung terapkan perubahan Spreading Factor
+#if ADR_ENABLED
+          xSemaphoreTake(loraTxSemaphore, portMAX_DELAY);
+          adr.begin(constrain(loraSettingParameter.spreadingFactor, ADR_SF_MIN, ADR_SF_MAX)); // SF manual menjadi titik awal ADR
+          xSemaphoreGive(loraTxSemaphore);
+#endif
           centerText("Menyimpan Data", 0);
           delay(1000);
           Lcd.clear();
@@ -603,13 +906,14 @@ void inputUpdateTask(void *pvParameter) // Task untuk menangani input tombol
     lcdMenu = (lcdMenu > LCD_PAGES_COUNT) ? LCD_PAGES_COUNT : (lcdMenu < 0) ? 0
                                                                             : lcdMenu;
 
-    // Logika untuk mengaktifkan buzzer berdasarkan respons server
-    if (serverResponse.buzzerOn && buzzerLastState != serverResponse.buzzerOn) // Jika buzzerOn dari server true dan status sebelumnya false
+    // Logika untuk mengaktifkan buzzer berdasarkan respons server ke node mana pun yang masih aktif
+    bool buzzerOn = nodeBuzzerRequested();
+    if (buzzerOn && buzzerLastState != buzzerOn) // Jika buzzerOn dari server true dan status sebelumnya false
     {
       activateBuzzerUntil = millis() + buzzerActiveTime; // Set waktu buzzer aktif
     }
 
-    if (serverResponse.buzzerOn && millis() < activateBuzzerUntil) // Jika buzzerOn true dan masih dalam durasi aktif
+    if (buzzerOn && millis() < activateBuzzerUntil) // Jika buzzerOn true dan masih dalam durasi aktif
     {
       digitalWrite(buzzerPin, HIGH); // Nyalakan buzzer
     }
@@ -620,7 +924,7 @@ void inputUpdateTask(void *pvParameter) // Task untuk menangani input tombol
 
     lastLcdMenu = lcdMenu;                     // Simpan menu saat ini sebagai menu terakhir
     lastButtonState = buttonState;             // Simpan status tombol saat ini sebagai status terakhir
-    buzzerLastState = serverResponse.buzzerOn; // Simpan status buzzer saat ini sebagai status terakhir
+    buzzerLastState = buzzerOn;                // Simpan status buzzer saat ini sebagai status terakhir
     vTaskDelay(33);                            // Memberi jeda task sekitar 30 FPS (1000ms / 30 = ~33ms)
   }
 }
@@ -631,12 +935,21 @@ void lcdUpdateTask(void *pvParameter) // Task untuk memperbarui tampilan LCD
   {
     if (xSemaphoreTake(lcdUpdateSemaphore, portMAX_DELAY) == pdTRUE) // Mencoba mengambil semaphore LCD
     {
+      NodeState *node = selectedNode(); // Halaman monitoring dan status menampilkan node yang dipilih di halaman Node
+      float temperature = node != NULL ? telemetryFromFixed(node->temperature) : 0;
+      float humidity = node != NULL ? telemetryFromFixed(node->humidity) : 0;
+      float pH = node != NULL ? telemetryFromFixed(node->ph) : 0;
+      bool classification = node != NULL && (node->lastFlags & ArqAckClassification);
+      bool buzzerOn = node != NULL && (node->lastFlags & ArqAckBuzzer);
+
       switch (lcdMenu) // Menampilkan konten berdasarkan menu yang aktif
       {
       case LcdScreen::Monitoring:
       {
         Lcd.setCursor(0, 0);
         Lcd.printf("T %.2f C", temperature); // Menampilkan suhu
+        Lcd.setCursor(11, 0);
+        Lcd.printf("%02X", node != NULL ? node->address : 0); // Alamat node yang ditampilkan
         Lcd.setCursor(0, 1);
 
         if (humidity > 10.0) // Format tampilan kelembaban agar rapi
@@ -663,7 +976,7 @@ void lcdUpdateTask(void *pvParameter) // Task untuk memperbarui tampilan LCD
         Lcd.printf("pH %.1f ", pH); // Menampilkan pH
 
         Lcd.setCursor(14, 0);
-        Lcd.printf((serverResponse.classification) ? "L" : "T"); // Menampilkan status klasifikasi (L/T)
+        Lcd.printf(classification ? "L" : "T"); // Menampilkan status klasifikasi (L/T)
         break;
       }
       case LcdScreen::LoraRSSI:
@@ -673,13 +986,15 @@ void lcdUpdateTask(void *pvParameter) // Task untuk memperbarui tampilan LCD
         {
           centerText("Terjeda", 1);
         }
-        else if (loraRSSI == 0) // Jika RSSI 0 (belum ada koneksi/data)
+        else if (node == NULL) // Belum ada paket dari transmitter mana pun
         {
           centerText("Tidak Terhubung", 1);
         }
         else
         {
-          centerText(String(loraRSSI).c_str(), 1); // Menampilkan nilai RSSI
+          char rssi[16];
+          snprintf(rssi, sizeof(rssi), "%02X: %d", node->address, node->rssi);
+          centerText(rssi, 1); // Menampilkan nilai RSSI node yang dipilih
         }
         break;
       }
@@ -706,7 +1021,7 @@ void lcdUpdateTask(void *pvParameter) // Task untuk memperbarui tampilan LCD
       case LcdScreen::StatusBuzzer:
       {
         centerText("Status Buzzer", 0);
-        centerText(serverResponse.buzzerOn ? "Hidup" : " Mati ", 1); // Menampilkan status buzzer
+        centerText(buzzerOn ? "Hidup" : " Mati ", 1); // Menampilkan status buzzer
         break;
       }
       case LcdScreen::WiFiStatus:
@@ -777,6 +1092,43 @@ void lcdUpdateTask(void *pvParameter) // Task untuk memperbarui tampilan LCD
         }
         break;
       }
+      case LcdScreen::LoraRxQueue:
+      {
+        centerText("LoRA RX Queue", 0);
+        Lcd.setCursor(0, 1);
+        Lcd.printf("Drop %-4lu HW %lu/%lu", (unsigned long)loraRxQueue.dropped(), (unsigned long)loraRxQueue.highWater(), (unsigned long)loraRxQueue.capacity()); // Paket terbuang dan puncak isi antrian
+        break;
+      }
+      case LcdScreen::UplinkQueue:
+      {
+        centerText("Uplink Queue", 0);
+        Lcd.setCursor(0, 1);
+        Lcd.printf("Q%-2u D%-3lu %4lums", (unsigned)uxQueueMessagesWaiting(uplinkQueue), pipelineStats.dropped + pipelineStats.coalesced, pipelineStats.uplink.lastUs / 1000); // Isi antrian, pembacaan terbuang, durasi POST terakhir
+        break;
+      }
+      case LcdScreen::UplinkSpool:
+      {
+        Lcd.setCursor(0, 0);
+        Lcd.printf("Spool %-10s", uplinkUp ? "uplink OK" : "terputus");
+        Lcd.setCursor(0, 1);
+        Lcd.printf("S%-5lu R%5.1f/s ", (unsigned long)uplinkSpool.count(), spoolReplayThroughput()); // Isi spool, throughput replay
+        break;
+      }
+      case LcdScreen::NodeList:
+      {
+        // Node yang dipilih (PB tengah: node berikutnya), urutan di registry, RSSI dan umur paket terakhirnya
+        Lcd.setCursor(0, 0);
+        if (node == NULL)
+        {
+          Lcd.printf("Node -/%-8u", (unsigned)nodes.count());
+          centerText("Belum ada node", 1);
+          break;
+        }
+        Lcd.printf("Node %02X %3u/%-4u", node->address, (unsigned)lcdNode + 1, (unsigned)nodes.count());
+        Lcd.setCursor(0, 1);
+        Lcd.printf("%4ddBm %6lus  ", node->rssi, (millis() - node->lastSeenMs) / 1000);
+        break;
+      }
       }
       xSemaphoreGive(lcdUpdateSemaphore); // Memberikan kembali semaphore LCD
     }
@@ -784,66 +1136,249 @@ void lcdUpdateTask(void *pvParameter) // Task untuk memperbarui tampilan LCD
   }
 }
 
-void sendToServer(String data) // Fungsi untuk mengirim data ke server Python
+// Serialisasi batch pembacaan ke buffer (tanpa heap: dokumen di uplinkJsonArena, teks langsung ke buffer).
+// Mengembalikan panjang JSON, 0 jika arena atau buffer tidak cukup (batch tidak dikirim terpotong)
+size_t encodeUplinkBatch(const SensorReading *readings, size_t count, char *buffer, size_t size)
+{
+  // Payload: {"readings": [{temperature, temperature_min, temperature_max, humidity, ph, sender, rssi, age_ms, held|heartbeat, probes}, ...]}
+  JsonDocument request(&uplinkJsonArena);
+  JsonArray items = request["readings"].to<JsonArray>();
+  unsigned long nowUs = micros();
+  for (size_t i = 0; i < count; i++)
+  {
+    JsonObject item = items.add<JsonObject>();
+    item["temperature"] = readings[i].temperature;
+    item["temperature_min"] = readings[i].temperatureMin;
+    item["temperature_max"] = readings[i].temperatureMax;
+    item["humidity"] = readings[i].humidity;
+    item["ph"] = readings[i].ph;
+    item["sender"] = readings[i].sender;
+    item["rssi"] = readings[i].rssi;
+    unsigned long ageMs = (nowUs - readings[i].receivedAtUs) / 1000; // Umur pembacaan, untuk timestamp di server
+    if (readings[i].capturedAgeMs != TELEMETRY_AGE_UNKNOWN)
+      ageMs += readings[i].capturedAgeMs; // Ditambah lama pembacaan tersimpan di flash transmitter atau spool
+    else
+      item["age_unknown"] = true; // Diambil sebelum transmitter/Receiver restart, jam-nya tidak bisa dibandingkan
+    item["age_ms"] = ageMs;
+    if (readings[i].held)
+      item["held"] = true; // Sampel rekonstruksi: nilai terakhir node masih berlaku (di dalam deadband)
+    else if (readings[i].backlog)
+      item["backlog"] = true;
+    else if (readings[i].heartbeat)
+      item["heartbeat"] = true;
+    if (readings[i].probeCount > 0)
+    {
+      // Vektor suhu lengkap per probe: [{"id":..,"temperature":..}], temperature null jika probe gagal dibaca
+      JsonArray probes = item["probes"].to<JsonArray>();
+      for (uint8_t p = 0; p < readings[i].probeCount; p++)
+      {
+        JsonObject probe = probes.add<JsonObject>();
+        probe["id"] = readings[i].probeId[p];
+        if (readings[i].probeTemperature[p] != TELEMETRY_PROBE_INVALID)
+          probe["temperature"] = telemetryFromFixed(readings[i].probeTemperature[p]);
+        else
+          probe["temperature"] = nullptr;
+      }
+    }
+  }
+  if (request.overflowed())
+  {
+    Serial.println("[Uplink] Arena JSON penuh");
+    return 0;
+  }
+  size_t length = measureJson(request);
+  if (length >= size)
+  {
+    Serial.printf("[Uplink] JSON %u B melebihi buffer\n", (unsigned)length);
+    return 0;
+  }
+  return serializeJson(request, buffer, size);
+}
+
+// Satu POST lewat sesi keep-alive; socket dibuka ulang oleh HTTPClient hanya jika sudah tertutup
+int postUplink(const char *data, size_t length, bool &reusedConnection)
+{
+  reusedConnection = uplinkSession.client.connected();
+  if (!reusedConnection)
+    uplinkSession.connects++;
+
+  uplinkSession.http.begin(uplinkSession.client, uplinkSession.serverIp.toString(), ServerPort, ServerPath);
+  uplinkSession.http.setReuse(true);                                 // Pertahankan koneksi setelah end()
+  uplinkSession.http.addHeader("Content-Type", "application/json"); // Menambahkan header Content-Type
+  return uplinkSession.http.POST((uint8_t *)data, length);
+}
+
+// Mengirim satu batch pembacaan ke server Python, lalu meneruskan hasil klasifikasinya ke transmitter via LoRa
+// (kecuali replay spool: transmitter sudah lama di-ACK). Mengembalikan true jika server menjawab dengan hasil
+// untuk setiap pembacaan
+bool sendToServer(const SensorReading *readings, size_t count, bool replay)
 {
   if (WiFi.status() != WL_CONNECTED) // Cek status koneksi WiFi
   {
     wiFiConnected = false; // Set status WiFi tidak terhubung
+    uplinkSession.client.stop();
     Serial.println("Tidak terhubung ke internet, restart perangkat dan hubungkan lagi");
-    return; // Keluar dari fungsi jika tidak ada koneksi
+    return false; // Keluar dari fungsi jika tidak ada koneksi
   }
 
-  // Tinggal kirim data ke server python setelah LoRA (Komentar ini mungkin bisa diperjelas atau dihapus)
-  WiFiClient client; // Membuat objek WiFiClient
-  HTTPClient http;   // Membuat objek HTTPClient
+  // Lookup mDNS hanya sekali; diulang setelah POST gagal karena IP server mungkin berubah
+  if (!uplinkSession.resolved)
+  {
+    uplinkSession.resolves++;
+    if (!WiFi.hostByName(ServerHost, uplinkSession.serverIp))
+    {
+      wiFiConnected = false;
+      Serial.printf("Gagal resolve %s\n", ServerHost);
+      return false;
+    }
+    uplinkSession.resolved = true;
+  }
 
-  http.begin(client, Endpoint);                       // Memulai koneksi HTTP ke endpoint server
-  http.addHeader("Content-Type", "application/json"); // Menambahkan header Content-Type
+  size_t length = encodeUplinkBatch(readings, count, uplinkSession.body, sizeof(uplinkSession.body));
+  if (length == 0)
+    return false; // Batch masuk spool seperti saat server tidak menjawab
 
-  int httpResponseCode = http.POST(data); // Mengirim data JSON via metode POST dan mendapatkan kode respons
-  Serial.printf("[Mengirim ke %s] -> %s\n", Endpoint.c_str(), data.c_str());
+  HTTPClient &http = uplinkSession.http;
+  bool reusedConnection;
+  int httpResponseCode = postUplink(uplinkSession.body, length, reusedConnection); // Mengirim data JSON via metode POST dan mendapatkan kode respons
+  if (httpResponseCode < 0 && reusedConnection)                                    // Server menutup koneksi idle: ulangi sekali dengan koneksi baru
+  {
+    uplinkSession.staleRetries++;
+    http.end();
+    uplinkSession.client.stop();
+    httpResponseCode = postUplink(uplinkSession.body, length, reusedConnection);
+  }
+  // Log dicetak per bagian: printf ESP32 mengalokasikan buffer sementara untuk keluaran 64 byte ke atas
+  Serial.printf("[Mengirim %u pembacaan ke ", (unsigned)count);
+  Serial.print(Endpoint);
+  Serial.print("/batch] -> ");
+  Serial.println(uplinkSession.body);
 
   // Jika berhasil (kode respons 200 OK)
   if (httpResponseCode == 200)
   {
-    String response = http.getString();                          // Mendapatkan respons dari server sebagai String
-    JsonDocument doc;                                            // Membuat objek JsonDocument untuk parsing respons
-    DeserializationError error = deserializeJson(doc, response); // Parsing JSON respons
+    JsonDocument doc(&uplinkJsonArena);                                  // Dokumen respons di arena uplink (request sudah dilepas)
+    DeserializationError error = deserializeJson(doc, http.getStream());  // Parsing langsung dari stream HTTP, tanpa salinan String
+    JsonArray results = doc["results"];
 
     if (error) // Jika terjadi error saat parsing JSON
     {
       Serial.print(F("deserializeJson() failed: "));
       Serial.print(error.f_str());
-      return; // Keluar dari fungsi
+      http.end();   // Selesai membaca respons, koneksi tetap disimpan untuk POST berikutnya
+      return false; // Keluar dari fungsi
+    }
+
+    wiFiConnected = true; // Set status WiFi terhubung (karena server merespons)
+
+    // Server harus mengembalikan satu hasil per pembacaan. Jika tidak, hasil tidak bisa dipasangkan dan respons
+    // LoRa dilewati, tapi batch sudah diterima server (200): tidak di-spool agar tidak di-replay berulang
+    if (results.size() != count)
+    {
+      Serial.printf("Jumlah hasil batch tidak sesuai: %u dari %u, respons LoRa dilewati\n", (unsigned)results.size(), (unsigned)count);
+      http.end();
+      return true;
     }
 
-    wiFiConnected = true;                   // Set status WiFi terhubung (karena server merespons)
-    classification = doc["classification"]; // Mengambil nilai "classification" dari JSON respons
-    buzzerOn = doc["buzzer_on"];            // Mengambil nilai "buzzer_on" dari JSON respons
+    Serial.printf("[%d] -> ", httpResponseCode);
+    serializeJson(doc, Serial);
+    Serial.println();
+
+#if LOCAL_KNN_ENABLED
+    // Respons LoRa sudah dikirim dari hasil KNN lokal; hasil server hanya dicocokkan sebagai pemeriksaan model
+    for (size_t i = 0; i < count; i++)
+    {
+      if (readings[i].classifiedLocally && results[i]["classification"].as<bool>() != readings[i].classification)
+        pipelineStats.knnMismatches++;
+    }
+#else
+    for (size_t i = 0; i < count && !replay; i++)
+    {
+      // Sampel rekonstruksi tidak dijawab: transmitter hanya mendengar setelah mengirim frame.
+      // Pembacaan backlog sudah di-ACK saat frame batch diterima
+      if (readings[i].held || readings[i].backlog)
+        continue;
+
+      // Transmitter hanya butuh hasil pembacaan terbarunya
+      if (!isLatestFromSender(readings, count, i))
+        continue;
 
-    serverResponse.classification = classification; // Menyimpan hasil ke struct serverResponse
-    serverResponse.buzzerOn = buzzerOn;
+      ServerResponse serverResponse;
+      serverResponse.classification = results[i]["classification"]; // Mengambil nilai "classification" hasil pembacaan ini
+      serverResponse.buzzerOn = results[i]["buzzer_on"];             // Mengambil nilai "buzzer_on" hasil pembacaan ini
 
-    Serial.printf("[%d] -> %s\n", httpResponseCode, response.c_str());
+      if (!readings[i].arq) // Transmitter lama: respons JSON menunggu hasil server seperti sebelumnya
+      {
+        sendLoraMessage(serverResponse, readings[i].sender, readings[i].msgId, NULL);
+        continue;
+      }
 
-    sendLoraMessage(serverResponse); // Mengirim respons server kembali ke transmitter via LoRa
+      // Frame ARQ sudah di-ACK task RX dengan hasil sebelumnya; hasil baru dikirim terpisah hanya jika berbeda
+      uint8_t resultFlags = (serverResponse.classification ? ArqAckClassification : 0) | (serverResponse.buzzerOn ? ArqAckBuzzer : 0);
+      if (resultChanged(readings[i].sender, resultFlags))
+      {
+        ArqAck result = readings[i].ack;
+        result.flags |= ArqAckResult;
+        sendLoraMessage(serverResponse, readings[i].sender, readings[i].msgId, &result);
+      }
+    }
+#endif
+    http.end();
+    return true;
   }
   else // Jika terjadi error saat mengirim POST
   {
-    classification = false; // Set default nilai jika error
-    buzzerOn = false;
     wiFiConnected = false; // Set status WiFi tidak terhubung (karena error)
+    Serial.printf("Error on sending POST: %d\n", httpResponseCode);
 
-    serverResponse.classification = classification;
-    serverResponse.buzzerOn = buzzerOn;
-    Serial.println("Error on sending POST: " + String(httpResponseCode));
+    uplinkSession.client.stop();    // Buang socket yang rusak
+    uplinkSession.resolved = false; // Resolve ulang IP server pada POST berikutnya
   }
 
-  http.end(); // Menutup koneksi HTTP
+  http.end(); // Selesai dengan request ini; dengan setReuse(true) socket tetap terbuka
+  return false;
 }
 
-// Fungsi sendLoraMessage overload untuk mengirim struct ServerResponse
-void sendLoraMessage(const ServerResponse &responseData)
+// Pembacaan asli terakhir dari pengirim yang sama di batch (pembacaan sebelumnya sudah tergantikan)
+bool isLatestFromSender(const SensorReading *readings, size_t count, size_t index)
+{
+  for (size_t j = index + 1; j < count; j++)
+  {
+    if (!readings[j].held && !readings[j].backlog && readings[j].sender == readings[index].sender)
+      return false;
+  }
+  return true;
+}
+
+// Hasil server berbeda dari hasil terakhir yang dikirim ke node (di ACK task RX atau pesan hasil sebelumnya).
+// Node yang sudah digusur dari registry tidak dikirimi hasil
+bool resultChanged(byte address, uint8_t resultFlags)
+{
+  xSemaphoreTake(nodesMutex, portMAX_DELAY);
+  NodeState *node = nodes.find(address);
+  bool changed = node != NULL && node->address == address && node->lastFlags != resultFlags;
+  xSemaphoreGive(nodesMutex);
+  return changed;
+}
+
+// Listen-before-talk: respons ditahan selama radio sedang menerima sinyal (frame yang masih di udara akan
+// hilang jika radio pindah ke TX), paling lama satu time-on-air frame terpanjang (batch backlog) pada setting aktif
+void waitChannelClear()
+{
+  int spreadingFactor = constrain(loraSettingParameter.spreadingFactor, 6, 12);
+  int codeDenominator = constrain(loraSettingParameter.codeDenominator, 5, 8);
+  float signalBandwidth = max(loraSettingParameter.signalBandwidth, loraBandwidth[0]);
+  unsigned long maxWaitMs = loraTimeOnAirUs(4 + TELEMETRY_BATCH_MAX_SIZE, spreadingFactor, signalBandwidth, codeDenominator) / 1000 + 1;
+
+  unsigned long start = millis();
+  while (LoRa.rssi() > LBT_THRESHOLD_DBM && millis() - start < maxWaitMs)
+    delay(LBT_POLL_MS);
+}
+
+// Fungsi sendLoraMessage overload untuk mengirim struct ServerResponse. Transmitter dengan ARQ (ack != NULL)
+// dijawab dengan frame ACK biner yang membawa hasil klasifikasi (ArqAckResult: pesan hasil setelah POST);
+// transmitter lama dengan JSON dan msgId frame yang dijawab. Bisa dipanggil dari task RX dan task uplink, radio dilindungi loraTxSemaphore.
+void sendLoraMessage(const ServerResponse &responseData, byte destination, byte msgId, const ArqAck *ack)
 {
   if (paused)
   { // Jangan kirim jika sistem dijeda
@@ -853,12 +1388,61 @@ void sendLoraMessage(const ServerResponse &responseData)
 
   digitalWrite(ledKiri, HIGH); // Nyalakan LED TX LoRa
 
-  // Membuat payload JSON dari struct ServerResponse
-  JsonDocument doc;
-  String serializedResponse;
-  doc["classification"] = responseData.classification;
-  doc["buzzer_on"] = responseData.buzzerOn;
-  serializeJson(doc, serializedResponse); // Serialisasi JSON ke String
+  // Membuat payload dari struct ServerResponse: frame ACK atau JSON
+  uint8_t payload[ARQ_ACK_MAX_SIZE];
+  size_t payloadLength = 0;
+  char legacyResponse[LEGACY_RESPONSE_MAX_SIZE]; // Hanya respons JSON lama
+  char responseLog[64];                          // Ringkasan respons untuk log
+  uint8_t resultFlags = (responseData.classification ? ArqAckClassification : 0) | (responseData.buzzerOn ? ArqAckBuzzer : 0);
+
+  ArqAck response;
+  if (ack != NULL)
+  {
+    response = *ack;
+    response.flags |= resultFlags;
+    msgId = (uint8_t)response.seq;
+    snprintf(responseLog, sizeof(responseLog), "ACK seq %u%s", response.seq,
+             response.flags & ArqAckDuplicate ? " (duplikat)" : response.flags & ArqAckResult ? " (hasil)" : "");
+  }
+
+  xSemaphoreTake(loraTxSemaphore, portMAX_DELAY);
+  // Slot node dicari di bawah nodesMutex: task RX bisa menggusur dan memakai ulang slot untuk alamat lain
+  // kapan saja, jadi hasil yang datang terlambat tidak boleh mendarat di node lain
+  xSemaphoreTake(nodesMutex, portMAX_DELAY);
+  NodeState *node = nodes.find(destination);
+  if (node != NULL && node->address != destination)
+    node = NULL;
+  if (node != NULL)
+    node->lastFlags = resultFlags; // Hasil per node: ACK ulang frame yang dikirim ulang, LCD dan buzzer
+
+  if (ack == NULL)
+  {
+    // Respons JSON lama, dibangun di bawah loraTxSemaphore karena task RX dan uplink berbagi loraTxJsonArena
+    JsonDocument doc(&loraTxJsonArena);
+    doc["classification"] = responseData.classification;
+    doc["buzzer_on"] = responseData.buzzerOn;
+    payloadLength = serializeJson(doc, legacyResponse, sizeof(legacyResponse)); // Serialisasi JSON ke buffer tetap
+    snprintf(responseLog, sizeof(responseLog), "%s", legacyResponse);
+  }
+  else
+  {
+#if ADR_ENABLED
+    // Perintah ADR diulang di setiap ACK sampai node mengonfirmasinya; sisa waktu ganti SF dihitung saat dikirim
+    if (node != NULL && node->adr.commandPending())
+    {
+      AdrCommand command = adr.commandFor(node->adr, millis());
+      response.flags |= ArqAckCommand;
+      encodeAdrCommand(command, &payload[ARQ_ACK_SIZE], sizeof(payload) - ARQ_ACK_SIZE);
+      size_t logLength = strlen(responseLog);
+      snprintf(&responseLog[logLength], sizeof(responseLog) - logLength, " ADR #%u SF%u %d dBm", command.id, command.spreadingFactor, command.txPower);
+    }
+#endif
+    payloadLength = encodeArqAck(response, payload, sizeof(payload));
+    if (response.flags & ArqAckCommand)
+      payloadLength += ARQ_ACK_COMMAND_SIZE;
+  }
+  xSemaphoreGive(nodesMutex); // node tidak dipakai lagi setelah ini
+  waitChannelClear(); // Transmitter bisa sudah mengirim frame berikutnya sebelum respons ini terkirim
 
   // *** ADD LoRa State Management *** (Komentar ini menandakan bagian penting)
   LoRa.idle(); // Masuk ke mode standby sebelum mengirim
@@ -866,16 +1450,19 @@ void sendLoraMessage(const ServerResponse &responseData)
   // Kirim ke Receiver (actually back to Transmitter) -> Komentar ini menjelaskan tujuan pengiriman
   if (LoRa.beginPacket())
   {                                             // Memulai paket LoRa
-    LoRa.write(loraParameter.loraDestination);  // Tambahkan alamat tujuan (transmitter asal)
+    LoRa.write(destination);                    // Tambahkan alamat tujuan (transmitter asal)
     LoRa.write(loraParameter.loraLocalAddress); // Tambahkan alamat pengirim (receiver ini)
-    LoRa.write(0xAA);                           // Tambahkan ID pesan (gunakan ID unik untuk respons)
-    LoRa.write(serializedResponse.length());    // Tambahkan panjang payload
-    LoRa.print(serializedResponse);             // Tambahkan payload
+    LoRa.write(msgId);                          // Tambahkan ID pesan frame yang dijawab
+    LoRa.write(payloadLength); // Tambahkan panjang payload
+    if (ack != NULL)
+      LoRa.write(payload, payloadLength); // Tambahkan frame ACK
+    else
+      LoRa.write((const uint8_t *)legacyResponse, payloadLength); // Tambahkan payload JSON
 
     if (LoRa.endPacket())
     { // Selesaikan dan kirim paket (blocking)
       Serial.print("[LoRa TX Response Sent] -> ");
-      Serial.println(serializedResponse);
+      Serial.println(responseLog);
     }
     else
     {
@@ -889,34 +1476,271 @@ void sendLoraMessage(const ServerResponse &responseData)
 
   // *** ADD LoRa State Management *** (Komentar ini menandakan bagian penting)
   LoRa.receive();             // PENTING: Kembali ke mode receive setelah mengirim
+  xSemaphoreGive(loraTxSemaphore);
   digitalWrite(ledKiri, LOW); // Matikan LED TX LoRa
 }
 
-void onLoraReceiveCallback(int packetSize) // Callback yang dipanggil ketika ada paket LoRa masuk
+#if SCHEDULE_ENABLED
+// Beacon TDMA: susunan slot diperbarui dari registry setiap periode (node stale dilepas, node baru ditambah di
+// belakang agar slot node lain tidak bergeser). Periode berikutnya dihitung dari awal TX beacon yang sebenarnya,
+// karena node memproyeksikan slot dari beacon yang didengarnya, bukan dari jadwal nominal
+void scheduleTask(void *pvParameter)
 {
-  if (packetSize == 0) // Jika ukuran paket 0 (tidak ada data)
+  ScheduleBeacon beacon;
+  uint8_t number = 0;
+  uint32_t periodMs = SCHEDULE_MIN_PERIOD_MS;
+  scheduleTable.reset();
+
+  while (1)
   {
-    digitalWrite(ledKanan, LOW); // Matikan LED RX jika tidak ada data (sebaiknya LED dikontrol saat data valid diterima/selesai diproses)
-    return;                      // Keluar
+    int spreadingFactor = constrain(loraSettingParameter.spreadingFactor, 6, 12);
+    int codeDenominator = constrain(loraSettingParameter.codeDenominator, 5, 8);
+    float signalBandwidth = max(loraSettingParameter.signalBandwidth, loraBandwidth[0]);
+
+    unsigned long now = millis();
+    uint32_t staleMs = scheduleStaleMs(periodMs, REPORT_STALE_MS);
+    xSemaphoreTake(nodesMutex, portMAX_DELAY); // Alamat slot tidak berganti selama pemindaian
+    for (uint8_t i = 0; i < nodes.count(); i++)
+    {
+      NodeState &node = nodes.at(i);
+      if (node.frameLength > 0 && now - node.lastSeenMs < staleMs)
+        scheduleTable.update(node.address, node.frameLength);
+      else
+        scheduleTable.remove(node.address);
+    }
+    for (uint8_t i = 0; i < scheduleTable.size();) // Node yang tergusur dari registry
+    {
+      NodeState *node = nodes.find(scheduleTable.address(i));
+      if (node == NULL)
+        scheduleTable.remove(scheduleTable.address(i));
+      else
+        i++;
+    }
+    xSemaphoreGive(nodesMutex);
+
+    scheduleTable.build(beacon, number, spreadingFactor, signalBandwidth, codeDenominator, SCHEDULE_MIN_PERIOD_MS);
+    periodMs = schedulePeriodMs(beacon);
+    if (beacon.count == 0 || paused) // Belum ada node terjadwal: semua transmitter ALOHA
+    {
+      vTaskDelay(pdMS_TO_TICKS(periodMs));
+      continue;
+    }
+
+    unsigned long startMs = sendScheduleBeacon(beacon);
+    number++;
+    Serial.printf("[TDMA] Beacon #%u: %u slot, periode %lu ms\n", beacon.number, beacon.count, (unsigned long)periodMs);
+    unsigned long elapsedMs = millis() - startMs;
+    vTaskDelay(pdMS_TO_TICKS(elapsedMs < periodMs ? periodMs - elapsedMs : 0));
   }
+}
 
-  // nyalakan indikator led jika ada data masuk
-  digitalWrite(ledKanan, HIGH); // Nyalakan LED RX LoRa
+// Menyiarkan beacon ke alamat broadcast 0xFF, mengembalikan millis() saat TX dimulai (awal periode)
+unsigned long sendScheduleBeacon(const ScheduleBeacon &beacon)
+{
+  uint8_t payload[SCHEDULE_BEACON_MAX_SIZE];
+  size_t payloadLength = encodeScheduleBeacon(beacon, payload, sizeof(payload));
+
+  xSemaphoreTake(loraTxSemaphore, portMAX_DELAY);
+  waitChannelClear(); // Beacon yang tertunda tetap konsisten: node mengukur awal periode dari beacon ini
+  digitalWrite(ledKiri, HIGH);
+  LoRa.idle();
+  unsigned long startMs = millis();
+  if (LoRa.beginPacket())
+  {
+    LoRa.write(0xFF);                           // Broadcast ke semua transmitter
+    LoRa.write(loraParameter.loraLocalAddress);
+    LoRa.write(beacon.number);
+    LoRa.write(payloadLength);
+    LoRa.write(payload, payloadLength);
+    if (!LoRa.endPacket())
+      Serial.println("[LoRa TX ERROR] Failed to send beacon!");
+  }
+  else
+  {
+    Serial.println("[LoRa TX ERROR] Failed to begin beacon!");
+  }
+  LoRa.receive();
+  xSemaphoreGive(loraTxSemaphore);
+  digitalWrite(ledKiri, LOW);
+  return startMs;
+}
+#endif
 
-  int recipient = LoRa.read();       // Baca alamat penerima dari paket
-  byte sender = LoRa.read();         // Baca alamat pengirim dari paket
-  byte incomingMsgId = LoRa.read();  // Baca ID pesan dari paket
-  byte incomingLength = LoRa.read(); // Baca panjang pesan dari paket
+// Status transmitter, didaftarkan saat paket pertamanya masuk (hanya dari loraRxTask). Node yang menggusur
+// slot node lain mulai dengan jendela ARQ dan pembacaan kosong; penggusuran dan pengosongan slot di bawah
+// nodesMutex agar task uplink dan scheduleTask tidak melihat slot setengah berganti
+NodeState &nodeFor(byte sender, int16_t rssi)
+{
+  bool created;
+  xSemaphoreTake(nodesMutex, portMAX_DELAY);
+  NodeState &node = nodes.acquire(sender, millis(), created);
+  if (created)
+  {
+    node.window.reset();
+    node.lastFlags = 0;
+    node.probeCount = 0;
+    node.frameLength = 0;
+    node.hasSeq = false;
+    node.seq = 0;
+    node.temperature = node.temperatureMin = node.temperatureMax = 0;
+    node.humidity = 0;
+    node.ph = 0;
+    node.packets = 0;
+    node.adr.reset();
+  }
+  xSemaphoreGive(nodesMutex);
+  if (created)
+    Serial.printf("[Node] Node baru 0x%02X (%u/%u node)\n", sender, (unsigned)nodes.count(), (unsigned)nodes.capacity());
+  node.rssi = rssi;
+  node.packets++;
+  return node;
+}
 
-  String incoming = ""; // String untuk menyimpan data yang diterima
+// Node yang ditampilkan LCD, NULL jika belum ada transmitter yang terdengar
+NodeState *selectedNode()
+{
+  if (nodes.count() == 0)
+    return NULL;
+  return &nodes.at(lcdNode < nodes.count() ? lcdNode : 0);
+}
 
-  while (LoRa.available()) // Selama masih ada data yang bisa dibaca dari buffer LoRa
+// Buzzer Receiver menyala jika hasil terakhir salah satu node yang belum stale meminta buzzer
+bool nodeBuzzerRequested()
+{
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < nodes.count(); i++)
   {
-    incoming += (char)LoRa.read(); // Baca per karakter dan tambahkan ke string
+    NodeState &node = nodes.at(i);
+    if ((node.lastFlags & ArqAckBuzzer) && now - node.lastSeenMs < REPORT_STALE_MS)
+      return true;
   }
+  return false;
+}
+
+#if ADR_ENABLED
+// Node yang ikut keputusan ADR: terdengar dalam REPORT_STALE_MS terakhir (lebih lama untuk node yang jarang mengirim)
+AdrNode *adrNodeAt(uint8_t slot)
+{
+  NodeState &node = nodes.at(slot);
+  return millis() - node.lastSeenMs < node.adr.staleMs(REPORT_STALE_MS) ? &node.adr : NULL;
+}
+
+// Node ADR terdaftar yang sudah tidak aktif tapi belum ADR_NODE_GONE_MS: menahan SF jaringan agar tidak turun
+uint8_t adrSilentNodes()
+{
+  uint8_t silent = 0;
+  uint32_t now = millis();
+  for (uint8_t slot = 0; slot < nodes.count(); slot++)
+  {
+    NodeState &node = nodes.at(slot);
+    uint32_t idleMs = now - node.lastSeenMs;
+    if (node.adr.capable && idleMs >= node.adr.staleMs(REPORT_STALE_MS) && idleMs < ADR_NODE_GONE_MS)
+      silent++;
+  }
+  return silent;
+}
+
+// SNR frame baru (bukan duplikat) masuk riwayat node; perintah daya dan usulan SF disusun sebelum ACK dikirim
+void adrOnFrame(NodeState &node, uint8_t frameFlags, float snr)
+{
+  xSemaphoreTake(loraTxSemaphore, portMAX_DELAY);
+  uint8_t commandId = node.adr.command.id;
+  uint8_t proposal = adr.proposal();
+  bool switching = adr.switching();
+  adr.onFrame(node.adr, frameFlags, snr, millis());
+  adr.plan(nodes.count(), adrNodeAt, millis(), adrSilentNodes());
+  xSemaphoreGive(loraTxSemaphore);
+
+  if (node.adr.command.id != commandId)
+    Serial.printf("[ADR] 0x%02X SNR %.1f dB: perintah #%u SF%u %d dBm\n", node.address, snr, node.adr.command.id,
+                  node.adr.command.spreadingFactor, node.adr.command.txPower);
+  if (adr.proposal() != proposal && adr.proposal() != 0)
+    Serial.printf("[ADR] Usulan SF%u -> SF%u\n", adr.spreadingFactor(), adr.proposal());
+  else if (adr.proposal() == 0 && proposal != 0 && !adr.switching())
+    Serial.printf("[ADR] Usulan SF%u dibatalkan\n", proposal);
+  if (adr.switching() && !switching)
+    Serial.printf("[ADR] Ganti ke SF%u dalam %lu ms\n", adr.proposal(), (unsigned long)adr.msUntilSwitch(millis()));
+}
+
+// Waktu ganti SF jaringan tiba: radio Receiver pindah bersamaan dengan node yang sudah menerima jadwalnya
+void serviceAdrSwitch()
+{
+  xSemaphoreTake(loraTxSemaphore, portMAX_DELAY);
+  if (adr.service(nodes.count(), adrNodeAt, millis()))
+  {
+    loraSettingParameter.spreadingFactor = adr.spreadingFactor(); // Hanya RAM: EEPROM tetap titik awal setelah boot
+    LoRa.setSpreadingFactor(adr.spreadingFactor());
+    LoRa.receive();
+    Serial.printf("[ADR] SF jaringan sekarang SF%u (%lu pergantian)\n", adr.spreadingFactor(), (unsigned long)adr.changes());
+  }
+  xSemaphoreGive(loraTxSemaphore);
+}
+#endif
+
+// Callback interrupt DIO0: hanya menyalin paket dari FIFO radio ke antrian, pemrosesan dilakukan di loraRxTask.
+// Salinan langsung ke slot statis dengan satu burst SPI, tanpa heap
+void IRAM_ATTR onLoraReceiveCallback(int packetSize)
+{
+  LoraPacket *slot = loraRxQueue.beginPush(); // Ambil slot kosong di antrian
+  if (slot != NULL)                           // Antrian penuh: paket dibuang (tercatat di loraRxQueue.dropped()), FIFO ditimpa paket berikutnya
+  {
+    int length = packetSize < LORA_MAX_PACKET_SIZE ? packetSize : LORA_MAX_PACKET_SIZE;
+    loraReadFifo(ss, slot->data, length); // Salin isi paket apa adanya
+    slot->length = length;
+    slot->rssi = LoRa.packetRssi(); // RSSI harus dibaca sebelum paket berikutnya masuk
+    slot->snr = LoRa.packetSnr();   // Register SNR dikalikan 0.25 dengan double (soft-float), tanpa FPU di interrupt
+    slot->receivedAtUs = micros();  // Waktu tiba untuk metrik latensi
+    loraRxQueue.commitPush();       // Paket siap diproses task RX
+  }
+
+  BaseType_t higherPriorityTaskWoken = pdFALSE;
+  vTaskNotifyGiveFromISR(taskLoraRxHandler, &higherPriorityTaskWoken); // Bangunkan task RX
+  portYIELD_FROM_ISR(higherPriorityTaskWoken);
+}
+
+void loraRxTask(void *pvParameter) // Task untuk memproses paket LoRa dari antrian
+{
+  while (1)
+  {
+#if ADR_ENABLED
+    uint32_t switchMs = adr.msUntilSwitch(millis()); // Bangun juga tepat saat SF jaringan dijadwalkan berganti
+    ulTaskNotifyTake(pdTRUE, switchMs > 0 ? pdMS_TO_TICKS(switchMs) : portMAX_DELAY);
+    serviceAdrSwitch();
+#else
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY); // Tidur sampai interrupt DIO0 memberi notifikasi
+#endif
+
+    LoraPacket *packet;
+    while ((packet = loraRxQueue.front()) != NULL) // Proses semua paket yang sudah mengantri
+    {
+      if (!paused) // Paket yang masuk saat sistem dijeda diabaikan
+      {
+        processLoraPacket(*packet);
+      }
+      loraRxQueue.pop(); // Bebaskan slot untuk interrupt berikutnya
+    }
+  }
+}
+
+void processLoraPacket(const LoraPacket &packet) // Memproses satu paket LoRa yang sudah diterima
+{
+  LoraPacketView view; // Header dan payload dibaca di tempat dari slot antrian
+  if (!parseLoraPacket(packet.data, packet.length, view)) // Paket terlalu pendek untuk berisi header
+  {
+    return; // Keluar
+  }
+
+  // nyalakan indikator led jika ada data masuk
+  digitalWrite(ledKanan, HIGH); // Nyalakan LED RX LoRa
+
+  int recipient = view.recipient;     // Alamat penerima
+  byte sender = view.sender;          // Alamat pengirim
+  byte incomingMsgId = view.msgId;    // ID pesan
+  const uint8_t *payload = view.payload;
+  size_t payloadLength = view.payloadLength;
 
   // Cek jika panjang pesan tidak sesuai
-  if (incomingLength != incoming.length())
+  if (!view.lengthValid())
   {
     Serial.println("Panjang pesan tidak sesuai");
     digitalWrite(ledKanan, LOW); // Matikan LED jika error
@@ -931,33 +1755,543 @@ void onLoraReceiveCallback(int packetSize) // Callback yang dipanggil ketika ada
     return;                      // Keluar
   }
 
-  Serial.print("[Received LoRA Packet] -> ");
-  Serial.println(incoming);
+  // Status per pengirim (lookup O(1)); RSSI yang dicatat interrupt saat paket diterima
+  NodeState &node = nodeFor(sender, packet.rssi);
+
+  SensorReading reading;
+  reading.probeCount = 0;
+  reading.heartbeat = false;
+  reading.held = false;
+  reading.arq = false;
+  reading.backlog = false;
+  reading.capturedAgeMs = 0;
+  reading.classification = false;
+  reading.classifiedLocally = false;
 
-  loraParameter.incomingMessage = incoming; // Simpan pesan masuk
-  loraRSSI = LoRa.packetRssi();             // Dapatkan nilai RSSI dari paket terakhir
+  if (payloadLength > 0 && payload[0] == '{') // Payload JSON lama (transmitter dengan firmware sebelum frame biner)
+  {
+    JsonDocument doc(&loraRxJsonArena); // Dokumen di arena statis, jalur RX tetap tanpa heap
+    DeserializationError error = deserializeJson(doc, (const char *)payload, payloadLength); // Parse JSON dari buffer
 
-  JsonDocument doc;                                            // Objek untuk parsing JSON
-  DeserializationError error = deserializeJson(doc, incoming); // Parse JSON dari string masuk
+    if (error) // Jika error parsing JSON
+    {
+      Serial.print(F("deserializeJson() failed: "));
+      Serial.print(error.f_str());
+      digitalWrite(ledKanan, LOW); // Matikan LED jika error
+      return;                      // Keluar
+    }
 
-  if (error) // Jika error parsing JSON
+    // Dapatkan semua parameter dari JSON
+    reading.humidity = doc["humidity"];
+    reading.temperature = doc["temperature"];
+    reading.ph = doc["ph"];
+  }
+  else if (payloadLength > 0 && payload[0] == TELEMETRY_BATCH_VERSION) // Batch backlog dari flash transmitter
   {
-    Serial.print(F("deserializeJson() failed: "));
-    Serial.print(error.f_str());
-    digitalWrite(ledKanan, LOW); // Matikan LED jika error
-    return;                      // Keluar
+    processBacklogBatch(packet, node, incomingMsgId, payload, payloadLength);
+    digitalWrite(ledKanan, LOW);
+    return;
   }
+  else // Frame biner telemetri
+  {
+    TelemetryFrame frame;
+    bool compact = payloadLength > 0 && (payload[0] & 0xF0) == TELEMETRY_COMPACT_TAG; // Frame kompak: byte terbawah nomor urut = msgId
+    if (!(compact ? decodeCompactTelemetryFrame(payload, payloadLength, incomingMsgId, frame)
+                  : decodeTelemetryFrame(payload, payloadLength, frame))) // Cek versi, panjang dan CRC
+    {
+      Serial.println("Frame telemetri tidak valid (versi/CRC)");
+      digitalWrite(ledKanan, LOW); // Matikan LED jika error
+      return;                      // Keluar
+    }
 
-  // Dapatkan semua parameter dari JSON
-  humidity = doc["humidity"];
-  temperature = doc["temperature"];
-  pH = doc["ph"];
+    // Frame dengan nomor urut: kiriman ulang yang sudah pernah diterima hanya di-ACK ulang, tidak diteruskan
+    if (frame.version >= TELEMETRY_FRAME_VERSION)
+    {
+      node.hasSeq = true;
+      node.seq = frame.seq;
+      node.frameLength = payloadLength;
+      if (!node.window.accept(frame.seq))
+      {
+        pipelineStats.duplicates++;
+        Serial.printf("[ARQ] Duplikat seq %u dari 0x%02X, ACK ulang\n", frame.seq, sender);
+        ArqAck ack = node.window.ack(ArqAckDuplicate);
+        ServerResponse last = {(bool)(node.lastFlags & ArqAckClassification), (bool)(node.lastFlags & ArqAckBuzzer)};
+        sendLoraMessage(last, sender, incomingMsgId, &ack);
+        digitalWrite(ledKanan, LOW);
+        return;
+      }
+      reading.arq = true;
+      reading.ack = node.window.ack(0);
+#if ADR_ENABLED
+      adrOnFrame(node, frame.flags, packet.snr);
+#endif
+    }
+
+    // Hanya perbarui nilai sensor yang ditandai valid oleh transmitter, sisanya nilai terakhir node ini
+    reading.temperature = telemetryFromFixed(frame.flags & TelemetryTemperatureValid ? frame.temperature : node.temperature);
+    reading.humidity = telemetryFromFixed(frame.flags & TelemetryHumidityValid ? frame.humidity : node.humidity);
+    reading.ph = telemetryFromFixed(frame.flags & TelemetryPhValid ? frame.ph : node.ph);
+
+    reading.heartbeat = frame.flags & TelemetryHeartbeat;
+    reading.probeCount = frame.probeCount;
+    memcpy(reading.probeId, frame.probeId, frame.probeCount * sizeof(uint16_t));
+    memcpy(reading.probeTemperature, frame.probeTemperature, frame.probeCount * sizeof(int16_t));
+  }
+
+  setProbeRange(reading);
+  node.temperature = telemetryToFixed(reading.temperature);
+  node.temperatureMin = telemetryToFixed(reading.temperatureMin);
+  node.temperatureMax = telemetryToFixed(reading.temperatureMax);
+  node.humidity = telemetryToFixed(reading.humidity);
+  node.ph = telemetryToFixed(reading.ph);
+  node.probeCount = reading.probeCount;
+
+  logPrintf("[Received LoRA Packet] <- 0x%02X T=%.2f (%.2f..%.2f, %u probe) H=%.2f pH=%.2f RSSI=%d\n", sender, reading.temperature, reading.temperatureMin,
+            reading.temperatureMax, reading.probeCount, reading.humidity, reading.ph, packet.rssi);
+
+  // Pembacaan diteruskan ke task uplink lewat antrian, task RX langsung siap menerima paket berikutnya
+  reading.rssi = packet.rssi;
+  reading.sender = sender;
+  reading.msgId = incomingMsgId;
+  reading.receivedAtUs = packet.receivedAtUs;
+
+#if LOCAL_KNN_ENABLED
+  // Klasifikasi langsung di Receiver, keputusan buzzer tidak lagi menunggu WiFi/mDNS/server
+  unsigned long knnStartUs = micros();
+  // Model terkuantisasi menerima nilai x100 seperti di frame telemetri; pencarian tetangga seluruhnya integer
+#if KNN_MODEL_FEATURES == 5 // Model dilatih dengan profil suhu (lihat FEATURE_COLUMNS di knn_model_training.py)
+  int16_t featuresX100[KNN_MODEL_FEATURES] = {node.temperatureMin, node.temperature, node.temperatureMax, node.humidity, node.ph};
+#else
+  int16_t featuresX100[KNN_MODEL_FEATURES] = {node.temperature, node.humidity, node.ph};
+#endif
+  reading.classification = knnClassify(knnModel, featuresX100) == 1;
+  reading.classifiedLocally = true;
+  recordLatency(pipelineStats.knn, micros() - knnStartUs);
+#endif
+
+  enqueueReading(reading);
+
+#if LOCAL_KNN_ENABLED
+  ServerResponse knnResponse = {reading.classification, reading.classification}; // Logika buzzer sama dengan server: buzzer ON jika prediksi 'Layak'
+  sendLoraMessage(knnResponse, sender, incomingMsgId, reading.arq ? &reading.ack : NULL); // Respons langsung ke transmitter, server hanya untuk logging
+#else
+  if (reading.arq)
+  {
+    // ACK langsung dari task RX selagi transmitter masih mendengar, seperti batch backlog. Hasil terakhir node
+    // ikut di ACK; hasil server untuk pembacaan ini menyusul setelah POST jika berbeda (sendToServer)
+    ServerResponse last = {(bool)(node.lastFlags & ArqAckClassification), (bool)(node.lastFlags & ArqAckBuzzer)};
+    sendLoraMessage(last, sender, incomingMsgId, &reading.ack);
+  }
+#endif
 
-  // Send directly (Komentar ini menandakan data langsung dikirim ke server)
-  sendToServer(incoming);      // Kirim data yang diterima dari LoRa ke server
   digitalWrite(ledKanan, LOW); // Matikan LED RX setelah selesai memproses
 }
 
+// Profil suhu tumpukan: min/max dari probe yang valid, atau suhu tunggal untuk transmitter satu probe
+void setProbeRange(SensorReading &reading)
+{
+  reading.temperatureMin = reading.temperatureMax = reading.temperature;
+  bool probeFound = false;
+  for (uint8_t i = 0; i < reading.probeCount; i++)
+  {
+    if (reading.probeTemperature[i] == TELEMETRY_PROBE_INVALID)
+      continue;
+    float probe = telemetryFromFixed(reading.probeTemperature[i]);
+    reading.temperatureMin = probeFound ? min(reading.temperatureMin, probe) : probe;
+    reading.temperatureMax = probeFound ? max(reading.temperatureMax, probe) : probe;
+    probeFound = true;
+  }
+}
+
+// Frame batch backlog: pembacaan yang tersimpan di flash transmitter selama link putus. Di-ACK langsung dari
+// task RX (tidak menunggu server, transmitter hanya butuh tahu batch sudah sampai), lalu setiap record masuk
+// antrian uplink dengan umurnya. Nilai sensor terkini, LCD dan buzzer tidak diubah oleh data lama ini.
+void processBacklogBatch(const LoraPacket &packet, NodeState &node, byte msgId, const uint8_t *payload, size_t length)
+{
+  uint8_t count;
+  uint16_t seq;
+  if (!decodeTelemetryBatch(payload, length, count, seq))
+  {
+    Serial.println("Frame batch backlog tidak valid (versi/CRC)");
+    return;
+  }
+
+  byte sender = node.address;
+  node.hasSeq = true;
+  node.seq = seq;
+  bool fresh = node.window.accept(seq);
+  if (!fresh)
+    pipelineStats.duplicates++;
+  ArqAck ack = node.window.ack(fresh ? 0 : ArqAckDuplicate);
+  ServerResponse last = {(bool)(node.lastFlags & ArqAckClassification), (bool)(node.lastFlags & ArqAckBuzzer)};
+  sendLoraMessage(last, sender, msgId, &ack);
+  if (!fresh)
+  {
+    Serial.printf("[Backlog] Duplikat batch seq %u dari 0x%02X, ACK ulang\n", seq, sender);
+    return;
+  }
+
+  size_t offset = TELEMETRY_BATCH_HEADER_SIZE;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    uint32_t ageSeconds;
+    TelemetryFrame frame;
+    offset = decodeTelemetryBatchRecord(payload, length, offset, ageSeconds, frame);
+    if (offset == 0)
+    {
+      Serial.printf("[Backlog] Record %u di batch seq %u rusak\n", i, seq);
+      return;
+    }
+
+    SensorReading reading;
+    reading.temperature = telemetryFromFixed(frame.temperature);
+    reading.humidity = telemetryFromFixed(frame.humidity);
+    reading.ph = telemetryFromFixed(frame.ph);
+    reading.probeCount = frame.probeCount;
+    memcpy(reading.probeId, frame.probeId, frame.probeCount * sizeof(uint16_t));
+    memcpy(reading.probeTemperature, frame.probeTemperature, frame.probeCount * sizeof(int16_t));
+    setProbeRange(reading);
+    reading.rssi = packet.rssi;
+    reading.sender = sender;
+    reading.msgId = msgId;
+    reading.arq = false;
+    reading.heartbeat = frame.flags & TelemetryHeartbeat;
+    reading.held = false;
+    reading.backlog = true;
+    reading.capturedAgeMs = ageSeconds == TELEMETRY_AGE_UNKNOWN ? TELEMETRY_AGE_UNKNOWN : ageSeconds * 1000;
+    reading.classification = false;
+    reading.classifiedLocally = false; // Backlog tidak diklasifikasi lokal, tidak ikut dicocokkan dengan server
+    reading.receivedAtUs = packet.receivedAtUs;
+    enqueueReading(reading);
+    pipelineStats.backlog++;
+  }
+  Serial.printf("[Backlog] Batch seq %u dari 0x%02X: %u pembacaan lama diteruskan\n", seq, sender, count);
+}
+
+void recordLatency(StageLatency &stage, unsigned long us) // Mencatat satu sampel latensi untuk satu tahap pipeline
+{
+  stage.lastUs = us;
+  stage.maxUs = max(stage.maxUs, us);
+  stage.totalUs += us;
+  stage.count++;
+}
+
+void enqueueReading(SensorReading &reading) // Memasukkan pembacaan ke antrian uplink sesuai kebijakan backpressure
+{
+  reading.queuedAtUs = micros();
+  recordLatency(pipelineStats.rx, reading.queuedAtUs - reading.receivedAtUs);
+
+  if (xQueueSend(uplinkQueue, &reading, 0) == pdTRUE) // Antrian masih ada tempat
+  {
+    return;
+  }
+
+  SensorReading discarded;
+#if UPLINK_BACKPRESSURE_POLICY == UPLINK_COALESCE
+  // Pembacaan yang mengantri sudah digantikan yang terbaru, cukup kirim yang terakhir
+  while (xQueueReceive(uplinkQueue, &discarded, 0) == pdTRUE)
+  {
+    pipelineStats.coalesced++;
+  }
+#else
+  // Buang pembacaan tertua untuk memberi tempat pembacaan baru
+  if (xQueueReceive(uplinkQueue, &discarded, 0) == pdTRUE)
+  {
+    pipelineStats.dropped++;
+  }
+#endif
+
+  xQueueSend(uplinkQueue, &reading, 0);
+}
+
+// Mencatat pembacaan asli terakhir sebuah node; node baru menempati slot kosong atau slot yang paling lama diam
+void trackReport(const SensorReading &reading)
+{
+  if (reading.heartbeat)
+    pipelineStats.heartbeats++;
+  else
+    pipelineStats.reports++;
+
+  unsigned long now = millis();
+  NodeSeries *known = nodeSeries.find(reading.sender);
+  unsigned long gapMs = known != NULL && known->active ? now - known->lastSeenMs : 0;
+  bool created;
+  NodeSeries &slot = nodeSeries.acquire(reading.sender, now, created);
+  if (created)
+    slot.periodMs = 0;
+  // Jarak lebih pendek langsung dipakai; lebih panjang (nilai stabil, atau periode node diperbesar) mendekat perlahan
+  if (gapMs > 0)
+    slot.periodMs = slot.periodMs == 0 || gapMs < slot.periodMs ? gapMs : slot.periodMs + (gapMs - slot.periodMs) / 16;
+  slot.last = reading;
+  slot.lastEmitMs = now;
+  slot.active = true;
+}
+
+// Sample-and-hold: node yang tidak mengirim selama periodenya (minimal REPORT_HOLD_PERIOD_MS) dikurangi setengah
+// giliran mendapat salinan nilai terakhirnya, sehingga jarak antar sampel di uplink tetap periode +/- setengah
+// giliran. Node yang periodenya belum diketahui tidak diulang. Mengembalikan jumlah sampel yang ditulis ke out.
+size_t reconstructHeldReadings(SensorReading *out, size_t capacity)
+{
+  size_t count = 0;
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < nodeSeries.count(); i++)
+  {
+    NodeSeries &node = nodeSeries.at(i);
+    if (!node.active)
+      continue;
+
+    if (now - node.lastSeenMs > REPORT_STALE_MS) // Dua heartbeat terlewat: node mati atau di luar jangkauan
+    {
+      node.active = false;
+      pipelineStats.staleNodes++;
+      Serial.printf("[Report] Node 0x%02X tidak mengirim heartbeat selama %lu ms, rekonstruksi dihentikan\n", node.address, now - node.lastSeenMs);
+      continue;
+    }
+
+    unsigned long holdMs = node.periodMs > REPORT_HOLD_PERIOD_MS ? node.periodMs : REPORT_HOLD_PERIOD_MS;
+    if (node.periodMs == 0 || now - node.lastEmitMs < holdMs - REPORT_HOLD_PERIOD_MS / 2 || count >= capacity)
+      continue;
+
+    SensorReading &held = out[count++];
+    held = node.last;
+    held.held = true;
+    held.heartbeat = false;
+    held.classifiedLocally = false; // Salinan: hasil KNN-nya sudah dicocokkan saat pembacaan asli
+    held.receivedAtUs = micros(); // Timestamp sampel rekonstruksi = saat dibuat
+    held.queuedAtUs = held.receivedAtUs;
+    node.lastEmitMs = now;
+    pipelineStats.held++;
+  }
+  return count;
+}
+
+// Memulihkan spool dari partisi; spool nonaktif (batch gagal dibuang seperti sebelumnya) jika partisi tidak ada
+bool spoolBegin()
+{
+#if SPOOL_ENABLED
+  spoolStorage.partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, NULL);
+  if (spoolStorage.partition == NULL || spoolStorage.partition->size < SPOOL_SECTORS * FLASH_LOG_SECTOR_SIZE ||
+      !uplinkSpool.begin(&spoolStorage, SPOOL_SECTORS))
+  {
+    Serial.println("[Spool] Partisi spiffs tidak tersedia, spool uplink nonaktif");
+    return false;
+  }
+  Serial.printf("[Spool] %lu pembacaan menunggu replay (kapasitas %lu), slot rusak dilewati %lu\n", (unsigned long)uplinkSpool.count(),
+                (unsigned long)uplinkSpool.capacity(), (unsigned long)uplinkSpool.stats().corrupt);
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Menyimpan batch yang tidak sampai ke server. Record: byte 0 pengirim, byte 1 SpoolFlag, lalu frame telemetri
+// versi 3; waktu pengambilan disimpan sebagai millis() (hanya berlaku selama boot yang sama, lihat FlashLog::boot())
+void spoolReadings(const SensorReading *readings, size_t count)
+{
+  if (!uplinkSpool.isReady())
+    return;
+  unsigned long nowUs = micros();
+  for (size_t i = 0; i < count; i++)
+  {
+    const SensorReading &reading = readings[i];
+    uint8_t flags = (reading.held ? SpoolHeld : 0) | (reading.backlog ? SpoolBacklog : 0) | (reading.classification ? SpoolClassification : 0) |
+                    (reading.classifiedLocally ? SpoolClassifiedLocally : 0);
+    uint32_t ageMs = (nowUs - reading.receivedAtUs) / 1000;
+    if (reading.capturedAgeMs == TELEMETRY_AGE_UNKNOWN)
+      flags |= SpoolAgeUnknown;
+    else
+      ageMs += reading.capturedAgeMs;
+
+    TelemetryFrame frame = makeTelemetryFrame(reading.temperature, reading.humidity, reading.ph,
+                                              TelemetryTemperatureValid | TelemetryHumidityValid | TelemetryPhValid |
+                                                  (reading.heartbeat ? TelemetryHeartbeat : 0));
+    frame.probeCount = reading.probeCount;
+    memcpy(frame.probeId, reading.probeId, reading.probeCount * sizeof(uint16_t));
+    memcpy(frame.probeTemperature, reading.probeTemperature, reading.probeCount * sizeof(int16_t));
+
+    uint8_t record[2 + TELEMETRY_FRAME_MAX_SIZE];
+    record[0] = reading.sender;
+    record[1] = flags;
+    size_t length = 2 + encodeTelemetryFrame(frame, &record[2], sizeof(record) - 2);
+    if (uplinkSpool.append(record, length, millis() - ageMs))
+      spoolStats.spooled++;
+    else
+      spoolStats.writeErrors++;
+  }
+}
+
+// Kebalikan spoolReadings(): SensorReading dari record spool, umurnya dihitung terhadap saat ini
+bool readingFromSpool(const FlashLogRecord &record, SensorReading &reading)
+{
+  TelemetryFrame frame;
+  if (record.length < 2 || !decodeTelemetryFrame(&record.data[2], record.length - 2, frame))
+    return false;
+
+  reading.temperature = telemetryFromFixed(frame.temperature);
+  reading.humidity = telemetryFromFixed(frame.humidity);
+  reading.ph = telemetryFromFixed(frame.ph);
+  reading.probeCount = frame.probeCount;
+  memcpy(reading.probeId, frame.probeId, frame.probeCount * sizeof(uint16_t));
+  memcpy(reading.probeTemperature, frame.probeTemperature, frame.probeCount * sizeof(int16_t));
+  setProbeRange(reading);
+  reading.rssi = 0;
+  reading.sender = record.data[0];
+  reading.msgId = 0;
+  reading.arq = false;
+  reading.heartbeat = frame.flags & TelemetryHeartbeat;
+  reading.held = record.data[1] & SpoolHeld;
+  reading.backlog = record.data[1] & SpoolBacklog;
+  reading.classification = record.data[1] & SpoolClassification;
+  reading.classifiedLocally = record.data[1] & SpoolClassifiedLocally;
+  bool ageKnown = !(record.data[1] & SpoolAgeUnknown) && record.boot == uplinkSpool.boot();
+  reading.capturedAgeMs = ageKnown ? millis() - record.capturedMs : TELEMETRY_AGE_UNKNOWN;
+  reading.receivedAtUs = micros();
+  reading.queuedAtUs = reading.receivedAtUs;
+  return true;
+}
+
+// Satu POST replay berisi pembacaan spool tertua; record di-consume hanya setelah server menjawab
+bool replaySpool()
+{
+  static FlashLogRecord records[SPOOL_REPLAY_BATCH]; // Statis: hanya uplinkTask, tidak membebani stack task
+  static SensorReading readings[SPOOL_REPLAY_BATCH];
+  uint8_t peeked = uplinkSpool.peek(FlashLogOldestFirst, records, SPOOL_REPLAY_BATCH);
+  size_t count = 0;
+  for (uint8_t i = 0; i < peeked; i++)
+  {
+    if (readingFromSpool(records[i], readings[count]))
+      count++;
+    else
+      uplinkSpool.consume(records[i]); // Record yang tidak bisa di-decode tidak akan pernah terkirim
+  }
+  if (count == 0)
+    return true;
+
+  unsigned long startUs = micros();
+  if (!sendToServer(readings, count, true))
+    return false;
+  unsigned long elapsedUs = micros() - startUs;
+
+  for (uint8_t i = 0; i < peeked; i++)
+    uplinkSpool.consume(records[i]);
+  spoolStats.replayed += count;
+  spoolStats.replayBatches++;
+  spoolStats.replayUs += elapsedUs;
+  Serial.printf("[Spool] replay %u pembacaan dalam %lu ms, sisa %lu, throughput %.1f pembacaan/s\n", (unsigned)count, elapsedUs / 1000,
+                (unsigned long)uplinkSpool.count(), spoolReplayThroughput());
+  return true;
+}
+
+// Pembacaan per detik POST replay (rata-rata sejak boot)
+float spoolReplayThroughput()
+{
+  return spoolStats.replayUs > 0 ? spoolStats.replayed * 1e6f / spoolStats.replayUs : 0.0f;
+}
+
+void uplinkTask(void *pvParameter) // Task untuk mengirim pembacaan dari antrian ke server secara batch
+{
+  SensorReading batch[UPLINK_BATCH_SIZE];
+  size_t batchCount = 0;
+  unsigned long batchStartMs = 0;
+  unsigned long holdDueMs = millis() + REPORT_HOLD_PERIOD_MS;
+
+  spoolBegin();
+
+  while (1)
+  {
+    // Tanpa batch terbuka, tunggu sampai giliran rekonstruksi; dengan batch terbuka, paling lama sampai umur batch habis
+    long untilHold = (long)(holdDueMs - millis());
+    TickType_t wait = untilHold > 0 ? pdMS_TO_TICKS(untilHold) : 0;
+    if (batchCount > 0)
+    {
+      unsigned long age = millis() - batchStartMs;
+      TickType_t batchWait = age >= UPLINK_BATCH_MAX_AGE_MS ? 0 : pdMS_TO_TICKS(UPLINK_BATCH_MAX_AGE_MS - age);
+      wait = min(wait, batchWait);
+    }
+    // Tanpa batch terbuka dan spool berisi: replay langsung selama uplink hidup, atau pada percobaan berikutnya saat putus
+    else if (uplinkSpool.count() > 0)
+    {
+      unsigned long sinceAttempt = millis() - lastUplinkAttemptMs;
+      bool retryDue = uplinkUp || sinceAttempt >= SPOOL_RETRY_MS;
+      wait = min(wait, retryDue ? (TickType_t)0 : pdMS_TO_TICKS(SPOOL_RETRY_MS - sinceAttempt));
+    }
+
+    if (xQueueReceive(uplinkQueue, &batch[batchCount], wait) == pdTRUE) // Pembacaan berikutnya masuk batch
+    {
+      recordLatency(pipelineStats.queue, micros() - batch[batchCount].queuedAtUs);
+      if (!batch[batchCount].backlog) // Data lama tidak menjadi nilai terakhir node untuk rekonstruksi
+        trackReport(batch[batchCount]);
+      if (batchCount++ == 0)
+        batchStartMs = millis();
+    }
+
+    // Giliran rekonstruksi: sampel sample-and-hold untuk node yang sedang menahan kiriman. Batch penuh sebelum
+    // semua node kebagian (banyak node di jaringan): giliran tetap jatuh tempo dan dilanjutkan setelah flush
+    if ((long)(millis() - holdDueMs) >= 0)
+    {
+      size_t room = UPLINK_BATCH_SIZE - batchCount;
+      size_t held = reconstructHeldReadings(&batch[batchCount], room);
+      if (held < room)
+        holdDueMs = millis() + REPORT_HOLD_PERIOD_MS;
+      if (held > 0 && batchCount == 0)
+        batchStartMs = millis();
+      batchCount += held;
+    }
+
+    if (batchCount == 0)
+    {
+      // Tidak ada batch baru: giliran replay spool
+      if (uplinkSpool.count() > 0 && (uplinkUp || millis() - lastUplinkAttemptMs >= SPOOL_RETRY_MS))
+      {
+        lastUplinkAttemptMs = millis();
+        uplinkUp = replaySpool();
+      }
+      continue;
+    }
+    if (batchCount < UPLINK_BATCH_SIZE && millis() - batchStartMs < UPLINK_BATCH_MAX_AGE_MS)
+      continue; // Batch belum penuh dan belum kedaluwarsa
+
+    // Flush batch: penuh atau pembacaan pertamanya sudah menunggu UPLINK_BATCH_MAX_AGE_MS
+    unsigned long flushStartUs = micros();
+    for (size_t i = 0; i < batchCount; i++)
+      recordLatency(pipelineStats.batch, flushStartUs - batch[i].queuedAtUs);
+
+    // Simpan pesan masuk terakhir langsung ke buffer tetap (tanpa salinan String per flush)
+    snprintf(loraParameter.incomingMessage, sizeof(loraParameter.incomingMessage), "{\"temperature\":%.2f,\"humidity\":%.2f,\"ph\":%.2f}",
+             batch[batchCount - 1].temperature, batch[batchCount - 1].humidity, batch[batchCount - 1].ph);
+
+    // Kirim ke server, lalu respons diteruskan ke transmitter via LoRa. Uplink putus: batch langsung ke spool
+    // tanpa menunggu timeout koneksi, sampai giliran percobaan berikutnya
+    bool answered = false;
+    if (!uplinkSpool.isReady() || uplinkUp || millis() - lastUplinkAttemptMs >= SPOOL_RETRY_MS)
+    {
+      lastUplinkAttemptMs = millis();
+      answered = sendToServer(batch, batchCount, false);
+      uplinkUp = answered;
+    }
+    else
+    {
+      spoolStats.skippedPosts++;
+    }
+    if (!answered)
+      spoolReadings(batch, batchCount); // Frame ARQ sudah di-ACK task RX, transmitter tidak mengirim ulang
+
+    pipelineStats.batches++;
+    recordLatency(pipelineStats.uplink, micros() - flushStartUs);
+    logPrintf("[Pipeline] rx %lu us, knn %lu us (beda %lu), antri %lu us, batch %u/%d %lu ms, uplink %lu ms, antrian %u/%d, drop %lu, coalesce %lu, koneksi %lu, dns %lu, "
+              "frame %lu + heartbeat %lu, hold %lu, stale %lu, duplikat %lu, backlog %lu, spool %lu (masuk %lu, replay %lu, %.1f/s, ditimpa %lu), "
+              "json puncak %u/%u B (penuh %lu)\n",
+              pipelineStats.rx.lastUs, pipelineStats.knn.lastUs, pipelineStats.knnMismatches, pipelineStats.queue.lastUs, (unsigned)batchCount, UPLINK_BATCH_SIZE,
+              pipelineStats.batch.lastUs / 1000, pipelineStats.uplink.lastUs / 1000,
+              (unsigned)uxQueueMessagesWaiting(uplinkQueue), UPLINK_QUEUE_DEPTH, pipelineStats.dropped, pipelineStats.coalesced,
+              uplinkSession.connects, uplinkSession.resolves, pipelineStats.reports, pipelineStats.heartbeats, pipelineStats.held,
+              pipelineStats.staleNodes, pipelineStats.duplicates, pipelineStats.backlog, (unsigned long)uplinkSpool.count(),
+              spoolStats.spooled, spoolStats.replayed, spoolReplayThroughput(), (unsigned long)uplinkSpool.stats().overwritten,
+              (unsigned)uplinkJsonArena.highWater(), (unsigned)uplinkJsonArena.capacity(), (unsigned long)uplinkJsonArena.failures());
+    batchCount = 0;
+  }
+}
+
 // Fungsi sendLoraMessage overload untuk mengirim String (tidak dipakai dalam alur utama saat ini, tapi ada untuk kemungkinan lain)
 void sendLoraMessage(String message)
 {
@@ -990,21 +2324,37 @@ void centerText(const char *text, int row)
   Lcd.print(text);              // Cetak teks
 }
 
+// Serial.printf untuk log yang tercetak di setiap paket atau batch: Print::printf ESP32 memformat ke buffer
+// stack 64 byte dan memakai malloc untuk keluaran yang lebih panjang, di sini buffer stack LOG_LINE_MAX_SIZE
+void logPrintf(const char *format, ...)
+{
+  char line[LOG_LINE_MAX_SIZE];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  if (length <= 0)
+    return;
+  if (length >= (int)sizeof(line))
+  {
+    length = sizeof(line) - 1;
+    line[length - 1] = '\n'; // Baris terpotong tetap diakhiri newline
+  }
+  Serial.write((const uint8_t *)line, length);
+}
+
 unsigned long lastSendTime = 0; // Variabel untuk melacak waktu pengiriman terakhir (tidak terpakai)
 unsigned long interval;         // Variabel untuk interval (tidak terpakai)
 
 void loop() // Fungsi loop utama, akan dipanggil berulang kali
 {
-  if (!paused) // Jika sistem tidak dijeda
-  {
-    onLoraReceiveCallback(LoRa.parsePacket()); // Cek dan proses paket LoRa yang masuk
-  }
   if (paused) // Jika sistem dijeda
   {
     // Menyalakan kedua LED sebagai indikasi pause
     digitalWrite(ledKiri, HIGH);
     digitalWrite(ledKanan, HIGH);
   }
-  // Tidak ada delay di loop utama karena sebagian besar pekerjaan dilakukan oleh task RTOS
-  // dan onLoraReceiveCallback bersifat non-blocking jika tidak ada paket.
+
+  // Paket LoRa diterima lewat interrupt dan diproses loraRxTask, jadi loop cukup tidur agar CPU idle
+  vTaskDelay(pdMS_TO_TICKS(100));
 }
\ No newline at end of file
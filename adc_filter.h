@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Filter burst sampel ADC (oversampling + desimasi): satu burst N sampel mentah menjadi satu nilai.
+// Tidak bergantung pada Arduino/ESP-IDF sehingga bisa diuji di host dengan trace rekaman
+// (lihat host/bench/adc_filter_bench.cpp).
+//
+//   AdcFilterMean         rata-rata, noise turun ~1/sqrt(N) tapi sensitif terhadap spike
+//   AdcFilterMedian       median, kebal spike tapi resolusinya tetap 1 LSB
+//   AdcFilterTrimmedMean  rata-rata 50 % sampel tengah (interquartile mean): spike dibuang,
+//                         sisanya dirata-rata sehingga resolusi di bawah 1 LSB
+
+enum AdcFilterMode : uint8_t
+{
+  AdcFilterMean,
+  AdcFilterMedian,
+  AdcFilterTrimmedMean,
+};
+
+template <uint16_t Capacity>
+struct AdcBurst
+{
+  uint16_t samples[Capacity];
+  uint16_t count;
+
+  void reset() { count = 0; }
+  bool full() const { return count >= Capacity; }
+
+  // Mengembalikan false jika burst sudah penuh (sampel diabaikan)
+  bool push(uint16_t raw)
+  {
+    if (count >= Capacity)
+      return false;
+    samples[count++] = raw;
+    return true;
+  }
+
+  // Nilai hasil filter dalam satuan LSB ADC (dengan pecahan). Untuk median/trimmed mean,
+  // sampel diurutkan di tempat (insertion sort, cukup cepat untuk burst puluhan sampel).
+  float filtered(AdcFilterMode mode)
+  {
+    if (count == 0)
+      return 0.0f;
+
+    if (mode == AdcFilterMean)
+      return (float)sum(0, count) / count;
+
+    sort();
+    if (mode == AdcFilterMedian)
+      return (count & 1) ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) * 0.5f;
+
+    uint16_t trim = count / 4;
+    return (float)sum(trim, count - trim) / (count - 2 * trim);
+  }
+
+private:
+  uint32_t sum(uint16_t from, uint16_t to) const
+  {
+    uint32_t total = 0;
+    for (uint16_t i = from; i < to; i++)
+      total += samples[i];
+    return total;
+  }
+
+  void sort()
+  {
+    for (uint16_t i = 1; i < count; i++)
+    {
+      uint16_t value = samples[i];
+      uint16_t j = i;
+      while (j > 0 && samples[j - 1] > value)
+      {
+        samples[j] = samples[j - 1];
+        j--;
+      }
+      samples[j] = value;
+    }
+  }
+};
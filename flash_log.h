@@ -0,0 +1,418 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "telemetry_frame.h"
+
+// Log cincin di flash NOR (partisi mentah) untuk store-and-forward transmitter: pembacaan yang tidak
+// mendapat ACK disimpan di sini dan dikirim ulang dalam frame batch setelah link LoRa pulih.
+// Tidak bergantung pada Arduino; akses flash lewat Storage dengan tiga fungsi:
+//   bool read(uint32_t offset, void *data, size_t size);
+//   bool write(uint32_t offset, const void *data, size_t size); // Hanya mengubah bit 1 -> 0 (NOR)
+//   bool eraseSector(uint32_t offset);                          // Satu sektor FLASH_LOG_SECTOR_SIZE -> 0xFF
+// sehingga bisa diuji di host dengan flash tersimulasi (host/bench/flash_log_bench.cpp).
+//
+// Tata letak: setiap sektor dibagi slot FLASH_LOG_SLOT_SIZE byte, slot 0 berisi header sektor
+// (magic, nomor urut sektor yang naik setiap sektor dipakai ulang, CRC). Record berukuran tetap satu slot:
+//  byte 0      : FLASH_LOG_RECORD_MAGIC, ditulis paling akhir (record dengan magic = penulisan selesai)
+//  byte 1      : 0xFF = belum terkirim, 0x00 = sudah di-ACK (ditulis ulang di tempat, tanpa erase)
+//  byte 2..5   : nomor urut record uint32
+//  byte 6..7   : nomor boot uint16 (jam rtcMillis() hanya berlaku dalam boot yang sama)
+//  byte 8..11  : waktu pembacaan, rtcMillis() uint32
+//  byte 12     : panjang data
+//  byte 13..   : data (frame telemetri versi 3)
+//  2 byte akhir: CRC-16/CCITT-FALSE slot dengan byte 1 dianggap 0xFF
+//
+// Append O(1): head hanya maju satu slot; sektor berikutnya di-erase saat sektor head penuh, sehingga
+// setiap sektor di-erase tepat sekali per putaran cincin (wear leveling merata tanpa tabel pemetaan).
+// Jika sektor berikutnya masih berisi record yang belum terkirim, record itu ditimpa (data tertua hilang).
+// Pemulihan saat boot membaca header sektor dan seluruh slot sekali: head = sektor dengan nomor urut
+// terbesar, record yang tulisannya terpotong (CRC salah) dilewati dan tidak pernah ditimpa sebelum sektornya
+// di-erase. ACK yang terpotong hanya membuat record terkirim ulang (at-least-once, Receiver membuang duplikat).
+
+#define FLASH_LOG_SECTOR_SIZE 4096
+#define FLASH_LOG_SLOT_SIZE 64
+#define FLASH_LOG_SLOTS_PER_SECTOR (FLASH_LOG_SECTOR_SIZE / FLASH_LOG_SLOT_SIZE)
+#define FLASH_LOG_MAX_SECTORS 64
+#define FLASH_LOG_RECORD_HEADER_SIZE 13
+#define FLASH_LOG_DATA_MAX (FLASH_LOG_SLOT_SIZE - FLASH_LOG_RECORD_HEADER_SIZE - 2)
+#define FLASH_LOG_SECTOR_MAGIC 0x474F4C46UL // "FLOG"
+#define FLASH_LOG_RECORD_MAGIC 0x5A
+
+enum FlashLogOrder : uint8_t
+{
+  FlashLogOldestFirst, // Urutan kronologis, deret di server terisi dari awal gangguan
+  FlashLogNewestFirst  // Kondisi terbaru lebih dulu sampai, sisa backlog menyusul
+};
+
+struct FlashLogRecord
+{
+  uint16_t position; // sektor x FLASH_LOG_SLOTS_PER_SECTOR + slot, untuk consume()
+  uint32_t seq;
+  uint16_t boot;
+  uint32_t capturedMs;
+  uint8_t length;
+  uint8_t data[FLASH_LOG_DATA_MAX];
+};
+
+struct FlashLogStats
+{
+  uint32_t appended;
+  uint32_t consumed;
+  uint32_t overwritten; // Record yang belum terkirim ditimpa karena log penuh
+  uint32_t erases;
+  uint32_t corrupt;     // Slot rusak (penulisan terpotong) yang ditemukan saat pemulihan
+  uint32_t writeErrors;
+};
+
+template <typename Storage>
+class FlashLog
+{
+public:
+  // Memulihkan head/tail dari isi flash, atau memformat sektor pertama jika belum ada log.
+  // sectorCount minimal 2: sektor berikutnya di-erase begitu sektor head penuh.
+  bool begin(Storage *flash, uint8_t sectorCount)
+  {
+    storage = flash;
+    sectors = sectorCount > FLASH_LOG_MAX_SECTORS ? FLASH_LOG_MAX_SECTORS : sectorCount;
+    logStats = FlashLogStats();
+    live = 0;
+    ready = false;
+    if (sectors < 2)
+      return false;
+
+    int head = -1;
+    for (uint8_t s = 0; s < sectors; s++)
+    {
+      sectorSeq[s] = readSectorHeader(s);
+      sectorLive[s] = 0;
+      if (sectorSeq[s] != 0 && (head < 0 || sectorSeq[s] > sectorSeq[head]))
+        head = s;
+    }
+    if (head < 0)
+    {
+      nextSeq = 0;
+      bootId = 0;
+      if (!startSector(0, 1))
+        return false;
+      headSector = 0;
+      headSlot = 1;
+      tail = position(0, 1);
+      ready = true;
+      return true;
+    }
+
+    // Hitung record yang belum terkirim dan cari slot terakhir yang terpakai di sektor head
+    bool anyRecord = false;
+    uint32_t maxSeq = 0;
+    uint16_t maxBoot = 0;
+    uint8_t lastUsed = 0;
+    for (uint8_t s = 0; s < sectors; s++)
+    {
+      if (sectorSeq[s] == 0)
+        continue;
+      for (uint8_t slot = 1; slot < FLASH_LOG_SLOTS_PER_SECTOR; slot++)
+      {
+        uint8_t buffer[FLASH_LOG_SLOT_SIZE];
+        if (!storage->read(slotOffset(position(s, slot)), buffer, sizeof(buffer)) || erased(buffer))
+          continue;
+        if (s == head)
+          lastUsed = slot;
+        FlashLogRecord record;
+        if (!parseRecord(buffer, record))
+        {
+          logStats.corrupt++;
+          continue;
+        }
+        if (!anyRecord || (int32_t)(record.seq - maxSeq) > 0)
+          maxSeq = record.seq;
+        if (!anyRecord || (int16_t)(record.boot - maxBoot) > 0)
+          maxBoot = record.boot;
+        anyRecord = true;
+        if (buffer[1] == 0xFF)
+        {
+          sectorLive[s]++;
+          live++;
+        }
+      }
+    }
+    nextSeq = anyRecord ? maxSeq + 1 : 0;
+    bootId = anyRecord ? maxBoot + 1 : 0;
+    headSector = head;
+    headSlot = lastUsed + 1;
+    tail = position((head + 1) % sectors, 1); // Sektor tertua dalam urutan cincin
+    ready = true;
+    if (headSlot >= FLASH_LOG_SLOTS_PER_SECTOR && !advanceHead())
+    {
+      ready = false;
+      return false;
+    }
+    advanceTail();
+    return true;
+  }
+
+  // Menambah satu record di head; false jika data terlalu panjang atau flash gagal ditulis
+  bool append(const uint8_t *data, uint8_t length, uint32_t capturedMs)
+  {
+    if (!ready || length > FLASH_LOG_DATA_MAX)
+      return false;
+
+    uint8_t buffer[FLASH_LOG_SLOT_SIZE];
+    memset(buffer, 0xFF, sizeof(buffer));
+    buffer[0] = FLASH_LOG_RECORD_MAGIC;
+    writeUint32(&buffer[2], nextSeq);
+    buffer[6] = bootId & 0xFF;
+    buffer[7] = bootId >> 8;
+    writeUint32(&buffer[8], capturedMs);
+    buffer[12] = length;
+    memcpy(&buffer[FLASH_LOG_RECORD_HEADER_SIZE], data, length);
+    uint16_t crc = telemetryCrc16(buffer, FLASH_LOG_SLOT_SIZE - 2);
+    buffer[FLASH_LOG_SLOT_SIZE - 2] = crc & 0xFF;
+    buffer[FLASH_LOG_SLOT_SIZE - 1] = crc >> 8;
+
+    // Isi record dulu, magic terakhir: record tanpa magic tidak pernah dianggap valid
+    uint16_t at = position(headSector, headSlot);
+    uint32_t offset = slotOffset(at);
+    if (!storage->write(offset + 2, &buffer[2], FLASH_LOG_SLOT_SIZE - 2) || !storage->write(offset, buffer, 1))
+    {
+      logStats.writeErrors++;
+      headSlot++; // Slot yang gagal ditulis dilewati
+      if (headSlot >= FLASH_LOG_SLOTS_PER_SECTOR)
+        advanceHead();
+      return false;
+    }
+
+    if (live == 0)
+      tail = at;
+    live++;
+    sectorLive[headSector]++;
+    nextSeq++;
+    logStats.appended++;
+    headSlot++;
+    if (headSlot >= FLASH_LOG_SLOTS_PER_SECTOR)
+      advanceHead();
+    return true;
+  }
+
+  // Menyalin sampai max record yang belum terkirim, dari tail (tertua) atau dari head (terbaru)
+  uint8_t peek(FlashLogOrder order, FlashLogRecord *records, uint8_t max)
+  {
+    uint8_t count = 0;
+    if (!ready || live == 0)
+      return 0;
+
+    uint16_t head = position(headSector, headSlot);
+    if (order == FlashLogOldestFirst)
+    {
+      for (uint16_t p = tail; p != head && count < max; p = nextPosition(p))
+      {
+        if (readLive(p, records[count]))
+          count++;
+      }
+      return count;
+    }
+
+    uint16_t p = head;
+    while (count < max && p != tail)
+    {
+      p = previousPosition(p);
+      if (readLive(p, records[count]))
+        count++;
+    }
+    return count;
+  }
+
+  // Menandai record sudah di-ACK; false jika record sudah ditimpa atau sudah ditandai sebelumnya
+  bool consume(const FlashLogRecord &record)
+  {
+    if (!ready)
+      return false;
+    FlashLogRecord current;
+    if (!readLive(record.position, current) || current.seq != record.seq)
+      return false;
+
+    uint8_t consumed = 0x00;
+    if (!storage->write(slotOffset(record.position) + 1, &consumed, 1))
+    {
+      logStats.writeErrors++;
+      return false;
+    }
+    sectorLive[record.position / FLASH_LOG_SLOTS_PER_SECTOR]--;
+    live--;
+    logStats.consumed++;
+    if (record.position == tail)
+      advanceTail();
+    return true;
+  }
+
+  bool isReady() const { return ready; }
+  uint32_t count() const { return live; }
+  // Record yang pasti tertampung; di atas ini record tertua ditimpa saat sektor head berikutnya penuh
+  uint32_t capacity() const { return (uint32_t)(sectors - 1) * (FLASH_LOG_SLOTS_PER_SECTOR - 1); }
+  uint16_t boot() const { return bootId; }
+  const FlashLogStats &stats() const { return logStats; }
+
+private:
+  static uint16_t position(uint8_t sector, uint8_t slot) { return (uint16_t)sector * FLASH_LOG_SLOTS_PER_SECTOR + slot; }
+  static uint32_t slotOffset(uint16_t at) { return (uint32_t)at * FLASH_LOG_SLOT_SIZE; }
+
+  static void writeUint32(uint8_t *buffer, uint32_t value)
+  {
+    for (uint8_t i = 0; i < 4; i++)
+      buffer[i] = (value >> (8 * i)) & 0xFF;
+  }
+
+  static uint32_t readUint32(const uint8_t *buffer)
+  {
+    return buffer[0] | (uint32_t)buffer[1] << 8 | (uint32_t)buffer[2] << 16 | (uint32_t)buffer[3] << 24;
+  }
+
+  static bool erased(const uint8_t *buffer)
+  {
+    for (size_t i = 0; i < FLASH_LOG_SLOT_SIZE; i++)
+      if (buffer[i] != 0xFF)
+        return false;
+    return true;
+  }
+
+  static bool parseRecord(const uint8_t *buffer, FlashLogRecord &record)
+  {
+    if (buffer[0] != FLASH_LOG_RECORD_MAGIC || buffer[12] > FLASH_LOG_DATA_MAX)
+      return false;
+    uint8_t copy[FLASH_LOG_SLOT_SIZE];
+    memcpy(copy, buffer, sizeof(copy));
+    copy[1] = 0xFF;
+    uint16_t crc = buffer[FLASH_LOG_SLOT_SIZE - 2] | (uint16_t)buffer[FLASH_LOG_SLOT_SIZE - 1] << 8;
+    if (crc != telemetryCrc16(copy, FLASH_LOG_SLOT_SIZE - 2))
+      return false;
+
+    record.seq = readUint32(&buffer[2]);
+    record.boot = buffer[6] | (uint16_t)buffer[7] << 8;
+    record.capturedMs = readUint32(&buffer[8]);
+    record.length = buffer[12];
+    memcpy(record.data, &buffer[FLASH_LOG_RECORD_HEADER_SIZE], record.length);
+    return true;
+  }
+
+  bool readLive(uint16_t at, FlashLogRecord &record)
+  {
+    uint8_t buffer[FLASH_LOG_SLOT_SIZE];
+    if (!storage->read(slotOffset(at), buffer, sizeof(buffer)) || buffer[1] != 0xFF || !parseRecord(buffer, record))
+      return false;
+    record.position = at;
+    return true;
+  }
+
+  // Nomor urut sektor dari header, 0 jika sektor belum pernah dipakai atau header rusak
+  uint32_t readSectorHeader(uint8_t sector)
+  {
+    uint8_t header[10];
+    if (!storage->read((uint32_t)sector * FLASH_LOG_SECTOR_SIZE, header, sizeof(header)))
+      return 0;
+    uint16_t crc = header[8] | (uint16_t)header[9] << 8;
+    if (readUint32(header) != FLASH_LOG_SECTOR_MAGIC || crc != telemetryCrc16(header, 8))
+      return 0;
+    return readUint32(&header[4]);
+  }
+
+  bool startSector(uint8_t sector, uint32_t seq)
+  {
+    uint32_t offset = (uint32_t)sector * FLASH_LOG_SECTOR_SIZE;
+    logStats.erases++;
+    uint8_t header[10];
+    writeUint32(header, FLASH_LOG_SECTOR_MAGIC);
+    writeUint32(&header[4], seq);
+    uint16_t crc = telemetryCrc16(header, 8);
+    header[8] = crc & 0xFF;
+    header[9] = crc >> 8;
+    if (!storage->eraseSector(offset) || !storage->write(offset, header, sizeof(header)))
+    {
+      logStats.writeErrors++;
+      return false;
+    }
+    sectorSeq[sector] = seq;
+    sectorLive[sector] = 0;
+    return true;
+  }
+
+  // Sektor head penuh: sektor berikutnya di-erase (record yang belum terkirim di sana ditimpa)
+  bool advanceHead()
+  {
+    uint8_t next = (headSector + 1) % sectors;
+    bool tailLost = live > 0 && tail / FLASH_LOG_SLOTS_PER_SECTOR == next;
+    logStats.overwritten += sectorLive[next];
+    live -= sectorLive[next];
+    sectorLive[next] = 0;
+    if (!startSector(next, sectorSeq[headSector] + 1))
+    {
+      ready = false;
+      return false;
+    }
+    headSector = next;
+    headSlot = 1;
+    if (tailLost || live == 0)
+    {
+      tail = position((next + 1) % sectors, 1);
+      advanceTail();
+    }
+    return true;
+  }
+
+  // Slot berikutnya dalam urutan cincin; sektor tanpa record yang belum terkirim dilompati utuh
+  uint16_t nextPosition(uint16_t at) const
+  {
+    uint8_t sector = at / FLASH_LOG_SLOTS_PER_SECTOR;
+    uint8_t slot = at % FLASH_LOG_SLOTS_PER_SECTOR + 1;
+    uint16_t head = position(headSector, headSlot);
+    while (1)
+    {
+      if (slot >= FLASH_LOG_SLOTS_PER_SECTOR)
+      {
+        sector = (sector + 1) % sectors;
+        slot = 1;
+      }
+      if (sector == headSector || sectorLive[sector] > 0)
+        return sector == headSector && slot >= headSlot ? head : position(sector, slot);
+      slot = FLASH_LOG_SLOTS_PER_SECTOR;
+    }
+  }
+
+  uint16_t previousPosition(uint16_t at) const
+  {
+    uint8_t sector = at / FLASH_LOG_SLOTS_PER_SECTOR;
+    uint8_t slot = at % FLASH_LOG_SLOTS_PER_SECTOR;
+    while (slot <= 1)
+    {
+      sector = (sector + sectors - 1) % sectors;
+      slot = FLASH_LOG_SLOTS_PER_SECTOR;
+      if (sectorLive[sector] == 0 && sector != tail / FLASH_LOG_SLOTS_PER_SECTOR)
+        slot = 1; // Tidak ada record yang belum terkirim, lompati sektor
+    }
+    return position(sector, slot - 1);
+  }
+
+  // Tail maju melewati record yang sudah di-ACK (diamortisasi O(1): setiap slot dilewati sekali per putaran)
+  void advanceTail()
+  {
+    uint16_t head = position(headSector, headSlot);
+    FlashLogRecord record;
+    while (live > 0 && tail != head && !readLive(tail, record))
+      tail = nextPosition(tail);
+    if (live == 0)
+      tail = head;
+  }
+
+  Storage *storage;
+  uint8_t sectors;
+  uint8_t headSector;
+  uint8_t headSlot;
+  uint16_t tail;
+  uint32_t live;
+  uint32_t nextSeq;
+  uint16_t bootId;
+  bool ready;
+  uint32_t sectorSeq[FLASH_LOG_MAX_SECTORS];
+  uint16_t sectorLive[FLASH_LOG_MAX_SECTORS];
+  FlashLogStats logStats;
+};
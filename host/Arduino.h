@@ -0,0 +1,305 @@
+#pragma once
+
+// Backend POSIX untuk API Arduino-ESP32 + FreeRTOS yang dipakai transmitter.cpp dan Receiver.cpp.
+// Di board, header aslinya dipakai (backend ESP32); di Linux, folder host/ dimasukkan ke include path
+// sehingga firmware yang sama bisa dijalankan sebagai binary native untuk profiling dan soak test.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+#define ARDUINOJSON_ENABLE_ARDUINO_STRING 1
+#define ARDUINOJSON_ENABLE_ARDUINO_PRINT 1
+#define ARDUINOJSON_ENABLE_ARDUINO_STREAM 1
+#define ARDUINOJSON_ENABLE_PROGMEM 0
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::max;
+using std::min;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define F(string_literal) (string_literal)
+
+#define B00000 0
+#define B00001 1
+#define B00010 2
+#define B00011 3
+#define B00100 4
+#define B00101 5
+#define B00110 6
+#define B00111 7
+#define B01000 8
+#define B01001 9
+#define B01010 10
+#define B01011 11
+#define B01100 12
+#define B01101 13
+#define B01110 14
+#define B01111 15
+#define B10000 16
+#define B10001 17
+#define B10010 18
+#define B10011 19
+#define B10100 20
+#define B10101 21
+#define B10110 22
+#define B10111 23
+#define B11000 24
+#define B11001 25
+#define B11010 26
+#define B11011 27
+#define B11100 28
+#define B11101 29
+#define B11110 30
+#define B11111 31
+
+// --- String ---
+class String
+{
+public:
+  String() {}
+  String(const char *cstr) : buffer(cstr ? cstr : "") {}
+  String(const std::string &str) : buffer(str) {}
+  String(char c) : buffer(1, c) {}
+  String(int value) : buffer(std::to_string(value)) {}
+  String(unsigned int value) : buffer(std::to_string(value)) {}
+  String(long value) : buffer(std::to_string(value)) {}
+  String(unsigned long value) : buffer(std::to_string(value)) {}
+  String(float value, unsigned int decimalPlaces = 2) { fromDouble(value, decimalPlaces); }
+  String(double value, unsigned int decimalPlaces = 2) { fromDouble(value, decimalPlaces); }
+
+  const char *c_str() const { return buffer.c_str(); }
+  unsigned int length() const { return buffer.length(); }
+  bool reserve(unsigned int size)
+  {
+    buffer.reserve(size);
+    return true;
+  }
+
+  bool concat(const String &str)
+  {
+    buffer += str.buffer;
+    return true;
+  }
+  bool concat(const char *cstr)
+  {
+    buffer += cstr;
+    return true;
+  }
+  bool concat(const char *cstr, unsigned int length)
+  {
+    buffer.append(cstr, length);
+    return true;
+  }
+  bool concat(char c)
+  {
+    buffer += c;
+    return true;
+  }
+
+  String &operator+=(const String &str)
+  {
+    concat(str);
+    return *this;
+  }
+  String &operator+=(const char *cstr)
+  {
+    concat(cstr);
+    return *this;
+  }
+  String &operator+=(char c)
+  {
+    concat(c);
+    return *this;
+  }
+
+  char operator[](unsigned int index) const { return buffer[index]; }
+  bool operator==(const String &rhs) const { return buffer == rhs.buffer; }
+  bool operator==(const char *rhs) const { return buffer == rhs; }
+  bool operator!=(const String &rhs) const { return buffer != rhs.buffer; }
+
+  int indexOf(char c, unsigned int from = 0) const
+  {
+    size_t pos = buffer.find(c, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+  }
+  String substring(unsigned int from, unsigned int to) const { return String(buffer.substr(from, to - from)); }
+  String substring(unsigned int from) const { return String(buffer.substr(from)); }
+  long toInt() const { return strtol(buffer.c_str(), NULL, 10); }
+  float toFloat() const { return strtof(buffer.c_str(), NULL); }
+
+private:
+  void fromDouble(double value, unsigned int decimalPlaces)
+  {
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", (int)decimalPlaces, value);
+    buffer = text;
+  }
+
+  std::string buffer;
+};
+
+inline String operator+(const String &lhs, const String &rhs)
+{
+  String result(lhs);
+  result += rhs;
+  return result;
+}
+
+inline String operator+(const char *lhs, const String &rhs)
+{
+  String result(lhs);
+  result += rhs;
+  return result;
+}
+
+// --- Print / Serial ---
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t written = 0;
+    while (size--)
+      written += write(*buffer++);
+    return written;
+  }
+  size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+  size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+
+  size_t print(const char *str) { return write(str); }
+  size_t print(const String &str) { return write(str.c_str(), str.length()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int value) { return printf("%d", value); }
+  size_t print(unsigned int value) { return printf("%u", value); }
+  size_t print(long value) { return printf("%ld", value); }
+  size_t print(unsigned long value) { return printf("%lu", value); }
+  size_t print(double value, int digits = 2) { return printf("%.*f", digits, value); }
+
+  template <typename T>
+  size_t println(const T &value)
+  {
+    size_t n = print(value);
+    return n + println();
+  }
+  size_t println() { return write("\r\n"); }
+
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+// Sumber byte seperti Stream Arduino; read()/peek() mengembalikan -1 jika tidak ada data lagi
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  size_t readBytes(char *buffer, size_t length)
+  {
+    size_t count = 0;
+    int c;
+    while (count < length && (c = read()) >= 0)
+      buffer[count++] = (char)c;
+    return count;
+  }
+  size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+};
+
+class HardwareSerial : public Print
+{
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+  void flush() { fflush(stdout); }
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// --- Clock ---
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+uint32_t esp_random(); // RNG hardware ESP32 (esp_system.h), di host dari std::random_device
+
+// --- GPIO / ADC (periferal tersimulasi) ---
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+void analogReadResolution(uint8_t bits);
+
+// Hook simulasi: nilai mentah ADC per pin (sebelum noise) dan status input digital
+void hostSetAnalogValue(uint8_t pin, uint16_t value);
+void hostSetDigitalInput(uint8_t pin, uint8_t value);
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+void esp_restart();
+
+#define IRAM_ATTR
+#define RTC_DATA_ATTR __attribute__((section("rtc_data"), used)) // Bertahan selama deep sleep (lihat esp_sleep.h)
+
+// Hook host untuk main(): argv untuk exec ulang saat deep sleep, dan batas HOST_RUN_MS yang berlaku lintas exec
+void hostBoot(int argc, char **argv);
+unsigned long hostRunUntil(unsigned long runMs);
+
+// --- FreeRTOS ---
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void *);
+typedef struct HostTask *TaskHandle_t;
+typedef struct HostSemaphore *SemaphoreHandle_t;
+typedef struct HostQueue *QueueHandle_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms) / portTICK_PERIOD_MS)
+
+BaseType_t xTaskCreate(TaskFunction_t taskCode, const char *name, uint32_t stackDepth, void *parameters, UBaseType_t priority, TaskHandle_t *createdTask);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t *previousWakeTime, TickType_t increment);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higherPriorityTaskWoken);
+#define portYIELD_FROM_ISR(...)
+TickType_t xTaskGetTickCount();
+
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticksToWait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *buffer, TickType_t ticksToWait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
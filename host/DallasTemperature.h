@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+#include <OneWire.h>
+
+// Probe DS18B20 tersimulasi (default satu, hostSetProbeCount() untuk beberapa probe di bus yang sama).
+// Konversi memblokir selama waktu konversi resolusi aktif (750 ms untuk 12 bit) seperti sensor asli,
+// kecuali setWaitForConversion(false): requestTemperatures() langsung kembali dan hasil baru terbaca
+// setelah waktu konversi lewat; sebelum itu scratchpad masih berisi hasil konversi sebelumnya
+// (85 C setelah power-on). Suhu dasar diatur lewat hostSetTemperature(), probe ke-i lebih panas 0.5 C x i.
+
+#define DEVICE_DISCONNECTED_C -127
+#define DS18B20_HOST_MAX_PROBES 8
+
+typedef uint8_t DeviceAddress[8];
+
+class DallasTemperature
+{
+public:
+  DallasTemperature(OneWire *oneWire) : oneWire(oneWire) {}
+
+  void begin() {}
+  void setWaitForConversion(bool wait) { waitForConversion = wait; }
+  bool getWaitForConversion() const { return waitForConversion; }
+  void setResolution(uint8_t newResolution) { resolution = constrain(newResolution, 9, 12); }
+  uint8_t getResolution() const { return resolution; }
+  uint16_t millisToWaitForConversion(uint8_t bitResolution) const { return 750 >> (12 - constrain(bitResolution, 9, 12)); }
+
+  uint8_t getDeviceCount();
+  bool getAddress(uint8_t *deviceAddress, uint8_t index);
+  void requestTemperatures();
+  bool isConversionComplete();
+  float getTempC(const uint8_t *deviceAddress);
+  float getTempCByIndex(uint8_t index);
+
+  static void hostSetTemperature(float celsius);
+  static void hostSetProbeCount(uint8_t count);
+
+private:
+  OneWire *oneWire;
+  bool waitForConversion = true;
+  uint8_t resolution = 12;
+  unsigned long conversionReadyAt = 0;
+  bool conversionPending = false;
+  float pending[DS18B20_HOST_MAX_PROBES];
+  float scratchpad[DS18B20_HOST_MAX_PROBES] = {85, 85, 85, 85, 85, 85, 85, 85};
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Arduino.h>
+
+// NVS tersimulasi: isi EEPROM disimpan ke file (default "eeprom.bin", bisa diganti lewat HOST_NVS_FILE).
+// File yang belum ada dianggap terisi nol.
+
+class EEPROMClass
+{
+public:
+  bool begin(size_t size);
+  bool commit();
+
+  uint8_t read(int address);
+  void write(int address, uint8_t value);
+  size_t writeInt(int address, int32_t value) { return writeBytes(address, &value, sizeof(value)); }
+  int32_t readInt(int address)
+  {
+    int32_t value = 0;
+    readBytes(address, &value, sizeof(value));
+    return value;
+  }
+
+  size_t writeBytes(int address, const void *value, size_t length);
+  size_t readBytes(int address, void *value, size_t length);
+
+  template <typename T>
+  T &get(int address, T &value)
+  {
+    readBytes(address, &value, sizeof(T));
+    return value;
+  }
+
+  template <typename T>
+  const T &put(int address, const T &value)
+  {
+    writeBytes(address, &value, sizeof(T));
+    return value;
+  }
+
+  // Jumlah commit(), dipakai untuk memantau keausan flash pada soak test
+  unsigned long hostCommitCount() const { return commitCount; }
+
+private:
+  uint8_t data[4096];
+  size_t size = 0;
+  unsigned long commitCount = 0;
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <WiFi.h>
+
+// Klien HTTP/1.1 minimal di atas WiFiClient, cukup untuk POST JSON ke server.py.
+// Perilakunya mengikuti HTTPClient ESP32: dengan setReuse(true) socket di WiFiClient tetap terbuka
+// setelah end() selama server tidak membalas "Connection: close", dan begin() berikutnya memakainya lagi.
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-2)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+// Body respons yang sudah diterima POST(), dibaca sebagai Stream (di ESP32 getStream() adalah socket-nya)
+class HTTPResponseStream : public Stream
+{
+public:
+  void begin(const String &text)
+  {
+    body = &text;
+    position = 0;
+  }
+  int available() override { return body ? (int)(body->length() - position) : 0; }
+  int read() override { return available() > 0 ? (uint8_t)body->c_str()[position++] : -1; }
+  int peek() override { return available() > 0 ? (uint8_t)body->c_str()[position] : -1; }
+  size_t write(uint8_t c) override
+  {
+    (void)c;
+    return 0;
+  }
+
+private:
+  const String *body = NULL;
+  size_t position = 0;
+};
+
+class HTTPClient
+{
+public:
+  ~HTTPClient() { end(); }
+
+  bool begin(WiFiClient &client, const String &url);
+  bool begin(WiFiClient &client, const String &host, uint16_t port, const String &uri);
+  void setReuse(bool reuse) { reuseConnection = reuse; }
+  void addHeader(const String &name, const String &value);
+  int POST(uint8_t *payload, size_t size);
+  int POST(const String &payload) { return POST((uint8_t *)payload.c_str(), payload.length()); }
+  String getString() { return response; }
+  Stream &getStream()
+  {
+    responseStream.begin(response);
+    return responseStream;
+  }
+  void end();
+
+private:
+  WiFiClient *client = NULL;
+  String host;
+  uint16_t port = 80;
+  String path;
+  String headers;
+  String response;
+  HTTPResponseStream responseStream;
+  bool reuseConnection = false;
+  bool canReuse = false;
+};
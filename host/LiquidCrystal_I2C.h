@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Arduino.h>
+
+// LCD I2C tersimulasi: isi layar disimpan di buffer 16x2 dan bisa dicetak ke stdout
+// setiap clear() jika environment variable HOST_LCD_ECHO diset.
+
+class LiquidCrystal_I2C : public Print
+{
+public:
+  LiquidCrystal_I2C(uint8_t address, uint8_t columns, uint8_t rows);
+
+  void init();
+  void backlight() { backlightOn = true; }
+  void noBacklight() { backlightOn = false; }
+  void clear();
+  void setCursor(uint8_t column, uint8_t row);
+  void createChar(uint8_t location, uint8_t charmap[]);
+
+  size_t write(uint8_t c) override;
+
+  const char *hostLine(uint8_t row) const { return screen[row < 2 ? row : 1]; }
+
+private:
+  uint8_t columns;
+  uint8_t rows;
+  uint8_t cursorColumn;
+  uint8_t cursorRow;
+  bool backlightOn;
+  char screen[2][17];
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define LORA_DEFAULT_SPI_FREQUENCY 8E6
+
+// Radio LoRa tersimulasi: setiap paket dikirim sebagai datagram UDP multicast di localhost,
+// sehingga binary transmitter dan receiver yang berjalan di mesin yang sama bisa saling bertukar paket.
+// Port medium bisa diganti lewat environment variable HOST_LORA_PORT, dan HOST_LORA_LOSS (persen)
+// membuang sebagian paket yang diterima untuk meniru kanal yang lossy. Paket membawa SF/BW dan daya TX pengirim:
+// penerima dengan SF/BW lain tidak mendengarnya, dan RSSI/SNR dihitung dari daya TX dikurangi redaman link
+// (HOST_LORA_PATH_LOSS dB per proses, dijumlahkan di kedua ujung) agar ADR bisa diuji.
+
+class LoRaClass : public Print
+{
+public:
+  LoRaClass();
+
+  int begin(long frequency);
+  void end();
+
+  int beginPacket(int implicitHeader = false);
+  int endPacket(bool async = false);
+
+  int parsePacket(int size = 0);
+  int packetRssi();
+  float packetSnr();
+  int rssi();
+
+  size_t write(uint8_t byte) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+
+  int available();
+  int read();
+  int peek();
+
+  void onReceive(void (*callback)(int));
+  void onTxDone(void (*callback)());
+
+  void receive(int size = 0);
+  void idle();
+  void sleep();
+
+  void setTxPower(int level, int outputPin = 1);
+  void setFrequency(long frequency);
+  void setSpreadingFactor(int sf);
+  void setSignalBandwidth(long sbw);
+  void setCodingRate4(int denominator);
+  void setPreambleLength(long length);
+  void setSyncWord(int sw);
+  void enableCrc();
+  void disableCrc();
+
+  void setPins(int ss, int reset, int dio0);
+
+  int getSpreadingFactor() const { return spreadingFactor; }
+  long getSignalBandwidth() const { return signalBandwidth; }
+  int getCodingRate4() const { return codingRate4; }
+  int getTxPower() const { return txPower; }
+
+  // Dipanggil oleh thread DIO0 tersimulasi
+  void hostPollReceive();
+  // Burst read register FIFO lewat host/SPI.h: size byte berikutnya dari paket terakhir
+  void hostReadFifo(uint8_t *buffer, size_t size);
+
+private:
+  bool receivePacket(bool blocking);
+
+  int socketFd;
+  bool receiving;
+  uint64_t nodeNonce;
+
+  uint8_t txBuffer[256];
+  size_t txLength;
+  uint8_t rxBuffer[256];
+  size_t rxLength;
+  size_t rxIndex;
+  int lastRssi;
+  float lastSnr;
+
+  int spreadingFactor;
+  long signalBandwidth;
+  int codingRate4;
+  int txPower;
+  long preambleLength;
+
+  void (*receiveCallback)(int);
+  void (*txDoneCallback)();
+};
+
+extern LoRaClass LoRa;
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Bus OneWire tidak disimulasikan per bit; DallasTemperature.h langsung mensimulasikan probe DS18B20.
+
+class OneWire
+{
+public:
+  OneWire(uint8_t pin) : pin(pin) {}
+
+  uint8_t pin;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Bus SPI hanya disimulasikan sejauh yang dipakai firmware di luar library LoRa: burst read register FIFO
+// SX127x (loraReadFifo() di lora_packet.h), dilayani dari paket terakhir radio tersimulasi di LoRa.h.
+// Register lain tidak ada; radio diatur lewat API LoRa.h.
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+class SPISettings
+{
+public:
+  SPISettings() {}
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+  {
+    (void)clock;
+    (void)bitOrder;
+    (void)dataMode;
+  }
+};
+
+class SPIClass
+{
+public:
+  void begin() {}
+  void beginTransaction(SPISettings settings);
+  void endTransaction() {}
+
+  uint8_t transfer(uint8_t data);
+  void transfer(void *data, uint32_t size);
+
+private:
+  int address = -1; // Register transaksi ini, -1 = byte berikutnya adalah alamat
+};
+
+extern SPIClass SPI;
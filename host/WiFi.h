@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Arduino.h>
+
+// WiFi tersimulasi: selalu terhubung kecuali diputus lewat hostSetConnected(false).
+// WiFiClient memegang socket TCP sehingga HTTPClient bisa memakai ulang koneksi (keep-alive) seperti di ESP32.
+
+typedef enum
+{
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED = 3,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+class IPAddress
+{
+public:
+  IPAddress() : address(0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : address((uint32_t)a | (uint32_t)b << 8 | (uint32_t)c << 16 | (uint32_t)d << 24) {}
+  explicit IPAddress(uint32_t value) : address(value) {}
+
+  operator uint32_t() const { return address; }
+  uint8_t operator[](int index) const { return (address >> (index * 8)) & 0xFF; }
+  String toString() const
+  {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(text);
+  }
+
+private:
+  uint32_t address; // urutan byte jaringan, sama seperti IPAddress ESP32
+};
+
+class WiFiClass
+{
+public:
+  wl_status_t status() const { return connected ? WL_CONNECTED : WL_DISCONNECTED; }
+  // Nama "*.local" (mDNS) diarahkan ke HOST_SERVER_ADDR (default 127.0.0.1)
+  int hostByName(const char *hostName, IPAddress &result);
+  void hostSetConnected(bool value) { connected = value; }
+
+private:
+  volatile bool connected = true;
+};
+
+extern WiFiClass WiFi;
+
+class WiFiClient
+{
+public:
+  ~WiFiClient() { stop(); }
+
+  int connect(IPAddress ip, uint16_t port);
+  uint8_t connected();
+  void stop();
+  int fd() const { return socketFd; }
+
+private:
+  int socketFd = -1;
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <WiFi.h>
+
+class WiFiManager
+{
+public:
+  bool autoConnect(const char *apName) { (void)apName; return WiFi.status() == WL_CONNECTED; }
+  void resetSettings() {}
+};
@@ -0,0 +1,850 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <LiquidCrystal_I2C.h>
+#include <DallasTemperature.h>
+#include <WiFi.h>
+#include <esp_adc/adc_continuous.h>
+#include <esp_sleep.h>
+#include <esp_partition.h>
+
+#include <stdarg.h>
+#include <unistd.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+WiFiClass WiFi;
+
+// --- Print / Serial ---
+size_t Print::printf(const char *format, ...)
+{
+  // Seperti ESP32: buffer di stack, keluaran yang lebih panjang diformat ulang ke buffer heap
+  char text[256];
+  va_list args, copy;
+  va_start(args, format);
+  va_copy(copy, args);
+  int length = vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+
+  if (length < 0)
+  {
+    va_end(copy);
+    return 0;
+  }
+  if ((size_t)length < sizeof(text))
+  {
+    va_end(copy);
+    return write((const uint8_t *)text, length);
+  }
+  std::vector<char> longText(length + 1);
+  vsnprintf(longText.data(), longText.size(), format, copy);
+  va_end(copy);
+  return write((const uint8_t *)longText.data(), length);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+  return fwrite(buffer, 1, size, stdout);
+}
+
+// --- Clock ---
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+
+unsigned long millis()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(unsigned long ms)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+uint32_t esp_random()
+{
+  static std::random_device random;
+  return random();
+}
+
+// --- GPIO / ADC ---
+#define HOST_PIN_COUNT 40
+
+static volatile uint8_t pinModes[HOST_PIN_COUNT];
+static volatile uint8_t pinLevels[HOST_PIN_COUNT];
+static volatile uint16_t analogValues[HOST_PIN_COUNT];
+static uint8_t analogResolution = 12;
+static std::mutex noiseMutex;
+static std::minstd_rand noise(12345);
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  if (pin >= HOST_PIN_COUNT)
+    return;
+  pinModes[pin] = mode;
+  if (mode == INPUT_PULLUP)
+    pinLevels[pin] = HIGH; // tombol tidak ditekan
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  if (pin < HOST_PIN_COUNT)
+    pinLevels[pin] = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin)
+{
+  return pin < HOST_PIN_COUNT ? pinLevels[pin] : LOW;
+}
+
+void hostSetDigitalInput(uint8_t pin, uint8_t value)
+{
+  digitalWrite(pin, value);
+}
+
+void hostSetAnalogValue(uint8_t pin, uint16_t value)
+{
+  if (pin < HOST_PIN_COUNT)
+    analogValues[pin] = value;
+}
+
+void analogReadResolution(uint8_t bits)
+{
+  analogResolution = bits;
+}
+
+uint16_t analogRead(uint8_t pin)
+{
+  if (pin >= HOST_PIN_COUNT)
+    return 0;
+
+  // nilai dasar (skala 10 bit) ditambah noise +-4 LSB, lalu diskalakan ke resolusi aktif
+  int value;
+  {
+    std::lock_guard<std::mutex> lock(noiseMutex);
+    value = analogValues[pin] + (int)(noise() % 9) - 4;
+  }
+  int maxValue = (1 << analogResolution) - 1;
+  value = value << analogResolution >> 10;
+  return constrain(value, 0, maxValue);
+}
+
+// --- ADC continuous (DMA) ---
+// ADC1 ESP32: channel 0..7 = GPIO 36, 37, 38, 39, 32, 33, 34, 35
+static const int adc1ChannelPins[8] = {36, 37, 38, 39, 32, 33, 34, 35};
+
+struct HostAdcContinuous
+{
+  adc_digi_pattern_config_t pattern[SOC_ADC_PATT_LEN_MAX];
+  uint32_t patternCount = 0;
+  uint32_t sampleFrequency = 20000;
+  uint32_t nextPattern = 0;
+  bool running = false;
+  std::chrono::steady_clock::time_point startedAt;
+  uint64_t delivered = 0; // Jumlah konversi yang sudah dibaca sejak start
+};
+
+esp_err_t adc_continuous_new_handle(const adc_continuous_handle_cfg_t *config, adc_continuous_handle_t *handle)
+{
+  (void)config;
+  *handle = new HostAdcContinuous();
+  return ESP_OK;
+}
+
+esp_err_t adc_continuous_config(adc_continuous_handle_t handle, const adc_continuous_config_t *config)
+{
+  if (handle->running || config->pattern_num == 0 || config->pattern_num > SOC_ADC_PATT_LEN_MAX)
+    return ESP_ERR_INVALID_STATE;
+  std::copy_n(config->adc_pattern, config->pattern_num, handle->pattern);
+  handle->patternCount = config->pattern_num;
+  handle->sampleFrequency = config->sample_freq_hz;
+  return ESP_OK;
+}
+
+esp_err_t adc_continuous_start(adc_continuous_handle_t handle)
+{
+  if (handle->running)
+    return ESP_ERR_INVALID_STATE;
+  handle->running = true;
+  handle->startedAt = std::chrono::steady_clock::now();
+  handle->delivered = 0;
+  handle->nextPattern = 0;
+  return ESP_OK;
+}
+
+esp_err_t adc_continuous_stop(adc_continuous_handle_t handle)
+{
+  if (!handle->running)
+    return ESP_ERR_INVALID_STATE;
+  handle->running = false;
+  return ESP_OK;
+}
+
+esp_err_t adc_continuous_flush_pool(adc_continuous_handle_t handle)
+{
+  (void)handle;
+  return ESP_OK;
+}
+
+esp_err_t adc_continuous_channel_to_io(adc_unit_t unit, adc_channel_t channel, int *io)
+{
+  if (unit != ADC_UNIT_1 || channel > ADC_CHANNEL_7)
+    return ESP_FAIL;
+  *io = adc1ChannelPins[channel];
+  return ESP_OK;
+}
+
+esp_err_t adc_continuous_read(adc_continuous_handle_t handle, uint8_t *buffer, uint32_t lengthMax, uint32_t *outLength, uint32_t timeoutMs)
+{
+  *outLength = 0;
+  if (!handle->running)
+    return ESP_ERR_INVALID_STATE;
+
+  // Menunggu sampai DMA "mengisi" frame sesuai laju sampling
+  uint32_t conversions = lengthMax / SOC_ADC_DIGI_RESULT_BYTES;
+  auto readyAt = handle->startedAt + std::chrono::microseconds((handle->delivered + conversions) * 1000000ULL / handle->sampleFrequency);
+  if (readyAt > std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs))
+  {
+    delay(timeoutMs);
+    return ESP_ERR_TIMEOUT;
+  }
+  std::this_thread::sleep_until(readyAt);
+
+  std::lock_guard<std::mutex> lock(noiseMutex);
+  adc_digi_output_data_t *out = (adc_digi_output_data_t *)buffer;
+  for (uint32_t i = 0; i < conversions; i++)
+  {
+    const adc_digi_pattern_config_t &pattern = handle->pattern[handle->nextPattern];
+    handle->nextPattern = (handle->nextPattern + 1) % handle->patternCount;
+
+    // nilai dasar (skala 10 bit -> 12 bit), noise +-16 LSB dan spike +-256 LSB pada ~1 % sampel
+    int value = analogValues[adc1ChannelPins[pattern.channel & 7]] * 4 + (int)(noise() % 33) - 16;
+    if (noise() % 100 == 0)
+      value += (noise() & 1) ? 256 : -256;
+    out[i].type1.data = constrain(value, 0, 4095);
+    out[i].type1.channel = pattern.channel;
+  }
+  handle->delivered += conversions;
+  *outLength = conversions * SOC_ADC_DIGI_RESULT_BYTES;
+  return ESP_OK;
+}
+
+void esp_restart()
+{
+  Serial.println("[host] esp_restart()");
+  fflush(stdout);
+  exit(0);
+}
+
+// --- Deep sleep ---
+// Section rtc_data berisi semua variabel RTC_DATA_ATTR; simbol batasnya dibuat linker (weak: Receiver tidak punya)
+extern "C" char __start_rtc_data[] __attribute__((weak));
+extern "C" char __stop_rtc_data[] __attribute__((weak));
+
+static char **hostArgv;
+static uint64_t sleepTimerUs;
+static esp_sleep_wakeup_cause_t wakeupCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+static const char *rtcFile()
+{
+  const char *file = getenv("HOST_RTC_FILE");
+  return file ? file : "rtc.bin";
+}
+
+static long long epochMs()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void hostBoot(int argc, char **argv)
+{
+  (void)argc;
+  hostArgv = argv;
+
+  // Diset esp_deep_sleep_start() sebelum exec: pulihkan memori RTC
+  const char *cause = getenv("HOST_WAKEUP_CAUSE");
+  if (!cause)
+    return;
+  wakeupCause = (esp_sleep_wakeup_cause_t)atoi(cause);
+  unsetenv("HOST_WAKEUP_CAUSE");
+
+  FILE *file = fopen(rtcFile(), "rb");
+  if (!file)
+    return;
+  if (__start_rtc_data)
+  {
+    size_t loaded = fread(__start_rtc_data, 1, __stop_rtc_data - __start_rtc_data, file);
+    (void)loaded;
+  }
+  fclose(file);
+}
+
+unsigned long hostRunUntil(unsigned long runMs)
+{
+  long long deadlineMs;
+  const char *deadline = getenv("HOST_RUN_DEADLINE_MS");
+  if (deadline)
+  {
+    deadlineMs = atoll(deadline);
+  }
+  else
+  {
+    deadlineMs = epochMs() + runMs;
+    setenv("HOST_RUN_DEADLINE_MS", std::to_string(deadlineMs).c_str(), 1);
+  }
+
+  long long remainingMs = deadlineMs - epochMs();
+  if (remainingMs <= 0)
+  {
+    fflush(stdout);
+    exit(0);
+  }
+  return millis() + remainingMs;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us)
+{
+  sleepTimerUs = time_in_us;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t gpio_num, int level)
+{
+  (void)gpio_num;
+  (void)level;
+  return ESP_OK;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause()
+{
+  return wakeupCause;
+}
+
+void esp_deep_sleep_start()
+{
+  Serial.printf("[host] deep sleep %llu ms\n", (unsigned long long)(sleepTimerUs / 1000));
+  fflush(stdout);
+
+  FILE *file = fopen(rtcFile(), "wb");
+  if (file)
+  {
+    if (__start_rtc_data)
+      fwrite(__start_rtc_data, 1, __stop_rtc_data - __start_rtc_data, file);
+    fclose(file);
+  }
+
+  // Tanpa timer hanya tombol yang bisa membangunkan, dan tombol tidak disimulasikan
+  long long sleepMs = sleepTimerUs / 1000;
+  const char *deadline = getenv("HOST_RUN_DEADLINE_MS");
+  if (sleepTimerUs == 0 || (deadline && epochMs() + sleepMs >= atoll(deadline)))
+  {
+    if (deadline && atoll(deadline) > epochMs())
+      std::this_thread::sleep_for(std::chrono::milliseconds(atoll(deadline) - epochMs()));
+    exit(0);
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(sleepMs));
+  setenv("HOST_WAKEUP_CAUSE", std::to_string(ESP_SLEEP_WAKEUP_TIMER).c_str(), 1);
+  execv("/proc/self/exe", hostArgv);
+  perror("execv");
+  exit(1);
+}
+
+// --- FreeRTOS ---
+struct HostTask
+{
+  const char *name;
+  std::mutex mutex;
+  std::condition_variable notified;
+  uint32_t notifyCount;
+};
+
+// Task untuk thread yang tidak dibuat lewat xTaskCreate (misalnya thread main yang menjalankan loop())
+static thread_local HostTask *currentTask = NULL;
+
+struct HostTaskStart
+{
+  TaskFunction_t taskCode;
+  void *parameters;
+  HostTask *task;
+};
+
+static void runTask(HostTaskStart start)
+{
+  currentTask = start.task;
+  start.taskCode(start.parameters);
+}
+
+BaseType_t xTaskCreate(TaskFunction_t taskCode, const char *name, uint32_t stackDepth, void *parameters, UBaseType_t priority, TaskHandle_t *createdTask)
+{
+  (void)stackDepth;
+  (void)priority;
+
+  HostTask *task = new HostTask();
+  task->name = name;
+  task->notifyCount = 0;
+
+  if (createdTask)
+    *createdTask = task;
+
+  std::thread(runTask, HostTaskStart{taskCode, parameters, task}).detach();
+  return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+  if (!currentTask)
+  {
+    currentTask = new HostTask();
+    currentTask->name = "loopTask";
+    currentTask->notifyCount = 0;
+  }
+  return currentTask;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait)
+{
+  HostTask *task = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> lock(task->mutex);
+
+  auto pending = [task]
+  { return task->notifyCount > 0; };
+  if (ticksToWait == portMAX_DELAY)
+    task->notified.wait(lock, pending);
+  else
+    task->notified.wait_for(lock, std::chrono::milliseconds(ticksToWait * portTICK_PERIOD_MS), pending);
+
+  uint32_t count = task->notifyCount;
+  if (count > 0)
+    task->notifyCount = clearCountOnExit ? 0 : count - 1;
+  return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+  if (!task)
+    return pdFAIL;
+
+  std::lock_guard<std::mutex> lock(task->mutex);
+  task->notifyCount++;
+  task->notified.notify_one();
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higherPriorityTaskWoken)
+{
+  xTaskNotifyGive(task);
+  if (higherPriorityTaskWoken)
+    *higherPriorityTaskWoken = pdFALSE;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+  delay(ticks * portTICK_PERIOD_MS);
+}
+
+TickType_t xTaskGetTickCount()
+{
+  return millis() / portTICK_PERIOD_MS;
+}
+
+void vTaskDelayUntil(TickType_t *previousWakeTime, TickType_t increment)
+{
+  *previousWakeTime += increment;
+  TickType_t now = xTaskGetTickCount();
+  if ((int32_t)(*previousWakeTime - now) > 0)
+    vTaskDelay(*previousWakeTime - now);
+}
+
+struct HostSemaphore
+{
+  std::mutex mutex;
+  std::condition_variable available;
+  unsigned int count;
+};
+
+SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+  return new HostSemaphore{{}, {}, 0};
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+  return new HostSemaphore{{}, {}, 1};
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+  std::unique_lock<std::mutex> lock(semaphore->mutex);
+  if (ticksToWait == portMAX_DELAY)
+  {
+    semaphore->available.wait(lock, [semaphore]
+                              { return semaphore->count > 0; });
+  }
+  else if (!semaphore->available.wait_for(lock, std::chrono::milliseconds(ticksToWait * portTICK_PERIOD_MS), [semaphore]
+                                          { return semaphore->count > 0; }))
+  {
+    return pdFALSE;
+  }
+
+  semaphore->count--;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+  std::lock_guard<std::mutex> lock(semaphore->mutex);
+  if (semaphore->count > 0)
+    return pdFALSE; // semaphore biner sudah tersedia
+  semaphore->count++;
+  semaphore->available.notify_one();
+  return pdTRUE;
+}
+
+struct HostQueue
+{
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<std::string> items;
+  UBaseType_t length;
+  UBaseType_t itemSize;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+  HostQueue *queue = new HostQueue();
+  queue->length = length;
+  queue->itemSize = itemSize;
+  return queue;
+}
+
+// Menunggu sampai predicate terpenuhi atau timeout habis (ticksToWait 0 = tidak menunggu)
+template <typename Predicate>
+static bool waitFor(std::condition_variable &condition, std::unique_lock<std::mutex> &lock, TickType_t ticksToWait, Predicate predicate)
+{
+  if (ticksToWait == portMAX_DELAY)
+  {
+    condition.wait(lock, predicate);
+    return true;
+  }
+  return condition.wait_for(lock, std::chrono::milliseconds(ticksToWait * portTICK_PERIOD_MS), predicate);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticksToWait)
+{
+  std::unique_lock<std::mutex> lock(queue->mutex);
+  if (!waitFor(queue->changed, lock, ticksToWait, [queue]
+               { return queue->items.size() < queue->length; }))
+    return pdFALSE;
+
+  queue->items.emplace_back((const char *)item, queue->itemSize);
+  queue->changed.notify_all();
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *buffer, TickType_t ticksToWait)
+{
+  std::unique_lock<std::mutex> lock(queue->mutex);
+  if (!waitFor(queue->changed, lock, ticksToWait, [queue]
+               { return !queue->items.empty(); }))
+    return pdFALSE;
+
+  memcpy(buffer, queue->items.front().data(), queue->itemSize);
+  queue->items.pop_front();
+  queue->changed.notify_all();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+  std::lock_guard<std::mutex> lock(queue->mutex);
+  return queue->items.size();
+}
+
+// --- EEPROM ---
+static const char *nvsFile()
+{
+  const char *file = getenv("HOST_NVS_FILE");
+  return file ? file : "eeprom.bin";
+}
+
+bool EEPROMClass::begin(size_t requestedSize)
+{
+  size = std::min(requestedSize, sizeof(data));
+  memset(data, 0, sizeof(data));
+
+  FILE *file = fopen(nvsFile(), "rb");
+  if (file)
+  {
+    size_t loaded = fread(data, 1, size, file);
+    (void)loaded;
+    fclose(file);
+  }
+  return true;
+}
+
+bool EEPROMClass::commit()
+{
+  FILE *file = fopen(nvsFile(), "wb");
+  if (!file)
+    return false;
+
+  bool ok = fwrite(data, 1, size, file) == size;
+  fclose(file);
+  commitCount++;
+  return ok;
+}
+
+uint8_t EEPROMClass::read(int address)
+{
+  return (address >= 0 && (size_t)address < size) ? data[address] : 0;
+}
+
+void EEPROMClass::write(int address, uint8_t value)
+{
+  if (address >= 0 && (size_t)address < size)
+    data[address] = value;
+}
+
+size_t EEPROMClass::writeBytes(int address, const void *value, size_t length)
+{
+  if (address < 0 || (size_t)address + length > size)
+    return 0;
+  memcpy(&data[address], value, length);
+  return length;
+}
+
+size_t EEPROMClass::readBytes(int address, void *value, size_t length)
+{
+  if (address < 0 || (size_t)address + length > size)
+    return 0;
+  memcpy(value, &data[address], length);
+  return length;
+}
+
+// --- Partisi flash ---
+// Satu partisi data spiffs; isi file dibaca/ditulis langsung per operasi agar listrik putus (kill proses)
+// meninggalkan flash persis seperti di perangkat
+static const esp_partition_t hostPartition = {ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, 0x290000, HOST_FLASH_SIZE,
+                                              SPI_FLASH_SEC_SIZE, "spiffs"};
+static std::mutex flashMutex;
+
+static FILE *openFlash()
+{
+  const char *name = getenv("HOST_FLASH_FILE");
+  name = name ? name : "flash.bin";
+  FILE *file = fopen(name, "r+b");
+  if (file)
+    return file;
+
+  // Flash baru dalam keadaan ter-erase
+  file = fopen(name, "w+b");
+  if (!file)
+    return nullptr;
+  static uint8_t erased[SPI_FLASH_SEC_SIZE];
+  memset(erased, 0xFF, sizeof(erased));
+  for (uint32_t offset = 0; offset < HOST_FLASH_SIZE; offset += sizeof(erased))
+    fwrite(erased, 1, sizeof(erased), file);
+  return file;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label)
+{
+  if (type != hostPartition.type || (subtype != ESP_PARTITION_SUBTYPE_ANY && subtype != hostPartition.subtype) ||
+      (label && strcmp(label, hostPartition.label) != 0))
+    return nullptr;
+  return &hostPartition;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+{
+  if (partition != &hostPartition || src_offset + size > partition->size)
+    return ESP_ERR_INVALID_SIZE;
+  std::lock_guard<std::mutex> lock(flashMutex);
+  FILE *file = openFlash();
+  if (!file)
+    return ESP_FAIL;
+  fseek(file, src_offset, SEEK_SET);
+  bool ok = fread(dst, 1, size, file) == size;
+  fclose(file);
+  return ok ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size)
+{
+  if (partition != &hostPartition || dst_offset + size > partition->size)
+    return ESP_ERR_INVALID_SIZE;
+  std::lock_guard<std::mutex> lock(flashMutex);
+  FILE *file = openFlash();
+  if (!file)
+    return ESP_FAIL;
+
+  uint8_t current[256];
+  const uint8_t *bytes = (const uint8_t *)src;
+  bool ok = true;
+  for (size_t done = 0; ok && done < size; done += sizeof(current))
+  {
+    size_t chunk = std::min(sizeof(current), size - done);
+    fseek(file, dst_offset + done, SEEK_SET);
+    ok = fread(current, 1, chunk, file) == chunk;
+    for (size_t i = 0; i < chunk; i++)
+      current[i] &= bytes[done + i]; // NOR: bit hanya bisa 1 -> 0
+    fseek(file, dst_offset + done, SEEK_SET);
+    ok = ok && fwrite(current, 1, chunk, file) == chunk;
+  }
+  fclose(file);
+  return ok ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size)
+{
+  if (partition != &hostPartition || offset % SPI_FLASH_SEC_SIZE != 0 || size % SPI_FLASH_SEC_SIZE != 0)
+    return ESP_ERR_INVALID_ARG;
+  if (offset + size > partition->size)
+    return ESP_ERR_INVALID_SIZE;
+  std::lock_guard<std::mutex> lock(flashMutex);
+  FILE *file = openFlash();
+  if (!file)
+    return ESP_FAIL;
+
+  uint8_t erased[SPI_FLASH_SEC_SIZE];
+  memset(erased, 0xFF, sizeof(erased));
+  fseek(file, offset, SEEK_SET);
+  bool ok = true;
+  for (size_t done = 0; ok && done < size; done += sizeof(erased))
+    ok = fwrite(erased, 1, sizeof(erased), file) == sizeof(erased);
+  fclose(file);
+  return ok ? ESP_OK : ESP_FAIL;
+}
+
+// --- LCD ---
+LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t address, uint8_t columns, uint8_t rows)
+    : columns(columns), rows(rows), cursorColumn(0), cursorRow(0), backlightOn(false)
+{
+  (void)address;
+  clear();
+}
+
+void LiquidCrystal_I2C::init()
+{
+  clear();
+}
+
+void LiquidCrystal_I2C::clear()
+{
+  if (getenv("HOST_LCD_ECHO"))
+    fprintf(stderr, "[LCD] |%s|%s|\n", screen[0], screen[1]);
+
+  memset(screen, ' ', sizeof(screen));
+  screen[0][16] = '\0';
+  screen[1][16] = '\0';
+  cursorColumn = 0;
+  cursorRow = 0;
+}
+
+void LiquidCrystal_I2C::setCursor(uint8_t column, uint8_t row)
+{
+  cursorColumn = column;
+  cursorRow = row;
+}
+
+void LiquidCrystal_I2C::createChar(uint8_t location, uint8_t charmap[])
+{
+  (void)location;
+  (void)charmap;
+}
+
+size_t LiquidCrystal_I2C::write(uint8_t c)
+{
+  if (cursorRow < 2 && cursorColumn < 16 && cursorColumn < columns && cursorRow < rows)
+    screen[cursorRow][cursorColumn] = (c < 8) ? '#' : c; // custom char ditampilkan sebagai '#'
+  cursorColumn++;
+  return 1;
+}
+
+// --- DS18B20 ---
+static volatile float simulatedTemperature = 45.0f;
+static volatile uint8_t simulatedProbeCount = 1;
+
+void DallasTemperature::hostSetTemperature(float celsius)
+{
+  simulatedTemperature = celsius;
+}
+
+void DallasTemperature::hostSetProbeCount(uint8_t count)
+{
+  simulatedProbeCount = std::min<uint8_t>(count, DS18B20_HOST_MAX_PROBES);
+}
+
+uint8_t DallasTemperature::getDeviceCount()
+{
+  return simulatedProbeCount;
+}
+
+// ROM code: family 0x28, nomor seri = indeks probe
+bool DallasTemperature::getAddress(uint8_t *deviceAddress, uint8_t index)
+{
+  if (index >= simulatedProbeCount)
+    return false;
+  const uint8_t address[8] = {0x28, index, 0x4B, 0x46, 0x0D, 0x00, 0x00, (uint8_t)(0xA0 + index)};
+  memcpy(deviceAddress, address, sizeof(address));
+  return true;
+}
+
+void DallasTemperature::requestTemperatures()
+{
+  std::lock_guard<std::mutex> lock(noiseMutex);
+  float step = 0.0625f * (1 << (12 - resolution)); // 9 bit = 0.5 C .. 12 bit = 0.0625 C
+  for (uint8_t i = 0; i < simulatedProbeCount; i++)
+    pending[i] = floorf((simulatedTemperature + 0.5f * i + (int)(noise() % 5 - 2) * 0.0625f) / step) * step;
+  conversionReadyAt = millis() + millisToWaitForConversion(resolution);
+  conversionPending = true;
+
+  if (waitForConversion)
+    delay(millisToWaitForConversion(resolution));
+}
+
+bool DallasTemperature::isConversionComplete()
+{
+  return !conversionPending || millis() >= conversionReadyAt;
+}
+
+float DallasTemperature::getTempC(const uint8_t *deviceAddress)
+{
+  uint8_t index = deviceAddress[1];
+  if (deviceAddress[0] != 0x28 || index >= simulatedProbeCount)
+    return DEVICE_DISCONNECTED_C;
+
+  if (conversionPending && millis() >= conversionReadyAt)
+  {
+    memcpy(scratchpad, pending, sizeof(pending));
+    conversionPending = false;
+  }
+  return scratchpad[index];
+}
+
+float DallasTemperature::getTempCByIndex(uint8_t index)
+{
+  DeviceAddress address;
+  return getAddress(address, index) ? getTempC(address) : DEVICE_DISCONNECTED_C;
+}
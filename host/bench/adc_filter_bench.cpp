@@ -0,0 +1,103 @@
+// Evaluasi filter burst ADC (adc_filter.h) pada trace sampel mentah: noise nilai keluaran
+// (simpangan baku dan deviasi maksimum terhadap referensi) untuk tiap mode filter dan ukuran burst.
+//
+// Build & jalankan (dari root repo):
+//   g++ -std=c++17 -O2 -I. host/bench/adc_filter_bench.cpp -o adc_filter_bench
+//   ./adc_filter_bench                    trace sintetis (noise +-16 LSB, spike 1 %)
+//   ./adc_filter_bench trace.txt [ch]     trace rekaman
+//
+// Trace rekaman diambil dari transmitter dengan ADC_TRACE_DUMP 1 (baris "ADC,channel,raw"),
+// atau satu nilai mentah per baris. Sinyal dianggap konstan selama trace, jadi referensinya
+// median seluruh trace.
+
+#include "adc_filter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#define BURST_CAPACITY 256
+
+static std::vector<uint16_t> loadTrace(const char *path, int channel)
+{
+  std::vector<uint16_t> trace;
+  FILE *file = fopen(path, "r");
+  if (!file)
+  {
+    perror(path);
+    exit(1);
+  }
+
+  char line[64];
+  while (fgets(line, sizeof(line), file))
+  {
+    int sampleChannel, raw;
+    if (sscanf(line, "ADC,%d,%d", &sampleChannel, &raw) == 2)
+    {
+      if (channel < 0 || sampleChannel == channel)
+        trace.push_back(raw);
+    }
+    else if (sscanf(line, "%d", &raw) == 1)
+      trace.push_back(raw);
+  }
+  fclose(file);
+  return trace;
+}
+
+// Sama dengan ADC tersimulasi di host/arduino_host.cpp
+static std::vector<uint16_t> syntheticTrace(size_t count, uint16_t level)
+{
+  std::minstd_rand noise(12345);
+  std::vector<uint16_t> trace(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    int value = level + (int)(noise() % 33) - 16;
+    if (noise() % 100 == 0)
+      value += (noise() & 1) ? 256 : -256;
+    trace[i] = std::min(std::max(value, 0), 4095);
+  }
+  return trace;
+}
+
+int main(int argc, char **argv)
+{
+  std::vector<uint16_t> trace = argc > 1 ? loadTrace(argv[1], argc > 2 ? atoi(argv[2]) : -1) : syntheticTrace(200000, 2472);
+  if (trace.empty())
+  {
+    fprintf(stderr, "Trace kosong\n");
+    return 1;
+  }
+
+  std::vector<uint16_t> sorted(trace);
+  std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+  double reference = sorted[sorted.size() / 2];
+  printf("%zu sampel, referensi (median) %.0f LSB\n\n", trace.size(), reference);
+
+  const char *modeNames[] = {"mean", "median", "trimmed mean"};
+  printf("%-14s %6s %9s %14s %14s\n", "mode", "burst", "keluaran", "stddev (LSB)", "maks dev (LSB)");
+  for (AdcFilterMode mode : {AdcFilterMean, AdcFilterMedian, AdcFilterTrimmedMean})
+  {
+    for (uint16_t burstSize : {1, 4, 16, 64, 256})
+    {
+      static AdcBurst<BURST_CAPACITY> burst;
+      double squares = 0, maxDeviation = 0;
+      size_t outputs = 0;
+      for (size_t start = 0; start + burstSize <= trace.size(); start += burstSize)
+      {
+        burst.reset();
+        for (size_t i = start; i < start + burstSize; i++)
+          burst.push(trace[i]);
+
+        double deviation = burst.filtered(mode) - reference;
+        squares += deviation * deviation;
+        maxDeviation = std::max(maxDeviation, fabs(deviation));
+        outputs++;
+      }
+      printf("%-14s %6u %9zu %14.2f %14.2f\n", modeNames[mode], burstSize, outputs, sqrt(squares / outputs), maxDeviation);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,275 @@
+// Uji dan benchmark log cincin flash (flash_log.h) di atas flash NOR tersimulasi: urutan peek
+// tertua/terbaru, penimpaan saat log penuh, pemulihan setelah listrik putus di tengah penulisan atau erase,
+// sebaran erase per sektor (wear leveling), dan biaya flash per append (harus konstan, tidak tergantung isi log).
+//
+// Build & jalankan (dari root repo):
+//   g++ -std=c++17 -O2 -I. host/bench/flash_log_bench.cpp -o flash_log_bench
+//   ./flash_log_bench [jumlah_operasi] [seed]
+//
+// Listrik putus disimulasikan dengan memotong penulisan setelah sejumlah byte acak (sisa byte tidak ditulis)
+// atau erase yang berhenti di tengah sektor; setelah itu log di-begin() ulang dari isi flash dan isinya
+// dibandingkan dengan model. Record yang operasinya terpotong boleh ada atau hilang, record lain tidak boleh
+// berubah. Keluar dengan status 1 jika ada pelanggaran.
+
+#include "flash_log.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+#define SECTORS 4
+
+struct NorFlash
+{
+  std::vector<uint8_t> memory;
+  std::vector<uint32_t> erases;
+  long cutAfterBytes = -1; // Listrik putus setelah sekian byte ditulis/di-erase, -1 = tidak
+  bool off = false;
+  unsigned long bytesRead = 0;
+  unsigned long bytesWritten = 0;
+
+  explicit NorFlash(uint8_t sectors) : memory(sectors * FLASH_LOG_SECTOR_SIZE, 0xFF), erases(sectors, 0) {}
+
+  // Mengembalikan jumlah byte yang masih boleh ditulis sebelum listrik putus
+  size_t budget(size_t size)
+  {
+    if (cutAfterBytes < 0)
+      return size;
+    size_t allowed = std::min(size, (size_t)cutAfterBytes);
+    cutAfterBytes -= allowed;
+    if (allowed < size)
+      off = true;
+    return allowed;
+  }
+
+  bool read(uint32_t offset, void *data, size_t size)
+  {
+    if (off || offset + size > memory.size())
+      return false;
+    memcpy(data, &memory[offset], size);
+    bytesRead += size;
+    return true;
+  }
+
+  bool write(uint32_t offset, const void *data, size_t size)
+  {
+    if (off || offset + size > memory.size())
+      return false;
+    size_t allowed = budget(size);
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < allowed; i++)
+      memory[offset + i] &= bytes[i]; // NOR: bit hanya bisa 1 -> 0
+    bytesWritten += allowed;
+    return allowed == size;
+  }
+
+  bool eraseSector(uint32_t offset)
+  {
+    if (off)
+      return false;
+    size_t allowed = budget(FLASH_LOG_SECTOR_SIZE);
+    memset(&memory[offset], 0xFF, allowed);
+    erases[offset / FLASH_LOG_SECTOR_SIZE]++;
+    return allowed == FLASH_LOG_SECTOR_SIZE;
+  }
+};
+
+static int failures = 0;
+
+static void check(bool condition, const char *what, long step)
+{
+  if (!condition)
+  {
+    failures++;
+    if (failures <= 10)
+      printf("GAGAL langkah %ld: %s\n", step, what);
+  }
+}
+
+// Seluruh isi log urut dari tertua (kapasitas log uji < 255 record, cukup satu peek)
+static std::vector<uint32_t> liveSeqs(FlashLog<NorFlash> &log)
+{
+  std::vector<FlashLogRecord> records(255);
+  uint8_t count = log.peek(FlashLogOldestFirst, records.data(), 255);
+  std::vector<uint32_t> seqs;
+  for (uint8_t i = 0; i < count; i++)
+    seqs.push_back(records[i].seq);
+  return seqs;
+}
+
+static void appendValue(FlashLog<NorFlash> &log, uint32_t value)
+{
+  uint8_t data[TELEMETRY_FRAME_MAX_SIZE];
+  memset(data, value & 0xFF, sizeof(data));
+  log.append(data, sizeof(data), value);
+}
+
+// Urutan peek, consume di tengah, dan penimpaan record tertua saat log penuh
+static void functionalTest()
+{
+  NorFlash flash(SECTORS);
+  FlashLog<NorFlash> log;
+  check(log.begin(&flash, SECTORS), "begin flash kosong", 0);
+  for (uint32_t i = 0; i < 10; i++)
+    appendValue(log, i);
+
+  FlashLogRecord records[4];
+  uint8_t count = log.peek(FlashLogOldestFirst, records, 4);
+  check(count == 4 && records[0].seq == 0 && records[3].seq == 3, "peek tertua", 1);
+  count = log.peek(FlashLogNewestFirst, records, 4);
+  check(count == 4 && records[0].seq == 9 && records[3].seq == 6, "peek terbaru", 2);
+  for (uint8_t i = 0; i < count; i++)
+    log.consume(records[i]);
+  check(log.count() == 6, "count setelah consume terbaru", 3);
+  check(!log.consume(records[0]), "consume ganda ditolak", 4);
+  count = log.peek(FlashLogNewestFirst, records, 1);
+  check(count == 1 && records[0].seq == 5, "peek terbaru melewati record yang sudah di-ACK", 5);
+
+  // Pulihkan dari flash yang sama: isi harus identik
+  FlashLog<NorFlash> recovered;
+  recovered.begin(&flash, SECTORS);
+  check(recovered.count() == 6 && recovered.boot() == log.boot() + 1, "pemulihan count dan nomor boot", 6);
+
+  // Penuhi log: record tertua ditimpa, sisanya tetap urut
+  uint32_t total = log.capacity() + 100;
+  for (uint32_t i = 10; i < 10 + total; i++)
+    appendValue(recovered, i);
+  std::vector<uint32_t> seqs = liveSeqs(recovered);
+  check(recovered.stats().overwritten > 0 && recovered.count() >= recovered.capacity() && recovered.count() < SECTORS * (FLASH_LOG_SLOTS_PER_SECTOR - 1),
+        "penimpaan saat penuh", 7);
+  check(std::is_sorted(seqs.begin(), seqs.end()) && !seqs.empty() && seqs.back() == 9 + total, "urutan setelah penimpaan", 8);
+  printf("fungsional: kapasitas %u record (%d sektor), ditimpa %u saat penuh\n", (unsigned)recovered.capacity(), SECTORS,
+         (unsigned)recovered.stats().overwritten);
+}
+
+// Operasi acak dengan listrik putus acak; model = himpunan nomor urut record yang belum terkirim
+static void powerCutTest(long operations, unsigned seed)
+{
+  std::mt19937 random(seed);
+  NorFlash flash(SECTORS);
+  FlashLog<NorFlash> log;
+  log.begin(&flash, SECTORS);
+  std::set<uint32_t> model;
+  uint32_t value = 0;
+  long cuts = 0;
+
+  for (long step = 0; step < operations; step++)
+  {
+    bool cut = random() % 50 == 0;
+    flash.cutAfterBytes = cut ? (long)(random() % (FLASH_LOG_SECTOR_SIZE + 200)) : -1;
+    std::vector<uint32_t> before(model.begin(), model.end());
+    std::set<uint32_t> required = model; // Record yang wajib tetap ada walaupun operasi terpotong
+    uint32_t newestBefore = before.empty() ? 0 : before.back();
+
+    if (random() % 10 < 6) // Append (pembacaan tanpa ACK)
+    {
+      uint32_t overwrittenBefore = log.stats().overwritten;
+      appendValue(log, value++);
+      if (!flash.off)
+      {
+        // Record yang ditimpa selalu record tertua
+        for (uint32_t i = 0; i < log.stats().overwritten - overwrittenBefore && i < before.size(); i++)
+          model.erase(before[i]);
+        std::vector<uint32_t> seqs = liveSeqs(log);
+        check(!seqs.empty() && (before.empty() || seqs.back() > newestBefore), "record baru di head", step);
+        if (!seqs.empty())
+          model.insert(seqs.back());
+      }
+      // Erase sektor berikutnya yang terpotong boleh menghilangkan record tertua (paling banyak satu sektor)
+      for (size_t i = 0; i < before.size() && i < FLASH_LOG_SLOTS_PER_SECTOR - 1; i++)
+        required.erase(before[i]);
+    }
+    else // Drain satu batch dengan urutan acak, lalu consume record-nya
+    {
+      FlashLogRecord records[8];
+      FlashLogOrder order = random() % 2 ? FlashLogOldestFirst : FlashLogNewestFirst;
+      uint8_t count = log.peek(order, records, 1 + random() % 8);
+      if (order == FlashLogOldestFirst && count > 0)
+        check(records[0].seq == before.front(), "peek tertua mulai dari tail", step);
+      if (order == FlashLogNewestFirst && count > 0)
+        check(records[0].seq == before.back(), "peek terbaru mulai dari head", step);
+      for (uint8_t i = 0; i < count; i++)
+      {
+        required.erase(records[i].seq);
+        if (log.consume(records[i]))
+          model.erase(records[i].seq);
+      }
+    }
+
+    if (!flash.off)
+    {
+      std::vector<uint32_t> seqs = liveSeqs(log);
+      check(seqs.size() == log.count(), "count() sama dengan isi peek", step);
+      check(std::set<uint32_t>(seqs.begin(), seqs.end()) == model, "isi log sama dengan model", step);
+      continue;
+    }
+
+    // Listrik putus: boot ulang dari isi flash
+    cuts++;
+    flash.off = false;
+    flash.cutAfterBytes = -1;
+    FlashLog<NorFlash> recovered;
+    check(recovered.begin(&flash, SECTORS), "begin setelah listrik putus", step);
+    std::vector<uint32_t> seqs = liveSeqs(recovered);
+    std::set<uint32_t> recoveredSet(seqs.begin(), seqs.end());
+    check(seqs.size() == recovered.count(), "count() setelah pemulihan", step);
+    check(std::is_sorted(seqs.begin(), seqs.end()), "urutan setelah pemulihan", step);
+    for (uint32_t s : required)
+      check(recoveredSet.count(s) == 1, "record yang tidak disentuh hilang setelah pemulihan", step);
+    size_t fresh = 0;
+    for (uint32_t s : recoveredSet)
+    {
+      if (!model.count(s) && !std::binary_search(before.begin(), before.end(), s))
+        fresh++;
+    }
+    check(fresh <= 1, "record asing setelah pemulihan", step);
+
+    log = recovered;
+    model = recoveredSet;
+  }
+
+  uint32_t minErase = *std::min_element(flash.erases.begin(), flash.erases.end());
+  uint32_t maxErase = *std::max_element(flash.erases.begin(), flash.erases.end());
+  printf("listrik putus: %ld operasi, %ld kali putus, slot korup dilewati %u, sisa %u record\n", operations, cuts,
+         (unsigned)log.stats().corrupt, (unsigned)log.count());
+  printf("wear leveling: erase per sektor min %u / maks %u\n", minErase, maxErase);
+}
+
+// Biaya append pada log kosong dan hampir penuh harus sama (O(1))
+static void appendCostTest()
+{
+  NorFlash flash(SECTORS);
+  FlashLog<NorFlash> log;
+  log.begin(&flash, SECTORS);
+  printf("%-14s %12s %12s\n", "isi log", "baca B/op", "tulis B/op");
+  for (uint32_t fill : {0u, log.capacity() / 2, log.capacity() - 70})
+  {
+    while (log.count() < fill)
+      appendValue(log, log.count());
+    unsigned long readBefore = flash.bytesRead, writtenBefore = flash.bytesWritten;
+    for (int i = 0; i < 60; i++)
+      appendValue(log, i);
+    printf("%8u rec   %12.1f %12.1f\n", fill, (flash.bytesRead - readBefore) / 60.0, (flash.bytesWritten - writtenBefore) / 60.0);
+  }
+
+  unsigned long readBefore = flash.bytesRead;
+  FlashLog<NorFlash> recovered;
+  recovered.begin(&flash, SECTORS);
+  printf("pemulihan saat boot: baca %lu B untuk %u record\n", flash.bytesRead - readBefore, (unsigned)recovered.count());
+}
+
+int main(int argc, char **argv)
+{
+  long operations = argc > 1 ? atol(argv[1]) : 200000;
+  unsigned seed = argc > 2 ? (unsigned)atoi(argv[2]) : 1;
+
+  functionalTest();
+  powerCutTest(operations, seed);
+  appendCostTest();
+
+  printf(failures ? "GAGAL: %d pelanggaran\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
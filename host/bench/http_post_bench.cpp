@@ -0,0 +1,97 @@
+// Benchmark latensi POST uplink Receiver: koneksi baru per pembacaan (perilaku lama sendToServer)
+// dibandingkan sesi keep-alive dengan IP server yang di-cache (UplinkSession di Receiver.cpp).
+//
+// Build & jalankan (dari root repo, stand-in server di terminal lain):
+//   python3 host/bench/server_standin.py 5000
+//   g++ -std=c++17 -O2 -Ihost host/bench/http_post_bench.cpp host/http_host.cpp host/arduino_host.cpp -o http_post_bench -pthread
+//   ./http_post_bench [jumlah_post] [resolve_delay_ms]
+//
+// resolve_delay_ms mensimulasikan lookup mDNS biodrying-server.local (di ESP32 biasanya puluhan
+// sampai ratusan milidetik); di host nama .local langsung diarahkan ke HOST_SERVER_ADDR.
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+
+#include <vector>
+
+static const char *ServerHost = "biodrying-server.local";
+static const uint16_t ServerPort = 5000;
+static const char *ServerPath = "/biodrying_data";
+static const char *Payload = "{\"temperature\":45.5,\"humidity\":30.25,\"ph\":7.1}";
+
+static unsigned long resolveDelayMs = 0;
+
+static bool resolveServer(IPAddress &ip)
+{
+  delay(resolveDelayMs);
+  return WiFi.hostByName(ServerHost, ip);
+}
+
+// Perilaku lama: WiFiClient/HTTPClient baru, lookup nama dan handshake TCP di setiap POST
+static int postFresh()
+{
+  IPAddress ip;
+  if (!resolveServer(ip))
+    return -1;
+
+  WiFiClient client;
+  HTTPClient http;
+  http.begin(client, ip.toString(), ServerPort, ServerPath);
+  http.addHeader("Content-Type", "application/json");
+  int code = http.POST(Payload);
+  http.end();
+  return code;
+}
+
+// Perilaku baru: sesi keep-alive, lookup hanya sekali
+static WiFiClient sessionClient;
+static HTTPClient sessionHttp;
+static IPAddress sessionIp;
+static bool sessionResolved = false;
+
+static int postKeepAlive()
+{
+  if (!sessionResolved && !(sessionResolved = resolveServer(sessionIp)))
+    return -1;
+
+  sessionHttp.begin(sessionClient, sessionIp.toString(), ServerPort, ServerPath);
+  sessionHttp.setReuse(true);
+  sessionHttp.addHeader("Content-Type", "application/json");
+  int code = sessionHttp.POST(Payload);
+  sessionHttp.end();
+  return code;
+}
+
+static void runBenchmark(const char *name, int (*post)(), int count)
+{
+  std::vector<unsigned long> samples;
+  int failures = 0;
+  for (int i = 0; i < count; i++)
+  {
+    unsigned long start = micros();
+    if (post() != 200)
+      failures++;
+    samples.push_back(micros() - start);
+  }
+
+  std::sort(samples.begin(), samples.end());
+  unsigned long long total = 0;
+  for (unsigned long sample : samples)
+    total += sample;
+
+  Serial.printf("%-10s n=%d gagal=%d  mean %7.1f us  p50 %6lu us  p95 %6lu us  max %6lu us\n", name, count, failures,
+                (double)total / samples.size(), samples[samples.size() / 2], samples[samples.size() * 95 / 100], samples.back());
+}
+
+int main(int argc, char **argv)
+{
+  int count = argc > 1 ? atoi(argv[1]) : 500;
+  resolveDelayMs = argc > 2 ? strtoul(argv[2], NULL, 10) : 0;
+
+  // Pemanasan agar server dan cache OS tidak memengaruhi sampel pertama
+  postFresh();
+
+  runBenchmark("baru/POST", postFresh, count);
+  runBenchmark("keep-alive", postKeepAlive, count);
+  return 0;
+}
@@ -0,0 +1,193 @@
+// Benchmark latensi query KNN di knn_classifier.h: brute force dibandingkan KD-tree implisit (float),
+// dan KD-tree dengan model terkuantisasi int16 (KnnQuantizedModel), untuk data latih sintetis
+// 1k/10k/100k sampel (suhu, kelembaban, pH).
+//
+// Build & jalankan (dari root repo):
+//   g++ -std=c++17 -O2 -I. host/bench/knn_index_bench.cpp -o knn_index_bench
+//   ./knn_index_bench [jumlah_query]
+//
+// Tata letak KD-tree dibangun dengan algoritma yang sama dengan build_kd_layout() di
+// knn_model_training.py, lalu kedua mode diverifikasi menghasilkan label yang sama. Model int16
+// dikuantisasi seperti quantization_params() di knn_model_training.py; kolom "beda int16" adalah
+// jumlah query yang labelnya berbeda dari model float.
+
+#include "knn_classifier.h"
+#include "telemetry_frame.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#define FEATURES 3
+#define LEAF_SIZE 8
+#define K 5
+
+// Label sintetis mengikuti batas kelayakan di server.py (suhu 40-70 C, kelembaban <= 25 %, pH 6.5-8.5)
+static uint8_t feasible(const float *raw)
+{
+  return raw[0] >= 40 && raw[0] <= 70 && raw[1] <= 25 && raw[2] >= 6.5f && raw[2] <= 8.5f;
+}
+
+static void randomReading(std::mt19937 &random, float *raw)
+{
+  std::uniform_real_distribution<float> temperature(20, 80), humidity(5, 60), ph(5, 9);
+  raw[0] = temperature(random);
+  raw[1] = humidity(random);
+  raw[2] = ph(random);
+}
+
+// Port C++ dari build_kd_layout() di knn_model_training.py
+static void buildKdLayout(std::vector<float> &samples, std::vector<uint8_t> &labels, std::vector<uint8_t> &splitDims)
+{
+  uint32_t count = labels.size();
+  std::vector<uint32_t> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  splitDims.assign(count, 0);
+
+  std::vector<std::pair<uint32_t, uint32_t>> ranges = {{0, count}};
+  while (!ranges.empty())
+  {
+    auto [lo, hi] = ranges.back();
+    ranges.pop_back();
+    if (hi - lo <= LEAF_SIZE)
+      continue;
+
+    uint8_t dim = 0;
+    float bestSpread = -1;
+    for (uint8_t d = 0; d < FEATURES; d++)
+    {
+      auto [low, high] = std::minmax_element(order.begin() + lo, order.begin() + hi, [&](uint32_t a, uint32_t b)
+                                             { return samples[a * FEATURES + d] < samples[b * FEATURES + d]; });
+      float spread = samples[*high * FEATURES + d] - samples[*low * FEATURES + d];
+      if (spread > bestSpread)
+      {
+        bestSpread = spread;
+        dim = d;
+      }
+    }
+
+    uint32_t mid = lo + (hi - lo) / 2;
+    std::nth_element(order.begin() + lo, order.begin() + mid, order.begin() + hi, [&](uint32_t a, uint32_t b)
+                     { return samples[a * FEATURES + dim] < samples[b * FEATURES + dim]; });
+    splitDims[mid] = dim;
+    ranges.push_back({lo, mid});
+    ranges.push_back({mid + 1, hi});
+  }
+
+  std::vector<float> sortedSamples(samples.size());
+  std::vector<uint8_t> sortedLabels(count);
+  for (uint32_t i = 0; i < count; i++)
+  {
+    std::copy_n(&samples[order[i] * FEATURES], FEATURES, &sortedSamples[i * FEATURES]);
+    sortedLabels[i] = labels[order[i]];
+  }
+  samples.swap(sortedSamples);
+  labels.swap(sortedLabels);
+}
+
+template <typename Model, typename Raw>
+static double queryNs(const Model &model, const std::vector<Raw> &queries, std::vector<uint8_t> &results)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (size_t q = 0; q < results.size(); q++)
+    results[q] = knnClassify(model, &queries[q * FEATURES]);
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / results.size();
+}
+
+// Port C++ dari quantization_params() di knn_model_training.py. Data latih sudah tersusun sebagai
+// KD-tree float; pembulatan monoton jadi tata letak yang sama tetap valid untuk sampel int16.
+static void quantizeModel(const std::vector<float> &samples, const float *mean, const float *scale,
+                          std::vector<int16_t> &quantized, int32_t *recipScale, int64_t *offset)
+{
+  float maxAbs = 0;
+  for (float value : samples)
+    maxAbs = std::max(maxAbs, fabsf(value));
+  double quantScale = exp2(floor(log2(KNN_QUANT_LIMIT / maxAbs)));
+
+  quantized.resize(samples.size());
+  for (size_t i = 0; i < samples.size(); i++)
+    quantized[i] = std::max(-KNN_QUANT_LIMIT, std::min(KNN_QUANT_LIMIT, (int)lround(samples[i] * quantScale)));
+  for (uint8_t f = 0; f < FEATURES; f++)
+  {
+    recipScale[f] = lround(quantScale * (1 << KNN_QUANT_RECIP_SHIFT) / (scale[f] * 100.0));
+    offset[f] = llround(mean[f] * 100.0 * recipScale[f]) - (1 << (KNN_QUANT_RECIP_SHIFT - 1));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  size_t queryCount = argc > 1 ? atoi(argv[1]) : 10000;
+  std::mt19937 random(20240601);
+
+  printf("%8s %14s %14s %8s %10s %14s %11s\n", "sampel", "brute (us)", "kd-tree (us)", "speedup", "beda label", "kd int16 (us)", "beda int16");
+  for (uint32_t count : {1000u, 10000u, 100000u})
+  {
+    // Data latih mentah -> statistik StandardScaler -> data latih ter-scale
+    std::vector<float> raw(count * FEATURES), samples(count * FEATURES);
+    std::vector<uint8_t> labels(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+      randomReading(random, &raw[i * FEATURES]);
+      labels[i] = feasible(&raw[i * FEATURES]);
+    }
+
+    float mean[FEATURES] = {0}, scale[FEATURES] = {0};
+    for (uint8_t f = 0; f < FEATURES; f++)
+    {
+      double sum = 0, squares = 0;
+      for (uint32_t i = 0; i < count; i++)
+        sum += raw[i * FEATURES + f];
+      mean[f] = sum / count;
+      for (uint32_t i = 0; i < count; i++)
+        squares += (raw[i * FEATURES + f] - mean[f]) * (raw[i * FEATURES + f] - mean[f]);
+      scale[f] = sqrt(squares / count);
+      for (uint32_t i = 0; i < count; i++)
+        samples[i * FEATURES + f] = (raw[i * FEATURES + f] - mean[f]) / scale[f];
+    }
+
+    std::vector<float> queries(queryCount * FEATURES);
+    for (size_t q = 0; q < queryCount; q++)
+      randomReading(random, &queries[q * FEATURES]);
+    // Query int16 dalam satuan x100 seperti yang dibawa frame telemetri; query float memakai nilai yang sama
+    std::vector<int16_t> queriesX100(queries.size());
+    for (size_t i = 0; i < queries.size(); i++)
+    {
+      queriesX100[i] = telemetryToFixed(queries[i]);
+      queries[i] = telemetryFromFixed(queriesX100[i]);
+    }
+
+    KnnModel brute = {FEATURES, 2, K, count, mean, scale, samples.data(), labels.data(), LEAF_SIZE, NULL};
+    std::vector<uint8_t> bruteResults(queryCount);
+    double bruteNs = queryNs(brute, queries, bruteResults);
+
+    std::vector<uint8_t> splitDims;
+    buildKdLayout(samples, labels, splitDims);
+    KnnModel tree = {FEATURES, 2, K, count, mean, scale, samples.data(), labels.data(), LEAF_SIZE, splitDims.data()};
+    std::vector<uint8_t> treeResults(queryCount);
+    double treeNs = queryNs(tree, queries, treeResults);
+
+    std::vector<int16_t> quantizedSamples;
+    int32_t recipScale[FEATURES];
+    int64_t offset[FEATURES];
+    quantizeModel(samples, mean, scale, quantizedSamples, recipScale, offset);
+    KnnQuantizedModel quantized = {FEATURES, 2, K, count, recipScale, offset, quantizedSamples.data(), labels.data(), LEAF_SIZE, splitDims.data()};
+    std::vector<uint8_t> quantizedResults(queryCount);
+    double quantizedNs = queryNs(quantized, queriesX100, quantizedResults);
+
+    size_t differences = 0, quantizedDifferences = 0;
+    for (size_t q = 0; q < queryCount; q++)
+    {
+      differences += bruteResults[q] != treeResults[q];
+      quantizedDifferences += treeResults[q] != quantizedResults[q];
+    }
+
+    printf("%8u %14.2f %14.2f %7.1fx %10zu %14.2f %11zu\n", count, bruteNs / 1000, treeNs / 1000, bruteNs / treeNs, differences,
+           quantizedNs / 1000, quantizedDifferences);
+  }
+  return 0;
+}
@@ -0,0 +1,241 @@
+// Benchmark penerimaan paket LoRa di callback DIO0: perilaku lama (LoRa.read() per byte, payload disusun ke
+// String incoming += char lalu di-decode dari String) dibandingkan burst read FIFO ke slot antrian statis dan
+// view header/payload di tempat (lora_packet.h, dipakai Receiver dan transmitter). Untuk setiap paket dicatat
+// jumlah alokasi heap, byte heap puncak selama callback, dan latensi callback.
+//
+// Build & jalankan (dari root repo):
+//   g++ -std=c++17 -O2 -I. -Ihost host/bench/lora_rx_bench.cpp host/lora_host.cpp host/arduino_host.cpp -o lora_rx_bench -pthread
+//   ./lora_rx_bench [jumlah_paket_per_mode]
+//
+// Pengirim dan penerima adalah dua radio tersimulasi di proses yang sama (medium UDP multicast di port
+// HOST_LORA_PORT, default 47995 agar tidak tercampur firmware host yang sedang jalan). Frame telemetri v3 dengan
+// 0..TELEMETRY_MAX_PROBES probe bergantian, SF7/500 kHz agar time-on-air pendek.
+// String host memakai std::string yang tumbuh geometris (dan SSO 15 byte); String ESP32 melakukan realloc ke
+// ukuran pas di setiap concat, jadi alokasi jalur lama di perangkat kira-kira satu per byte di atas SSO-nya.
+// Keluar dengan status 1 jika jalur baru mengalokasikan heap atau ada paket yang gagal di-decode.
+
+#include <Arduino.h>
+#include <LoRa.h>
+#include "lora_packet.h"
+#include "telemetry_frame.h"
+#include "spsc_ring.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <vector>
+
+#define BENCH_SS_PIN 5
+#define BENCH_QUEUE_SIZE 8
+
+// Penghitung heap: setiap operator new dicatat beserta ukurannya (disimpan di depan blok)
+static std::atomic<unsigned long> heapAllocations(0);
+static std::atomic<long> heapLiveBytes(0);
+static std::atomic<long> heapPeakBytes(0);
+
+static void *countedAlloc(size_t size)
+{
+  size_t *block = (size_t *)malloc(size + sizeof(max_align_t));
+  if (block == NULL)
+    throw std::bad_alloc();
+  *block = size;
+  heapAllocations++;
+  long live = heapLiveBytes += (long)size;
+  long peak = heapPeakBytes;
+  while (live > peak && !heapPeakBytes.compare_exchange_weak(peak, live))
+    ;
+  return (uint8_t *)block + sizeof(max_align_t);
+}
+
+static void countedFree(void *pointer)
+{
+  if (pointer == NULL)
+    return;
+  size_t *block = (size_t *)((uint8_t *)pointer - sizeof(max_align_t));
+  heapLiveBytes -= (long)*block;
+  free(block);
+}
+
+void *operator new(size_t size) { return countedAlloc(size); }
+void *operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void *pointer) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer) noexcept { countedFree(pointer); }
+void operator delete(void *pointer, size_t) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { countedFree(pointer); }
+
+// Slot antrian seperti LoraPacket di firmware
+struct BenchPacket
+{
+  uint8_t data[255];
+  uint8_t length;
+};
+
+static SpscRing<BenchPacket, BENCH_QUEUE_SIZE> benchQueue;
+
+struct ModeStats
+{
+  std::vector<double> latencyUs;
+  unsigned long allocations = 0;
+  long peakBytes = 0;
+  unsigned long decodeErrors = 0;
+};
+
+static std::atomic<bool> legacyMode(true);
+static std::atomic<unsigned long> receivedPackets(0);
+static ModeStats legacyStats;
+static ModeStats viewStats;
+
+// Perilaku lama: header per byte, payload per byte ke String, decode dari isi String
+static bool receiveLegacy(int packetSize)
+{
+  (void)packetSize;
+  int recipient = LoRa.read();
+  uint8_t sender = LoRa.read();
+  uint8_t msgId = LoRa.read();
+  uint8_t declaredLength = LoRa.read();
+  String incoming = "";
+  while (LoRa.available())
+    incoming += (char)LoRa.read();
+  (void)recipient;
+  (void)sender;
+  (void)msgId;
+
+  TelemetryFrame frame;
+  return declaredLength == incoming.length() && decodeTelemetryFrame((const uint8_t *)incoming.c_str(), incoming.length(), frame);
+}
+
+// Perilaku baru: burst FIFO ke slot statis (callback), view dan decode di tempat (task RX)
+static bool receiveView(int packetSize)
+{
+  BenchPacket *slot = benchQueue.beginPush();
+  if (slot == NULL)
+    return false;
+  int length = packetSize < (int)sizeof(slot->data) ? packetSize : (int)sizeof(slot->data);
+  loraReadFifo(BENCH_SS_PIN, slot->data, length);
+  slot->length = length;
+  benchQueue.commitPush();
+
+  const BenchPacket *packet = benchQueue.front();
+  LoraPacketView view;
+  TelemetryFrame frame;
+  bool valid = parseLoraPacket(packet->data, packet->length, view) && view.lengthValid() &&
+               decodeTelemetryFrame(view.payload, view.payloadLength, frame);
+  benchQueue.pop();
+  return valid;
+}
+
+static void onBenchReceive(int packetSize)
+{
+  bool legacy = legacyMode;
+  ModeStats &stats = legacy ? legacyStats : viewStats;
+
+  unsigned long allocationsBefore = heapAllocations;
+  long liveBefore = heapLiveBytes;
+  heapPeakBytes = liveBefore;
+  auto start = std::chrono::steady_clock::now();
+
+  bool valid = legacy ? receiveLegacy(packetSize) : receiveView(packetSize);
+
+  auto end = std::chrono::steady_clock::now();
+  stats.latencyUs.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+  stats.allocations += heapAllocations - allocationsBefore;
+  stats.peakBytes = std::max(stats.peakBytes, (long)heapPeakBytes - liveBefore);
+  if (!valid)
+    stats.decodeErrors++;
+  receivedPackets++;
+}
+
+static double percentile(std::vector<double> values, double fraction)
+{
+  if (values.empty())
+    return 0;
+  std::sort(values.begin(), values.end());
+  return values[std::min(values.size() - 1, (size_t)(fraction * values.size()))];
+}
+
+static void report(const char *name, const ModeStats &stats)
+{
+  double sum = 0;
+  for (double value : stats.latencyUs)
+    sum += value;
+  size_t count = stats.latencyUs.size();
+  printf("%-28s %6zu paket  alokasi %7.2f/paket  heap puncak %5ld B  latensi us mean %7.2f  p50 %7.2f  p99 %7.2f  max %8.2f  gagal %lu\n",
+         name, count, count ? (double)stats.allocations / count : 0.0, stats.peakBytes, count ? sum / count : 0.0,
+         percentile(stats.latencyUs, 0.5), percentile(stats.latencyUs, 0.99), percentile(stats.latencyUs, 1.0), stats.decodeErrors);
+}
+
+// Kirim count paket dan tunggu masing-masing diterima sebelum paket berikutnya (tidak ada paket tertimpa)
+static unsigned long sendPackets(LoRaClass &sender, int count, uint16_t &seq)
+{
+  unsigned long lost = 0;
+  for (int i = 0; i < count; i++)
+  {
+    TelemetryFrame frame = makeTelemetryFrame(45.0f + i % 10, 40.0f, 7.0f, TelemetryTemperatureValid | TelemetryHumidityValid | TelemetryPhValid);
+    frame.seq = seq++;
+    for (int probe = 0; probe < i % (TELEMETRY_MAX_PROBES + 1); probe++)
+      addTelemetryProbe(frame, 0x4B00 + probe, 44.5f + probe, true);
+    uint8_t payload[TELEMETRY_FRAME_MAX_SIZE];
+    size_t length = encodeTelemetryFrame(frame, payload, sizeof(payload));
+
+    unsigned long expected = receivedPackets + 1;
+    sender.beginPacket();
+    sender.write(0x02);
+    sender.write(0x05);
+    sender.write((uint8_t)frame.seq);
+    sender.write((uint8_t)length);
+    sender.write(payload, length);
+    sender.endPacket();
+
+    unsigned long waitStart = millis();
+    while (receivedPackets < expected && millis() - waitStart < 500)
+      delay(1);
+    if (receivedPackets < expected)
+      lost++;
+  }
+  return lost;
+}
+
+int main(int argc, char **argv)
+{
+  int count = argc > 1 ? atoi(argv[1]) : 300;
+  setenv("HOST_LORA_PORT", "47995", 0);
+
+  static LoRaClass sender;
+  LoRaClass *radios[] = {&LoRa, &sender};
+  for (LoRaClass *radio : radios)
+  {
+    if (!radio->begin(433E6))
+    {
+      fprintf(stderr, "Radio tersimulasi gagal dibuka\n");
+      return 1;
+    }
+    radio->setSpreadingFactor(7);
+    radio->setSignalBandwidth(500E3);
+  }
+  LoRa.onReceive(onBenchReceive);
+  LoRa.receive();
+
+  uint16_t seq = 0;
+  legacyStats.latencyUs.reserve(count);
+  viewStats.latencyUs.reserve(count);
+
+  legacyMode = true;
+  unsigned long legacyLost = sendPackets(sender, count, seq);
+  legacyMode = false;
+  unsigned long viewLost = sendPackets(sender, count, seq);
+
+  printf("paket %d per mode, frame telemetri %d..%d byte + header %d\n", count, (int)telemetryFrameSize(0),
+         (int)telemetryFrameSize(TELEMETRY_MAX_PROBES), LORA_PACKET_HEADER_SIZE);
+  report("String per byte (lama)", legacyStats);
+  report("burst FIFO + view (baru)", viewStats);
+  if (legacyLost + viewLost > 0)
+    printf("paket tidak terdengar: lama %lu, baru %lu\n", legacyLost, viewLost);
+
+  bool ok = viewStats.allocations == 0 && viewStats.peakBytes == 0 && viewStats.decodeErrors == 0 && legacyStats.decodeErrors == 0 &&
+            !viewStats.latencyUs.empty();
+  printf("%s\n", ok ? "OK: jalur baru tanpa alokasi heap" : "GAGAL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+# Pengganti server.py untuk benchmark di host: endpoint dan format respons sama, tanpa model KNN,
+# ThingSpeak, maupun mDNS. Server HTTP/1.1 multithread (keep-alive) seperti app.run() Flask.
+#
+#   python3 host/bench/server_standin.py [port] [delay_detik]
+import json
+import sys
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+PORT = int(sys.argv[1]) if len(sys.argv) > 1 else 5000
+# Waktu proses per request (prediksi + update ThingSpeak di server asli)
+DELAY = float(sys.argv[2]) if len(sys.argv) > 2 else 0.0
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    # Header dan body ditulis terpisah; tanpa ini Nagle + delayed ACK menahan body ~40 ms di koneksi keep-alive
+    disable_nagle_algorithm = True
+
+    def do_POST(self):
+        body = self.rfile.read(int(self.headers.get('Content-Length', 0)))
+        time.sleep(DELAY)
+        try:
+            data = json.loads(body)
+            result = {'classification': 1, 'buzzer_on': 1}
+            if self.path.endswith('/batch'):
+                status, out = 200, {'results': [result] * len(data['readings'])}
+            else:
+                status, out = 200, result
+        except (ValueError, KeyError, TypeError):
+            status, out = 400, {'error': 'Invalid data'}
+
+        data = json.dumps(out).encode()
+        self.send_response(status)
+        self.send_header('Content-Type', 'application/json')
+        self.send_header('Content-Length', str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def log_message(self, *args):
+        pass
+
+
+if __name__ == '__main__':
+    print(f"Stand-in server.py di 127.0.0.1:{PORT}, delay {DELAY} s")
+    ThreadingHTTPServer(('127.0.0.1', PORT), Handler).serve_forever()
@@ -0,0 +1,149 @@
+// Benchmark ukuran dan time-on-air payload telemetri: JSON lama ({"humidity":..,"temperature":..,"ph":..}
+// dari transmitter sebelum frame biner) dibandingkan frame versi 1, versi 3 dan frame kompak dengan
+// 0..TELEMETRY_MAX_PROBES probe serta frame batch backlog penuh (telemetry_frame.h), semuanya ditambah header
+// paket 4 byte. Time-on-air dihitung dengan lora_airtime.h pada BW 125 kHz CR 4/5 untuk SF7..SF12. Juga mengukur
+// waktu encode+decode satu frame versi 3 dan satu frame kompak di host.
+//
+// Build & jalankan (dari root repo):
+//   g++ -std=c++17 -O2 -I. host/bench/telemetry_airtime_bench.cpp -o telemetry_airtime_bench
+//   ./telemetry_airtime_bench [jumlah_iterasi]
+//
+// Panjang JSON dihitung dari pembacaan acak dengan dua desimal, mendekati keluaran serializeJson() untuk nilai
+// sensor biasa. Keluar dengan status 1 jika frame biner tidak lebih pendek di udara daripada JSON.
+
+#include "telemetry_frame.h"
+#include "lora_airtime.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+
+#define LORA_HEADER_SIZE 4
+#define BENCH_BANDWIDTH 125E3
+#define BENCH_CODE_DENOMINATOR 5
+
+struct PayloadCase
+{
+  char name[32];
+  double bytes; // Rata-rata panjang payload (JSON bervariasi per pembacaan)
+};
+
+static void printRow(const PayloadCase &payload, const PayloadCase &reference)
+{
+  printf("%-26s %6.1f B", payload.name, payload.bytes + LORA_HEADER_SIZE);
+  for (int sf = 7; sf <= 12; sf++)
+  {
+    uint32_t us = loraTimeOnAirUs((int)(payload.bytes + 0.5) + LORA_HEADER_SIZE, sf, BENCH_BANDWIDTH, BENCH_CODE_DENOMINATOR);
+    printf("  %8.1f", us / 1000.0);
+  }
+  uint32_t referenceUs = loraTimeOnAirUs((int)(reference.bytes + 0.5) + LORA_HEADER_SIZE, 12, BENCH_BANDWIDTH, BENCH_CODE_DENOMINATOR);
+  uint32_t payloadUs = loraTimeOnAirUs((int)(payload.bytes + 0.5) + LORA_HEADER_SIZE, 12, BENCH_BANDWIDTH, BENCH_CODE_DENOMINATOR);
+  printf("  %5.2fx\n", (double)referenceUs / payloadUs);
+}
+
+int main(int argc, char **argv)
+{
+  long iterations = argc > 1 ? atol(argv[1]) : 1000000;
+  std::mt19937 random(1);
+  std::uniform_real_distribution<float> temperature(30.0f, 70.0f), humidity(10.0f, 90.0f), ph(5.0f, 9.0f);
+
+  PayloadCase json = {"JSON lama", 0};
+  const int jsonSamples = 1000;
+  for (int i = 0; i < jsonSamples; i++)
+  {
+    char text[96];
+    json.bytes += snprintf(text, sizeof(text), "{\"humidity\":%.2f,\"temperature\":%.2f,\"ph\":%.2f}", humidity(random), temperature(random), ph(random));
+  }
+  json.bytes /= jsonSamples;
+
+  PayloadCase cases[2 * TELEMETRY_MAX_PROBES + 4];
+  int caseCount = 0;
+  snprintf(cases[caseCount].name, sizeof(cases[caseCount].name), "frame v1");
+  cases[caseCount++].bytes = TELEMETRY_FRAME_V1_SIZE;
+  for (uint8_t probes = 0; probes <= TELEMETRY_MAX_PROBES; probes == 0 ? probes = 1 : probes *= 2)
+  {
+    snprintf(cases[caseCount].name, sizeof(cases[caseCount].name), "frame v3, %u probe", probes);
+    cases[caseCount++].bytes = telemetryFrameSize(probes);
+  }
+  // Frame kompak; satu probe yang suhunya sama dengan rata-rata (kasus umum) tidak mengirim suhu probe
+  snprintf(cases[caseCount].name, sizeof(cases[caseCount].name), "kompak, 1 probe implisit");
+  cases[caseCount++].bytes = telemetryCompactFrameSize(1, true);
+  for (uint8_t probes = 0; probes <= TELEMETRY_MAX_PROBES; probes == 0 ? probes = 1 : probes *= 2)
+  {
+    snprintf(cases[caseCount].name, sizeof(cases[caseCount].name), "kompak, %u probe", probes);
+    cases[caseCount++].bytes = telemetryCompactFrameSize(probes);
+  }
+
+  // Batch backlog penuh dengan frame satu probe: per pembacaan jauh lebih murah karena header dan preamble dibagi
+  uint8_t batch[TELEMETRY_BATCH_MAX_SIZE];
+  size_t batchLength = beginTelemetryBatch(batch, 1);
+  uint8_t frame[TELEMETRY_FRAME_MAX_SIZE];
+  TelemetryFrame sample = makeTelemetryFrame(45.0f, 40.0f, 7.0f, TelemetryTemperatureValid | TelemetryHumidityValid | TelemetryPhValid);
+  addTelemetryProbe(sample, 0x4B00, 45.0f, true);
+  size_t frameLength = encodeTelemetryFrame(sample, frame, sizeof(frame));
+  while (addTelemetryBatchRecord(batch, sizeof(batch), batchLength, 60, frame, frameLength))
+    ;
+  uint8_t records = batch[1];
+  batchLength = finishTelemetryBatch(batch, batchLength);
+  snprintf(cases[caseCount].name, sizeof(cases[caseCount].name), "batch %u x 1 probe", records);
+  cases[caseCount++].bytes = batchLength;
+
+  printf("Time-on-air (ms) BW 125 kHz CR 4/5, header paket %d byte; kolom terakhir = penghematan vs JSON di SF12\n", LORA_HEADER_SIZE);
+  printf("%-26s %8s", "payload", "di udara");
+  for (int sf = 7; sf <= 12; sf++)
+    printf("  %6s%-2d", "SF", sf);
+  printf("  %6s\n", "hemat");
+  printRow(json, json);
+  for (int i = 0; i < caseCount; i++)
+    printRow(cases[i], json);
+  uint32_t batchUs = loraTimeOnAirUs(batchLength + LORA_HEADER_SIZE, 12, BENCH_BANDWIDTH, BENCH_CODE_DENOMINATOR);
+  uint32_t jsonUs = loraTimeOnAirUs((int)(json.bytes + 0.5) + LORA_HEADER_SIZE, 12, BENCH_BANDWIDTH, BENCH_CODE_DENOMINATOR);
+  printf("batch per pembacaan di SF12: %.1f ms (JSON %.1f ms per paket)\n", batchUs / 1000.0 / records, jsonUs / 1000.0);
+
+  // Encode + decode frame versi 3 dengan 4 probe
+  TelemetryFrame encoded = sample;
+  for (uint16_t id = 1; id < 4; id++)
+    addTelemetryProbe(encoded, 0x4B00 + id, 45.0f + id, true);
+  uint8_t buffer[TELEMETRY_FRAME_MAX_SIZE];
+  TelemetryFrame decoded;
+  unsigned long decodeErrors = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++)
+  {
+    encoded.seq = (uint16_t)i;
+    size_t length = encodeTelemetryFrame(encoded, buffer, sizeof(buffer));
+    if (!decodeTelemetryFrame(buffer, length, decoded) || decoded.seq != encoded.seq)
+      decodeErrors++;
+  }
+  auto end = std::chrono::steady_clock::now();
+  printf("encode+decode frame v3 4 probe: %.1f ns/frame (%ld iterasi, gagal %lu)\n",
+         std::chrono::duration<double, std::nano>(end - start).count() / iterations, iterations, decodeErrors);
+
+  unsigned long compactErrors = 0;
+  start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++)
+  {
+    encoded.seq = (uint16_t)i;
+    size_t length = encodeCompactTelemetryFrame(encoded, buffer, sizeof(buffer));
+    if (!decodeCompactTelemetryFrame(buffer, length, (uint8_t)i, decoded) || decoded.seq != encoded.seq)
+      compactErrors++;
+  }
+  end = std::chrono::steady_clock::now();
+  printf("encode+decode frame kompak 4 probe: %.1f ns/frame (%ld iterasi, gagal %lu)\n",
+         std::chrono::duration<double, std::nano>(end - start).count() / iterations, iterations, compactErrors);
+  decodeErrors += compactErrors;
+
+  bool ok = decodeErrors == 0;
+  for (int i = 0; i < caseCount - 1; i++) // Batch sengaja lebih panjang dari satu JSON
+  {
+    for (int sf = 7; sf <= 12; sf++)
+    {
+      if (loraTimeOnAirUs((int)cases[i].bytes + LORA_HEADER_SIZE, sf, BENCH_BANDWIDTH, BENCH_CODE_DENOMINATOR) >
+          loraTimeOnAirUs((int)(json.bytes + 0.5) + LORA_HEADER_SIZE, sf, BENCH_BANDWIDTH, BENCH_CODE_DENOMINATOR))
+        ok = false;
+    }
+  }
+  printf("%s\n", ok ? "OK" : "GAGAL");
+  return ok ? 0 : 1;
+}
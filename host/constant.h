@@ -0,0 +1,3 @@
+#pragma once
+
+// Pengganti constant.h milik project PlatformIO Receiver untuk build host.
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <esp_sleep.h>
+
+// Subset driver/rtc_io.h ESP-IDF: pull-up/pull-down pin RTC yang tetap aktif selama deep sleep.
+// Di host tidak ada pin yang mengambang, jadi cukup no-op.
+
+inline esp_err_t rtc_gpio_pullup_en(gpio_num_t gpio_num)
+{
+  (void)gpio_num;
+  return ESP_OK;
+}
+
+inline esp_err_t rtc_gpio_pullup_dis(gpio_num_t gpio_num)
+{
+  (void)gpio_num;
+  return ESP_OK;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Subset esp_err.h ESP-IDF: kode error dan ESP_ERROR_CHECK.
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_TIMEOUT 0x107
+
+#define ESP_ERROR_CHECK(x)                                            \
+  do                                                                  \
+  {                                                                   \
+    esp_err_t error = (x);                                            \
+    if (error != ESP_OK)                                              \
+    {                                                                 \
+      fprintf(stderr, "ESP_ERROR_CHECK failed: 0x%x (%s)\n", error, #x); \
+      abort();                                                        \
+    }                                                                 \
+  } while (0)
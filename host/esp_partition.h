@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Arduino.h>
+#include <esp_err.h>
+
+// Subset esp_partition.h ESP-IDF untuk log backlog transmitter.cpp (partisi data mentah, tanpa filesystem).
+// Di host partisi adalah file HOST_FLASH_FILE (default flash.bin) berukuran HOST_FLASH_SIZE dengan semantik
+// NOR flash: write hanya bisa mengubah bit 1 -> 0, erase mengembalikan satu sektor 4 KB ke 0xFF.
+
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_SIZE 0x104
+#define SPI_FLASH_SEC_SIZE 4096
+#define HOST_FLASH_SIZE (1024 * 1024)
+
+typedef enum
+{
+  ESP_PARTITION_TYPE_APP = 0x00,
+  ESP_PARTITION_TYPE_DATA = 0x01,
+} esp_partition_type_t;
+
+typedef enum
+{
+  ESP_PARTITION_SUBTYPE_DATA_NVS = 0x02,
+  ESP_PARTITION_SUBTYPE_DATA_SPIFFS = 0x82,
+  ESP_PARTITION_SUBTYPE_ANY = 0xff,
+} esp_partition_subtype_t;
+
+typedef struct
+{
+  esp_partition_type_t type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  uint32_t erase_size;
+  char label[17];
+} esp_partition_t;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label);
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size);
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size);
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size);
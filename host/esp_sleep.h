@@ -0,0 +1,25 @@
+#pragma once
+
+#include <Arduino.h>
+#include <esp_err.h>
+
+// Subset esp_sleep.h ESP-IDF untuk mode deep sleep transmitter.cpp.
+// Deep sleep di host: isi memori RTC (variabel RTC_DATA_ATTR) disimpan ke HOST_RTC_FILE, proses tidur
+// selama timer wakeup lalu menjalankan ulang dirinya sendiri (exec) dengan wakeup cause TIMER dan
+// memori RTC dipulihkan sebelum setup(). Wakeup tombol (ext0) hanya dicatat, tidak disimulasikan.
+
+typedef int gpio_num_t;
+
+typedef enum
+{
+  ESP_SLEEP_WAKEUP_UNDEFINED = 0, // Cold boot / reset, bukan bangun dari deep sleep
+  ESP_SLEEP_WAKEUP_ALL = 1,
+  ESP_SLEEP_WAKEUP_EXT0 = 2,
+  ESP_SLEEP_WAKEUP_EXT1 = 3,
+  ESP_SLEEP_WAKEUP_TIMER = 4,
+} esp_sleep_wakeup_cause_t;
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us);
+esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t gpio_num, int level);
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause();
+void esp_deep_sleep_start() __attribute__((noreturn));
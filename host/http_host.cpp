@@ -0,0 +1,205 @@
+#include <HTTPClient.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// --- WiFi ---
+int WiFiClass::hostByName(const char *hostName, IPAddress &result)
+{
+  // mDNS tidak tersedia di host build, jadi nama .local diarahkan ke HOST_SERVER_ADDR
+  const char *name = hostName;
+  size_t length = strlen(name);
+  if (length > 6 && strcmp(name + length - 6, ".local") == 0)
+  {
+    const char *override = getenv("HOST_SERVER_ADDR");
+    name = override ? override : "127.0.0.1";
+  }
+
+  addrinfo hints = {};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *found = NULL;
+  if (getaddrinfo(name, NULL, &hints, &found) != 0)
+    return 0;
+
+  result = IPAddress((uint32_t)((sockaddr_in *)found->ai_addr)->sin_addr.s_addr);
+  freeaddrinfo(found);
+  return 1;
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port)
+{
+  stop();
+
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = (uint32_t)ip;
+
+  socketFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (socketFd < 0)
+    return 0;
+  if (::connect(socketFd, (sockaddr *)&address, sizeof(address)) < 0)
+  {
+    stop();
+    return 0;
+  }
+
+  int enable = 1;
+  setsockopt(socketFd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+  return 1;
+}
+
+// Seperti WiFiClient ESP32: socket dianggap putus jika peer sudah menutupnya (recv peek mengembalikan 0)
+uint8_t WiFiClient::connected()
+{
+  if (socketFd < 0)
+    return 0;
+
+  char probe;
+  ssize_t length = recv(socketFd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+  if (length == 0 || (length < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+  {
+    stop();
+    return 0;
+  }
+  return 1;
+}
+
+void WiFiClient::stop()
+{
+  if (socketFd >= 0)
+    close(socketFd);
+  socketFd = -1;
+}
+
+// --- HTTPClient ---
+bool HTTPClient::begin(WiFiClient &wifiClient, const String &url)
+{
+  const char *prefix = "http://";
+  const char *text = url.c_str();
+  if (strncmp(text, prefix, strlen(prefix)) != 0)
+    return false;
+  text += strlen(prefix);
+
+  const char *slash = strchr(text, '/');
+  std::string authority = slash ? std::string(text, slash - text) : std::string(text);
+
+  size_t colon = authority.find(':');
+  uint16_t urlPort = (colon == std::string::npos) ? 80 : atoi(authority.c_str() + colon + 1);
+  return begin(wifiClient, String(authority.substr(0, colon)), urlPort, slash ? slash : "/");
+}
+
+bool HTTPClient::begin(WiFiClient &wifiClient, const String &hostName, uint16_t hostPort, const String &uri)
+{
+  // Ganti tujuan = koneksi lama tidak bisa dipakai lagi
+  if (client && (client != &wifiClient || !(host == hostName) || port != hostPort))
+    client->stop();
+
+  client = &wifiClient;
+  host = hostName;
+  port = hostPort;
+  path = uri;
+  headers = "";
+  return true;
+}
+
+void HTTPClient::addHeader(const String &name, const String &value)
+{
+  headers += name + ": " + value + "\r\n";
+}
+
+static bool connectClient(WiFiClient &client, const String &host, uint16_t port)
+{
+  IPAddress ip;
+  in_addr literal;
+  if (inet_pton(AF_INET, host.c_str(), &literal) == 1)
+    ip = IPAddress((uint32_t)literal.s_addr);
+  else if (!WiFi.hostByName(host.c_str(), ip))
+    return false;
+  return client.connect(ip, port);
+}
+
+// Membaca sampai header lengkap, lalu body sebanyak Content-Length (atau sampai koneksi ditutup)
+static int readResponse(int fd, std::string &raw, size_t &headerEnd, long &contentLength)
+{
+  char chunk[1024];
+  headerEnd = std::string::npos;
+  contentLength = -1;
+
+  while (true)
+  {
+    if (headerEnd != std::string::npos && contentLength >= 0 && raw.size() >= headerEnd + contentLength)
+      return 1;
+
+    // timeout 5 detik seperti HTTPClient ESP32
+    pollfd descriptor = {fd, POLLIN, 0};
+    if (poll(&descriptor, 1, 5000) <= 0)
+      return HTTPC_ERROR_READ_TIMEOUT;
+
+    ssize_t length = recv(fd, chunk, sizeof(chunk), 0);
+    if (length <= 0)
+      return headerEnd != std::string::npos ? 0 : HTTPC_ERROR_CONNECTION_LOST;
+    raw.append(chunk, length);
+
+    if (headerEnd == std::string::npos && (headerEnd = raw.find("\r\n\r\n")) != std::string::npos)
+    {
+      headerEnd += 4;
+      const char *field = strcasestr(raw.c_str(), "\r\nContent-Length:");
+      if (field && field < raw.c_str() + headerEnd)
+        contentLength = strtol(field + 17, NULL, 10);
+    }
+  }
+}
+
+int HTTPClient::POST(uint8_t *payload, size_t size)
+{
+  response = "";
+  canReuse = false;
+  if (!client)
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  if (!client->connected() && !connectClient(*client, host, port))
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+
+  String request = "POST " + path + " HTTP/1.1\r\nHost: " + host + "\r\n" + headers +
+                   "Content-Length: " + String((unsigned long)size) +
+                   (reuseConnection ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n");
+  request.concat((const char *)payload, size);
+  if (send(client->fd(), request.c_str(), request.length(), MSG_NOSIGNAL) != (ssize_t)request.length())
+  {
+    client->stop();
+    return HTTPC_ERROR_SEND_PAYLOAD_FAILED;
+  }
+
+  std::string raw;
+  size_t headerEnd;
+  long contentLength;
+  int status = readResponse(client->fd(), raw, headerEnd, contentLength);
+  int code = 0;
+  if (status < 0 || sscanf(raw.c_str(), "HTTP/%*s %d", &code) != 1)
+  {
+    client->stop();
+    return status < 0 ? status : HTTPC_ERROR_CONNECTION_LOST;
+  }
+
+  // Koneksi hanya dipakai ulang jika panjang body jelas dan server tidak meminta close
+  const char *connection = strcasestr(raw.c_str(), "\r\nConnection: close");
+  canReuse = reuseConnection && status == 1 && strncmp(raw.c_str(), "HTTP/1.1", 8) == 0 &&
+             !(connection && connection < raw.c_str() + headerEnd);
+
+  response = String(raw.substr(headerEnd));
+  return code;
+}
+
+void HTTPClient::end()
+{
+  if (client && !canReuse)
+    client->stop();
+  headers = "";
+}
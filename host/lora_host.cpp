@@ -0,0 +1,423 @@
+#include <LoRa.h>
+#include <SPI.h>
+#include "../lora_airtime.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <thread>
+
+LoRaClass LoRa;
+SPIClass SPI;
+
+#define HOST_LORA_GROUP "239.255.43.3"
+#define HOST_LORA_DEFAULT_PORT 47433
+#define HOST_LORA_NONCE_SIZE 8
+#define HOST_LORA_HEADER_SIZE 7        // Setelah nonce: SF, BW (int32 LE), daya TX, redaman jalur pengirim
+#define HOST_LORA_REFERENCE_LOSS_DB 77 // Redaman dasar: 17 dBm diterima -60 dBm seperti RSSI tetap sebelumnya
+#define HOST_LORA_SNR_MAX_DB 10.0f     // SNR SX127x jenuh sekitar +10 dB pada sinyal kuat
+
+static std::mutex radioMutex;
+
+static uint16_t mediumPort()
+{
+  const char *port = getenv("HOST_LORA_PORT");
+  return port ? atoi(port) : HOST_LORA_DEFAULT_PORT;
+}
+
+// Redaman tambahan antara radio ini dan gateway (dB), untuk menguji ADR: link = redaman dasar + milik pengirim +
+// milik penerima
+static int pathLossDb()
+{
+  const char *loss = getenv("HOST_LORA_PATH_LOSS");
+  return loss ? atoi(loss) : 0;
+}
+
+// SNR minimal demodulasi SX127x per SF (datasheet)
+static float requiredSnrDb(int spreadingFactor)
+{
+  return -7.5f - 2.5f * (spreadingFactor - 7);
+}
+
+LoRaClass::LoRaClass()
+    : socketFd(-1), receiving(false), nodeNonce(0), txLength(0), rxLength(0), rxIndex(0),
+      lastRssi(0), lastSnr(0), spreadingFactor(7), signalBandwidth(125E3), codingRate4(5),
+      txPower(17), preambleLength(8), receiveCallback(NULL), txDoneCallback(NULL)
+{
+}
+
+int LoRaClass::begin(long frequency)
+{
+  (void)frequency;
+  if (socketFd >= 0)
+    return 1;
+
+  socketFd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0); // Tidak diwariskan ke exec deep sleep
+  if (socketFd < 0)
+    return 0;
+
+  int enable = 1;
+  setsockopt(socketFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+  setsockopt(socketFd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(mediumPort());
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(socketFd, (sockaddr *)&address, sizeof(address)) < 0)
+  {
+    close(socketFd);
+    socketFd = -1;
+    return 0;
+  }
+
+  // medium radio = grup multicast di interface loopback
+  ip_mreq group = {};
+  inet_pton(AF_INET, HOST_LORA_GROUP, &group.imr_multiaddr);
+  inet_pton(AF_INET, "127.0.0.1", &group.imr_interface);
+  setsockopt(socketFd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &group, sizeof(group));
+  setsockopt(socketFd, IPPROTO_IP, IP_MULTICAST_IF, &group.imr_interface, sizeof(group.imr_interface));
+  unsigned char loop = 1;
+  setsockopt(socketFd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+
+  fcntl(socketFd, F_SETFL, fcntl(socketFd, F_GETFL) | O_NONBLOCK);
+
+  std::random_device random;
+  nodeNonce = (uint64_t)random() << 32 | random();
+  return 1;
+}
+
+void LoRaClass::end()
+{
+  if (socketFd >= 0)
+    close(socketFd);
+  socketFd = -1;
+}
+
+int LoRaClass::beginPacket(int implicitHeader)
+{
+  (void)implicitHeader;
+  idle();
+  txLength = 0;
+  return socketFd >= 0;
+}
+
+int LoRaClass::endPacket(bool async)
+{
+  (void)async;
+  if (socketFd < 0)
+    return 0;
+
+  uint8_t datagram[HOST_LORA_NONCE_SIZE + HOST_LORA_HEADER_SIZE + sizeof(txBuffer)];
+  uint8_t *header = &datagram[HOST_LORA_NONCE_SIZE];
+  memcpy(datagram, &nodeNonce, HOST_LORA_NONCE_SIZE);
+  header[0] = spreadingFactor;
+  for (int i = 0; i < 4; i++)
+    header[1 + i] = (uint32_t)signalBandwidth >> (8 * i);
+  header[5] = (uint8_t)(int8_t)txPower;
+  header[6] = (uint8_t)constrain(pathLossDb(), 0, 255);
+  memcpy(&header[HOST_LORA_HEADER_SIZE], txBuffer, txLength);
+
+  sockaddr_in group = {};
+  group.sin_family = AF_INET;
+  group.sin_port = htons(mediumPort());
+  inet_pton(AF_INET, HOST_LORA_GROUP, &group.sin_addr);
+
+  // endPacket() di library asli memblokir sampai TxDone, jadi tahan selama time-on-air paket
+  delayMicroseconds(loraTimeOnAirUs(txLength, spreadingFactor, signalBandwidth, codingRate4, preambleLength));
+
+  ssize_t sent = sendto(socketFd, datagram, HOST_LORA_NONCE_SIZE + HOST_LORA_HEADER_SIZE + txLength, 0, (sockaddr *)&group, sizeof(group));
+
+  if (txDoneCallback)
+    txDoneCallback();
+  return sent >= 0;
+}
+
+size_t LoRaClass::write(uint8_t byte)
+{
+  return write(&byte, 1);
+}
+
+size_t LoRaClass::write(const uint8_t *buffer, size_t size)
+{
+  size_t space = sizeof(txBuffer) - 1 - txLength; // payload LoRa maksimal 255 byte
+  size = size > space ? space : size;
+  memcpy(&txBuffer[txLength], buffer, size);
+  txLength += size;
+  return size;
+}
+
+// Membaca satu datagram dari medium, mengabaikan paket yang dikirim node ini sendiri. Seperti radio asli, paket
+// dengan SF atau BW berbeda tidak terdengar, dan paket yang SNR-nya di bawah batas demodulasi SF hilang.
+// HOST_LORA_RSSI memakai RSSI tetap (SNR 9.5 dB) tanpa model redaman
+bool LoRaClass::receivePacket(bool blocking)
+{
+  if (socketFd < 0)
+    return false;
+
+  uint8_t datagram[HOST_LORA_NONCE_SIZE + HOST_LORA_HEADER_SIZE + sizeof(rxBuffer)];
+  while (true)
+  {
+    if (blocking)
+    {
+      pollfd descriptor = {socketFd, POLLIN, 0};
+      if (poll(&descriptor, 1, 100) <= 0)
+        return false;
+    }
+
+    ssize_t length = recv(socketFd, datagram, sizeof(datagram), 0);
+    if (length < HOST_LORA_NONCE_SIZE + HOST_LORA_HEADER_SIZE)
+      return false;
+
+    if (memcmp(datagram, &nodeNonce, HOST_LORA_NONCE_SIZE) == 0)
+      continue;
+
+    const uint8_t *header = &datagram[HOST_LORA_NONCE_SIZE];
+    long bandwidth = 0;
+    for (int i = 0; i < 4; i++)
+      bandwidth |= (long)header[1 + i] << (8 * i);
+    if (header[0] != spreadingFactor || bandwidth != signalBandwidth)
+      continue;
+
+    const char *rssi = getenv("HOST_LORA_RSSI");
+    int packetRssi;
+    float packetSnr = 9.5f;
+    if (rssi)
+    {
+      packetRssi = atoi(rssi) - (int)(rand() % 4);
+    }
+    else
+    {
+      packetRssi = (int8_t)header[5] - HOST_LORA_REFERENCE_LOSS_DB - header[6] - pathLossDb() - (int)(rand() % 4);
+      float noiseFloorDbm = -174.0f + 10.0f * log10f((float)signalBandwidth) + 6.0f; // Noise figure SX127x ~6 dB
+      packetSnr = std::min(packetRssi - noiseFloorDbm, HOST_LORA_SNR_MAX_DB);
+      if (packetSnr < requiredSnrDb(spreadingFactor))
+        continue;
+    }
+
+    static const char *loss = getenv("HOST_LORA_LOSS"); // Persen paket yang hilang di udara, untuk menguji ARQ
+    if (loss && (int)(rand() % 100) < atoi(loss))
+      continue;
+
+    std::lock_guard<std::mutex> lock(radioMutex);
+    rxLength = length - HOST_LORA_NONCE_SIZE - HOST_LORA_HEADER_SIZE;
+    memcpy(rxBuffer, &header[HOST_LORA_HEADER_SIZE], rxLength);
+    rxIndex = 0;
+    lastRssi = packetRssi;
+    lastSnr = packetSnr;
+    return true;
+  }
+}
+
+// Membuang paket yang tiba saat radio tidak dalam mode RX (radio asli juga tidak menerimanya)
+static void drainMedium(int socketFd)
+{
+  uint8_t discard[512];
+  while (socketFd >= 0 && recv(socketFd, discard, sizeof(discard), 0) > 0)
+    ;
+}
+
+int LoRaClass::parsePacket(int size)
+{
+  (void)size;
+  if (!receiving)
+  {
+    drainMedium(socketFd);
+    receiving = true;
+  }
+
+  return receivePacket(false) ? rxLength : 0;
+}
+
+int LoRaClass::packetRssi()
+{
+  return lastRssi;
+}
+
+float LoRaClass::packetSnr()
+{
+  return lastSnr;
+}
+
+// RSSI kanal saat ini: medium UDP mengirim paket utuh di akhir time-on-air, jadi tidak ada sinyal
+// yang sedang berlangsung untuk dideteksi dan kanal selalu terbaca di noise floor
+int LoRaClass::rssi()
+{
+  return -120 - (int)(rand() % 4);
+}
+
+int LoRaClass::available()
+{
+  std::lock_guard<std::mutex> lock(radioMutex);
+  return rxLength - rxIndex;
+}
+
+int LoRaClass::read()
+{
+  std::lock_guard<std::mutex> lock(radioMutex);
+  return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1;
+}
+
+int LoRaClass::peek()
+{
+  std::lock_guard<std::mutex> lock(radioMutex);
+  return rxIndex < rxLength ? rxBuffer[rxIndex] : -1;
+}
+
+void LoRaClass::hostReadFifo(uint8_t *buffer, size_t size)
+{
+  std::lock_guard<std::mutex> lock(radioMutex);
+  size_t copied = std::min(size, rxLength - rxIndex);
+  memcpy(buffer, &rxBuffer[rxIndex], copied);
+  memset(&buffer[copied], 0, size - copied); // Di luar paket: FIFO berisi sisa lama, di sini nol
+  rxIndex += copied;
+}
+
+void LoRaClass::hostPollReceive()
+{
+  if (receiving && receiveCallback && receivePacket(true))
+  {
+    receiveCallback(rxLength);
+  }
+  else if (!receiving || !receiveCallback)
+  {
+    delay(1);
+  }
+}
+
+// Thread pengganti interrupt DIO0
+static void dio0Thread(LoRaClass *radio)
+{
+  while (true)
+    radio->hostPollReceive();
+}
+
+void LoRaClass::onReceive(void (*callback)(int))
+{
+  static bool dio0Started = false;
+  receiveCallback = callback;
+
+  if (callback && !dio0Started)
+  {
+    dio0Started = true;
+    std::thread(dio0Thread, this).detach();
+  }
+}
+
+void SPIClass::beginTransaction(SPISettings settings)
+{
+  (void)settings;
+  address = -1;
+}
+
+// Byte pertama transaksi = alamat register (bit 7 = tulis), byte berikutnya data; hanya baca REG_FIFO yang berisi
+uint8_t SPIClass::transfer(uint8_t data)
+{
+  if (address < 0)
+  {
+    address = data;
+    return 0;
+  }
+  uint8_t value;
+  transfer(&value, 1);
+  return value;
+}
+
+void SPIClass::transfer(void *data, uint32_t size)
+{
+  if (address == 0x00)
+    LoRa.hostReadFifo((uint8_t *)data, size);
+  else
+    memset(data, 0, size);
+}
+
+void LoRaClass::onTxDone(void (*callback)())
+{
+  txDoneCallback = callback;
+}
+
+void LoRaClass::receive(int size)
+{
+  (void)size;
+  if (!receiving)
+    drainMedium(socketFd);
+  receiving = true;
+}
+
+void LoRaClass::idle()
+{
+  receiving = false;
+}
+
+void LoRaClass::sleep()
+{
+  receiving = false;
+}
+
+void LoRaClass::setTxPower(int level, int outputPin)
+{
+  (void)outputPin;
+  txPower = constrain(level, 2, 20);
+}
+
+void LoRaClass::setFrequency(long frequency)
+{
+  (void)frequency;
+}
+
+void LoRaClass::setSpreadingFactor(int sf)
+{
+  spreadingFactor = constrain(sf, 6, 12);
+}
+
+void LoRaClass::setSignalBandwidth(long sbw)
+{
+  // pembulatan ke atas ke bandwidth SX127x yang valid, sama seperti library LoRa
+  static const long bandwidths[] = {7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000};
+  signalBandwidth = 500000;
+  for (long bandwidth : bandwidths)
+  {
+    if (sbw <= bandwidth)
+    {
+      signalBandwidth = bandwidth;
+      break;
+    }
+  }
+}
+
+void LoRaClass::setCodingRate4(int denominator)
+{
+  codingRate4 = constrain(denominator, 5, 8);
+}
+
+void LoRaClass::setPreambleLength(long length)
+{
+  preambleLength = length;
+}
+
+void LoRaClass::setSyncWord(int sw)
+{
+  (void)sw;
+}
+
+void LoRaClass::enableCrc()
+{
+}
+
+void LoRaClass::disableCrc()
+{
+}
+
+void LoRaClass::setPins(int ss, int reset, int dio0)
+{
+  (void)ss;
+  (void)reset;
+  (void)dio0;
+}
@@ -0,0 +1,66 @@
+// Entry point build host (Linux) untuk transmitter.cpp atau Receiver.cpp.
+//
+// Build (ArduinoJson v7 header-only harus tersedia di include path):
+//   g++ -std=c++17 -O2 -Ihost -I<ArduinoJson>/src transmitter.cpp host/*.cpp -o transmitter_host -pthread
+//   g++ -std=c++17 -O2 -Ihost -I<ArduinoJson>/src Receiver.cpp host/*.cpp -o receiver_host -pthread
+//
+// Kedua binary yang berjalan di mesin yang sama berbagi medium LoRa tersimulasi (lihat LoRa.h).
+// Environment variable:
+//   HOST_NVS_FILE     file EEPROM (default eeprom.bin), pakai file berbeda untuk tiap node
+//   HOST_ADC          nilai ADC awal, format "pin=nilai,pin=nilai" (skala 10 bit)
+//   HOST_TEMPERATURE  suhu DS18B20 tersimulasi dalam C
+//   HOST_DS18B20_PROBES jumlah probe DS18B20 di bus (default 1)
+//   HOST_LORA_PORT    port medium LoRa, HOST_LORA_RSSI nilai RSSI paket
+//   HOST_SERVER_ADDR  alamat pengganti biodrying-server.local
+//   HOST_RUN_MS       hentikan proses setelah sekian milidetik (untuk benchmark/soak test), termasuk
+//                     waktu deep sleep dan boot ulang berikutnya
+//   HOST_RTC_FILE     file memori RTC yang bertahan selama deep sleep (default rtc.bin)
+
+#include <Arduino.h>
+#include <DallasTemperature.h>
+
+void setup();
+void loop();
+
+static void loadAnalogValues()
+{
+  const char *values = getenv("HOST_ADC");
+  while (values && *values)
+  {
+    int pin, value, consumed;
+    if (sscanf(values, "%d=%d%n", &pin, &value, &consumed) != 2)
+      break;
+    hostSetAnalogValue(pin, value);
+    values += consumed;
+    if (*values == ',')
+      values++;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  hostBoot(argc, argv);
+  setvbuf(stdout, NULL, _IOLBF, 0);
+
+  // Nilai default ADC: kelembapan ~40 % (pin 34) dan pH ~7 (pin 35) sesuai kalibrasi transmitter
+  hostSetAnalogValue(34, 618);
+  hostSetAnalogValue(35, 231);
+  loadAnalogValues();
+
+  if (getenv("HOST_TEMPERATURE"))
+    DallasTemperature::hostSetTemperature(atof(getenv("HOST_TEMPERATURE")));
+  if (getenv("HOST_DS18B20_PROBES"))
+    DallasTemperature::hostSetProbeCount(atoi(getenv("HOST_DS18B20_PROBES")));
+
+  const char *runMs = getenv("HOST_RUN_MS");
+  unsigned long runUntil = runMs ? hostRunUntil(strtoul(runMs, NULL, 10)) : 0;
+
+  setup();
+  while (!runUntil || millis() < runUntil)
+  {
+    loop();
+  }
+
+  fflush(stdout);
+  return 0;
+}
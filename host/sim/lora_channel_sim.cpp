@@ -0,0 +1,1555 @@
+// Simulator kanal LoRa berbasis event untuk N transmitter yang berbagi satu Receiver.
+//
+// Build:
+//   g++ -std=c++17 -O2 -I. host/sim/lora_channel_sim.cpp -o lora_channel_sim
+//
+// Contoh:
+//   ./lora_channel_sim --nodes 16 --sf 12 --bw 125000 --cr 5 --update-rate 5000 --duration 3600
+//   ./lora_channel_sim --report-on-change 1 --trace log_transmitter.txt --trace-interval 1000
+//
+// Model:
+//  - time-on-air dari lora_airtime.h berdasarkan SF/BW/CR dan panjang payload
+//  - RSSI dari path loss log-distance 433 MHz + shadowing, paket di bawah sensitivitas hilang
+//  - tabrakan antar paket yang overlap pada SF yang sama, capture effect jika selisih daya >= 6 dB
+//  - transmitter meniru loop() di transmitter.cpp: kirim, dengar respons sampai 2000 ms,
+//    lalu tunggu updateRate; paket apapun yang terdengar menutup jendela dengar
+//  - --pipeline 1 meniru loop() yang tidak memblokir: jendela dengar per frame = time-on-air balasan +
+//    --gateway-ms + guard, siklus berikutnya mulai updateRate setelah TX selesai walaupun respons belum
+//    datang, dan respons dicocokkan lewat msgId yang dikembalikan Receiver (radio half-duplex: respons
+//    yang datang saat node sedang TX hilang). Dengan pipeline node dan Receiver sama-sama listen-before-talk:
+//    TX ditunda selama ada paket di udara yang terdengar di atas LBT_THRESHOLD_DBM
+//  - receiver meniru Receiver.cpp lama: polling parsePacket, lalu POST HTTP (blocking) dan kirim respons,
+//    selama itu radio tidak mendengar. --gateway-blocking 0 meniru Receiver.cpp sekarang: RX lewat interrupt,
+//    pembacaan dikumpulkan dalam batch (maks 8, umur 250 ms) lalu satu POST; hanya pembacaan terbaru tiap
+//    node yang dijawab, dan radio hanya tuli selama mengirim respons
+//  - --arq 1 (mengaktifkan --pipeline) meniru ARQ lora_arq.h: nomor urut 16 bit, Receiver membuang duplikat
+//    dan membalas frame ACK selektif (8 byte), transmitter mengirim ulang frame yang tidak tercakup ACK
+//    maksimal ARQ_MAX_RETRIES kali dengan backoff eksponensial yang ikut berlipat untuk setiap jendela dengar
+//    terakhir yang tidak dijawab (ArqCongestion). Dengan --gateway-blocking 0 ACK dikirim task RX begitu frame
+//    diterima; pesan hasil server setelah POST (hanya jika hasilnya berubah) tidak dimodelkan. --loss P membuang P % paket secara acak
+//    (fading/interferensi) di kedua arah. Delivery ratio = frame unik yang sampai / frame yang dibuat,
+//    goodput = byte frame telemetri unik yang sampai per detik
+//  - nilai sensor tiap sampel diambil dari trace (log Serial transmitter "hum: .. ph: .. suhu: ..",
+//    atau CSV "suhu,kelembapan,pH"), satu baris per --trace-interval ms; tiap node mulai dari posisi
+//    trace yang berbeda. Tanpa --trace dipakai profil biodrying sintetis dengan noise sensor
+//  - --report-on-change 1 menjalankan report_filter.h seperti transmitter: sampel di dalam deadband tidak
+//    dikirim, referensi diperbarui saat respons diterima. Error rekonstruksi = selisih nilai asli tiap
+//    sampel dengan nilai terakhir yang diterima Receiver (sample-and-hold)
+//  - --tdma 1 (mengaktifkan --arq) meniru MAC slot terjadwal lora_schedule.h: Receiver menyiarkan beacon setiap
+//    periode berisi slot node yang sudah terdengar, node yang mendengar beacon hanya mengirim (dan mengirim ulang)
+//    di awal slotnya menurut jam lokalnya sendiri (drift kristal ikut dimodelkan), node lain tetap ALOHA di jendela
+//    kontensi dengan backoff eksponensial antar periode. Bandingkan tabrakan dan goodput dengan --arq 1 tanpa --tdma, misalnya:
+//      ./lora_channel_sim --nodes 64 --arq 1 --gateway-blocking 0 --tdma 1
+//  - --adr 1 (mengaktifkan --arq) menjalankan lora_adr.h: Receiver mencatat SNR frame setiap node dan mengirim
+//    perintah daya/SF di belakang ACK, node menerapkannya (SF jaringan berganti bersamaan setelah semua node
+//    mengonfirmasi). --sf/--power menjadi pengaturan awal. Node dan Receiver hanya saling dengar pada SF yang sama,
+//    dan paket dengan SF berbeda tidak bertabrakan. Laporan: sebaran SF/daya akhir, airtime dan muatan TX per node
+//    (arus TX SX1278 per dBm), dibandingkan misalnya:
+//      ./lora_channel_sim --nodes 16 --arq 1 --gateway-blocking 0 --max-distance 2000 --adr 0
+//      ./lora_channel_sim --nodes 16 --arq 1 --gateway-blocking 0 --max-distance 2000 --adr 1
+//  - --check 1 memeriksa invarian dan keluar dengan status 1 jika ada yang dilanggar: dengan --arq, delivery ratio
+//    tidak boleh di bawah konfigurasi yang sama tanpa ARQ (dijalankan ulang dengan seed yang sama); dengan --adr,
+//    tidak ada node yang berakhir di SF selain SF jaringan kecuali pergantian SF pernah ditetapkan. Misalnya:
+//      ./lora_channel_sim --nodes 16 --arq 1 --gateway-blocking 0 --check 1
+//      ./lora_channel_sim --adr 1 --max-distance 2000 --check 1
+
+#include "lora_airtime.h"
+#include "telemetry_frame.h"
+#include "report_filter.h"
+#include "lora_arq.h"
+#include "lora_schedule.h"
+#include "lora_adr.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#define LORA_HEADER_SIZE 4        // destination, sender, msgId, length
+#define RESPONSE_PAYLOAD_SIZE 40  // {"classification":true,"buzzer_on":true}
+#define CAPTURE_THRESHOLD_DB 6.0f // selisih daya minimal agar paket terkuat tetap diterima
+#define RESPONSE_MAX_PACKET_SIZE 46 // Balasan JSON terpanjang untuk jendela dengar (transmitter tanpa ARQ)
+#define RESPONSE_GUARD_MS 50
+#define RESPONSE_MAX_PENDING 4
+#define LBT_THRESHOLD_DBM -100.0f    // transmitter.cpp / Receiver.cpp: RSSI kanal dianggap sibuk
+#define LBT_GUARD_MS 5
+#define GATEWAY_BATCH_SIZE 8         // UPLINK_BATCH_SIZE
+#define GATEWAY_BATCH_MAX_AGE_MS 250 // UPLINK_BATCH_MAX_AGE_MS
+#define NOISE_FIGURE_DB 6.0f         // SNR = RSSI - (-174 dBm/Hz + 10 log10(BW) + NF), sama dengan loraSensitivityDbm()
+#define SNR_MAX_DB 10.0f             // SNR SX127x jenuh pada sinyal kuat
+
+struct SimConfig
+{
+  int nodes = 1;
+  int spreadingFactor = 12;
+  float signalBandwidth = 125E3;
+  int codeDenominator = 5;
+  int txPower = 17;
+  int payloadLength = LORA_HEADER_SIZE + (int)telemetryCompactFrameSize(1, true); // Frame kompak satu probe suhu
+  double updateRateMs = 5000;
+  double responseTimeoutMs = 2000;
+  bool pipeline = false;
+  bool gatewayBlocking = true;
+  double responseGatewayMs = -1; // RESPONSE_GATEWAY_MS: 100 dengan ARQ (ACK dari task RX), 500 tanpa ARQ (respons setelah POST)
+  bool arq = false;
+  bool tdma = false;
+  bool adr = false;
+  double lossPercent = 0;
+  double serverLatencyMs = 150;
+  double serverJitterMs = 50;
+  double durationS = 3600;
+  double maxDistanceM = 300;
+  double pathLossExponent = 2.7;
+  double shadowingDb = 4.0;
+  unsigned seed = 1;
+  bool reportOnChange = false;
+  bool check = false; // --check 1: jalankan juga pembanding dan keluar dengan status 1 jika invarian dilanggar
+  double deadbandTemperature = REPORT_DEADBAND_TEMPERATURE / TELEMETRY_FIXED_SCALE;
+  double deadbandHumidity = REPORT_DEADBAND_HUMIDITY / TELEMETRY_FIXED_SCALE;
+  double deadbandPh = REPORT_DEADBAND_PH / TELEMETRY_FIXED_SCALE;
+  double heartbeatMs = REPORT_HEARTBEAT_MS;
+  std::string tracePath;
+  double traceIntervalMs = 1000; // SENSOR_LOG_PERIOD_MS
+};
+
+struct TraceSample
+{
+  float temperature;
+  float humidity;
+  float ph;
+};
+
+enum EventType
+{
+  NodeStartTx,
+  TransmissionEnd,
+  GatewayRespond,
+  NodeListenTimeout,
+  GatewayFlush,
+  NodeDeferredTx,     // TX setelah ditunda listen-before-talk, tanpa cek ulang (batas tunggu di firmware); --tdma: cek ulang setelah backoff acak
+  GatewayDeferredRespond,
+  NodeRetry,          // ARQ: backoff selesai, frame dikirim ulang
+  NodeDeferredRetry,
+  GatewayBeacon,      // TDMA: awal periode, Receiver menyusun beacon
+  GatewayBeaconTx,    // TDMA: beacon dikirim setelah respons/listen-before-talk selesai
+  NodeSlot,           // TDMA: awal slot node menurut jam lokalnya
+  GatewayAdrSwitch    // ADR: waktu ganti SF jaringan
+};
+
+struct Event
+{
+  double time;
+  EventType type;
+  int index; // node atau transmisi
+  unsigned token; // listenToken node, atau msgId/nomor urut untuk respons dan jendela dengar mode pipeline
+  unsigned long sequence; // Event dengan waktu sama diproses sesuai urutan dijadwalkan
+
+  bool operator>(const Event &other) const { return time > other.time || (time == other.time && sequence > other.sequence); }
+};
+
+struct Transmission
+{
+  int node;         // node transmitter yang terkait
+  bool fromGateway; // respons dari Receiver
+  double start;
+  double end;
+  int spreadingFactor;
+  int txPower;
+  float rssi;
+  bool collided;
+  bool gatewayListeningAtStart;
+  double generatedAt;
+  uint16_t msgId;       // msgId 8 bit, atau nomor urut ARQ
+  TelemetryFrame frame; // Frame uplink, nilai yang dipegang Receiver jika sampai
+  ArqAck ack;           // Respons ARQ
+  bool retransmission;  // Kiriman ulang ARQ, tidak memulai siklus sampel berikutnya
+  bool scheduled;       // TDMA: dikirim di slot node, siklus berikutnya dari jadwal slot
+  bool beacon;          // TDMA: beacon Receiver (isi di ChannelSimulator::airBeacon)
+  bool hasCommand;      // ADR: perintah di belakang ACK
+  AdrCommand command;
+};
+
+enum NodeState
+{
+  NodeIdle,
+  NodeTransmitting,
+  NodeListening
+};
+
+struct Node
+{
+  double distanceM;
+  double clockScale; // drift kristal
+  NodeState state = NodeIdle;
+  unsigned listenToken = 0;
+  double listenStart = 0;
+  double txEnd = 0;
+  double generatedAt = 0;
+  size_t traceOffset = 0;
+  ReportFilter filter;
+  TelemetryFrame pending = {};  // Frame yang sedang dikirim, dikonfirmasi saat respons diterima
+  TelemetryFrame held = {};     // Nilai terakhir yang diterima Receiver
+  bool receiverHasValue = false;
+  uint16_t heldSeq = 0;
+  uint8_t msgId = 0;
+  uint16_t seq = 0; // Nomor urut ARQ berikutnya
+  struct Pending // Mode pipeline: frame yang menunggu respons
+  {
+    uint16_t msgId;
+    TelemetryFrame frame;
+    double sentAt;
+    double generatedAt;
+    uint8_t attempts;
+    bool retryPending;
+  };
+  std::vector<Pending> waiting;
+  bool hasConfirmed = false;
+  uint16_t confirmedSeq = 0;
+  ArqWindow gatewayWindow; // Jendela duplikat Receiver untuk node ini
+  ScheduleSync sync;       // TDMA: slot node menurut beacon terakhir yang didengar
+  unsigned slotToken = 0;  // Event NodeSlot lama diabaikan setelah beacon baru
+  bool aloha = true;       // Siklus NodeStartTx (tanpa jadwal) sedang berjalan
+  double lastSampleAt = -1e12;
+  uint8_t contentionFailures = 0; // Kiriman di jendela kontensi yang tidak di-ACK berturut-turut
+  ArqCongestion congestion;       // Jendela dengar terakhir yang tidak dijawab (backoff kiriman ulang)
+  double contentionAt = -1;       // Saat kiriman kontensi yang sudah dipilih (tidak diundi ulang)
+  double joinUntil = -1;      // ACK diterima sebelum punya slot: tunggu beacon tanpa ALOHA sampai saat ini
+  double gatewayHeardAt = -1; // Receiver: paket terakhir node ini, -1 = tidak ada di jadwal
+  int spreadingFactor = 12;   // Pengaturan radio node (ADR: dari link)
+  int txPower = 17;
+  AdrLink link;               // ADR: status di transmitter
+  AdrNode adr;                // ADR: status node di Receiver
+  double adrHeardAt = -1;     // Receiver: frame terakhir node ini untuk keputusan ADR
+};
+
+struct ErrorStats // Selisih nilai asli dengan nilai yang dipegang Receiver
+{
+  double total = 0;
+  double max = 0;
+  unsigned long count = 0;
+
+  void add(double error)
+  {
+    error = fabs(error);
+    total += error;
+    max = std::max(max, error);
+    count++;
+  }
+  double mean() const { return count ? total / count : 0; }
+};
+
+enum GatewayState
+{
+  GatewayListening,
+  GatewayBusy,
+  GatewayTransmitting
+};
+
+struct Stats
+{
+  unsigned long uplinkSent = 0;
+  unsigned long uplinkDelivered = 0;
+  unsigned long uplinkCollided = 0;
+  unsigned long uplinkGatewayBusy = 0;
+  unsigned long uplinkWeakSignal = 0;
+  unsigned long uplinkWrongSf = 0; // ADR: Receiver sedang di SF lain
+  unsigned long responsesSent = 0;
+  unsigned long acksReceived = 0;
+  unsigned long acksMisrouted = 0;
+  unsigned long ackTimeouts = 0;
+  double airtimeMs = 0;
+  unsigned long samples = 0;
+  unsigned long suppressed = 0;
+  unsigned long heartbeats = 0;
+  unsigned long lbtDeferrals = 0; // TX ditunda karena kanal sibuk
+  unsigned long ackLate = 0; // respons untuk frame yang jendelanya sudah habis atau milik node lain
+  unsigned long lost = 0;    // paket yang dibuang --loss, kedua arah
+  unsigned long uplinkFaded = 0;
+  unsigned long arqFrames = 0;
+  unsigned long arqRetransmits = 0;
+  unsigned long arqDropped = 0;
+  unsigned long arqDuplicates = 0;
+  unsigned long arqUnique = 0; // frame unik yang sampai di Receiver
+  unsigned long beaconsSent = 0;
+  unsigned long beaconsExpected = 0; // Node tercantum di beacon yang dikirim
+  unsigned long beaconsHeard = 0;    // ... dan mendengarnya
+  unsigned long slotTx = 0;          // Kiriman di slot sendiri (termasuk kiriman ulang)
+  unsigned long unscheduledTx = 0;   // Kiriman ALOHA (belum sinkron atau di jendela kontensi)
+  double beaconAirtimeMs = 0;
+  double uplinkAirtimeMs = 0;
+  double uplinkChargeMas = 0; // Muatan TX semua node, mA x s
+  double periodTotalMs = 0;
+  std::vector<double> arqLatencyMs; // dari sampel dibuat sampai frame unik sampai di Receiver
+  ErrorStats temperatureError;
+  ErrorStats humidityError;
+  ErrorStats phError;
+  std::vector<double> uplinkLatencyMs;
+  std::vector<double> ackLatencyMs;
+};
+
+class ChannelSimulator
+{
+public:
+  ChannelSimulator(const SimConfig &config, const std::vector<TraceSample> &trace) : config(config), trace(trace), random(config.seed) {}
+
+  void run();
+  void report() const;
+  double deliveryRatio() const; // Frame unik yang sampai di Receiver / frame yang dikirim pertama kali
+  int nodesOffNetworkSf() const { return (int)std::count_if(nodes.begin(), nodes.end(), [&](const Node &n) { return n.spreadingFactor != gatewaySf; }); }
+  uint32_t sfSwitches() const { return adr.changes(); }
+
+private:
+  void schedule(double time, EventType type, int index, unsigned token = 0) { events.push({time, type, index, token, eventSequence++}); }
+  size_t traceIndex(size_t position) const;
+  float linkRssi(const Node &node, int txPower);
+  int startTransmission(int node, bool fromGateway, double now, int payloadLength, uint16_t msgId);
+  void onNodeStartTx(int node, double now);
+  void onTransmissionEnd(int id, double now);
+  void onGatewayRespond(int node, uint16_t msgId, double now, bool listen);
+  void onGatewayFlush(double now);
+  void onNodeListenTimeout(int node, unsigned token, double now);
+  void onPipelineResponse(const Transmission &tx, double now);
+  void transmitPending(int node, double now, bool listen);
+  void transmitFrame(int node, Node::Pending &pending, double now, bool retransmission);
+  void onNodeRetry(int node, uint16_t seq, double now, bool listen);
+  void onArqResponse(const Transmission &tx, double now);
+  double channelBusyUntil(double now) const;
+  void scheduleNextCycle(int node, double now);
+  double responseWindowMs(int spreadingFactor) const;
+  bool takeSample(int node, double now);
+  double lbtBackoffMs()
+  {
+    std::uniform_real_distribution<double> backoff(0.0, SCHEDULE_LBT_BACKOFF_MS);
+    return config.tdma ? backoff(random) : 0.0;
+  }
+  uint32_t localMs(const Node &n, double now) const { return (uint32_t)(now * n.clockScale); }
+  double trueMs(const Node &n, double now, uint32_t local) const { return now + (int32_t)(local - localMs(n, now)) / n.clockScale; }
+  void onGatewayBeacon(double now);
+  void sendBeacon(double now, bool listen);
+  void onBeaconEnd(const Transmission &tx, double now, bool lost);
+  void onNodeSlot(int node, unsigned token, double now);
+  bool deferToContention(int node, double now, EventType type, unsigned token);
+  void applyAdrLink(int node);
+  void serviceAdr(double now);
+  AdrNode *adrNodeAt(uint8_t node, double now) { return nodes[node].adrHeardAt >= 0 && now - nodes[node].adrHeardAt < nodes[node].adr.staleMs(REPORT_STALE_MS) ? &nodes[node].adr : NULL; }
+  uint8_t adrSilentNodes(double now) const
+  {
+    return (uint8_t)std::count_if(nodes.begin(), nodes.end(), [&](const Node &n) {
+      return n.adr.capable && n.adrHeardAt >= 0 && now - n.adrHeardAt >= n.adr.staleMs(REPORT_STALE_MS) && now - n.adrHeardAt < ADR_NODE_GONE_MS;
+    });
+  }
+
+  SimConfig config;
+  std::vector<TraceSample> trace;
+  std::mt19937 random;
+  std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+  std::vector<Node> nodes;
+  std::vector<Transmission> transmissions;
+  std::vector<int> onAir;
+  GatewayState gateway = GatewayListening;
+  double gatewayTxEnd = 0;
+  struct BatchEntry // Mode gateway non-blocking: pembacaan di batch uplink yang belum di-POST
+  {
+    int node;
+    uint16_t msgId;
+  };
+  std::vector<BatchEntry> batch;
+  unsigned batchToken = 0;
+  unsigned long eventSequence = 0;
+  ScheduleTable scheduleTable;  // TDMA: urutan slot di Receiver
+  ScheduleBeacon airBeacon = {}; // Beacon periode ini (satu beacon di udara pada satu waktu)
+  uint8_t beaconNumber = 0;
+  int gatewaySf = 12;    // SF radio Receiver (ADR: SF jaringan)
+  AdrController adr;
+  Stats stats;
+};
+
+// Trace diputar bolak-balik (maju lalu mundur) agar tidak ada lompatan nilai di ujung trace
+size_t ChannelSimulator::traceIndex(size_t position) const
+{
+  if (trace.size() < 2)
+    return 0;
+  size_t cycle = 2 * (trace.size() - 1);
+  position %= cycle;
+  return position < trace.size() ? position : cycle - position;
+}
+
+float ChannelSimulator::linkRssi(const Node &node, int txPower)
+{
+  // path loss 433 MHz: ~25.2 dB pada 1 m (free space), lalu eksponen log-distance
+  std::normal_distribution<double> shadowing(0.0, config.shadowingDb);
+  double pathLoss = 25.2 + 10.0 * config.pathLossExponent * log10(std::max(node.distanceM, 1.0));
+  return (float)(txPower - pathLoss + shadowing(random));
+}
+
+int ChannelSimulator::startTransmission(int node, bool fromGateway, double now, int payloadLength, uint16_t msgId)
+{
+  Transmission tx;
+  tx.spreadingFactor = fromGateway ? gatewaySf : nodes[node].spreadingFactor;
+  tx.txPower = fromGateway ? config.txPower : nodes[node].txPower;
+  double airtimeMs = loraTimeOnAirUs(payloadLength, tx.spreadingFactor, config.signalBandwidth, config.codeDenominator) / 1000.0;
+  tx.node = node;
+  tx.fromGateway = fromGateway;
+  tx.start = now;
+  tx.end = now + airtimeMs;
+  tx.rssi = linkRssi(nodes[node], tx.txPower);
+  tx.collided = false;
+  tx.gatewayListeningAtStart = gateway == GatewayListening;
+  tx.generatedAt = nodes[node].generatedAt;
+  tx.msgId = msgId;
+  tx.frame = nodes[node].pending;
+  tx.ack = ArqAck();
+  tx.retransmission = false;
+  tx.scheduled = false;
+  tx.beacon = false;
+  tx.hasCommand = false;
+
+  int id = transmissions.size();
+  transmissions.push_back(tx);
+
+  // overlap pada SF yang sama adalah potensi tabrakan; SF berbeda dianggap ortogonal
+  for (int other : onAir)
+  {
+    Transmission &existing = transmissions[other];
+    Transmission &incoming = transmissions[id];
+    if (existing.spreadingFactor != incoming.spreadingFactor)
+      continue;
+    if (existing.rssi - incoming.rssi >= CAPTURE_THRESHOLD_DB)
+    {
+      incoming.collided = true;
+    }
+    else if (incoming.rssi - existing.rssi >= CAPTURE_THRESHOLD_DB)
+    {
+      existing.collided = true;
+    }
+    else
+    {
+      existing.collided = true;
+      incoming.collided = true;
+    }
+  }
+
+  onAir.push_back(id);
+  stats.airtimeMs += airtimeMs;
+  if (!fromGateway)
+  {
+    // Arus TX SX1276/78 (datasheet, PA_BOOST di atas 13 dBm), interpolasi linear per dBm
+    static const float powerDbm[] = {2, 7, 13, 17, 20};
+    static const float currentMa[] = {18, 20, 29, 87, 120};
+    int k = 0;
+    while (k < 3 && tx.txPower > powerDbm[k + 1])
+      k++;
+    float fraction = std::min(1.0f, std::max(0.0f, (tx.txPower - powerDbm[k]) / (powerDbm[k + 1] - powerDbm[k])));
+    stats.uplinkAirtimeMs += airtimeMs;
+    stats.uplinkChargeMas += airtimeMs / 1000.0 * (currentMa[k] + fraction * (currentMa[k + 1] - currentMa[k]));
+  }
+  schedule(tx.end, TransmissionEnd, id);
+  return id;
+}
+
+void ChannelSimulator::onNodeStartTx(int node, double now)
+{
+  Node &n = nodes[node];
+  if (n.state == NodeTransmitting)
+  {
+    schedule(n.txEnd, NodeStartTx, node); // loop() baru berjalan lagi setelah kiriman ulang ARQ selesai
+    return;
+  }
+  if (config.tdma && n.sync.hasSlot(localMs(n, now)))
+  {
+    n.aloha = false; // Sampel berikutnya diambil di slot (onNodeSlot)
+    return;
+  }
+  if (config.tdma && !n.sync.synced(localMs(n, now)) && now < n.joinUntil)
+  {
+    schedule(n.joinUntil, NodeStartTx, node);
+    return;
+  }
+  if (config.tdma && deferToContention(node, now, NodeStartTx, 0))
+    return;
+  if (!takeSample(node, now))
+  {
+    scheduleNextCycle(node, now);
+    return;
+  }
+  if (config.tdma)
+    stats.unscheduledTx++;
+  transmitPending(node, now, true);
+}
+
+// Sampel sensor dan report filter; true jika frame (n.pending) perlu dikirim
+bool ChannelSimulator::takeSample(int node, double now)
+{
+  Node &n = nodes[node];
+  n.lastSampleAt = now;
+  const TraceSample &sample = trace[traceIndex(n.traceOffset + (size_t)(now / config.traceIntervalMs))];
+  TelemetryFrame frame = makeTelemetryFrame(sample.temperature, sample.humidity, sample.ph,
+                                            TelemetryTemperatureValid | TelemetryHumidityValid | TelemetryPhValid);
+  addTelemetryProbe(frame, 0x4B00 + node, sample.temperature, true);
+  stats.samples++;
+
+  if (n.receiverHasValue)
+  {
+    stats.temperatureError.add(sample.temperature - telemetryFromFixed(n.held.temperature));
+    stats.humidityError.add(sample.humidity - telemetryFromFixed(n.held.humidity));
+    stats.phError.add(sample.ph - telemetryFromFixed(n.held.ph));
+  }
+
+  // Deadband 0 saat report-on-change mati: setiap sampel dikirim
+  ReportReason reason = n.filter.evaluate(frame, (uint32_t)now);
+  if (reason == ReportSuppressed)
+  {
+    stats.suppressed++;
+    return false;
+  }
+  if (reason == ReportHeartbeat)
+    stats.heartbeats++;
+
+  n.pending = frame;
+  n.generatedAt = now;
+  return true;
+}
+
+// TDMA: node yang sudah mendengar beacon tapi belum punya slot hanya mengirim di jendela kontensi.
+// true jika event ditunda ke jendela kontensi berikutnya (titik acak di awal jendela)
+bool ChannelSimulator::deferToContention(int node, double now, EventType type, unsigned token)
+{
+  Node &n = nodes[node];
+  uint32_t local = localMs(n, now);
+  uint32_t holdMs = scheduleSlotMs(config.payloadLength - LORA_HEADER_SIZE, n.spreadingFactor, config.signalBandwidth, config.codeDenominator);
+  if (!n.sync.synced(local))
+    return false;
+  bool inWindow = n.sync.inContention(local, holdMs);
+  if (inWindow && fabs(now - n.contentionAt) < 1.0)
+    return false; // Waktu kirim yang dipilih sebelumnya
+  uint32_t skip = scheduleContentionSkip(n.contentionFailures, random());
+  if (inWindow && skip == 0)
+    return false;
+  if (inWindow)
+    skip--; // nextContention() sudah jendela periode berikutnya
+  uint32_t windowMs = scheduleContentionMs(n.spreadingFactor, config.signalBandwidth, config.codeDenominator);
+  std::uniform_real_distribution<double> offset(0.0, (double)(windowMs - holdMs));
+  n.contentionAt = trueMs(n, now, n.sync.nextContention(local) + skip * n.sync.periodMs()) + offset(random);
+  schedule(n.contentionAt, type, node, token);
+  return true;
+}
+
+// Listen-before-talk: akhir paket terakhir di udara yang terdengar di atas ambang, atau 0 jika kanal bebas
+double ChannelSimulator::channelBusyUntil(double now) const
+{
+  double busyUntil = 0;
+  for (int id : onAir)
+  {
+    const Transmission &other = transmissions[id];
+    if (other.rssi >= LBT_THRESHOLD_DBM && other.start < now)
+      busyUntil = std::max(busyUntil, other.end);
+  }
+  return busyUntil;
+}
+
+void ChannelSimulator::transmitPending(int node, double now, bool listen)
+{
+  Node &n = nodes[node];
+  if (config.pipeline && listen)
+  {
+    double busyUntil = channelBusyUntil(now);
+    if (busyUntil > 0)
+    {
+      stats.lbtDeferrals++;
+      schedule(busyUntil + LBT_GUARD_MS + lbtBackoffMs(), NodeDeferredTx, node);
+      return;
+    }
+  }
+
+  n.state = NodeTransmitting;
+  stats.uplinkSent++;
+  if (config.arq)
+  {
+    if (n.waiting.size() >= RESPONSE_MAX_PENDING)
+    {
+      stats.arqDropped++; // addPendingResponse(): slot tertua digantikan
+      n.waiting.erase(n.waiting.begin());
+    }
+    n.waiting.push_back({n.seq++, n.pending, now, n.generatedAt, 0, false});
+    stats.arqFrames++;
+    transmitFrame(node, n.waiting.back(), now, false);
+    return;
+  }
+
+  n.txEnd = transmissions[startTransmission(node, false, now, config.payloadLength, n.msgId)].end;
+  if (config.pipeline)
+  {
+    if (n.waiting.size() >= RESPONSE_MAX_PENDING)
+    {
+      stats.ackTimeouts++; // slot tertua digantikan
+      n.waiting.erase(n.waiting.begin());
+    }
+    n.waiting.push_back({n.msgId, n.pending, now, n.generatedAt, 0, false});
+  }
+  n.msgId++;
+}
+
+void ChannelSimulator::transmitFrame(int node, Node::Pending &pending, double now, bool retransmission)
+{
+  Node &n = nodes[node];
+  if (config.adr)
+  {
+    if (n.link.service(localMs(n, now))) // Jadwal ganti SF dari perintah sebelumnya
+      applyAdrLink(node);
+    pending.frame.flags = (pending.frame.flags & ~(TelemetryAdrCapable | TelemetryAdrCommandMask)) | n.link.frameFlags();
+  }
+  int id = startTransmission(node, false, now, config.payloadLength, pending.msgId);
+  Transmission &tx = transmissions[id];
+  tx.generatedAt = pending.generatedAt;
+  tx.frame = pending.frame;
+  tx.retransmission = retransmission;
+  pending.sentAt = now;
+  pending.retryPending = false;
+  nodes[node].txEnd = tx.end;
+}
+
+// transmitter.cpp dueRetransmission(): kiriman ulang didahulukan, tetap listen-before-talk
+void ChannelSimulator::onNodeRetry(int node, uint16_t seq, double now, bool listen)
+{
+  Node &n = nodes[node];
+  auto match = std::find_if(n.waiting.begin(), n.waiting.end(), [&](const Node::Pending &p) { return p.msgId == seq && p.retryPending; });
+  if (match == n.waiting.end())
+    return; // Sudah di-ACK atau digantikan frame baru
+  if (config.tdma && n.sync.hasSlot(localMs(n, now)))
+    return; // Kiriman ulang menunggu slot node (onNodeSlot)
+  if (config.tdma && deferToContention(node, now, NodeRetry, seq))
+    return;
+  if (n.state == NodeTransmitting)
+  {
+    schedule(n.txEnd, listen ? NodeRetry : NodeDeferredRetry, node, seq);
+    return;
+  }
+  double busyUntil = listen ? channelBusyUntil(now) : 0;
+  if (busyUntil > 0)
+  {
+    stats.lbtDeferrals++;
+    schedule(busyUntil + LBT_GUARD_MS + lbtBackoffMs(), NodeDeferredRetry, node, seq);
+    return;
+  }
+
+  n.state = NodeTransmitting;
+  match->attempts++;
+  stats.uplinkSent++;
+  stats.arqRetransmits++;
+  if (config.tdma)
+    stats.unscheduledTx++;
+  transmitFrame(node, *match, now, true);
+}
+
+// Jendela dengar transmitter.cpp (responseWindowMs()): time-on-air balasan + proses Receiver + guard
+double ChannelSimulator::responseWindowMs(int spreadingFactor) const
+{
+  int responseSize = config.adr ? LORA_HEADER_SIZE + ARQ_ACK_MAX_SIZE : config.arq ? LORA_HEADER_SIZE + ARQ_ACK_SIZE : RESPONSE_MAX_PACKET_SIZE;
+  return loraTimeOnAirUs(responseSize, spreadingFactor, config.signalBandwidth, config.codeDenominator) / 1000.0 +
+         config.responseGatewayMs + RESPONSE_GUARD_MS;
+}
+
+void ChannelSimulator::onTransmissionEnd(int id, double now)
+{
+  onAir.erase(std::find(onAir.begin(), onAir.end(), id));
+  const Transmission &tx = transmissions[id];
+  float sensitivity = loraSensitivityDbm(tx.spreadingFactor, config.signalBandwidth);
+  bool faded = false;
+  if (config.lossPercent > 0)
+  {
+    std::uniform_real_distribution<double> loss(0.0, 100.0);
+    faded = loss(random) < config.lossPercent;
+    if (faded)
+      stats.lost++;
+  }
+  bool audible = !tx.collided && !faded && tx.rssi >= sensitivity;
+
+  if (tx.beacon)
+  {
+    gateway = GatewayListening;
+    onBeaconEnd(tx, now, faded);
+    return;
+  }
+  if (tx.fromGateway)
+  {
+    gateway = GatewayListening;
+  }
+  else if (config.pipeline)
+  {
+    // Radio RX selama ada frame yang menunggu; siklus berikutnya tidak menunggu respons
+    Node &n = nodes[tx.node];
+    n.state = NodeListening;
+    n.listenStart = now;
+    schedule(now + responseWindowMs(n.spreadingFactor), NodeListenTimeout, tx.node, tx.msgId);
+    if (!tx.retransmission && !tx.scheduled)
+      scheduleNextCycle(tx.node, now);
+  }
+  else
+  {
+    nodes[tx.node].state = NodeListening;
+    nodes[tx.node].listenStart = now;
+    nodes[tx.node].listenToken++;
+    schedule(now + config.responseTimeoutMs, NodeListenTimeout, tx.node, nodes[tx.node].listenToken);
+  }
+
+  if (!tx.fromGateway)
+  {
+    // Receiver
+    if (tx.collided)
+    {
+      stats.uplinkCollided++;
+    }
+    else if (!tx.gatewayListeningAtStart || gateway != GatewayListening)
+    {
+      stats.uplinkGatewayBusy++;
+    }
+    else if (tx.spreadingFactor != gatewaySf)
+    {
+      stats.uplinkWrongSf++;
+    }
+    else if (tx.rssi < sensitivity)
+    {
+      stats.uplinkWeakSignal++;
+    }
+    else if (faded)
+    {
+      stats.uplinkFaded++;
+    }
+    else if (config.arq && !nodes[tx.node].gatewayWindow.accept(tx.msgId))
+    {
+      // Duplikat (ACK sebelumnya hilang): tidak diteruskan ke uplink, langsung dijawab ACK ulang
+      stats.uplinkDelivered++;
+      stats.arqDuplicates++;
+      schedule(now + 1, GatewayRespond, tx.node, tx.msgId);
+    }
+    else
+    {
+      Node &n = nodes[tx.node];
+      stats.uplinkDelivered++;
+      stats.uplinkLatencyMs.push_back(now - tx.generatedAt);
+      if (config.arq)
+      {
+        stats.arqUnique++;
+        stats.arqLatencyMs.push_back(now - tx.generatedAt);
+      }
+      // Kiriman ulang frame lama yang terlambat tidak menimpa nilai yang lebih baru
+      if (!config.arq || !n.receiverHasValue || (int16_t)(tx.msgId - n.heldSeq) > 0)
+      {
+        n.held = tx.frame;
+        n.heldSeq = tx.msgId;
+      }
+      n.receiverHasValue = true;
+      if (config.adr)
+      {
+        // Receiver.cpp adrOnFrame(): SNR frame unik, perintah daya dan usulan SF sebelum ACK dikirim
+        float noiseFloorDbm = -174.0f + 10.0f * log10f(config.signalBandwidth) + NOISE_FIGURE_DB;
+        bool switching = adr.switching();
+        n.adrHeardAt = now;
+        adr.onFrame(n.adr, tx.frame.flags, std::min(tx.rssi - noiseFloorDbm, SNR_MAX_DB), (uint32_t)now);
+        adr.plan((uint8_t)nodes.size(), [&](uint8_t i) { return adrNodeAt(i, now); }, (uint32_t)now, adrSilentNodes(now));
+        if (adr.switching() && !switching)
+          schedule(now + adr.msUntilSwitch((uint32_t)now), GatewayAdrSwitch, 0);
+      }
+      if (config.tdma)
+      {
+        // Receiver mencatat panjang frame telemetri node untuk slot di beacon berikutnya
+        scheduleTable.update((uint8_t)tx.node, config.payloadLength - LORA_HEADER_SIZE);
+        n.gatewayHeardAt = now;
+      }
+
+      if (config.gatewayBlocking)
+      {
+        // sendToServer() memblokir loop Receiver selama POST HTTP
+        gateway = GatewayBusy;
+        std::normal_distribution<double> latency(config.serverLatencyMs, config.serverJitterMs);
+        schedule(now + std::max(1.0, latency(random)), GatewayRespond, tx.node, tx.msgId);
+      }
+      else
+      {
+        // ARQ: task RX langsung membalas ACK begitu frame diterima, tidak menunggu batch dan POST
+        if (config.arq)
+          schedule(now + 1, GatewayRespond, tx.node, tx.msgId);
+        // Antrian uplink: batch dibuka pembacaan pertama, di-POST saat penuh atau umurnya habis
+        if (batch.empty())
+          schedule(now + GATEWAY_BATCH_MAX_AGE_MS, GatewayFlush, 0, ++batchToken);
+        batch.push_back({tx.node, tx.msgId});
+        if (batch.size() >= GATEWAY_BATCH_SIZE)
+          onGatewayFlush(now);
+      }
+    }
+  }
+
+  // Transmitter yang sedang mendengar menerima paket ini dan menutup jendela dengarnya.
+  // Penyederhanaan: status tabrakan dan RSSI link ke Receiver dipakai juga untuk link antar node.
+  if (!audible)
+    return;
+
+  if (config.pipeline)
+  {
+    if (tx.fromGateway && config.arq)
+      onArqResponse(tx, now);
+    else if (tx.fromGateway)
+      onPipelineResponse(tx, now);
+    return;
+  }
+
+  for (size_t i = 0; i < nodes.size(); i++)
+  {
+    Node &listener = nodes[i];
+
+    // paket hanya terdengar jika listener sudah dalam mode RX sebelum preamble dimulai
+    if (listener.state != NodeListening || listener.listenStart > tx.start)
+      continue;
+
+    if (tx.fromGateway && (int)i == tx.node)
+    {
+      stats.acksReceived++;
+      stats.ackLatencyMs.push_back(now - listener.generatedAt);
+    }
+    else if (tx.fromGateway)
+    {
+      stats.acksMisrouted++; // semua transmitter memakai alamat 0x01, respons node lain ikut diterima
+    }
+
+    // Respons apapun yang lolos cek alamat dianggap konfirmasi oleh transmitter, termasuk respons node lain
+    if (tx.fromGateway)
+      listener.filter.confirm(listener.pending, (uint32_t)now);
+
+    listener.listenToken++;
+    scheduleNextCycle(i, now);
+  }
+}
+
+// Mode pipeline: setiap node yang sedang RX memeriksa msgId respons terhadap frame yang ditunggunya
+void ChannelSimulator::onPipelineResponse(const Transmission &tx, double now)
+{
+  for (size_t i = 0; i < nodes.size(); i++)
+  {
+    Node &listener = nodes[i];
+    if (listener.state != NodeListening || listener.listenStart > tx.start)
+      continue;
+
+    auto match = std::find_if(listener.waiting.begin(), listener.waiting.end(), [&](const Node::Pending &p) { return p.msgId == tx.msgId; });
+    if (match == listener.waiting.end())
+    {
+      if ((int)i == tx.node)
+        stats.ackLate++;
+      continue;
+    }
+
+    if ((int)i == tx.node)
+    {
+      stats.acksReceived++;
+      stats.ackLatencyMs.push_back(now - match->sentAt);
+    }
+    else
+    {
+      stats.acksMisrouted++; // alamat sama dan msgId kebetulan sama
+    }
+    listener.filter.confirm(match->frame, (uint32_t)now);
+    listener.waiting.erase(match);
+    if (listener.waiting.empty())
+      listener.state = NodeIdle;
+  }
+}
+
+// Mode ARQ: ACK selektif menutup semua frame yang tercakup, referensi deadband hanya dari frame terbaru
+void ChannelSimulator::onArqResponse(const Transmission &tx, double now)
+{
+  for (size_t i = 0; i < nodes.size(); i++)
+  {
+    Node &listener = nodes[i];
+    if (listener.state != NodeListening || listener.listenStart > tx.start || listener.spreadingFactor != tx.spreadingFactor)
+      continue;
+
+    bool covered = false;
+    TelemetryFrame newest;
+    uint16_t newestSeq = 0;
+    for (auto p = listener.waiting.begin(); p != listener.waiting.end();)
+    {
+      if (!arqAcked(tx.ack, p->msgId))
+      {
+        ++p;
+        continue;
+      }
+      if ((int)i == tx.node)
+      {
+        stats.acksReceived++;
+        stats.ackLatencyMs.push_back(now - p->sentAt);
+      }
+      else
+      {
+        stats.acksMisrouted++; // alamat sama dan nomor urut kebetulan tercakup
+      }
+      if (!covered || (int16_t)(p->msgId - newestSeq) > 0)
+      {
+        newest = p->frame;
+        newestSeq = p->msgId;
+      }
+      covered = true;
+      p = listener.waiting.erase(p);
+    }
+    if (covered)
+    {
+      listener.contentionFailures = 0;
+      listener.congestion.onAnswered();
+    }
+    if (config.adr)
+    {
+      // transmitter.cpp: Receiver terdengar pada SF ini; perintah di ACK untuk node ini diterapkan atau disimpan
+      listener.link.onHeard();
+      if ((int)i == tx.node && tx.hasCommand && listener.link.onCommand(tx.command, localMs(listener, now)))
+        applyAdrLink(i);
+    }
+    if (covered && config.tdma && !listener.sync.hasSlot(localMs(listener, now)))
+      listener.joinUntil = now + scheduleJoinWaitMs(listener.spreadingFactor, config.signalBandwidth, config.codeDenominator);
+    if (covered && (!listener.hasConfirmed || (int16_t)(newestSeq - listener.confirmedSeq) > 0))
+    {
+      listener.filter.confirm(newest, (uint32_t)now);
+      listener.confirmedSeq = newestSeq;
+      listener.hasConfirmed = true;
+    }
+    if (!covered && (int)i == tx.node)
+      stats.ackLate++;
+    if (listener.waiting.empty())
+      listener.state = NodeIdle;
+  }
+}
+
+// Satu POST batch; setelah respons server, pembacaan terbaru tiap node dijawab berurutan
+void ChannelSimulator::onGatewayFlush(double now)
+{
+  std::normal_distribution<double> latency(config.serverLatencyMs, config.serverJitterMs);
+  double respondAt = now + std::max(1.0, latency(random));
+  for (size_t i = 0; i < batch.size(); i++)
+  {
+    bool superseded = false;
+    for (size_t j = i + 1; j < batch.size() && !superseded; j++)
+      superseded = batch[j].node == batch[i].node;
+    if (!superseded && !config.arq)
+      schedule(respondAt, GatewayRespond, batch[i].node, batch[i].msgId);
+  }
+  batch.clear();
+  batchToken++; // Event flush karena umur batch yang masih terjadwal diabaikan
+}
+
+void ChannelSimulator::onGatewayRespond(int node, uint16_t msgId, double now, bool listen)
+{
+  if (gateway == GatewayTransmitting)
+  {
+    schedule(gatewayTxEnd, listen ? GatewayRespond : GatewayDeferredRespond, node, msgId); // Respons dikirim berurutan oleh satu task
+    return;
+  }
+  double busyUntil = config.pipeline && listen ? channelBusyUntil(now) : 0;
+  if (busyUntil > 0)
+  {
+    stats.lbtDeferrals++;
+    schedule(busyUntil + LBT_GUARD_MS, GatewayDeferredRespond, node, msgId); // Jangan timpa frame yang sedang diterima
+    return;
+  }
+  gateway = GatewayTransmitting;
+  stats.responsesSent++;
+  int responseSize = config.arq ? ARQ_ACK_SIZE : RESPONSE_PAYLOAD_SIZE;
+  bool command = config.adr && nodes[node].adr.commandPending(); // Perintah ADR diulang sampai dikonfirmasi
+  if (command)
+    responseSize += ARQ_ACK_COMMAND_SIZE;
+  int id = startTransmission(node, true, now, LORA_HEADER_SIZE + responseSize, msgId);
+  if (config.arq)
+    transmissions[id].ack = nodes[node].gatewayWindow.ack(0); // Mencakup semua frame node yang sudah diterima
+  if (command)
+  {
+    transmissions[id].hasCommand = true;
+    transmissions[id].command = adr.commandFor(nodes[node].adr, (uint32_t)now);
+  }
+  gatewayTxEnd = transmissions[id].end;
+}
+
+void ChannelSimulator::onNodeListenTimeout(int node, unsigned token, double now)
+{
+  Node &n = nodes[node];
+  if (config.arq)
+  {
+    // expirePendingResponses(): jadwalkan kiriman ulang dengan backoff, atau buang setelah ARQ_MAX_RETRIES
+    auto match = std::find_if(n.waiting.begin(), n.waiting.end(), [&](const Node::Pending &p) { return p.msgId == (uint16_t)token && !p.retryPending; });
+    if (match == n.waiting.end())
+      return;
+    stats.ackTimeouts++;
+    n.congestion.onUnanswered();
+    if (config.tdma && !n.sync.hasSlot(localMs(n, now)) && n.contentionFailures < 255)
+      n.contentionFailures++;
+    if (config.adr && n.link.onUnanswered()) // Link hilang: usulan tersimpan, daya maksimum, lalu SF berikutnya
+      applyAdrLink(node);
+    if (match->attempts < ARQ_MAX_RETRIES)
+    {
+      match->retryPending = true;
+      if (!config.tdma || !n.sync.hasSlot(localMs(n, now))) // Node dengan slot mengirim ulang di slot berikutnya
+        schedule(now + n.congestion.backoffMs(match->attempts, random()), NodeRetry, node, match->msgId);
+      return;
+    }
+    stats.arqDropped++;
+    n.waiting.erase(match);
+    if (n.waiting.empty() && n.state == NodeListening)
+      n.state = NodeIdle;
+    return;
+  }
+  if (config.pipeline)
+  {
+    auto match = std::find_if(n.waiting.begin(), n.waiting.end(), [&](const Node::Pending &p) { return p.msgId == (uint8_t)token; });
+    if (match == n.waiting.end())
+      return;
+    stats.ackTimeouts++;
+    n.waiting.erase(match);
+    if (n.waiting.empty() && n.state == NodeListening)
+      n.state = NodeIdle;
+    return;
+  }
+
+  if (n.state != NodeListening || n.listenToken != token)
+    return;
+
+  stats.ackTimeouts++;
+  scheduleNextCycle(node, now);
+}
+
+void ChannelSimulator::scheduleNextCycle(int node, double now)
+{
+  Node &n = nodes[node];
+  n.state = config.pipeline && !n.waiting.empty() ? NodeListening : NodeIdle;
+
+  // loop() berjalan setiap 10 ms, jadi siklus berikutnya mulai sedikit setelah updateRate lewat
+  std::uniform_real_distribution<double> loopJitter(0.0, 10.0);
+  schedule(now + config.updateRateMs * n.clockScale + loopJitter(random), NodeStartTx, node);
+}
+
+// Awal periode: node yang tidak terdengar selama REPORT_STALE_MS keluar dari jadwal, beacon disusun dari
+// tabel slot lalu dikirim setelah respons yang sedang berjalan selesai (satu radio di Receiver)
+void ChannelSimulator::onGatewayBeacon(double now)
+{
+  uint32_t staleMs = scheduleStaleMs(schedulePeriodMs(airBeacon), REPORT_STALE_MS);
+  for (size_t i = 0; i < nodes.size(); i++)
+  {
+    if (nodes[i].gatewayHeardAt >= 0 && now - nodes[i].gatewayHeardAt > staleMs)
+    {
+      scheduleTable.remove((uint8_t)i);
+      nodes[i].gatewayHeardAt = -1;
+    }
+  }
+  scheduleTable.build(airBeacon, beaconNumber, gatewaySf, config.signalBandwidth, config.codeDenominator, SCHEDULE_MIN_PERIOD_MS);
+  if (airBeacon.count == 0)
+  {
+    schedule(now + schedulePeriodMs(airBeacon), GatewayBeacon, 0);
+    return; // Belum ada node terjadwal: tidak ada beacon, semua node ALOHA
+  }
+  beaconNumber++;
+  stats.periodTotalMs += schedulePeriodMs(airBeacon);
+  sendBeacon(now, true);
+}
+
+void ChannelSimulator::sendBeacon(double now, bool listen)
+{
+  if (gateway == GatewayTransmitting)
+  {
+    schedule(gatewayTxEnd, GatewayBeaconTx, 0, listen);
+    return;
+  }
+  double busyUntil = listen ? channelBusyUntil(now) : 0;
+  if (busyUntil > 0)
+  {
+    stats.lbtDeferrals++;
+    schedule(busyUntil + LBT_GUARD_MS, GatewayBeaconTx, 0, 0);
+    return;
+  }
+  // Periode dihitung dari awal TX beacon yang sebenarnya: node memproyeksikan beacon berikutnya dari beacon ini
+  schedule(now + schedulePeriodMs(airBeacon), GatewayBeacon, 0);
+  gateway = GatewayTransmitting;
+  stats.beaconsSent++;
+  stats.beaconsExpected += airBeacon.count;
+  int id = startTransmission(0, true, now, LORA_HEADER_SIZE + (int)scheduleBeaconSize(airBeacon.count), airBeacon.number);
+  transmissions[id].beacon = true;
+  stats.beaconAirtimeMs += transmissions[id].end - now;
+  gatewayTxEnd = transmissions[id].end;
+}
+
+// Beacon selesai: node yang radionya RX di awal beacon (tidak sedang TX) dan sinyalnya cukup menyinkronkan jadwal
+void ChannelSimulator::onBeaconEnd(const Transmission &tx, double now, bool lost)
+{
+  float sensitivity = loraSensitivityDbm(tx.spreadingFactor, config.signalBandwidth);
+  int beaconSize = LORA_HEADER_SIZE + (int)scheduleBeaconSize(airBeacon.count);
+  uint32_t beaconMs = scheduleAirtimeMs(beaconSize, tx.spreadingFactor, config.signalBandwidth, config.codeDenominator);
+  uint32_t maxBeaconMs = scheduleAirtimeMs(LORA_HEADER_SIZE + SCHEDULE_BEACON_MAX_SIZE, tx.spreadingFactor, config.signalBandwidth,
+                                           config.codeDenominator);
+  for (size_t i = 0; i < nodes.size(); i++)
+  {
+    Node &n = nodes[i];
+    bool listed = false;
+    for (uint8_t s = 0; s < airBeacon.count && !listed; s++)
+      listed = airBeacon.slots[s].address == (uint8_t)i;
+    uint32_t localStart = localMs(n, tx.start);
+    bool listening = n.txEnd <= tx.start && n.sync.listenForBeacon(localStart, maxBeaconMs);
+    if (tx.collided || lost || !listening || n.spreadingFactor != tx.spreadingFactor || linkRssi(n, tx.txPower) < sensitivity)
+      continue;
+    if (listed)
+      stats.beaconsHeard++;
+    if (config.adr)
+      n.link.onHeard();
+
+    n.sync.onBeacon(airBeacon, (uint8_t)i, localMs(n, now), beaconMs);
+    n.slotToken++;
+    uint32_t local = localMs(n, now);
+    if (n.sync.hasSlot(local))
+    {
+      std::uniform_real_distribution<double> loopJitter(0.0, 10.0);
+      schedule(trueMs(n, now, n.sync.nextSlot(local)) + loopJitter(random), NodeSlot, i, n.slotToken);
+    }
+    else if (!n.aloha)
+    {
+      n.aloha = true; // Tidak tercantum lagi: kembali ke siklus tanpa jadwal di jendela kontensi
+      schedule(now + 10.0, NodeStartTx, i);
+    }
+  }
+}
+
+// Awal slot node: kiriman ulang didahulukan, sampel baru jika sudah updateRate sejak sampel terakhir
+// (toleransi setengah periode agar tidak melompati slot karena jitter), tanpa listen-before-talk
+void ChannelSimulator::onNodeSlot(int node, unsigned token, double now)
+{
+  Node &n = nodes[node];
+  if (token != n.slotToken)
+    return;
+  uint32_t local = localMs(n, now);
+  if (!n.sync.hasSlot(local))
+  {
+    if (!n.aloha)
+    {
+      n.aloha = true; // Beacon terlalu lama tidak terdengar: kembali tanpa jadwal
+      schedule(now, NodeStartTx, node);
+    }
+    return;
+  }
+  std::uniform_real_distribution<double> loopJitter(0.0, 10.0);
+  schedule(trueMs(n, now, n.sync.nextSlot(local + SCHEDULE_GUARD_MS)) + loopJitter(random), NodeSlot, node, token);
+  if (n.state == NodeTransmitting || !n.sync.slotUsable(local))
+    return; // Beacon periode ini terlewat saat jadwal belum stabil: lewati slot, tanpa ALOHA
+
+  auto retry = std::find_if(n.waiting.begin(), n.waiting.end(), [](const Node::Pending &p) { return p.retryPending; });
+  if (retry != n.waiting.end())
+  {
+    n.state = NodeTransmitting;
+    retry->attempts++;
+    stats.uplinkSent++;
+    stats.arqRetransmits++;
+    stats.slotTx++;
+    transmitFrame(node, *retry, now, true);
+    return;
+  }
+
+  double periodMs = n.sync.periodMs() / n.clockScale;
+  if (now - n.lastSampleAt < config.updateRateMs * n.clockScale - periodMs / 2 || !takeSample(node, now))
+    return;
+  stats.slotTx++;
+  transmitPending(node, now, false);
+  transmissions.back().scheduled = true;
+}
+
+// transmitter.cpp applyAdrSettings(): pengaturan radio dari link, slot TDMA lama tidak berlaku di SF lain
+void ChannelSimulator::applyAdrLink(int node)
+{
+  Node &n = nodes[node];
+  if (config.tdma && n.link.spreadingFactor != n.spreadingFactor)
+    n.sync.reset();
+  n.spreadingFactor = n.link.spreadingFactor;
+  n.txPower = n.link.txPower;
+}
+
+// Receiver.cpp serviceAdrSwitch(): radio Receiver pindah ke SF jaringan baru
+void ChannelSimulator::serviceAdr(double now)
+{
+  if (adr.service((uint8_t)nodes.size(), [&](uint8_t i) { return adrNodeAt(i, now); }, (uint32_t)now))
+    gatewaySf = adr.spreadingFactor();
+}
+
+void ChannelSimulator::run()
+{
+  std::uniform_real_distribution<double> distance(10.0, config.maxDistanceM);
+  std::uniform_real_distribution<double> drift(-20e-6, 20e-6);
+  std::uniform_real_distribution<double> phase(0.0, config.updateRateMs);
+  ReportDeadband deadband = {0, 0, 0, 0};
+  if (config.reportOnChange)
+    deadband = {telemetryToFixed(config.deadbandTemperature), telemetryToFixed(config.deadbandHumidity), telemetryToFixed(config.deadbandPh),
+                (uint32_t)config.heartbeatMs};
+
+  for (int i = 0; i < config.nodes; i++)
+  {
+    Node node;
+    node.distanceM = distance(random);
+    node.clockScale = 1.0 + drift(random);
+    node.traceOffset = trace.size() * i / config.nodes;
+    node.filter.begin(deadband);
+    node.gatewayWindow.reset();
+    node.sync.reset();
+    node.congestion.reset();
+    node.spreadingFactor = config.spreadingFactor;
+    node.txPower = config.txPower;
+    node.link.begin(config.spreadingFactor, config.txPower);
+    node.adr.reset();
+    if (config.arq)
+      node.seq = (uint16_t)random(); // arqSeq acak saat cold boot
+    nodes.push_back(node);
+    schedule(phase(random), NodeStartTx, i);
+  }
+  scheduleTable.reset();
+  gatewaySf = config.spreadingFactor;
+  adr.begin(config.spreadingFactor);
+  if (config.tdma)
+    schedule(phase(random), GatewayBeacon, 0);
+
+  double endTime = config.durationS * 1000.0;
+  while (!events.empty() && events.top().time < endTime)
+  {
+    Event event = events.top();
+    events.pop();
+
+    switch (event.type)
+    {
+    case NodeStartTx:
+      onNodeStartTx(event.index, event.time);
+      break;
+    case TransmissionEnd:
+      onTransmissionEnd(event.index, event.time);
+      break;
+    case GatewayRespond:
+      onGatewayRespond(event.index, (uint16_t)event.token, event.time, true);
+      break;
+    case GatewayDeferredRespond:
+      onGatewayRespond(event.index, (uint16_t)event.token, event.time, false);
+      break;
+    case NodeRetry:
+      onNodeRetry(event.index, (uint16_t)event.token, event.time, true);
+      break;
+    case NodeDeferredRetry:
+      onNodeRetry(event.index, (uint16_t)event.token, event.time, config.tdma);
+      break;
+    case NodeListenTimeout:
+      onNodeListenTimeout(event.index, event.token, event.time);
+      break;
+    case NodeDeferredTx:
+      transmitPending(event.index, event.time, config.tdma);
+      break;
+    case GatewayFlush:
+      if (event.token == batchToken)
+        onGatewayFlush(event.time);
+      break;
+    case GatewayBeacon:
+      onGatewayBeacon(event.time);
+      break;
+    case GatewayBeaconTx:
+      sendBeacon(event.time, event.token != 0);
+      break;
+    case NodeSlot:
+      onNodeSlot(event.index, event.token, event.time);
+      break;
+    case GatewayAdrSwitch:
+      serviceAdr(event.time);
+      break;
+    }
+  }
+}
+
+double ChannelSimulator::deliveryRatio() const
+{
+  if (config.arq)
+    return (double)stats.arqUnique / std::max(1UL, stats.arqFrames);
+  return (double)stats.uplinkDelivered / std::max(1UL, stats.uplinkSent);
+}
+
+static double percentile(std::vector<double> values, double p)
+{
+  if (values.empty())
+    return 0;
+  std::sort(values.begin(), values.end());
+  size_t index = std::min(values.size() - 1, (size_t)(p * (values.size() - 1) + 0.5));
+  return values[index];
+}
+
+static double mean(const std::vector<double> &values)
+{
+  double sum = 0;
+  for (double v : values)
+    sum += v;
+  return values.empty() ? 0 : sum / values.size();
+}
+
+void ChannelSimulator::report() const
+{
+  double uplinkAirtimeMs = loraTimeOnAirUs(config.payloadLength, config.spreadingFactor, config.signalBandwidth, config.codeDenominator) / 1000.0;
+  double sent = std::max(1UL, stats.uplinkSent);
+
+  printf("nodes=%d SF%d BW%.1fkHz CR4/%d payload=%dB airtime=%.1fms updateRate=%.0fms duration=%.0fs\n",
+         config.nodes, config.spreadingFactor, config.signalBandwidth / 1000.0, config.codeDenominator,
+         config.payloadLength, uplinkAirtimeMs, config.updateRateMs, config.durationS);
+  printf("  receiver             %s\n", config.gatewayBlocking ? "POST blocking per paket" : "antrian + batch uplink, tuli hanya saat TX respons");
+  if (config.pipeline)
+    printf("  pipeline             jendela dengar %.0f ms per frame, maks %d frame menunggu\n", responseWindowMs(config.spreadingFactor),
+           RESPONSE_MAX_PENDING);
+  else
+    printf("  blocking listen      %.0f ms\n", config.responseTimeoutMs);
+  if (config.reportOnChange)
+    printf("  report-on-change     deadband %.2f C / %.2f %% / pH %.2f, heartbeat %.0f ms\n", config.deadbandTemperature,
+           config.deadbandHumidity, config.deadbandPh, config.heartbeatMs);
+  printf("  samples              %8lu, suppressed %lu (%.1f %%), heartbeat %lu\n", stats.samples, stats.suppressed,
+         100.0 * stats.suppressed / std::max(1UL, stats.samples), stats.heartbeats);
+  printf("  uplink sent          %8lu\n", stats.uplinkSent);
+  printf("  delivered            %8lu (%.1f %%)  %.3f pkt/s\n", stats.uplinkDelivered, 100.0 * stats.uplinkDelivered / sent, stats.uplinkDelivered / config.durationS);
+  printf("  collided             %8lu (%.1f %%)\n", stats.uplinkCollided, 100.0 * stats.uplinkCollided / sent);
+  printf("  lost, gateway busy   %8lu (%.1f %%)\n", stats.uplinkGatewayBusy, 100.0 * stats.uplinkGatewayBusy / sent);
+  printf("  lost, weak signal    %8lu (%.1f %%)\n", stats.uplinkWeakSignal, 100.0 * stats.uplinkWeakSignal / sent);
+  if (config.adr)
+    printf("  lost, receiver on other SF %lu (%.1f %%)\n", stats.uplinkWrongSf, 100.0 * stats.uplinkWrongSf / sent);
+  printf("  acks ok / misrouted / timeout / late  %lu / %lu / %lu / %lu\n", stats.acksReceived, stats.acksMisrouted, stats.ackTimeouts,
+         stats.ackLate);
+  if (config.pipeline)
+    printf("  listen-before-talk   %lu penundaan\n", stats.lbtDeferrals);
+  if (config.lossPercent > 0)
+    printf("  random loss          %.1f %%, %lu paket dibuang (uplink %lu)\n", config.lossPercent, stats.lost, stats.uplinkFaded);
+  if (config.arq)
+  {
+    double frames = std::max(1UL, stats.arqFrames);
+    printf("  arq frames           %8lu, kirim ulang %lu (%.2f per frame), hilang %lu, duplikat dibuang %lu\n", stats.arqFrames,
+           stats.arqRetransmits, stats.arqRetransmits / frames, stats.arqDropped, stats.arqDuplicates);
+    printf("  delivery ratio       %8.2f %% frame unik sampai di Receiver\n", 100.0 * stats.arqUnique / frames);
+    printf("  goodput              %8.1f B/s frame unik (%.1f frame/min/node), efisiensi %.1f %% dari uplink terkirim\n",
+           stats.arqUnique * (config.payloadLength - LORA_HEADER_SIZE) / config.durationS, stats.arqUnique / (config.durationS / 60.0) / config.nodes,
+           100.0 * stats.arqUnique / sent);
+    printf("  arq latency ms       mean %.1f  p95 %.1f  (sampel dibuat sampai frame unik diterima)\n", mean(stats.arqLatencyMs),
+           percentile(stats.arqLatencyMs, 0.95));
+  }
+  if (config.tdma)
+  {
+    int synced = 0;
+    for (const Node &n : nodes)
+      synced += n.sync.hasSlot(localMs(n, config.durationS * 1000.0)) ? 1 : 0;
+    double beacons = std::max(1UL, stats.beaconsSent);
+    printf("  tdma beacon          %8lu, periode rata-rata %.0f ms, airtime beacon %.1f %%, didengar node terjadwal %.1f %%\n",
+           stats.beaconsSent, stats.periodTotalMs / beacons, 100.0 * stats.beaconAirtimeMs / (config.durationS * 1000.0),
+           100.0 * stats.beaconsHeard / std::max(1UL, stats.beaconsExpected));
+    printf("  tdma kiriman         %8lu di slot, %lu tanpa jadwal (ALOHA/kontensi), node punya slot di akhir %d/%d\n", stats.slotTx,
+           stats.unscheduledTx, synced, config.nodes);
+  }
+  if (config.adr)
+  {
+    int perSf[ADR_SF_MAX + 1] = {};
+    double power = 0;
+    unsigned long fallbacks = 0;
+    for (const Node &n : nodes)
+    {
+      perSf[std::min(std::max(n.spreadingFactor, 0), ADR_SF_MAX)]++;
+      power += n.txPower;
+      fallbacks += n.link.fallbacks;
+    }
+    printf("  adr                  SF jaringan akhir SF%d, %lu pergantian SF, %lu perintah daya, fallback link %lu\n", gatewaySf,
+           (unsigned long)adr.changes(), (unsigned long)adr.commands(), fallbacks);
+    printf("  adr node akhir       daya rata-rata %.1f dBm, SF:", power / config.nodes);
+    for (int sf = ADR_SF_MIN; sf <= ADR_SF_MAX; sf++)
+      if (perSf[sf] > 0)
+        printf(" SF%d=%d", sf, perSf[sf]);
+    printf("\n");
+  }
+  double minutes = config.durationS / 60.0 * config.nodes;
+  printf("  readings/min/node    sampled %.1f  sent %.1f  delivered %.1f  acked %.1f\n", stats.samples / minutes, stats.uplinkSent / minutes,
+         stats.uplinkDelivered / minutes, stats.acksReceived / minutes);
+  printf("  offered channel load %8.1f %%\n", 100.0 * stats.airtimeMs / (config.durationS * 1000.0));
+  printf("  uplink airtime/node  %8.1f s/h, muatan TX %.3f mAh/h (SF%d %d dBm: %.1f ms per frame)\n",
+         stats.uplinkAirtimeMs / 1000.0 / config.nodes / (config.durationS / 3600.0),
+         stats.uplinkChargeMas / 3600.0 / config.nodes / (config.durationS / 3600.0), config.spreadingFactor, config.txPower, uplinkAirtimeMs);
+  printf("  held error mean/max  T %.3f/%.2f C  H %.3f/%.2f %%  pH %.4f/%.3f\n", stats.temperatureError.mean(), stats.temperatureError.max,
+         stats.humidityError.mean(), stats.humidityError.max, stats.phError.mean(), stats.phError.max);
+  printf("  uplink latency ms    mean %.1f  p95 %.1f\n", mean(stats.uplinkLatencyMs), percentile(stats.uplinkLatencyMs, 0.95));
+  printf("  end-to-end ack ms    mean %.1f  p95 %.1f\n", mean(stats.ackLatencyMs), percentile(stats.ackLatencyMs, 0.95));
+}
+
+// Trace rekaman: log Serial transmitter (sensorLogJob) atau CSV suhu,kelembapan,pH; baris lain diabaikan
+static std::vector<TraceSample> loadTrace(const char *path)
+{
+  std::vector<TraceSample> trace;
+  FILE *file = fopen(path, "r");
+  if (!file)
+  {
+    perror(path);
+    exit(1);
+  }
+
+  char line[256];
+  while (fgets(line, sizeof(line), file))
+  {
+    TraceSample sample;
+    const char *log = strstr(line, "hum:");
+    if (log && sscanf(log, "hum: %f htest: %*f phAdc: %*d ph: %f suhu: %f", &sample.humidity, &sample.ph, &sample.temperature) == 3)
+      trace.push_back(sample);
+    else if (sscanf(line, "%f,%f,%f", &sample.temperature, &sample.humidity, &sample.ph) == 3)
+      trace.push_back(sample);
+  }
+  fclose(file);
+  return trace;
+}
+
+// Profil biodrying sintetis: suhu naik ke fase termofilik lalu turun, kelembapan turun eksponensial,
+// pH naik perlahan; ditambah noise sensor setelah filter (DS18B20 12 bit, burst ADC trimmed mean)
+static std::vector<TraceSample> syntheticTrace(const SimConfig &config)
+{
+  std::mt19937 noise(config.seed + 1);
+  std::normal_distribution<float> temperatureNoise(0.0f, 0.06f);
+  std::normal_distribution<float> humidityNoise(0.0f, 0.15f);
+  std::normal_distribution<float> phNoise(0.0f, 0.01f);
+
+  size_t count = (size_t)(config.durationS * 1000.0 / config.traceIntervalMs) + 1;
+  std::vector<TraceSample> trace(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    double hours = i * config.traceIntervalMs / 3600000.0;
+    double temperature = 30.0 + 35.0 * (1.0 - exp(-hours / 6.0)) * exp(-hours / 72.0);
+    trace[i].temperature = roundf((float)(temperature + temperatureNoise(noise)) * 16.0f) / 16.0f; // resolusi 0.0625 C
+    trace[i].humidity = (float)(35.0 + 35.0 * exp(-hours / 48.0)) + humidityNoise(noise);
+    trace[i].ph = (float)(6.5 + 0.02 * hours) + phNoise(noise);
+  }
+  return trace;
+}
+
+static void usage()
+{
+  printf("usage: lora_channel_sim [--nodes N] [--sf 7..12] [--bw Hz] [--cr 5..8] [--power dBm]\n"
+         "                        [--payload bytes] [--update-rate ms] [--response-timeout ms]\n"
+         "                        [--pipeline 0|1] [--arq 0|1] [--tdma 0|1] [--adr 0|1] [--check 0|1] [--loss %%] [--gateway-ms ms] [--gateway-blocking 0|1]\n"
+         "                        [--server-ms ms] [--duration s] [--max-distance m] [--seed n]\n"
+         "                        [--report-on-change 0|1] [--deadband-temp C] [--deadband-hum %%]\n"
+         "                        [--deadband-ph pH] [--heartbeat ms] [--trace file] [--trace-interval ms]\n");
+}
+
+int main(int argc, char **argv)
+{
+  SimConfig config;
+
+  for (int i = 1; i < argc; i++)
+  {
+    std::string option = argv[i];
+    if (option == "--help" || i + 1 >= argc)
+    {
+      usage();
+      return option == "--help" ? 0 : 1;
+    }
+
+    if (option == "--trace")
+    {
+      config.tracePath = argv[++i];
+      continue;
+    }
+
+    double value = atof(argv[++i]);
+    if (option == "--nodes")
+      config.nodes = (int)value;
+    else if (option == "--sf")
+      config.spreadingFactor = (int)value;
+    else if (option == "--bw")
+      config.signalBandwidth = (float)value;
+    else if (option == "--cr")
+      config.codeDenominator = (int)value;
+    else if (option == "--power")
+      config.txPower = (int)value;
+    else if (option == "--payload")
+      config.payloadLength = (int)value;
+    else if (option == "--update-rate")
+      config.updateRateMs = value;
+    else if (option == "--response-timeout")
+      config.responseTimeoutMs = value;
+    else if (option == "--pipeline")
+      config.pipeline = value != 0;
+    else if (option == "--arq")
+      config.arq = value != 0;
+    else if (option == "--tdma")
+      config.tdma = value != 0;
+    else if (option == "--adr")
+      config.adr = value != 0;
+    else if (option == "--check")
+      config.check = value != 0;
+    else if (option == "--loss")
+      config.lossPercent = value;
+    else if (option == "--gateway-blocking")
+      config.gatewayBlocking = value != 0;
+    else if (option == "--gateway-ms")
+      config.responseGatewayMs = value;
+    else if (option == "--server-ms")
+      config.serverLatencyMs = value;
+    else if (option == "--duration")
+      config.durationS = value;
+    else if (option == "--max-distance")
+      config.maxDistanceM = value;
+    else if (option == "--seed")
+      config.seed = (unsigned)value;
+    else if (option == "--report-on-change")
+      config.reportOnChange = value != 0;
+    else if (option == "--deadband-temp")
+      config.deadbandTemperature = value;
+    else if (option == "--deadband-hum")
+      config.deadbandHumidity = value;
+    else if (option == "--deadband-ph")
+      config.deadbandPh = value;
+    else if (option == "--heartbeat")
+      config.heartbeatMs = value;
+    else if (option == "--trace-interval")
+      config.traceIntervalMs = value;
+    else
+    {
+      usage();
+      return 1;
+    }
+  }
+
+  if (config.tdma || config.adr)
+    config.arq = true; // Slot beacon dan perintah ADR hanya untuk transmitter dengan ARQ (ACK)
+  if (config.arq)
+    config.pipeline = true; // ARQ transmitter.cpp selalu memakai loop pipeline
+  if (config.responseGatewayMs < 0)
+    config.responseGatewayMs = config.arq ? 100 : 500;
+
+  std::vector<TraceSample> trace = config.tracePath.empty() ? syntheticTrace(config) : loadTrace(config.tracePath.c_str());
+  if (trace.empty())
+  {
+    fprintf(stderr, "Trace kosong\n");
+    return 1;
+  }
+
+  ChannelSimulator simulator(config, trace);
+  simulator.run();
+  simulator.report();
+  if (!config.check)
+    return 0;
+
+  bool ok = true;
+  if (config.arq)
+  {
+    // ARQ menambah kiriman ulang dan ACK di kanal yang sama: di kanal jenuh hasilnya tidak boleh lebih buruk
+    // dari transmitter tanpa ARQ
+    SimConfig baselineConfig = config;
+    baselineConfig.arq = baselineConfig.tdma = baselineConfig.adr = false;
+    baselineConfig.responseGatewayMs = 500;
+    ChannelSimulator baseline(baselineConfig, trace);
+    baseline.run();
+    bool arqOk = simulator.deliveryRatio() >= baseline.deliveryRatio();
+    printf("  check arq            delivery %.2f %% vs tanpa ARQ %.2f %%: %s\n", 100.0 * simulator.deliveryRatio(),
+           100.0 * baseline.deliveryRatio(), arqOk ? "OK" : "GAGAL");
+    ok = ok && arqOk;
+  }
+  if (config.adr)
+  {
+    // Pencarian SF saat link hilang tidak boleh meninggalkan node di SF yang tidak pernah dipakai Receiver
+    bool adrOk = simulator.nodesOffNetworkSf() == 0 || simulator.sfSwitches() > 0;
+    printf("  check adr            %d node di luar SF jaringan, %lu pergantian SF: %s\n", simulator.nodesOffNetworkSf(),
+           (unsigned long)simulator.sfSwitches(), adrOk ? "OK" : "GAGAL");
+    ok = ok && adrOk;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,401 @@
+// Soak test jalur JSON Receiver dan transmitter: ratusan ribu pesan lewat JsonDocument di arena statis
+// (json_arena.h, ukuran dari uplink_json.h yang juga dipakai Receiver.cpp) dibandingkan allocator heap biasa (perilaku
+// lama, setara DefaultAllocator ArduinoJson). Setiap pesan meniru satu putaran firmware:
+//  - body POST batch ke buffer tetap: batch live 1..UPLINK_BATCH_SIZE pembacaan bergantian dengan batch replay
+//    spool SPOOL_REPLAY_BATCH pembacaan, 0..TELEMETRY_MAX_PROBES probe; setiap pesan ke-WORST_CASE_EVERY memakai
+//    batch terbesar dengan semua field terisi nilai terpanjang (batas UPLINK_JSON_MAX_SIZE / UPLINK_JSON_SLOTS)
+//  - parse respons server {"results":[...]} satu hasil per pembacaan, dibaca dari Stream seperti http.getStream()
+//  - respons JSON LoRa lama {"classification":..,"buzzer_on":..} ke buffer tetap, lalu di-parse seperti transmitter
+//  - parse payload JSON transmitter lama {"humidity":..,"temperature":..,"ph":..}
+//
+// Build & jalankan (dari root repo, ArduinoJson v7 header-only harus tersedia di include path):
+//   g++ -std=c++17 -O2 -I. -Ihost -I<ArduinoJson>/src host/test/json_soak_test.cpp host/arduino_host.cpp -o json_soak_test -pthread
+//   ./json_soak_test [jumlah_pesan] [seed]
+//
+// malloc/realloc/calloc/free proses diganti pembungkus __libc_* glibc yang menghitung alokasi dan byte heap
+// hidup (malloc_usable_size), termasuk operator new. Setelah pemanasan (stdout, statik pertama) jalur arena
+// tidak boleh mengalokasikan sama sekali dan puncak heap harus datar di setiap titik pemeriksaan. Keluaran
+// JSON kedua jalur dibandingkan lewat checksum. Keluar dengan status 1 jika ada pelanggaran, termasuk batch
+// terbesar yang tidak muat di buffer atau arena.
+//
+// Catatan: test ini belum pernah dijalankan dengan ArduinoJson asli, hanya dikompilasi dengan tiruan ArduinoJson
+// untuk host yang menyimpan dokumen di heap (std::string/std::vector), sehingga dengan tiruan itu jalur arena
+// pasti melanggar dan test keluar dengan status 1. Hasilnya baru bermakna dengan ArduinoJson v7 asli.
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "json_arena.h"
+#include "telemetry_frame.h"
+#include "uplink_json.h"
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#define WARMUP_MESSAGES 1000
+#define CHECKPOINTS 10
+#define WORST_CASE_EVERY 64
+
+// Penghitung heap (proses single-thread)
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *pointer, size_t size);
+extern "C" void __libc_free(void *pointer);
+
+static unsigned long heapAllocations = 0;
+static long heapLiveBytes = 0;
+static long heapPeakBytes = 0;
+
+static void *countAllocation(void *pointer, long previousBytes)
+{
+  if (pointer == NULL)
+    return NULL;
+  heapAllocations++;
+  heapLiveBytes += (long)malloc_usable_size(pointer) - previousBytes;
+  if (heapLiveBytes > heapPeakBytes)
+    heapPeakBytes = heapLiveBytes;
+  return pointer;
+}
+
+extern "C" void *malloc(size_t size) { return countAllocation(__libc_malloc(size), 0); }
+extern "C" void *calloc(size_t count, size_t size) { return countAllocation(__libc_calloc(count, size), 0); }
+
+extern "C" void *realloc(void *pointer, size_t size)
+{
+  long previousBytes = pointer ? (long)malloc_usable_size(pointer) : 0;
+  void *moved = __libc_realloc(pointer, size);
+  if (moved == NULL)
+    return NULL;
+  return countAllocation(moved, previousBytes);
+}
+
+extern "C" void free(void *pointer)
+{
+  if (pointer == NULL)
+    return;
+  heapLiveBytes -= (long)malloc_usable_size(pointer);
+  __libc_free(pointer);
+}
+
+// Perilaku lama: setiap JsonDocument mengambil pool dan string dari heap
+class HeapAllocator : public ArduinoJson::Allocator
+{
+public:
+  void *allocate(size_t size) override { return malloc(size); }
+  void deallocate(void *pointer) override { free(pointer); }
+  void *reallocate(void *pointer, size_t size) override { return realloc(pointer, size); }
+};
+
+// Body respons di buffer tetap sebagai Stream, pengganti socket di balik http.getStream()
+class TextStream : public Stream
+{
+public:
+  TextStream(const char *text, size_t length) : text(text), length(length) {}
+  int available() override { return (int)(length - position); }
+  int read() override { return position < length ? (uint8_t)text[position++] : -1; }
+  int peek() override { return position < length ? (uint8_t)text[position] : -1; }
+  size_t write(uint8_t c) override
+  {
+    (void)c;
+    return 0;
+  }
+
+private:
+  const char *text;
+  size_t length;
+  size_t position = 0;
+};
+
+// Subset SensorReading yang masuk ke body uplink
+struct TestReading
+{
+  float temperature, temperatureMin, temperatureMax, humidity, ph;
+  uint8_t sender;
+  int16_t rssi;
+  unsigned long ageMs;
+  bool ageUnknown, held, backlog, heartbeat;
+  uint8_t probeCount;
+  uint16_t probeId[TELEMETRY_MAX_PROBES];
+  int16_t probeTemperature[TELEMETRY_MAX_PROBES];
+};
+
+struct ModeStats
+{
+  unsigned long messages = 0;
+  unsigned long allocationsAfterWarmup = 0;
+  long peakAfterWarmup = 0;
+  bool peakGrew = false;
+  unsigned long errors = 0;
+  size_t longestBody = 0;
+  uint32_t checksum = 2166136261u;
+  double elapsedUs = 0;
+};
+
+static char body[UPLINK_BODY_MAX_SIZE];
+static char responseText[UPLINK_MAX_READINGS * 48 + 16];
+static char legacyText[LEGACY_RESPONSE_MAX_SIZE];
+static TestReading batch[UPLINK_MAX_READINGS];
+
+static uint32_t nextRandom(uint32_t &state)
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static void addChecksum(uint32_t &checksum, const char *text, size_t length)
+{
+  for (size_t i = 0; i < length; i++)
+    checksum = (checksum ^ (uint8_t)text[i]) * 16777619u;
+}
+
+static size_t makeBatch(uint32_t &state, unsigned long message)
+{
+  if (message % WORST_CASE_EVERY == WORST_CASE_EVERY - 1)
+  {
+    // Batch terbesar, angka dengan representasi terpanjang dan semua field opsional
+    for (size_t i = 0; i < UPLINK_MAX_READINGS; i++)
+    {
+      TestReading &reading = batch[i];
+      reading.temperature = reading.temperatureMin = reading.temperatureMax = -327.67f;
+      reading.humidity = -327.67f;
+      reading.ph = -327.67f;
+      reading.sender = 0xFF;
+      reading.rssi = INT16_MIN;
+      reading.ageMs = UINT32_MAX; // unsigned long 32 bit di ESP32
+      reading.ageUnknown = true;
+      reading.held = reading.backlog = false;
+      reading.heartbeat = true;
+      reading.probeCount = TELEMETRY_MAX_PROBES;
+      for (uint8_t p = 0; p < TELEMETRY_MAX_PROBES; p++)
+      {
+        reading.probeId[p] = 0xFFFF;
+        reading.probeTemperature[p] = -32767;
+      }
+    }
+    return UPLINK_MAX_READINGS;
+  }
+
+  size_t count = message % 4 == 0 ? SPOOL_REPLAY_BATCH : 1 + nextRandom(state) % UPLINK_BATCH_SIZE;
+  for (size_t i = 0; i < count; i++)
+  {
+    TestReading &reading = batch[i];
+    reading.temperature = 40.0f + (nextRandom(state) % 2000) / 100.0f;
+    reading.temperatureMin = reading.temperature - 0.5f;
+    reading.temperatureMax = reading.temperature + 0.5f;
+    reading.humidity = 30.0f + (nextRandom(state) % 4000) / 100.0f;
+    reading.ph = 6.0f + (nextRandom(state) % 200) / 100.0f;
+    reading.sender = 0x10 + nextRandom(state) % 64;
+    reading.rssi = -40 - (int16_t)(nextRandom(state) % 80);
+    reading.ageMs = nextRandom(state) % 600000;
+    reading.ageUnknown = nextRandom(state) % 16 == 0;
+    reading.held = nextRandom(state) % 4 == 0;
+    reading.backlog = !reading.held && message % 4 == 0;
+    reading.heartbeat = !reading.held && !reading.backlog && nextRandom(state) % 4 == 0;
+    reading.probeCount = nextRandom(state) % (TELEMETRY_MAX_PROBES + 1);
+    for (uint8_t p = 0; p < reading.probeCount; p++)
+    {
+      reading.probeId[p] = 0x4B00 + p;
+      reading.probeTemperature[p] = nextRandom(state) % 16 == 0 ? TELEMETRY_PROBE_INVALID : (int16_t)(4000 + nextRandom(state) % 2000);
+    }
+  }
+  return count;
+}
+
+// Sama dengan encodeUplinkBatch() di Receiver.cpp
+static size_t encodeBatch(ArduinoJson::Allocator *allocator, size_t count)
+{
+  JsonDocument request(allocator);
+  JsonArray items = request["readings"].to<JsonArray>();
+  for (size_t i = 0; i < count; i++)
+  {
+    const TestReading &reading = batch[i];
+    JsonObject item = items.add<JsonObject>();
+    item["temperature"] = reading.temperature;
+    item["temperature_min"] = reading.temperatureMin;
+    item["temperature_max"] = reading.temperatureMax;
+    item["humidity"] = reading.humidity;
+    item["ph"] = reading.ph;
+    item["sender"] = reading.sender;
+    item["rssi"] = reading.rssi;
+    if (reading.ageUnknown)
+      item["age_unknown"] = true;
+    item["age_ms"] = reading.ageMs;
+    if (reading.held)
+      item["held"] = true;
+    else if (reading.backlog)
+      item["backlog"] = true;
+    else if (reading.heartbeat)
+      item["heartbeat"] = true;
+    if (reading.probeCount > 0)
+    {
+      JsonArray probes = item["probes"].to<JsonArray>();
+      for (uint8_t p = 0; p < reading.probeCount; p++)
+      {
+        JsonObject probe = probes.add<JsonObject>();
+        probe["id"] = reading.probeId[p];
+        if (reading.probeTemperature[p] != TELEMETRY_PROBE_INVALID)
+          probe["temperature"] = telemetryFromFixed(reading.probeTemperature[p]);
+        else
+          probe["temperature"] = nullptr;
+      }
+    }
+  }
+  if (request.overflowed())
+    return 0;
+  size_t length = measureJson(request);
+  if (length >= sizeof(body) || length > UPLINK_JSON_MAX_SIZE(count))
+    return 0; // Melebihi buffer atau perkiraan kasus terburuk di Receiver.cpp
+  return serializeJson(request, body, sizeof(body));
+}
+
+// Respons server.py: satu hasil per pembacaan, dibentuk di buffer tetap
+static size_t makeResponse(uint32_t &state, size_t count)
+{
+  size_t length = snprintf(responseText, sizeof(responseText), "{\"results\":[");
+  for (size_t i = 0; i < count; i++)
+    length += snprintf(&responseText[length], sizeof(responseText) - length, "%s{\"classification\":%d,\"buzzer_on\":%d}", i ? "," : "",
+                       (int)(nextRandom(state) & 1), (int)(nextRandom(state) & 1));
+  length += snprintf(&responseText[length], sizeof(responseText) - length, "]}");
+  return length;
+}
+
+// Satu putaran firmware; false jika ada langkah yang gagal
+static bool runMessage(ArduinoJson::Allocator *uplinkAllocator, ArduinoJson::Allocator *legacyAllocator, uint32_t &state, unsigned long message,
+                       ModeStats &stats)
+{
+  size_t count = makeBatch(state, message);
+  size_t bodyLength = encodeBatch(uplinkAllocator, count);
+  if (bodyLength == 0)
+    return false;
+  if (bodyLength > stats.longestBody)
+    stats.longestBody = bodyLength;
+  addChecksum(stats.checksum, body, bodyLength);
+
+  // Respons server (dokumen request sudah dilepas, arena dipakai ulang)
+  size_t responseLength = makeResponse(state, count);
+  bool classification = false, buzzerOn = false;
+  {
+    JsonDocument response(uplinkAllocator);
+    TextStream stream(responseText, responseLength);
+    if (deserializeJson(response, stream))
+      return false;
+    JsonArray results = response["results"];
+    if (results.size() != count)
+      return false;
+    classification = results[count - 1]["classification"];
+    buzzerOn = results[count - 1]["buzzer_on"];
+  }
+
+  // Respons LoRa lama: Receiver membangun, transmitter mem-parse
+  size_t legacyLength;
+  {
+    JsonDocument doc(legacyAllocator);
+    doc["classification"] = classification;
+    doc["buzzer_on"] = buzzerOn;
+    legacyLength = serializeJson(doc, legacyText, sizeof(legacyText));
+  }
+  addChecksum(stats.checksum, legacyText, legacyLength);
+  {
+    JsonDocument doc(legacyAllocator);
+    if (deserializeJson(doc, legacyText, legacyLength) || doc["classification"].as<bool>() != classification)
+      return false;
+  }
+
+  // Payload JSON transmitter lama di task RX
+  const TestReading &reading = batch[0];
+  int payloadLength = snprintf(legacyText, sizeof(legacyText), "{\"humidity\":%.2f,\"temperature\":%.2f,\"ph\":%.2f}", reading.humidity,
+                               reading.temperature, reading.ph);
+  {
+    JsonDocument doc(legacyAllocator);
+    if (deserializeJson(doc, legacyText, payloadLength))
+      return false;
+    float humidity = doc["humidity"];
+    if (humidity != telemetryFromFixed(telemetryToFixed(reading.humidity)) && fabsf(humidity - reading.humidity) > 0.01f)
+      return false;
+  }
+  return true;
+}
+
+static void runMode(const char *name, ArduinoJson::Allocator *uplinkAllocator, ArduinoJson::Allocator *legacyAllocator, unsigned long messages,
+                    uint32_t seed, ModeStats &stats)
+{
+  uint32_t state = seed;
+  unsigned long checkpointEvery = (messages - WARMUP_MESSAGES) / CHECKPOINTS > 0 ? (messages - WARMUP_MESSAGES) / CHECKPOINTS : 1;
+  unsigned long allocationsAtWarmup = 0;
+  long peakAtCheckpoint = 0;
+  printf("%s\n", name);
+
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned long i = 0; i < messages; i++)
+  {
+    if (i == WARMUP_MESSAGES)
+    {
+      allocationsAtWarmup = heapAllocations;
+      heapPeakBytes = heapLiveBytes; // Puncak diukur ulang dari sini
+      peakAtCheckpoint = heapPeakBytes;
+    }
+    if (!runMessage(uplinkAllocator, legacyAllocator, state, i, stats))
+      stats.errors++;
+    stats.messages++;
+
+    if (i >= WARMUP_MESSAGES && (i + 1 - WARMUP_MESSAGES) % checkpointEvery == 0)
+    {
+      long peak = heapPeakBytes; // Dibaca sebelum printf (buffer stdout sudah ada sejak header)
+      unsigned long allocations = heapAllocations - allocationsAtWarmup;
+      printf("  pesan %8lu  heap hidup %6ld B  puncak %6ld B  alokasi sejak pemanasan %9lu\n", i + 1, heapLiveBytes, peak, allocations);
+      if (peak > peakAtCheckpoint)
+        stats.peakGrew = true;
+      peakAtCheckpoint = peak;
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  stats.elapsedUs = std::chrono::duration<double, std::micro>(end - start).count();
+  stats.allocationsAfterWarmup = heapAllocations - allocationsAtWarmup;
+  stats.peakAfterWarmup = heapPeakBytes;
+}
+
+static void report(const char *name, const ModeStats &stats, unsigned long measured)
+{
+  printf("%-22s %8lu pesan  alokasi %7.2f/pesan  puncak heap %6ld B%s  body terpanjang %5zu B  %6.2f us/pesan  gagal %lu\n", name,
+         stats.messages, measured ? (double)stats.allocationsAfterWarmup / measured : 0.0, stats.peakAfterWarmup, stats.peakGrew ? " (naik)" : "",
+         stats.longestBody, stats.messages ? stats.elapsedUs / stats.messages : 0.0, stats.errors);
+}
+
+int main(int argc, char **argv)
+{
+  unsigned long messages = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+  uint32_t seed = argc > 2 ? strtoul(argv[2], NULL, 10) : 1;
+  if (seed == 0)
+    seed = 1;
+  if (messages < WARMUP_MESSAGES + CHECKPOINTS)
+    messages = WARMUP_MESSAGES + CHECKPOINTS;
+  unsigned long measured = messages - WARMUP_MESSAGES;
+
+  static HeapAllocator heapAllocator;
+  static JsonArena<UPLINK_JSON_ARENA_SIZE> uplinkArena;
+  static JsonArena<LEGACY_JSON_ARENA_SIZE> legacyArena;
+  printf("%lu pesan per mode (pemanasan %d), seed %lu, arena uplink %u B + legacy %u B, ARDUINOJSON_POOL_CAPACITY %d, body maks %d B\n", messages,
+         WARMUP_MESSAGES, (unsigned long)seed, (unsigned)uplinkArena.capacity(), (unsigned)legacyArena.capacity(), (int)ARDUINOJSON_POOL_CAPACITY,
+         (int)UPLINK_JSON_MAX_SIZE(UPLINK_MAX_READINGS));
+
+  ModeStats heapStats, arenaStats;
+  runMode("heap (lama)", &heapAllocator, &heapAllocator, messages, seed, heapStats);
+  runMode("arena statis (baru)", &uplinkArena, &legacyArena, messages, seed, arenaStats);
+
+  report("heap (lama)", heapStats, measured);
+  report("arena statis (baru)", arenaStats, measured);
+  printf("arena uplink puncak %u/%u B, legacy %u/%u B, ditolak %u + %u\n", (unsigned)uplinkArena.highWater(), (unsigned)uplinkArena.capacity(),
+         (unsigned)legacyArena.highWater(), (unsigned)legacyArena.capacity(), (unsigned)uplinkArena.failures(), (unsigned)legacyArena.failures());
+
+  bool sameOutput = heapStats.checksum == arenaStats.checksum;
+  if (!sameOutput)
+    printf("keluaran JSON berbeda: checksum %08x vs %08x\n", (unsigned)heapStats.checksum, (unsigned)arenaStats.checksum);
+  bool ok = arenaStats.allocationsAfterWarmup == 0 && !arenaStats.peakGrew && arenaStats.errors == 0 && heapStats.errors == 0 && sameOutput &&
+            uplinkArena.failures() == 0 && legacyArena.failures() == 0;
+  printf("%s\n", ok ? "OK: jalur arena tanpa alokasi heap, puncak heap datar" : "GAGAL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,318 @@
+// Uji encode/decode frame telemetri (telemetry_frame.h): round trip versi 3 dengan 0..TELEMETRY_MAX_PROBES
+// probe, decode frame versi 1 dan 2 dari transmitter lama, CRC rusak (setiap bit dibalik), panjang salah
+// (terpotong, kelebihan, 0), saturasi nilai dan jumlah probe, round trip frame batch backlog, serta frame
+// kompak (round trip, probe implisit, CRC-8 termasuk msgId, panjang dan tag salah, saturasi field).
+//
+// Build & jalankan (dari root repo):
+//   g++ -std=c++17 -O2 -Wall -I. host/test/telemetry_frame_test.cpp -o telemetry_frame_test
+//   ./telemetry_frame_test
+//
+// Keluar dengan status 1 jika ada pemeriksaan yang gagal.
+
+#include "telemetry_frame.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK(condition)                                                  \
+  do                                                                      \
+  {                                                                       \
+    checks++;                                                             \
+    if (!(condition))                                                     \
+    {                                                                     \
+      failures++;                                                         \
+      printf("GAGAL %s:%d: %s\n", __FILE__, __LINE__, #condition);       \
+    }                                                                     \
+  } while (0)
+
+static TelemetryFrame sampleFrame(uint8_t probes)
+{
+  TelemetryFrame frame = makeTelemetryFrame(45.67f, 38.2f, -7.01f, TelemetryTemperatureValid | TelemetryHumidityValid | TelemetryHeartbeat);
+  frame.seq = 0xBEEF;
+  for (uint8_t i = 0; i < probes; i++)
+    addTelemetryProbe(frame, 0x4B00 + i, 40.0f + i * 1.25f, i != 2); // Probe ketiga gagal dibaca
+  return frame;
+}
+
+static bool sameFrame(const TelemetryFrame &a, const TelemetryFrame &b)
+{
+  if (a.version != b.version || a.flags != b.flags || a.temperature != b.temperature || a.humidity != b.humidity || a.ph != b.ph ||
+      a.probeCount != b.probeCount || a.seq != b.seq)
+    return false;
+  for (uint8_t i = 0; i < a.probeCount; i++)
+  {
+    if (a.probeId[i] != b.probeId[i] || a.probeTemperature[i] != b.probeTemperature[i])
+      return false;
+  }
+  return true;
+}
+
+// Frame lama dibangun manual: versi 2 = header 9 byte tanpa nomor urut, versi 1 = 10 byte tanpa jumlah probe
+static size_t encodeLegacyFrame(uint8_t version, const TelemetryFrame &frame, uint8_t *buffer)
+{
+  buffer[0] = version;
+  buffer[1] = frame.flags;
+  telemetryWriteInt16(&buffer[2], frame.temperature);
+  telemetryWriteInt16(&buffer[4], frame.humidity);
+  telemetryWriteInt16(&buffer[6], frame.ph);
+  size_t length = 8;
+  if (version == 2)
+  {
+    buffer[length++] = frame.probeCount;
+    for (uint8_t i = 0; i < frame.probeCount; i++, length += TELEMETRY_PROBE_SIZE)
+    {
+      telemetryWriteInt16(&buffer[length], (int16_t)frame.probeId[i]);
+      telemetryWriteInt16(&buffer[length + 2], frame.probeTemperature[i]);
+    }
+  }
+  uint16_t crc = telemetryCrc16(buffer, length);
+  buffer[length] = crc & 0xFF;
+  buffer[length + 1] = crc >> 8;
+  return length + 2;
+}
+
+static void testRoundTrip()
+{
+  for (uint8_t probes = 0; probes <= TELEMETRY_MAX_PROBES; probes++)
+  {
+    TelemetryFrame frame = sampleFrame(probes);
+    uint8_t buffer[TELEMETRY_FRAME_MAX_SIZE];
+    size_t length = encodeTelemetryFrame(frame, buffer, sizeof(buffer));
+    CHECK(length == telemetryFrameSize(probes));
+
+    TelemetryFrame decoded = {};
+    CHECK(decodeTelemetryFrame(buffer, length, decoded));
+    CHECK(sameFrame(frame, decoded));
+    CHECK(encodeTelemetryFrame(frame, buffer, length - 1) == 0); // Buffer kurang satu byte
+  }
+
+  TelemetryFrame decoded;
+  uint8_t buffer[TELEMETRY_FRAME_MAX_SIZE];
+  size_t length = encodeTelemetryFrame(sampleFrame(3), buffer, sizeof(buffer));
+  CHECK(decodeTelemetryFrame(buffer, length, decoded));
+  CHECK(decoded.temperature == 4567 && decoded.humidity == 3820 && decoded.ph == -701);
+  CHECK(decoded.probeTemperature[2] == TELEMETRY_PROBE_INVALID && decoded.probeTemperature[1] == 4125);
+}
+
+static void testLegacyVersions()
+{
+  TelemetryFrame frame = sampleFrame(4);
+  uint8_t buffer[TELEMETRY_FRAME_MAX_SIZE];
+  TelemetryFrame decoded;
+
+  size_t length = encodeLegacyFrame(2, frame, buffer);
+  CHECK(length == telemetryFrameSize(4, TELEMETRY_FRAME_V2_HEADER_SIZE));
+  CHECK(decodeTelemetryFrame(buffer, length, decoded));
+  CHECK(decoded.version == 2 && decoded.seq == 0 && decoded.probeCount == 4);
+  CHECK(decoded.temperature == frame.temperature && decoded.probeId[3] == frame.probeId[3] &&
+        decoded.probeTemperature[3] == frame.probeTemperature[3]);
+
+  length = encodeLegacyFrame(1, frame, buffer);
+  CHECK(length == TELEMETRY_FRAME_V1_SIZE);
+  CHECK(decodeTelemetryFrame(buffer, length, decoded));
+  CHECK(decoded.version == 1 && decoded.seq == 0 && decoded.probeCount == 0);
+  CHECK(decoded.humidity == frame.humidity && decoded.ph == frame.ph && decoded.flags == frame.flags);
+
+  buffer[0] = 4; // Versi tidak dikenal
+  CHECK(!decodeTelemetryFrame(buffer, length, decoded));
+}
+
+static void testCorruptedCrc()
+{
+  uint8_t buffer[TELEMETRY_FRAME_MAX_SIZE];
+  size_t length = encodeTelemetryFrame(sampleFrame(TELEMETRY_MAX_PROBES), buffer, sizeof(buffer));
+  TelemetryFrame decoded;
+  int accepted = 0;
+  for (size_t i = 0; i < length; i++)
+  {
+    for (int bit = 0; bit < 8; bit++)
+    {
+      buffer[i] ^= 1 << bit;
+      if (decodeTelemetryFrame(buffer, length, decoded))
+        accepted++;
+      buffer[i] ^= 1 << bit;
+    }
+  }
+  CHECK(accepted == 0);
+  CHECK(decodeTelemetryFrame(buffer, length, decoded)); // Buffer kembali utuh
+
+  buffer[length - 1] ^= 0xFF; // Byte CRC sendiri rusak
+  CHECK(!decodeTelemetryFrame(buffer, length, decoded));
+}
+
+static void testWrongLength()
+{
+  uint8_t buffer[TELEMETRY_FRAME_MAX_SIZE + 1];
+  size_t length = encodeTelemetryFrame(sampleFrame(2), buffer, sizeof(buffer));
+  TelemetryFrame decoded;
+  for (size_t truncated = 0; truncated < length; truncated++)
+    CHECK(!decodeTelemetryFrame(buffer, truncated, decoded));
+  buffer[length] = 0;
+  CHECK(!decodeTelemetryFrame(buffer, length + 1, decoded)); // Byte ekstra di belakang
+  CHECK(!decodeTelemetryFrame(NULL, 0, decoded));           // Panjang 0: buffer tidak boleh dibaca
+
+  // Frame versi 1 dengan panjang versi 3 dan sebaliknya
+  uint8_t legacy[TELEMETRY_FRAME_MAX_SIZE];
+  size_t legacyLength = encodeLegacyFrame(1, sampleFrame(0), legacy);
+  CHECK(!decodeTelemetryFrame(legacy, legacyLength + 1, decoded));
+  buffer[0] = 1;
+  CHECK(!decodeTelemetryFrame(buffer, length, decoded));
+}
+
+static void testSaturation()
+{
+  CHECK(telemetryToFixed(400.0f) == 32767);
+  CHECK(telemetryToFixed(-400.0f) == -32768);
+  CHECK(telemetryToFixed(327.67f) == 32767);
+  CHECK(telemetryToFixed(-0.004f) == 0 && telemetryToFixed(-0.005f) == -1);
+
+  TelemetryFrame frame = sampleFrame(TELEMETRY_MAX_PROBES);
+  CHECK(!addTelemetryProbe(frame, 0xFFFF, 20.0f, true)); // Probe ke-9 ditolak
+  CHECK(frame.probeCount == TELEMETRY_MAX_PROBES);
+
+  // probeCount di luar batas dipotong saat encode
+  frame.probeCount = TELEMETRY_MAX_PROBES + 4;
+  uint8_t buffer[TELEMETRY_FRAME_MAX_SIZE];
+  size_t length = encodeTelemetryFrame(frame, buffer, sizeof(buffer));
+  CHECK(length == TELEMETRY_FRAME_MAX_SIZE);
+  TelemetryFrame decoded;
+  CHECK(decodeTelemetryFrame(buffer, length, decoded) && decoded.probeCount == TELEMETRY_MAX_PROBES);
+
+  // Jumlah probe di frame melebihi batas walaupun panjang dan CRC konsisten
+  uint8_t oversized[TELEMETRY_FRAME_MAX_SIZE + TELEMETRY_PROBE_SIZE];
+  memcpy(oversized, buffer, length - 2);
+  oversized[8] = TELEMETRY_MAX_PROBES + 1;
+  memset(&oversized[length - 2], 0, TELEMETRY_PROBE_SIZE);
+  size_t oversizedLength = telemetryFrameSize(TELEMETRY_MAX_PROBES + 1);
+  uint16_t crc = telemetryCrc16(oversized, oversizedLength - 2);
+  oversized[oversizedLength - 2] = crc & 0xFF;
+  oversized[oversizedLength - 1] = crc >> 8;
+  CHECK(!decodeTelemetryFrame(oversized, oversizedLength, decoded));
+}
+
+static void testBatch()
+{
+  uint8_t batch[TELEMETRY_BATCH_MAX_SIZE];
+  size_t length = beginTelemetryBatch(batch, 0x1234);
+  uint8_t records = 0;
+  while (true)
+  {
+    uint8_t frame[TELEMETRY_FRAME_MAX_SIZE];
+    size_t frameLength = encodeTelemetryFrame(sampleFrame(records % 3), frame, sizeof(frame));
+    if (!addTelemetryBatchRecord(batch, sizeof(batch), length, records == 0 ? TELEMETRY_AGE_UNKNOWN : records * 60u, frame, frameLength))
+      break;
+    records++;
+  }
+  CHECK(records == TELEMETRY_BATCH_MAX_RECORDS);
+  length = finishTelemetryBatch(batch, length);
+
+  uint8_t count;
+  uint16_t seq;
+  CHECK(decodeTelemetryBatch(batch, length, count, seq) && count == records && seq == 0x1234);
+  size_t offset = TELEMETRY_BATCH_HEADER_SIZE;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    uint32_t age;
+    TelemetryFrame decoded;
+    offset = decodeTelemetryBatchRecord(batch, length, offset, age, decoded);
+    CHECK(offset != 0 && sameFrame(decoded, sampleFrame(i % 3)) && age == (i == 0 ? TELEMETRY_AGE_UNKNOWN : i * 60u));
+    if (offset == 0)
+      return;
+  }
+  CHECK(offset == length - 2);
+
+  batch[TELEMETRY_BATCH_HEADER_SIZE + 5] ^= 0x10;
+  CHECK(!decodeTelemetryBatch(batch, length, count, seq));
+  CHECK(!decodeTelemetryBatch(batch, 0, count, seq));
+}
+
+static void testCompact()
+{
+  for (uint8_t probes = 0; probes <= TELEMETRY_MAX_PROBES; probes++)
+  {
+    TelemetryFrame frame = sampleFrame(probes);
+    frame.ph = 701; // Kolom pH kompak tidak bertanda
+    uint8_t buffer[TELEMETRY_COMPACT_MAX_SIZE];
+    size_t length = encodeCompactTelemetryFrame(frame, buffer, sizeof(buffer));
+    CHECK(length == telemetryCompactFrameSize(probes) && length == telemetryCompactFrameSize(frame));
+
+    TelemetryFrame decoded = {};
+    CHECK(decodeCompactTelemetryFrame(buffer, length, (uint8_t)frame.seq, decoded));
+    frame.version = TELEMETRY_COMPACT_VERSION;
+    CHECK(sameFrame(frame, decoded));
+    CHECK(encodeCompactTelemetryFrame(frame, buffer, length - 1) == 0); // Buffer kurang satu byte
+  }
+
+  // Satu probe dengan suhu sama dengan suhu frame: suhu probe tidak ikut dikirim
+  TelemetryFrame frame = makeTelemetryFrame(45.67f, 38.2f, 7.01f, TelemetryTemperatureValid | TelemetryHumidityValid | TelemetryPhValid);
+  frame.seq = 0x1234;
+  addTelemetryProbe(frame, 0x4B00, 45.67f, true);
+  uint8_t buffer[TELEMETRY_COMPACT_MAX_SIZE + 1];
+  size_t length = encodeCompactTelemetryFrame(frame, buffer, sizeof(buffer));
+  CHECK(length == 11 && buffer[0] == (TELEMETRY_COMPACT_TAG | TELEMETRY_COMPACT_SINGLE_PROBE));
+  TelemetryFrame decoded = {};
+  CHECK(decodeCompactTelemetryFrame(buffer, length, 0x34, decoded));
+  frame.version = TELEMETRY_COMPACT_VERSION;
+  CHECK(sameFrame(frame, decoded));
+
+  // Probe tunggal tidak valid dan suhu frame tidak valid juga implisit
+  TelemetryFrame invalid = makeTelemetryFrame(0.0f, 38.2f, 7.01f, TelemetryHumidityValid);
+  addTelemetryProbe(invalid, 0x4B01, 0.0f, false);
+  CHECK(telemetryCompactFrameSize(invalid) == 11);
+  length = encodeCompactTelemetryFrame(invalid, buffer, sizeof(buffer));
+  CHECK(decodeCompactTelemetryFrame(buffer, length, 0, decoded) && decoded.probeTemperature[0] == TELEMETRY_PROBE_INVALID);
+
+  // Setiap bit dibalik, msgId lain (byte terbawah nomor urut) dan panjang salah ditolak
+  length = encodeCompactTelemetryFrame(sampleFrame(2), buffer, sizeof(buffer));
+  int accepted = 0;
+  for (size_t i = 0; i < length; i++)
+  {
+    for (int bit = 0; bit < 8; bit++)
+    {
+      buffer[i] ^= 1 << bit;
+      if (decodeCompactTelemetryFrame(buffer, length, 0xEF, decoded))
+        accepted++;
+      buffer[i] ^= 1 << bit;
+    }
+  }
+  CHECK(accepted == 0);
+  CHECK(decodeCompactTelemetryFrame(buffer, length, 0xEF, decoded) && decoded.seq == 0xBEEF);
+  CHECK(!decodeCompactTelemetryFrame(buffer, length, 0xEE, decoded));
+  for (size_t truncated = 0; truncated < length; truncated++)
+    CHECK(!decodeCompactTelemetryFrame(buffer, truncated, 0xEF, decoded));
+  buffer[length] = 0;
+  CHECK(!decodeCompactTelemetryFrame(buffer, length + 1, 0xEF, decoded));
+  CHECK(!decodeCompactTelemetryFrame(NULL, 0, 0xEF, decoded));
+
+  // Jumlah probe di luar batas dan frame versi 3 bukan frame kompak
+  buffer[0] = TELEMETRY_COMPACT_TAG | (TELEMETRY_MAX_PROBES + 1);
+  CHECK(!decodeCompactTelemetryFrame(buffer, telemetryCompactFrameSize(TELEMETRY_MAX_PROBES + 1), 0xEF, decoded));
+  length = encodeTelemetryFrame(sampleFrame(0), buffer, sizeof(buffer));
+  CHECK(!decodeCompactTelemetryFrame(buffer, length, 0xEF, decoded));
+
+  // Nilai di luar rentang field kompak dijenuhkan
+  TelemetryFrame extreme = makeTelemetryFrame(300.0f, -5.0f, 30.0f, TelemetryTemperatureValid);
+  length = encodeCompactTelemetryFrame(extreme, buffer, sizeof(buffer));
+  CHECK(decodeCompactTelemetryFrame(buffer, length, 0, decoded));
+  CHECK(decoded.temperature == 0x7FFF - TELEMETRY_COMPACT_TEMPERATURE_OFFSET && decoded.humidity == 0 && decoded.ph == 0x7FF);
+  extreme.temperature = -6000;
+  length = encodeCompactTelemetryFrame(extreme, buffer, sizeof(buffer));
+  CHECK(decodeCompactTelemetryFrame(buffer, length, 0, decoded) && decoded.temperature == -TELEMETRY_COMPACT_TEMPERATURE_OFFSET);
+}
+
+int main()
+{
+  testRoundTrip();
+  testLegacyVersions();
+  testCorruptedCrc();
+  testWrongLength();
+  testSaturation();
+  testBatch();
+  testCompact();
+
+  printf("%d pemeriksaan, %d gagal\n", checks, failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <ArduinoJson.h>
+
+// Allocator ArduinoJson di atas buffer statis berukuran tetap: JsonDocument doc(&arena) mengambil pool variant
+// dan salinan string dari arena, tidak pernah dari malloc, sehingga pesan JSON yang berulang tidak
+// memfragmentasi heap. Alokasi ditumpuk berurutan (bump); blok terakhir bisa tumbuh/menyusut di tempat karena
+// ArduinoJson membangun string dan daftar pool dengan reallocate(). deallocate() hanya mengurangi hitungan blok
+// hidup (blok terakhir langsung dikembalikan); saat dokumen dihancurkan atau clear() semua blok lepas dan arena
+// kosong lagi, jadi pemakaian tidak terakumulasi antar pesan. Arena penuh: allocate() mengembalikan NULL,
+// ArduinoJson menandai dokumen overflowed() / mengembalikan DeserializationError::NoMemory.
+// Satu arena untuk satu task (atau di bawah semaphore yang sama); beberapa dokumen boleh hidup bersamaan.
+//
+// Ukuran arena dihitung dalam pool ArduinoJson (ARDUINOJSON_POOL_CAPACITY slot per pool). Satu "slot" di sini
+// adalah satu elemen array atau satu member objek; JSON_ARENA_SLOT_SIZE mencukupi keduanya di ArduinoJson 7.3+
+// (kunci dan nilai masing-masing satu slot 8/16 byte) maupun 7.0-7.2 (satu slot 16/24 byte per member) di ESP32
+// dan host 64-bit. Pool selalu dialokasikan utuh, jadi arena minimal satu pool.
+
+#define JSON_ARENA_ALIGN 8
+#define JSON_ARENA_HEADER_SIZE 8                     // Ukuran blok, dibulatkan agar payload tetap rata 8 byte
+#define JSON_ARENA_SLOT_SIZE (4 * sizeof(void *))
+#define JSON_ARENA_POOL_SIZE (ARDUINOJSON_POOL_CAPACITY * JSON_ARENA_SLOT_SIZE + JSON_ARENA_HEADER_SIZE)
+#define JSON_ARENA_SIZE(pools, stringBytes) ((pools) * JSON_ARENA_POOL_SIZE + (stringBytes))
+#define JSON_ARENA_POOLS(slots) (((slots) + ARDUINOJSON_POOL_CAPACITY - 1) / ARDUINOJSON_POOL_CAPACITY + 1) // +1 pool cadangan untuk slot ekstensi (nilai 64 bit)
+
+template <size_t Size>
+class JsonArena : public ArduinoJson::Allocator
+{
+  static_assert(Size > JSON_ARENA_HEADER_SIZE, "Arena terlalu kecil");
+
+public:
+  void *allocate(size_t size) override
+  {
+    size_t total = blockSize(size);
+    if (size > Size || total > Size - offset)
+    {
+      failedCount++;
+      return NULL;
+    }
+    uint8_t *block = &storage[offset];
+    *(uint32_t *)block = (uint32_t)size;
+    lastOffset = offset;
+    offset += total;
+    liveBlocks++;
+    markHighWater();
+    return block + JSON_ARENA_HEADER_SIZE;
+  }
+
+  void deallocate(void *pointer) override
+  {
+    if (pointer == NULL)
+      return;
+    liveBlocks--;
+    if (liveBlocks == 0)
+    {
+      offset = 0; // Semua dokumen selesai: arena kosong lagi
+      lastOffset = NoBlock;
+    }
+    else if (isLast(pointer))
+    {
+      offset = lastOffset; // Blok sebelumnya tidak diketahui; ruang di bawahnya kembali saat arena kosong
+      lastOffset = NoBlock;
+    }
+  }
+
+  void *reallocate(void *pointer, size_t size) override
+  {
+    if (pointer == NULL)
+      return allocate(size);
+    uint8_t *block = (uint8_t *)pointer - JSON_ARENA_HEADER_SIZE;
+    if (isLast(pointer))
+    {
+      size_t total = blockSize(size);
+      if (size > Size || total > Size - lastOffset)
+      {
+        failedCount++;
+        return NULL;
+      }
+      *(uint32_t *)block = (uint32_t)size;
+      offset = lastOffset + total;
+      markHighWater();
+      return pointer;
+    }
+
+    // Blok di tengah: salin ke blok baru di ujung (blok lama baru kembali saat arena kosong)
+    void *moved = allocate(size);
+    if (moved == NULL)
+      return NULL; // Seperti realloc(): blok lama tetap berlaku
+    uint32_t oldSize = *(uint32_t *)block;
+    memcpy(moved, pointer, oldSize < size ? oldSize : size);
+    deallocate(pointer);
+    return moved;
+  }
+
+  size_t capacity() const { return Size; }
+  size_t used() const { return offset; }
+  size_t highWater() const { return highWaterMark; } // Pemakaian puncak sejak boot, untuk menyesuaikan Size
+  uint32_t failures() const { return failedCount; }  // Alokasi yang ditolak karena arena penuh
+
+private:
+  static const size_t NoBlock = SIZE_MAX;
+
+  static size_t blockSize(size_t size)
+  {
+    return (JSON_ARENA_HEADER_SIZE + size + JSON_ARENA_ALIGN - 1) & ~(size_t)(JSON_ARENA_ALIGN - 1);
+  }
+
+  bool isLast(void *pointer) const
+  {
+    return lastOffset != NoBlock && (uint8_t *)pointer == &storage[lastOffset + JSON_ARENA_HEADER_SIZE];
+  }
+
+  void markHighWater()
+  {
+    if (offset > highWaterMark)
+      highWaterMark = offset;
+  }
+
+  alignas(JSON_ARENA_ALIGN) uint8_t storage[Size];
+  size_t offset = 0;
+  size_t lastOffset = NoBlock;
+  size_t liveBlocks = 0;
+  size_t highWaterMark = 0;
+  uint32_t failedCount = 0;
+};
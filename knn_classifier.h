@@ -0,0 +1,241 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <float.h>
+
+// Inferensi KNN di perangkat, setara KNeighborsClassifier(metric='euclidean', weights='uniform')
+// dengan StandardScaler dari knn_model_training.py. Data latih, parameter scaler, dan k
+// diekspor oleh knn_model_training.py ke knn_model.h (array const, tersimpan di flash).
+//
+// Ada dua representasi dengan algoritma pencarian yang sama:
+//   KnnModel           fitur float hasil StandardScaler, jarak float (referensi / benchmark)
+//   KnnQuantizedModel  fitur int16 fixed-point, jarak int32; scaling pakai faktor kebalikan
+//                      yang sudah dihitung offline, jadi jalur query di ESP32 tanpa operasi float
+//
+// Jika splitDims tidak NULL, data latih sudah disusun offline menjadi KD-tree implisit tanpa pointer:
+// untuk rentang [lo, hi) dengan lebih dari leafSize sampel, node ada di mid = lo + (hi - lo) / 2,
+// dimensi pemisahnya splitDims[mid], subtree kiri [lo, mid) bernilai <= node dan kanan [mid + 1, hi) >= node.
+// Rentang berisi leafSize sampel atau kurang adalah daun yang dipindai linear.
+
+#define KNN_MAX_K 32          // Batas k yang didukung (GridSearchCV di training mencari k 1..20)
+#define KNN_MAX_CLASSES 8     // Batas jumlah kelas label
+#define KNN_MAX_FEATURES 8    // Batas jumlah fitur per sampel
+#define KNN_MAX_TREE_DEPTH 48 // Kedalaman stack pencarian KD-tree (cukup untuk 2^40 sampel)
+
+// Fitur terkuantisasi dibatasi +-KNN_QUANT_LIMIT sehingga selisih^2 x KNN_MAX_FEATURES tetap muat di int32
+#define KNN_QUANT_LIMIT 8191
+#define KNN_QUANT_RECIP_SHIFT 16 // Jumlah bit pecahan faktor kebalikan scale
+
+struct KnnModel
+{
+  typedef float Sample;
+  typedef float Distance;
+  static constexpr float maxDistance() { return FLT_MAX; }
+
+  uint8_t featureCount;      // Jumlah fitur (suhu, kelembaban, pH)
+  uint8_t classCount;        // Jumlah kelas label
+  uint8_t k;                 // Jumlah tetangga
+  uint32_t sampleCount;      // Jumlah sampel data latih
+  const float *mean;         // StandardScaler.mean_, satu per fitur
+  const float *scale;        // StandardScaler.scale_, satu per fitur
+  const float *samples;      // Data latih yang sudah di-scale, sampleCount x featureCount
+  const uint8_t *labels;     // Label tiap sampel data latih
+  uint8_t leafSize;          // Ukuran daun KD-tree
+  const uint8_t *splitDims;  // Dimensi pemisah tiap node KD-tree, NULL = tanpa indeks (brute force)
+};
+
+// Fitur terkuantisasi: q = round(z * quantScale), z = (x - mean) / scale hasil StandardScaler.
+// Input query adalah nilai sensor x100 (int16, sama dengan frame telemetri), sehingga
+// q = (x100 * recipScale - offset) >> KNN_QUANT_RECIP_SHIFT dengan
+// recipScale = round(quantScale * 2^16 / (scale * 100)) dan offset = round(mean * 100 * recipScale) - 2^15.
+struct KnnQuantizedModel
+{
+  typedef int16_t Sample;
+  typedef int32_t Distance;
+  static constexpr int32_t maxDistance() { return INT32_MAX; }
+
+  uint8_t featureCount;      // Jumlah fitur (suhu, kelembaban, pH)
+  uint8_t classCount;        // Jumlah kelas label
+  uint8_t k;                 // Jumlah tetangga
+  uint32_t sampleCount;      // Jumlah sampel data latih
+  const int32_t *recipScale; // Faktor kebalikan scale per fitur (Q16)
+  const int64_t *offset;     // Offset mean per fitur, sudah termasuk pembulatan
+  const int16_t *samples;    // Data latih terkuantisasi, sampleCount x featureCount
+  const uint8_t *labels;     // Label tiap sampel data latih
+  uint8_t leafSize;          // Ukuran daun KD-tree
+  const uint8_t *splitDims;  // Dimensi pemisah tiap node KD-tree, NULL = tanpa indeks (brute force)
+};
+
+// k tetangga terdekat sementara, terurut dari jarak (kuadrat) terkecil
+template <typename Model>
+struct KnnNeighbours
+{
+  typedef typename Model::Distance Distance;
+
+  Distance distance[KNN_MAX_K];
+  uint8_t label[KNN_MAX_K];
+  uint8_t found;
+  uint8_t k;
+
+  // Jarak tetangga ke-k, atau nilai maksimum selama belum ada k tetangga
+  Distance worst() const { return found < k ? Model::maxDistance() : distance[k - 1]; }
+
+  void insert(Distance candidateDistance, uint8_t candidateLabel)
+  {
+    if (candidateDistance >= worst())
+      return; // Tidak lebih dekat dari tetangga ke-k
+
+    // Sisipkan ke posisi terurut; tetangga terjauh terbuang jika sudah ada k tetangga
+    uint8_t position = found < k ? found++ : k - 1;
+    while (position > 0 && distance[position - 1] > candidateDistance)
+    {
+      distance[position] = distance[position - 1];
+      label[position] = label[position - 1];
+      position--;
+    }
+    distance[position] = candidateDistance;
+    label[position] = candidateLabel;
+  }
+
+  // Seri suara dimenangkan label terkecil, sama seperti mode() yang dipakai scikit-learn
+  uint8_t vote(uint8_t classCount) const
+  {
+    uint8_t votes[KNN_MAX_CLASSES] = {0};
+    for (uint8_t n = 0; n < found; n++)
+      if (label[n] < KNN_MAX_CLASSES)
+        votes[label[n]]++;
+
+    uint8_t best = 0;
+    for (uint8_t c = 1; c < classCount && c < KNN_MAX_CLASSES; c++)
+      if (votes[c] > votes[best])
+        best = c;
+    return best;
+  }
+};
+
+// Normalisasi fitur mentah dengan parameter StandardScaler: (x - mean) / scale
+inline void knnScale(const KnnModel &model, const float *raw, float *scaled)
+{
+  for (uint8_t f = 0; f < model.featureCount; f++)
+    scaled[f] = (raw[f] - model.mean[f]) / model.scale[f];
+}
+
+// Kuantisasi nilai sensor x100 tanpa float: satu perkalian int64 dan shift per fitur
+inline void knnQuantize(const KnnQuantizedModel &model, const int16_t *rawX100, int16_t *quantized)
+{
+  for (uint8_t f = 0; f < model.featureCount; f++)
+  {
+    int64_t q = ((int64_t)rawX100[f] * model.recipScale[f] - model.offset[f]) >> KNN_QUANT_RECIP_SHIFT;
+    quantized[f] = q > KNN_QUANT_LIMIT ? KNN_QUANT_LIMIT : q < -KNN_QUANT_LIMIT ? -KNN_QUANT_LIMIT : (int16_t)q;
+  }
+}
+
+// Selisih dihitung di tipe jarak (float atau int32), jadi int16 tidak overflow
+template <typename Model>
+inline typename Model::Distance knnDistance(const typename Model::Sample *sample, const typename Model::Sample *query, uint8_t featureCount)
+{
+  typename Model::Distance distance = 0;
+  for (uint8_t f = 0; f < featureCount; f++)
+  {
+    typename Model::Distance delta = (typename Model::Distance)sample[f] - query[f];
+    distance += delta * delta;
+  }
+  return distance;
+}
+
+// Pemindaian linear sampel [lo, hi); dipakai untuk brute force dan daun KD-tree
+template <typename Model>
+inline void knnScan(const Model &model, const typename Model::Sample *query, uint32_t lo, uint32_t hi, KnnNeighbours<Model> &neighbours)
+{
+  const typename Model::Sample *sample = model.samples + (size_t)lo * model.featureCount;
+  for (uint32_t i = lo; i < hi; i++, sample += model.featureCount)
+    neighbours.insert(knnDistance<Model>(sample, query, model.featureCount), model.labels[i]);
+}
+
+// Pencarian k-NN terbatas di KD-tree implisit. Stack eksplisit berukuran tetap (tanpa rekursi/alokasi);
+// sisi jauh sebuah node hanya dikunjungi jika jarak ke bidang pemisahnya lebih kecil dari tetangga ke-k.
+template <typename Model>
+inline void knnSearchTree(const Model &model, const typename Model::Sample *query, KnnNeighbours<Model> &neighbours)
+{
+  typedef typename Model::Distance Distance;
+  struct Range
+  {
+    uint32_t lo, hi;
+    Distance planeDistance; // Jarak kuadrat minimum dari query ke rentang ini
+  } stack[KNN_MAX_TREE_DEPTH];
+  uint8_t top = 0;
+  stack[top++] = {0, model.sampleCount, 0};
+
+  while (top > 0)
+  {
+    Range range = stack[--top];
+    if (range.planeDistance >= neighbours.worst())
+      continue; // Seluruh rentang lebih jauh dari tetangga ke-k
+
+    if (range.hi - range.lo <= model.leafSize)
+    {
+      knnScan(model, query, range.lo, range.hi, neighbours);
+      continue;
+    }
+
+    uint32_t mid = range.lo + (range.hi - range.lo) / 2;
+    const typename Model::Sample *node = model.samples + (size_t)mid * model.featureCount;
+    uint8_t dim = model.splitDims[mid];
+    neighbours.insert(knnDistance<Model>(node, query, model.featureCount), model.labels[mid]);
+
+    Distance delta = (Distance)query[dim] - node[dim];
+    Range left = {range.lo, mid, 0};
+    Range right = {mid + 1, range.hi, 0};
+    Range &nearSide = delta < 0 ? left : right;
+    Range &farSide = delta < 0 ? right : left;
+    farSide.planeDistance = delta * delta > range.planeDistance ? delta * delta : range.planeDistance;
+    nearSide.planeDistance = range.planeDistance;
+
+    // Sisi dekat di-push terakhir agar dikunjungi lebih dulu
+    if (top + 2 > KNN_MAX_TREE_DEPTH)
+    {
+      knnScan(model, query, range.lo, range.hi, neighbours); // Tidak terjadi untuk pohon seimbang; jaga-jaga saja
+      continue;
+    }
+    stack[top++] = farSide;
+    stack[top++] = nearSide;
+  }
+}
+
+// Mencari k tetangga dari query yang sudah di-scale/dikuantisasi lalu melakukan voting
+template <typename Model>
+inline uint8_t knnClassifyScaled(const Model &model, const typename Model::Sample *query)
+{
+  if (model.sampleCount == 0 || model.k == 0)
+    return 0;
+
+  KnnNeighbours<Model> neighbours;
+  neighbours.found = 0;
+  neighbours.k = model.k > KNN_MAX_K ? KNN_MAX_K : model.k;
+  if (neighbours.k > model.sampleCount)
+    neighbours.k = model.sampleCount;
+
+  if (model.splitDims)
+    knnSearchTree(model, query, neighbours);
+  else
+    knnScan(model, query, 0, model.sampleCount, neighbours);
+
+  return neighbours.vote(model.classCount);
+}
+
+// Klasifikasi satu titik fitur mentah (float)
+inline uint8_t knnClassify(const KnnModel &model, const float *raw)
+{
+  float query[KNN_MAX_FEATURES];
+  knnScale(model, raw, query);
+  return knnClassifyScaled(model, query);
+}
+
+// Klasifikasi satu titik fitur mentah dalam satuan x100 (int16), seluruhnya aritmetika integer
+inline uint8_t knnClassify(const KnnQuantizedModel &model, const int16_t *rawX100)
+{
+  int16_t query[KNN_MAX_FEATURES];
+  knnQuantize(model, rawX100, query);
+  return knnClassifyScaled(model, query);
+}
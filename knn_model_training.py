@@ -12,6 +12,7 @@ from sklearn.metrics import ( # Modul metrics untuk evaluasi model
     f1_score,  # Menghitung F1-score
 )
 import joblib  # Joblib untuk menyimpan dan memuat model scikit-learn
+import math  # Modul math untuk menghitung parameter kuantisasi fixed-point
 import os  # Modul os untuk berinteraksi dengan sistem operasi (tidak secara eksplisit digunakan di sini, tapi sering ada dalam skrip ML)
 from tabulate import tabulate # Tabulate untuk membuat tabel yang rapi di output konsol
 
@@ -21,11 +22,19 @@ TEST_SIZE = 0.3  # Proporsi dataset yang akan digunakan sebagai data uji (30%)
 RANDOM_STATE = 101  # Seed untuk generator angka acak, memastikan hasil pembagian data konsisten
 MODEL_FILE = 'knn_model.joblib'  # Nama file untuk menyimpan model KNN yang sudah dilatih
 SCALER_FILE = 'scaler.joblib'  # Nama file untuk menyimpan objek scaler
+KNN_HEADER_FILE = 'knn_model.h'  # Header C berisi data latih, scaler, dan k untuk inferensi KNN di Receiver (knn_classifier.h)
+KNN_LEAF_SIZE = 8  # Ukuran daun KD-tree implisit di header C (rentang sekecil ini dipindai linear)
+KNN_QUANT_LIMIT = 8191  # Batas fitur terkuantisasi int16, harus sama dengan knn_classifier.h
+KNN_QUANT_RECIP_SHIFT = 16  # Bit pecahan faktor kebalikan scale, harus sama dengan knn_classifier.h
 # --- parameter grid untuk GridSearchCV ---
 PARAM_GRID = {
     'n_neighbors': range(1, 21),  # Daftar nilai K (jumlah tetangga) yang akan diuji, dari 1 sampai 20
 }
 CV = 5  # Jumlah lipatan (folds) untuk cross-validation (validasi silang 5-lipatan)
+# Fitur model. Jika CSV berisi profil suhu multi-probe (temperature_min/temperature_max), model memakai
+# PROFILE_FEATURE_COLUMNS; urutan ini harus sama dengan feature_row() di server.py dan fitur KNN di Receiver.cpp
+FEATURE_COLUMNS = ['temperature', 'humidity', 'ph']
+PROFILE_FEATURE_COLUMNS = ['temperature_min', 'temperature', 'temperature_max', 'humidity', 'ph']
 
 
 # Fungsi untuk memuat data, melakukan pra-pemrosesan, dan membaginya menjadi data latih dan data uji
@@ -38,7 +47,9 @@ def load_and_split_data():
             # Jika tidak ada, tampilkan pesan error
             raise ValueError("CSV must contain 'temperature', 'humidity', 'ph', and 'classification'.")
         # Memisahkan fitur (X) dan target (y)
-        X = df[['temperature', 'humidity', 'ph']].values  # Fitur: suhu, kelembaban, pH
+        feature_columns = PROFILE_FEATURE_COLUMNS if set(PROFILE_FEATURE_COLUMNS).issubset(df.columns) else FEATURE_COLUMNS
+        print(f"Features: {feature_columns}")
+        X = df[feature_columns].values  # Fitur: suhu (atau profil suhu min/rata-rata/max), kelembaban, pH
         # Mengubah label klasifikasi dari teks ('Layak', 'Tidak Layak') menjadi numerik (1, 0)
         y = df['classification'].map({'Layak': 1, 'Tidak Layak': 0})
         # Memisahkan data menjadi data latih (train) dan data uji (test)
@@ -134,6 +145,145 @@ def save_model_and_scaler(model, scaler, model_path, scaler_path):
         # Menangani error jika gagal menyimpan model atau scaler
         print(f"Error saving model/scaler: {e}")
 
+# Fungsi untuk menyusun data latih menjadi KD-tree implisit (tanpa pointer) sesuai tata letak knn_classifier.h
+def build_kd_layout(samples, labels, leaf_size):
+    """Mengurutkan ulang sampel: untuk rentang [lo, hi) yang lebih besar dari leaf_size, median pada dimensi
+    dengan sebaran terbesar diletakkan di mid = lo + (hi - lo) // 2, sisi kiri <= median dan sisi kanan >= median.
+    Mengembalikan (samples, labels, split_dims) dalam urutan baru; split_dims hanya bermakna di posisi node."""
+    order = list(range(len(samples)))
+    split_dims = [0] * len(samples)
+    ranges = [(0, len(samples))]
+    while ranges:
+        lo, hi = ranges.pop()
+        if hi - lo <= leaf_size:
+            continue
+        spreads = [max(samples[i][d] for i in order[lo:hi]) - min(samples[i][d] for i in order[lo:hi]) for d in range(len(samples[0]))]
+        dim = spreads.index(max(spreads))
+        order[lo:hi] = sorted(order[lo:hi], key=lambda i: samples[i][dim])
+        mid = lo + (hi - lo) // 2
+        split_dims[mid] = dim
+        ranges += [(lo, mid), (mid + 1, hi)]
+    return [samples[i] for i in order], [labels[i] for i in order], split_dims
+
+# Fungsi untuk menghitung parameter kuantisasi fixed-point (lihat KnnQuantizedModel di knn_classifier.h)
+def quantization_params(scaler, X_train_scaled):
+    """Memilih quant_scale (pangkat dua) sehingga fitur ter-scale data latih muat di +-KNN_QUANT_LIMIT,
+    lalu menghitung faktor kebalikan scale (Q16) dan offset mean untuk input sensor x100."""
+    max_abs = max(abs(float(value)) for row in X_train_scaled for value in row) or 1.0
+    quant_scale = 2 ** math.floor(math.log2(KNN_QUANT_LIMIT / max_abs))
+    recip_scale = [round(quant_scale * 2 ** KNN_QUANT_RECIP_SHIFT / (float(scale) * 100)) for scale in scaler.scale_]
+    offset = [round(float(mean) * 100 * recip) - 2 ** (KNN_QUANT_RECIP_SHIFT - 1) for mean, recip in zip(scaler.mean_, recip_scale)]
+    return quant_scale, recip_scale, offset
+
+def clamp_quantized(value):
+    return max(-KNN_QUANT_LIMIT, min(KNN_QUANT_LIMIT, value))
+
+# Nilai sensor ke satuan x100 dengan pembulatan yang sama seperti telemetryToFixed() di telemetry_frame.h
+def to_fixed(value):
+    scaled = value * 100
+    scaled += 0.5 if scaled >= 0 else -0.5
+    return max(-32768, min(32767, int(scaled)))
+
+# Replika knnQuantize() di knn_classifier.h dengan aritmetika integer yang sama
+def quantize_reading(raw, recip_scale, offset):
+    return [clamp_quantized((to_fixed(value) * recip - off) >> KNN_QUANT_RECIP_SHIFT) for value, recip, off in zip(raw, recip_scale, offset)]
+
+# Fungsi untuk mengekspor model KNN ke header C agar klasifikasi bisa dijalankan langsung di Receiver
+def export_knn_header(model, scaler, X_train_scaled, y_train, header_path):
+    """Menulis data latih terkuantisasi int16, parameter kuantisasi, indeks KD-tree, dan k ke header C.
+    Header ini dibaca knn_classifier.h; KNN tidak punya bobot, jadi 'model'-nya adalah data latih itu sendiri."""
+    try:
+        # knn_classifier.h hanya mengimplementasikan jarak euclidean dengan voting seragam
+        if model.weights != 'uniform' or model.metric != 'euclidean':
+            raise ValueError(f"Unsupported KNN config: weights={model.weights}, metric={model.metric}")
+
+        quant_scale, recip_scale, offset = quantization_params(scaler, X_train_scaled)
+        # Data latih hasil StandardScaler, dikuantisasi ke int16
+        samples = [[clamp_quantized(round(float(value) * quant_scale)) for value in row] for row in X_train_scaled]
+        labels = [int(label) for label in y_train]  # Label numerik (1 = Layak, 0 = Belum layak)
+        k = int(model.n_neighbors)  # Nilai k terbaik dari GridSearchCV
+        feature_count = len(scaler.mean_)
+        feature_columns = PROFILE_FEATURE_COLUMNS if feature_count == len(PROFILE_FEATURE_COLUMNS) else FEATURE_COLUMNS
+        class_count = max(labels) + 1
+        # Indeks KD-tree dibangun offline agar pencarian di Receiver tidak linear terhadap ukuran data latih
+        samples, labels, split_dims = build_kd_layout(samples, labels, KNN_LEAF_SIZE)
+
+        def ints(values, suffix=""):
+            return ", ".join(f"{value}{suffix}" for value in values)
+
+        lines = [
+            "#pragma once",
+            "",
+            "// Dihasilkan oleh knn_model_training.py (export_knn_header), jangan diedit manual.",
+            f"// k={k}, {len(samples)} sampel latih, fitur: {', '.join(feature_columns)}",
+            f"// StandardScaler mean={[round(float(v), 6) for v in scaler.mean_]}, scale={[round(float(v), 6) for v in scaler.scale_]}",
+            "",
+            '#include "knn_classifier.h"',
+            "",
+            f"#define KNN_MODEL_K {k}",
+            f"#define KNN_MODEL_FEATURES {feature_count}",
+            f"#define KNN_MODEL_SAMPLES {len(samples)}",
+            f"#define KNN_MODEL_LEAF_SIZE {KNN_LEAF_SIZE}",
+            f"#define KNN_MODEL_QUANT_SCALE {quant_scale} // Fitur ter-scale z disimpan sebagai round(z * {quant_scale})",
+            "",
+            f"static const int32_t knnRecipScale[KNN_MODEL_FEATURES] = {{{ints(recip_scale)}}};",
+            f"static const int64_t knnOffset[KNN_MODEL_FEATURES] = {{{ints(offset, 'LL')}}};",
+            "",
+            "static const int16_t knnTrainingSamples[KNN_MODEL_SAMPLES * KNN_MODEL_FEATURES] = {",
+        ]
+        lines += [f"    {ints(row)}," for row in samples]
+        lines += [
+            "};",
+            "",
+            "static const uint8_t knnTrainingLabels[KNN_MODEL_SAMPLES] = {",
+        ]
+        lines += ["    " + ", ".join(str(label) for label in labels[i:i + 32]) + "," for i in range(0, len(labels), 32)]
+        lines += [
+            "};",
+            "",
+            "// Dimensi pemisah node KD-tree implisit (lihat knn_classifier.h)",
+            "static const uint8_t knnSplitDims[KNN_MODEL_SAMPLES] = {",
+        ]
+        lines += ["    " + ", ".join(str(dim) for dim in split_dims[i:i + 32]) + "," for i in range(0, len(split_dims), 32)]
+        lines += [
+            "};",
+            "",
+            f"static const KnnQuantizedModel knnModel = {{KNN_MODEL_FEATURES, {class_count}, KNN_MODEL_K, KNN_MODEL_SAMPLES,",
+            "                                           knnRecipScale, knnOffset, knnTrainingSamples, knnTrainingLabels,",
+            "                                           KNN_MODEL_LEAF_SIZE, knnSplitDims};",
+            "",
+        ]
+
+        with open(header_path, 'w') as header:
+            header.write("\n".join(lines))
+        print(f"KNN header exported to {header_path} (k={k}, {len(samples)} samples, quant_scale={quant_scale})") # Pesan konfirmasi ekspor
+        return samples, labels, k, recip_scale, offset
+    except Exception as e:
+        # Menangani error jika gagal mengekspor header
+        print(f"Error exporting KNN header: {e}")
+        return None
+
+# Fungsi untuk memastikan model terkuantisasi di header menghasilkan prediksi yang sama dengan model float scikit-learn
+def verify_exported_knn(model, scaler, exported, X_test_scaled):
+    """Menjalankan ulang algoritma knn_classifier.h dengan aritmetika integer yang sama (Python murni)
+    pada data uji dan membandingkannya dengan model.predict (float)."""
+    samples, labels, k, recip_scale, offset = exported
+    raw_test = scaler.inverse_transform(X_test_scaled)  # Fitur mentah, seperti yang diterima Receiver dari LoRa
+    expected = model.predict(X_test_scaled)
+    mismatches = 0
+    for raw, want in zip(raw_test, expected):
+        query = quantize_reading(raw, recip_scale, offset)
+        distances = sorted((sum((a - b) ** 2 for a, b in zip(sample, query)), label) for sample, label in zip(samples, labels))
+        votes = [0] * (max(labels) + 1)
+        for _, label in distances[:k]:
+            votes[label] += 1
+        if votes.index(max(votes)) != int(want):  # index() memilih label terkecil saat seri, sama seperti C++
+            mismatches += 1
+    print(f"Quantized KNN agrees with scikit-learn float model on {len(expected) - mismatches}/{len(expected)} test samples")
+    if mismatches:
+        print("WARNING: quantized predictions differ from the float model, check KNN_QUANT_LIMIT / dataset range")
+    return mismatches == 0
+
 # Fungsi utama yang menjalankan seluruh alur proses
 def main():
     # Memuat, memproses, dan membagi data. Juga mendapatkan scaler.
@@ -148,6 +298,10 @@ def main():
         evaluate_model(best_knn_model, X_test_scaled, y_test)
         # Menyimpan model terbaik dan scaler yang digunakan
         save_model_and_scaler(best_knn_model, scaler, MODEL_FILE, SCALER_FILE)
+        # Mengekspor model ke header C untuk inferensi di Receiver, lalu memverifikasinya
+        exported = export_knn_header(best_knn_model, scaler, X_train_scaled, y_train, KNN_HEADER_FILE)
+        if exported is not None:
+            verify_exported_knn(best_knn_model, scaler, exported, X_test_scaled)
     else:
         # Jika data gagal dimuat atau diproses, tampilkan pesan error
         print("Model training failed due to data loading/processing issues.")
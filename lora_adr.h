@@ -0,0 +1,524 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lora_arq.h"
+
+// Adaptive data rate (ADR): SF dan daya TX dipilih dari kualitas link, bukan lagi diatur manual di LCD.
+// Receiver hanya punya satu radio SX1278 yang mendemodulasi satu SF pada satu waktu, jadi SF (dan BW/CR yang
+// tetap manual) berlaku untuk seluruh jaringan; yang diatur per node adalah daya TX. Receiver mencatat SNR
+// ADR_HISTORY paket terakhir tiap node dan memakai SNR maksimumnya (seperti ADR LoRaWAN):
+//  - daya node diturunkan/dinaikkan per ADR_POWER_STEP_DB sampai cadangan SNR di atas batas demodulasi SF
+//    jaringan tinggal ADR_MARGIN_DB
+//  - SF jaringan = SF terendah yang masih menyisakan ADR_MARGIN_DB untuk node terburuk pada daya maksimum;
+//    turun satu tingkat per keputusan, naik langsung ke SF yang dibutuhkan
+//
+// Negosiasi: perintah menumpang di belakang frame ACK (flag ArqAckCommand) dan diulang di setiap ACK sampai node
+// melaporkan nomor perintah itu di flags frame telemetri (TelemetryAdrCapable + TelemetryAdrCommandMask).
+// Perintah dengan SF sama dengan SF node langsung diterapkan (daya). Pergantian SF dua fase: usulan
+// (switchIn = ADR_SWITCH_UNSCHEDULED) hanya disimpan node; setelah semua node aktif mengonfirmasi usulan (atau
+// batas waktu lewat untuk SF naik), Receiver menetapkan waktu ganti, ACK berikutnya membawa sisa waktunya, dan
+// Receiver serta node berganti SF bersamaan. Node yang kehilangan link (ADR_LINK_LOST_TX kiriman berturut-turut
+// tanpa ACK) memakai usulan yang tersimpan, lalu kembali ke SF terakhir tempat Receiver terdengar dengan daya
+// maksimum, lalu mencari hanya ke SF di atasnya sampai SF12 dan mulai lagi dari SF terakhir itu (tidak pernah
+// melompat dari SF12 ke SF7) sampai terdengar lagi; nomor perintahnya kembali 0 dan Receiver mulai lagi dari
+// perintah awal (daya maksimum).
+// Karena node yang kehilangan link tidak mencari ke SF lebih rendah, SF jaringan tidak diturunkan selama ada node
+// ADR terdaftar yang sedang diam (kurang dari ADR_NODE_GONE_MS).
+// Selama ada node aktif tanpa ADR (firmware lama), SF jaringan tidak diubah karena node itu tidak bisa ikut.
+// Pengaturan ADR hanya di RAM/RTC; EEPROM tetap berisi pengaturan manual sebagai titik awal setelah cold boot.
+// Tidak bergantung pada Arduino sehingga dipakai juga oleh simulator (host/sim/lora_channel_sim.cpp).
+//
+// Perintah ADR (ARQ_ACK_COMMAND_SIZE byte setelah frame ACK):
+//  byte 0     : nomor perintah 1..ADR_COMMAND_ID_MAX
+//  byte 1     : SF 7..12
+//  byte 2     : daya TX dBm, int8
+//  byte 3..4  : detik sampai ganti SF, uint16 little endian, ADR_SWITCH_UNSCHEDULED = usulan belum dijadwalkan
+//  byte 5..6  : CRC-16/CCITT-FALSE dari byte 0..4
+
+#define ADR_MARGIN_DB 10.0f          // Cadangan SNR untuk fading/shadowing di atas batas demodulasi SF
+#define ADR_HISTORY 8                // Paket per node sebelum keputusan; SNR maksimum dari sekian paket terakhir
+#define ADR_POWER_STEP_DB 3
+#define ADR_POWER_MIN_DBM 2
+#define ADR_POWER_MAX_DBM 20         // PA_BOOST SX1278
+#define ADR_POWER_UNKNOWN -128       // Daya node belum diketahui Receiver (belum mengonfirmasi perintah)
+#define ADR_SF_MIN 7
+#define ADR_SF_MAX 12
+#define ADR_COMMAND_ID_MAX 7         // Nomor perintah 3 bit di flags frame, 0 = node belum menerima perintah
+#define ADR_SWITCH_UNSCHEDULED 0xFFFF
+#define ADR_SWITCH_MIN_MS 30000UL    // Jeda minimal usulan terjadwal sampai ganti SF
+#define ADR_SWITCH_MAX_MS 1800000UL
+#define ADR_PROPOSE_TIMEOUT_MS 600000UL // Minimal; usulan SF yang belum dikonfirmasi semua node: dibatalkan (turun) atau dipaksa (naik)
+#define ADR_LINK_LOST_TX 16           // Kiriman berturut-turut tanpa ACK sebelum node mencoba pengaturan lain
+#define ADR_NODE_GONE_MS 86400000UL   // Node ADR yang diam selama ini dianggap sudah dicabut, tidak lagi menahan SF turun
+
+// SNR minimal demodulasi SX1276/SX1278 (datasheet): SF7 -7.5 dB sampai SF12 -20 dB, 2.5 dB per SF
+inline float adrRequiredSnrDb(int spreadingFactor)
+{
+  return -7.5f - 2.5f * (spreadingFactor - 7);
+}
+
+struct AdrCommand
+{
+  uint8_t id;
+  uint8_t spreadingFactor;
+  int8_t txPower;
+  uint16_t switchInS; // ADR_SWITCH_UNSCHEDULED, atau detik sampai ganti SF (0 = sekarang)
+};
+
+inline size_t encodeAdrCommand(const AdrCommand &command, uint8_t *buffer, size_t bufferSize)
+{
+  if (bufferSize < ARQ_ACK_COMMAND_SIZE)
+    return 0;
+  buffer[0] = command.id;
+  buffer[1] = command.spreadingFactor;
+  buffer[2] = (uint8_t)command.txPower;
+  telemetryWriteInt16(&buffer[3], (int16_t)command.switchInS);
+  uint16_t crc = telemetryCrc16(buffer, ARQ_ACK_COMMAND_SIZE - 2);
+  buffer[5] = crc & 0xFF;
+  buffer[6] = crc >> 8;
+  return ARQ_ACK_COMMAND_SIZE;
+}
+
+inline bool decodeAdrCommand(const uint8_t *buffer, size_t length, AdrCommand &command)
+{
+  if (length != ARQ_ACK_COMMAND_SIZE)
+    return false;
+  uint16_t crc = buffer[5] | (uint16_t)buffer[6] << 8;
+  if (crc != telemetryCrc16(buffer, ARQ_ACK_COMMAND_SIZE - 2))
+    return false;
+  if (buffer[0] == 0 || buffer[0] > ADR_COMMAND_ID_MAX || buffer[1] < ADR_SF_MIN || buffer[1] > ADR_SF_MAX)
+    return false;
+  command.id = buffer[0];
+  command.spreadingFactor = buffer[1];
+  command.txPower = (int8_t)buffer[2];
+  command.switchInS = (uint16_t)telemetryReadInt16(&buffer[3]);
+  return true;
+}
+
+// Bit flags frame telemetri yang melaporkan status ADR node
+inline uint8_t adrFrameFlags(uint8_t commandId)
+{
+  return TelemetryAdrCapable | (uint8_t)(commandId << TELEMETRY_ADR_COMMAND_SHIFT);
+}
+
+// Status ADR satu node di Receiver. Tanpa constructor; panggil reset() saat node baru terdaftar.
+struct AdrNode
+{
+  int8_t snr[ADR_HISTORY]; // SNR paket terakhir, satuan 0.25 dB
+  uint8_t samples;         // Jumlah SNR yang valid (maks ADR_HISTORY), dihitung ulang setiap daya/SF berubah
+  uint8_t next;
+  bool capable;            // Node melaporkan TelemetryAdrCapable
+  bool confirmed;          // Node melaporkan nomor perintah terakhir
+  int8_t txPower;          // Daya node menurut perintah yang dikonfirmasi, ADR_POWER_UNKNOWN
+  AdrCommand command;      // Perintah terakhir, id 0 = belum pernah
+  uint32_t lastFrameMs;
+  uint32_t intervalMs;     // Rata-rata jarak antar frame, untuk jeda pergantian SF
+
+  void reset()
+  {
+    samples = 0;
+    next = 0;
+    capable = false;
+    confirmed = false;
+    txPower = ADR_POWER_UNKNOWN;
+    command = {0, 0, 0, 0};
+    lastFrameMs = 0;
+    intervalMs = 0;
+  }
+
+  void clearHistory()
+  {
+    samples = 0;
+    next = 0;
+  }
+
+  float maxSnrDb() const
+  {
+    int8_t best = snr[0];
+    for (uint8_t i = 1; i < samples; i++)
+      best = snr[i] > best ? snr[i] : best;
+    return best / 4.0f;
+  }
+
+  // Batas diam sebelum node dianggap tidak aktif: minimal minimumMs, diperpanjang untuk node yang memang jarang
+  // mengirim (dua interval terlewat) agar tidak tertinggal dari pergantian SF
+  uint32_t staleMs(uint32_t minimumMs) const
+  {
+    uint32_t missedMs = 2 * intervalMs + 10000UL;
+    return missedMs > minimumMs ? missedMs : minimumMs;
+  }
+
+  // Siap dipakai untuk keputusan: daya diketahui dan riwayat SNR penuh pada daya itu
+  bool measured() const { return confirmed && txPower != ADR_POWER_UNKNOWN && samples >= ADR_HISTORY; }
+  // Perintah yang belum dikonfirmasi ikut di setiap ACK ke node ini
+  bool commandPending() const { return capable && command.id != 0 && !confirmed; }
+};
+
+// Keputusan ADR di Receiver: satu instance untuk jaringan, status per node di AdrNode milik registry pemanggil.
+// Fungsi yang memeriksa semua node menerima nodeAt(i) untuk i < count yang mengembalikan AdrNode* node aktif
+// (NULL untuk node yang sudah stale). Tanpa constructor; panggil begin() sebelum dipakai.
+class AdrController
+{
+public:
+  void begin(uint8_t spreadingFactor)
+  {
+    sf = spreadingFactor;
+    proposedSf = 0;
+    proposedAtMs = 0;
+    switchAtMs = 0;
+    switchScheduled = false;
+    sfChanges = 0;
+    powerCommands = 0;
+  }
+
+  uint8_t spreadingFactor() const { return sf; }
+  uint8_t proposal() const { return proposedSf; } // SF yang sedang diusulkan, 0 = tidak ada
+  bool switching() const { return switchScheduled; }
+  uint32_t changes() const { return sfChanges; }
+  uint32_t commands() const { return powerCommands; }
+
+  // Frame telemetri (bukan duplikat) dari node: konfirmasi perintah, catat SNR, susun perintah daya baru
+  void onFrame(AdrNode &node, uint8_t frameFlags, float snrDb, uint32_t nowMs)
+  {
+    if (node.lastFrameMs != 0)
+    {
+      uint32_t interval = nowMs - node.lastFrameMs;
+      node.intervalMs = node.intervalMs == 0 ? interval : node.intervalMs + ((int32_t)(interval - node.intervalMs)) / 4;
+    }
+    node.lastFrameMs = nowMs;
+    node.capable = frameFlags & TelemetryAdrCapable;
+    if (!node.capable)
+      return;
+
+    uint8_t reported = (frameFlags & TelemetryAdrCommandMask) >> TELEMETRY_ADR_COMMAND_SHIFT;
+    if (node.command.id != 0 && reported == node.command.id && node.command.spreadingFactor != sf && node.command.spreadingFactor != proposedSf)
+    {
+      // Perintah untuk SF lama (node stale saat SF jaringan berganti, lalu menemukan SF ini sendiri)
+      node.txPower = ADR_POWER_UNKNOWN;
+      node.clearHistory();
+      issue(node, sf, ADR_POWER_MAX_DBM);
+      return;
+    }
+    if (node.command.id != 0 && reported == node.command.id)
+    {
+      // Node terdengar pada SF jaringan dengan perintah ini (diterapkan langsung, atau usulan yang dipakai saat
+      // fallback link): dayanya sekarang daya perintah
+      if ((!node.confirmed || node.txPower == ADR_POWER_UNKNOWN) && node.command.spreadingFactor == sf)
+      {
+        node.txPower = node.command.txPower; // Perintah daya sudah diterapkan: SNR diukur ulang pada daya baru
+        node.clearHistory();
+      }
+      node.confirmed = true;
+    }
+    else if (reported == 0 && !(node.command.id != 0 && !node.confirmed && node.command.spreadingFactor == sf &&
+                                node.command.txPower == ADR_POWER_MAX_DBM))
+    {
+      // Node baru, restart, atau fallback link: daya tidak diketahui, mulai dari daya maksimum
+      node.txPower = ADR_POWER_UNKNOWN;
+      node.clearHistory();
+      issue(node, sf, ADR_POWER_MAX_DBM);
+      return;
+    }
+
+    if (!node.confirmed || node.txPower == ADR_POWER_UNKNOWN)
+      return;
+    int16_t quarterDb = (int16_t)(snrDb * 4.0f + (snrDb >= 0 ? 0.5f : -0.5f));
+    node.snr[node.next] = (int8_t)(quarterDb > 127 ? 127 : quarterDb < -128 ? -128 : quarterDb);
+    node.next = (node.next + 1) % ADR_HISTORY;
+    if (node.samples < ADR_HISTORY)
+      node.samples++;
+
+    if (proposedSf != 0 || !node.measured())
+      return;
+    int8_t power = powerFor(node, sf);
+    if (power != node.txPower)
+    {
+      issue(node, sf, power);
+      powerCommands++;
+    }
+  }
+
+  // Keputusan SF jaringan dan kemajuan usulan; dipanggil setelah onFrame. silentNodes = node ADR terdaftar yang
+  // sedang tidak aktif (nodeAt NULL) tapi belum dianggap dicabut
+  template <typename NodeAt>
+  void plan(uint8_t count, NodeAt nodeAt, uint32_t nowMs, uint8_t silentNodes)
+  {
+    if (switchScheduled)
+      return;
+    if (proposedSf != 0)
+    {
+      progressProposal(count, nodeAt, nowMs, silentNodes);
+      return;
+    }
+
+    uint8_t target = ADR_SF_MIN;
+    bool complete = true;
+    for (uint8_t i = 0; i < count; i++)
+    {
+      AdrNode *node = nodeAt(i);
+      if (node == NULL)
+        continue;
+      if (!node->capable)
+        return; // Node tanpa ADR tidak bisa ikut pindah SF
+      if (!node->measured())
+      {
+        complete = false;
+        continue;
+      }
+      uint8_t needed = sfFor(*node);
+      target = needed > target ? needed : target;
+    }
+    if (target < sf && (!complete || silentNodes > 0))
+      return; // SF hanya turun jika semua node aktif sudah terukur dan tidak ada node yang tertinggal
+    if (target == sf)
+      return;
+
+    proposedSf = target > sf ? target : sf - 1;
+    proposedAtMs = nowMs;
+    for (uint8_t i = 0; i < count; i++)
+    {
+      AdrNode *node = nodeAt(i);
+      if (node != NULL)
+        issue(*node, proposedSf, node->measured() ? powerFor(*node, proposedSf) : ADR_POWER_MAX_DBM);
+    }
+  }
+
+  // Waktu ganti SF sudah tiba: true jika SF jaringan berganti (radio Receiver harus dikonfigurasi ulang).
+  // Node yang sudah mengonfirmasi jadwal berganti bersamaan, node lain dianggap dayanya tidak diketahui
+  template <typename NodeAt>
+  bool service(uint8_t count, NodeAt nodeAt, uint32_t nowMs)
+  {
+    if (!switchScheduled || (int32_t)(nowMs - switchAtMs) < 0)
+      return false;
+    for (uint8_t i = 0; i < count; i++)
+    {
+      AdrNode *node = nodeAt(i);
+      if (node == NULL)
+        continue;
+      node->clearHistory();
+      bool followed = node->confirmed && node->command.spreadingFactor == proposedSf && node->command.switchInS != ADR_SWITCH_UNSCHEDULED;
+      node->txPower = followed ? node->command.txPower : ADR_POWER_UNKNOWN;
+    }
+    sf = proposedSf;
+    proposedSf = 0;
+    switchScheduled = false;
+    sfChanges++;
+    return true;
+  }
+
+  // Perintah yang ditempelkan ke ACK untuk node ini; sisa waktu ganti SF dihitung saat ACK dikirim
+  AdrCommand commandFor(const AdrNode &node, uint32_t nowMs) const
+  {
+    AdrCommand command = node.command;
+    if (command.switchInS != ADR_SWITCH_UNSCHEDULED && command.spreadingFactor != sf)
+    {
+      int32_t remainingMs = switchScheduled ? (int32_t)(switchAtMs - nowMs) : 0;
+      command.switchInS = remainingMs > 0 ? (uint16_t)((remainingMs + 999) / 1000) : 0;
+    }
+    return command;
+  }
+
+  // Sisa waktu sampai ganti SF (untuk menunggu di task RX), 0 jika tidak ada jadwal
+  uint32_t msUntilSwitch(uint32_t nowMs) const
+  {
+    if (!switchScheduled)
+      return 0;
+    int32_t remaining = (int32_t)(switchAtMs - nowMs);
+    return remaining > 0 ? (uint32_t)remaining : 1;
+  }
+
+  // Daya terendah yang menyisakan ADR_MARGIN_DB pada SF itu (kelipatan ADR_POWER_STEP_DB dari daya sekarang)
+  static int8_t powerFor(const AdrNode &node, uint8_t spreadingFactor)
+  {
+    float margin = node.maxSnrDb() - adrRequiredSnrDb(spreadingFactor) - ADR_MARGIN_DB;
+    int steps = (int)(margin >= 0 ? margin / ADR_POWER_STEP_DB : margin / ADR_POWER_STEP_DB - 0.999f);
+    int power = node.txPower - steps * ADR_POWER_STEP_DB;
+    return (int8_t)(power < ADR_POWER_MIN_DBM ? ADR_POWER_MIN_DBM : power > ADR_POWER_MAX_DBM ? ADR_POWER_MAX_DBM : power);
+  }
+
+  // SF terendah yang menyisakan ADR_MARGIN_DB jika node memakai daya maksimum
+  static uint8_t sfFor(const AdrNode &node)
+  {
+    float snrAtMax = node.maxSnrDb() + (ADR_POWER_MAX_DBM - node.txPower);
+    for (uint8_t spreadingFactor = ADR_SF_MIN; spreadingFactor < ADR_SF_MAX; spreadingFactor++)
+    {
+      if (snrAtMax - adrRequiredSnrDb(spreadingFactor) >= ADR_MARGIN_DB)
+        return spreadingFactor;
+    }
+    return ADR_SF_MAX;
+  }
+
+private:
+  void issue(AdrNode &node, uint8_t spreadingFactor, int8_t txPower)
+  {
+    node.command.id = node.command.id % ADR_COMMAND_ID_MAX + 1;
+    node.command.spreadingFactor = spreadingFactor;
+    node.command.txPower = txPower;
+    node.command.switchInS = spreadingFactor == sf || !switchScheduled ? ADR_SWITCH_UNSCHEDULED : 0;
+    node.confirmed = false;
+  }
+
+  // Usulan dijadwalkan setelah semua node aktif menyimpannya; jeda ganti cukup untuk dua frame node paling
+  // jarang agar setiap node sempat menerima jadwalnya. Usulan SF naik (link memburuk) dipaksa setelah batas
+  // waktu, usulan SF turun dibatalkan
+  template <typename NodeAt>
+  void progressProposal(uint8_t count, NodeAt nodeAt, uint32_t nowMs, uint8_t silentNodes)
+  {
+    bool accepted = proposedSf > sf || silentNodes == 0; // Node yang diam tidak akan menemukan SF lebih rendah
+    uint32_t slowestMs = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+      AdrNode *node = nodeAt(i);
+      if (node == NULL)
+        continue;
+      if (!node->capable)
+        accepted = false;
+      else if (node->command.spreadingFactor != proposedSf)
+        issue(*node, proposedSf, ADR_POWER_MAX_DBM); // Node baru terdengar setelah usulan dibuat
+      if (!node->confirmed)
+        accepted = false;
+      slowestMs = node->intervalMs > slowestMs ? node->intervalMs : slowestMs;
+    }
+
+    uint32_t timeoutMs = 4 * slowestMs > ADR_PROPOSE_TIMEOUT_MS ? 4 * slowestMs : ADR_PROPOSE_TIMEOUT_MS; // ACK lalu frame konfirmasi, dengan cadangan kiriman hilang
+    bool expired = nowMs - proposedAtMs > timeoutMs;
+    if (!accepted && expired && proposedSf < sf)
+    {
+      for (uint8_t i = 0; i < count; i++)
+      {
+        AdrNode *node = nodeAt(i);
+        if (node != NULL && node->capable)
+          issue(*node, sf, node->txPower == ADR_POWER_UNKNOWN ? ADR_POWER_MAX_DBM : node->txPower); // Batalkan usulan di node
+      }
+      proposedSf = 0;
+      return;
+    }
+    if (!accepted && !expired)
+      return;
+
+    uint32_t delayMs = 2 * slowestMs + 2000;
+    switchAtMs = nowMs + (delayMs < ADR_SWITCH_MIN_MS ? ADR_SWITCH_MIN_MS : delayMs > ADR_SWITCH_MAX_MS ? ADR_SWITCH_MAX_MS : delayMs);
+    switchScheduled = true;
+    for (uint8_t i = 0; i < count; i++)
+    {
+      AdrNode *node = nodeAt(i);
+      if (node != NULL && node->capable)
+        issue(*node, proposedSf, node->command.txPower);
+    }
+  }
+
+  uint8_t sf;
+  uint8_t proposedSf;
+  uint32_t proposedAtMs;
+  uint32_t switchAtMs;
+  bool switchScheduled;
+  uint32_t sfChanges;
+  uint32_t powerCommands;
+};
+
+// Status ADR di transmitter, disimpan di memori RTC agar bertahan lintas deep sleep. Tanpa constructor;
+// clear() saat cold boot, begin() setelah pengaturan manual dimuat dari EEPROM.
+struct AdrLink
+{
+  uint8_t spreadingFactor; // Pengaturan radio aktif, 0 = belum dimuat
+  int8_t txPower;
+  uint8_t commandId;       // Perintah terakhir yang diterima, dilaporkan di flags frame
+  uint8_t pendingSf;       // Usulan SF yang disimpan, 0 = tidak ada
+  int8_t pendingPower;
+  bool switchScheduled;
+  uint32_t switchAtMs;
+  uint8_t unanswered;      // Kiriman berturut-turut tanpa ACK
+  uint8_t heardSf;         // SF terakhir tempat Receiver terdengar, awal pencarian saat link hilang
+  uint32_t fallbacks;      // Pengaturan yang dicoba karena link hilang
+
+  void clear() { spreadingFactor = 0; }
+  bool loaded() const { return spreadingFactor != 0; }
+
+  void begin(uint8_t sf, int8_t power)
+  {
+    spreadingFactor = sf;
+    txPower = power;
+    commandId = 0;
+    pendingSf = 0;
+    switchScheduled = false;
+    unanswered = 0;
+    heardSf = sf;
+    fallbacks = 0;
+  }
+
+  uint8_t frameFlags() const { return adrFrameFlags(commandId); }
+
+  // Perintah dari ACK; true jika pengaturan radio berubah sekarang
+  bool onCommand(const AdrCommand &command, uint32_t nowMs)
+  {
+    commandId = command.id;
+    if (command.spreadingFactor == spreadingFactor)
+    {
+      pendingSf = 0;
+      switchScheduled = false;
+      bool changed = txPower != command.txPower;
+      txPower = command.txPower;
+      return changed;
+    }
+    pendingSf = command.spreadingFactor;
+    pendingPower = command.txPower;
+    switchScheduled = command.switchInS != ADR_SWITCH_UNSCHEDULED;
+    switchAtMs = nowMs + (uint32_t)command.switchInS * 1000;
+    return service(nowMs);
+  }
+
+  // Waktu ganti SF yang dijadwalkan sudah tiba; true jika pengaturan radio berubah
+  bool service(uint32_t nowMs)
+  {
+    if (!switchScheduled || (int32_t)(nowMs - switchAtMs) < 0)
+      return false;
+    applyPending();
+    return true;
+  }
+
+  // Paket dari Receiver terdengar pada SF ini (ACK, beacon, atau balasan untuk node lain): link hidup, kiriman
+  // yang tidak di-ACK hanya karena tabrakan tidak boleh memicu pencarian pengaturan lain
+  void onHeard()
+  {
+    unanswered = 0;
+    heardSf = spreadingFactor;
+  }
+
+  // Satu kiriman tanpa ACK; true jika pengaturan radio berubah karena link dianggap hilang
+  bool onUnanswered()
+  {
+    if (++unanswered < ADR_LINK_LOST_TX)
+      return false;
+    unanswered = 0;
+    fallbacks++;
+    if (pendingSf != 0)
+    {
+      applyPending(); // Receiver kemungkinan sudah pindah ke SF usulan
+      return true;
+    }
+    commandId = 0;
+    bool searching = spreadingFactor > heardSf && txPower == ADR_POWER_MAX_DBM;
+    if (searching ? spreadingFactor >= ADR_SF_MAX : spreadingFactor != heardSf || txPower < ADR_POWER_MAX_DBM)
+    {
+      // SF yang terakhir terbukti dipakai Receiver dicoba (lagi) dengan daya penuh
+      spreadingFactor = heardSf;
+      txPower = ADR_POWER_MAX_DBM;
+      return true;
+    }
+    if (spreadingFactor >= ADR_SF_MAX)
+      return false; // SF12 daya penuh adalah SF terakhir yang terdengar: tetap menunggu di sini
+    spreadingFactor++; // Receiver mungkin naik SF tanpa node ini; SF lebih rendah tidak dicoba
+    return true;
+  }
+
+private:
+  void applyPending()
+  {
+    spreadingFactor = pendingSf;
+    txPower = pendingPower;
+    pendingSf = 0;
+    switchScheduled = false;
+    unanswered = 0;
+  }
+};
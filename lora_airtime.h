@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+// Time-on-air paket LoRa (rumus Semtech AN1200.13 / datasheet SX1276 bagian 4.1.1.7)
+// spreadingFactor 6..12, signalBandwidth dalam Hz, codeDenominator 5..8 (coding rate 4/5..4/8).
+// Low data rate optimize aktif jika durasi simbol > 16 ms, sama seperti library LoRa (setLdoFlag).
+
+#define LORA_DEFAULT_PREAMBLE_LENGTH 8
+
+inline float loraSymbolTimeMs(int spreadingFactor, float signalBandwidth)
+{
+  return (float)(1L << spreadingFactor) * 1000.0f / signalBandwidth;
+}
+
+inline uint32_t loraTimeOnAirUs(int payloadLength, int spreadingFactor, float signalBandwidth, int codeDenominator,
+                                int preambleLength = LORA_DEFAULT_PREAMBLE_LENGTH, bool explicitHeader = true, bool crcOn = true)
+{
+  float symbolTimeMs = loraSymbolTimeMs(spreadingFactor, signalBandwidth);
+  int lowDataRateOptimize = symbolTimeMs > 16.0f ? 1 : 0;
+  int codingRate = codeDenominator - 4;
+
+  int numerator = 8 * payloadLength - 4 * spreadingFactor + 28 + (crcOn ? 16 : 0) - (explicitHeader ? 0 : 20);
+  int denominator = 4 * (spreadingFactor - 2 * lowDataRateOptimize);
+  int payloadSymbols = 8;
+  if (numerator > 0)
+  {
+    payloadSymbols += ((numerator + denominator - 1) / denominator) * (codingRate + 4);
+  }
+
+  float preambleMs = (preambleLength + 4.25f) * symbolTimeMs;
+  float payloadMs = payloadSymbols * symbolTimeMs;
+  return (uint32_t)((preambleMs + payloadMs) * 1000.0f + 0.5f);
+}
+
+// Sensitivitas SX1276/SX1278 pada BW 125 kHz (dBm), dipakai untuk model link di simulator
+inline float loraSensitivityDbm(int spreadingFactor, float signalBandwidth)
+{
+  static const float sensitivity125k[] = {-118.0f, -123.0f, -126.0f, -129.0f, -132.0f, -134.5f, -137.0f}; // SF6..SF12
+  int index = spreadingFactor < 6 ? 0 : spreadingFactor > 12 ? 6
+                                                             : spreadingFactor - 6;
+  // setiap kelipatan dua bandwidth menaikkan noise floor ~3 dB
+  float bandwidthPenalty = 10.0f * log10f(signalBandwidth / 125E3f);
+  return sensitivity125k[index] + bandwidthPenalty;
+}
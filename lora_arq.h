@@ -0,0 +1,184 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "telemetry_frame.h"
+
+// ARQ ringan transmitter -> Receiver: setiap frame telemetri versi 3/kompak membawa nomor urut 16 bit,
+// Receiver membalas frame ACK biner yang menggemakan nomor urut tertinggi yang sudah diterimanya
+// dari node itu ditambah bitmap 16 nomor sebelumnya (selective ACK). Transmitter hanya mengirim ulang
+// frame yang tidak tercakup ACK, maksimal ARQ_MAX_RETRIES kali dengan backoff eksponensial + jitter.
+// Receiver membuang frame duplikat (kiriman ulang yang ACK-nya hilang) tapi tetap membalas ACK-nya.
+// ACK dikirim begitu frame diterima; hasil klasifikasi server yang berbeda dari hasil di ACK menyusul (ArqAckResult).
+// Tidak bergantung pada Arduino sehingga dipakai juga oleh simulator (host/sim/lora_channel_sim.cpp).
+//
+// Frame ACK (8 byte, menggantikan respons JSON ~42 byte untuk transmitter dengan frame versi 3/kompak):
+//  byte 0     : ARQ_ACK_VERSION (bukan '{', jadi bisa dibedakan dari respons JSON Receiver lama)
+//  byte 1     : flags (lihat ArqAckFlag)
+//  byte 2..3  : nomor urut tertinggi yang diterima, uint16 little endian
+//  byte 4..5  : bitmap diterima: bit i = nomor urut (seq - 1 - i) sudah diterima
+//  byte 6..7  : CRC-16/CCITT-FALSE dari byte sebelumnya
+// Jika flag ArqAckCommand, perintah ADR ARQ_ACK_COMMAND_SIZE byte (lora_adr.h) menyusul setelah byte 7.
+
+#define ARQ_ACK_VERSION 0xA1
+#define ARQ_ACK_SIZE 8
+#define ARQ_ACK_COMMAND_SIZE 7
+#define ARQ_ACK_MAX_SIZE (ARQ_ACK_SIZE + ARQ_ACK_COMMAND_SIZE)
+#define ARQ_MAX_RETRIES 3       // Kiriman ulang maksimal per frame sebelum frame dianggap hilang
+#define ARQ_BACKOFF_BASE_MS 250 // Jeda sebelum kiriman ulang pertama, berlipat dua setiap percobaan
+#define ARQ_BACKOFF_MAX_MS 4000
+#define ARQ_CONGESTION_HISTORY 8             // Frame terakhir yang dinilai untuk beban kanal (ArqCongestion)
+#define ARQ_CONGESTION_BACKOFF_MAX_MS 120000 // Batas backoff saat kanal jenuh: frame lebih dulu digantikan sampel baru
+
+enum ArqAckFlag
+{
+  ArqAckClassification = 1 << 0, // Hasil klasifikasi (sama dengan "classification" respons JSON)
+  ArqAckBuzzer = 1 << 1,         // Buzzer dinyalakan (sama dengan "buzzer_on")
+  ArqAckDuplicate = 1 << 2,      // ACK ulang untuk frame yang sudah pernah diterima
+  ArqAckCommand = 1 << 3,        // Perintah ADR menyusul setelah frame ACK
+  ArqAckResult = 1 << 4          // Hasil server yang menyusul setelah POST (frame sudah di-ACK saat diterima)
+};
+
+struct ArqAck
+{
+  uint8_t flags;
+  uint16_t seq;      // Nomor urut tertinggi yang diterima dari node
+  uint16_t received; // bit i = seq - 1 - i sudah diterima
+};
+
+// Frame dengan nomor urut itu tercakup ACK (nomor urut tertinggi atau bit-nya di bitmap)
+inline bool arqAcked(const ArqAck &ack, uint16_t seq)
+{
+  uint16_t behind = (uint16_t)(ack.seq - seq);
+  if (behind == 0)
+    return true;
+  return behind <= 16 && (ack.received >> (behind - 1)) & 1;
+}
+
+inline size_t encodeArqAck(const ArqAck &ack, uint8_t *buffer, size_t bufferSize)
+{
+  if (bufferSize < ARQ_ACK_SIZE)
+    return 0;
+  buffer[0] = ARQ_ACK_VERSION;
+  buffer[1] = ack.flags;
+  telemetryWriteInt16(&buffer[2], (int16_t)ack.seq);
+  telemetryWriteInt16(&buffer[4], (int16_t)ack.received);
+  uint16_t crc = telemetryCrc16(buffer, ARQ_ACK_SIZE - 2);
+  buffer[6] = crc & 0xFF;
+  buffer[7] = crc >> 8;
+  return ARQ_ACK_SIZE;
+}
+
+// length boleh mencakup perintah ADR di belakang ACK (dibaca dengan decodeAdrCommand dari byte ARQ_ACK_SIZE)
+inline bool decodeArqAck(const uint8_t *buffer, size_t length, ArqAck &ack)
+{
+  if (length < ARQ_ACK_SIZE || buffer[0] != ARQ_ACK_VERSION)
+    return false;
+  uint16_t crc = buffer[6] | (uint16_t)buffer[7] << 8;
+  if (crc != telemetryCrc16(buffer, ARQ_ACK_SIZE - 2))
+    return false;
+  if (length != ((buffer[1] & ArqAckCommand) ? ARQ_ACK_MAX_SIZE : ARQ_ACK_SIZE))
+    return false;
+  ack.flags = buffer[1];
+  ack.seq = (uint16_t)telemetryReadInt16(&buffer[2]);
+  ack.received = (uint16_t)telemetryReadInt16(&buffer[4]);
+  return true;
+}
+
+// Jeda sebelum kiriman ulang ke-(attempt + 1): base x 2^attempt, dibatasi ARQ_BACKOFF_MAX_MS, ditambah
+// jitter acak sampai setengahnya agar node yang bertabrakan tidak mengirim ulang bersamaan lagi
+inline uint32_t arqBackoffMs(uint8_t attempt, uint32_t randomValue, uint32_t baseMs = ARQ_BACKOFF_BASE_MS)
+{
+  uint32_t backoff = baseMs << (attempt < 8 ? attempt : 8);
+  if (backoff > ARQ_BACKOFF_MAX_MS)
+    backoff = ARQ_BACKOFF_MAX_MS;
+  return backoff + randomValue % (backoff / 2 + 1);
+}
+
+// Beban kanal menurut transmitter: jawaban ARQ_CONGESTION_HISTORY jendela dengar terakhir (bit 1 = tanpa ACK).
+// Setiap jendela terakhir yang tidak dijawab menggandakan backoff kiriman ulang (batas ARQ_CONGESTION_BACKOFF_MAX_MS),
+// jadi saat kanal jenuh kiriman ulang menyebar dan frame lama tergantikan sampel baru sebelum sempat dikirim ulang,
+// bukan menambah tabrakan. Satu ACK menggeser satu jendela gagal keluar dari riwayat.
+// Tanpa constructor; panggil reset() sebelum dipakai.
+class ArqCongestion
+{
+public:
+  void reset() { history = 0; }
+  void onAnswered() { history = (uint8_t)(history << 1); }
+  void onUnanswered() { history = (uint8_t)(history << 1 | 1); }
+
+  uint8_t level() const
+  {
+    uint8_t count = 0;
+    for (uint8_t bits = history; bits != 0; bits &= bits - 1)
+      count++;
+    return count;
+  }
+
+  uint32_t backoffMs(uint8_t attempt, uint32_t randomValue) const
+  {
+    uint32_t backoff = arqBackoffMs(attempt, randomValue);
+    for (uint8_t i = level(); i > 0 && backoff < ARQ_CONGESTION_BACKOFF_MAX_MS / 2; i--)
+      backoff <<= 1;
+    return backoff;
+  }
+
+private:
+  uint8_t history;
+};
+
+// Jendela duplikat per node di Receiver (seperti jendela anti-replay): nomor urut tertinggi + bitmap
+// 32 nomor sebelumnya. Nomor yang mundur lebih jauh dari jendela dianggap node restart (transmitter
+// memulai nomor urut acak saat cold boot) dan jendela diulang dari nomor itu.
+// Tanpa constructor; panggil reset() sebelum dipakai.
+class ArqWindow
+{
+public:
+  void reset()
+  {
+    hasSeq = false;
+    highest = 0;
+    bitmap = 0;
+  }
+
+  // true jika frame baru (diteruskan ke uplink), false jika duplikat
+  bool accept(uint16_t seq)
+  {
+    int16_t ahead = (int16_t)(seq - highest);
+    if (!hasSeq || ahead < -32)
+    {
+      hasSeq = true;
+      highest = seq;
+      bitmap = 0;
+      return true;
+    }
+    if (ahead > 0)
+    {
+      bitmap = ahead >= 32 ? 0 : (bitmap << ahead) | (1UL << (ahead - 1));
+      highest = seq;
+      return true;
+    }
+    if (ahead == 0)
+      return false;
+
+    uint32_t bit = 1UL << (-ahead - 1);
+    if (bitmap & bit)
+      return false;
+    bitmap |= bit; // Frame lama yang terlambat (misalnya kiriman ulang) tapi belum pernah diterima
+    return true;
+  }
+
+  ArqAck ack(uint8_t flags) const
+  {
+    ArqAck result;
+    result.flags = flags;
+    result.seq = highest;
+    result.received = (uint16_t)bitmap;
+    return result;
+  }
+
+private:
+  bool hasSeq;
+  uint16_t highest;
+  uint32_t bitmap; // bit i = highest - 1 - i sudah diterima
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <LoRa.h>
+
+// Penerimaan paket LoRa tanpa alokasi heap: callback DIO0 menyalin isi FIFO SX127x ke slot antrian statis
+// dengan satu burst SPI, lalu header 4 byte dan payload dibaca langsung dari slot itu sebagai view (pointer +
+// panjang), tanpa String atau salinan lain. Dipakai Receiver dan transmitter; di host, burst FIFO dilayani
+// radio tersimulasi lewat host/SPI.h.
+//
+// Paket (header eksplisit aplikasi):
+//  byte 0 : alamat penerima
+//  byte 1 : alamat pengirim
+//  byte 2 : msgId
+//  byte 3 : panjang payload
+//  byte 4.. payload
+
+#define LORA_PACKET_HEADER_SIZE 4
+#define LORA_REG_FIFO 0x00 // Register FIFO SX127x; bit 7 alamat = 0 untuk baca
+
+// Burst read FIFO: alamat REG_FIFO sekali lalu length byte dalam satu transaksi SPI, sedangkan LoRa.read()
+// membuka transaksi terpisah (CS, alamat, data) untuk setiap byte. Dipanggil dari callback onReceive, saat
+// library sudah mengarahkan pointer FIFO ke awal paket; pengaturan SPI sama dengan library (default
+// LORA_DEFAULT_SPI_FREQUENCY, karena setSPIFrequency() tidak dipakai).
+inline void loraReadFifo(uint8_t ssPin, uint8_t *buffer, size_t length)
+{
+  digitalWrite(ssPin, LOW);
+  SPI.beginTransaction(SPISettings(LORA_DEFAULT_SPI_FREQUENCY, MSBFIRST, SPI_MODE0));
+  SPI.transfer(LORA_REG_FIFO);
+  SPI.transfer(buffer, length); // Isi buffer yang terkirim di MOSI diabaikan radio selama burst read
+  SPI.endTransaction();
+  digitalWrite(ssPin, HIGH);
+}
+
+// Header dan payload paket yang masih berada di buffer penerimaan; valid selama buffer itu belum dipakai ulang
+struct LoraPacketView
+{
+  uint8_t recipient;
+  uint8_t sender;
+  uint8_t msgId;
+  uint8_t declaredLength; // Panjang payload menurut header
+  const uint8_t *payload;
+  size_t payloadLength;   // Panjang payload yang benar-benar diterima
+
+  bool lengthValid() const { return declaredLength == payloadLength; }
+};
+
+// false jika paket terlalu pendek untuk berisi header
+inline bool parseLoraPacket(const uint8_t *data, size_t length, LoraPacketView &view)
+{
+  if (length < LORA_PACKET_HEADER_SIZE)
+    return false;
+  view.recipient = data[0];
+  view.sender = data[1];
+  view.msgId = data[2];
+  view.declaredLength = data[3];
+  view.payload = &data[LORA_PACKET_HEADER_SIZE];
+  view.payloadLength = length - LORA_PACKET_HEADER_SIZE;
+  return true;
+}
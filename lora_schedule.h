@@ -0,0 +1,405 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "telemetry_frame.h"
+#include "lora_arq.h"
+#include "lora_airtime.h"
+
+// MAC slot terjadwal (TDMA) untuk banyak transmitter yang berbagi satu Receiver. Receiver menyiarkan beacon
+// (alamat 0xFF) di awal setiap periode berisi urutan slot; setiap node terdaftar mendapat satu slot selebar
+// time-on-air frame telemetri terakhirnya pada SF/BW/CR aktif + proses Receiver + time-on-air ACK + guard, jadi
+// frame dan ACK satu node tidak pernah overlap dengan node lain. Sisa periode setelah slot terakhir adalah
+// jendela kontensi (ALOHA + listen-before-talk) untuk node yang belum punya slot dan batch backlog. Node yang
+// belum pernah mendengar beacon, atau beacon terakhirnya terlalu lama, kembali mengirim tanpa jadwal.
+// Tidak bergantung pada Arduino sehingga dipakai juga oleh simulator (host/sim/lora_channel_sim.cpp --tdma 1).
+//
+//  | beacon |guard| slot node A | slot node B | ... | kontensi ............... | beacon | ...
+//  ^ awal periode                                                              ^ awal periode berikutnya
+//
+// Frame beacon:
+//  byte 0     : SCHEDULE_BEACON_VERSION
+//  byte 1     : nomor beacon (naik satu setiap periode)
+//  byte 2     : satuan waktu slot dan periode (ms)
+//  byte 3..4  : panjang periode (satuan), uint16 little endian
+//  byte 5     : jumlah slot N
+//  byte 6..   : N x {alamat node, panjang slot (satuan)}, berurutan mulai SCHEDULE_GUARD_MS setelah akhir beacon
+//  2 byte     : CRC-16/CCITT-FALSE dari byte sebelumnya
+
+#define SCHEDULE_BEACON_VERSION 0xC1
+#define SCHEDULE_BEACON_HEADER_SIZE 6
+#define SCHEDULE_MAX_SLOTS 64 // Sama dengan NODE_REGISTRY_SIZE Receiver
+#define SCHEDULE_BEACON_MAX_SIZE (SCHEDULE_BEACON_HEADER_SIZE + 2 * SCHEDULE_MAX_SLOTS + 2)
+#define SCHEDULE_UNIT_MIN_MS 10
+#define SCHEDULE_GATEWAY_MS 500        // Proses Receiver sebelum ACK (RESPONSE_GATEWAY_MS transmitter)
+#define SCHEDULE_GUARD_MS 50           // Cadangan setelah beacon dan di akhir slot: selisih jam node, perpindahan RX/TX
+#define SCHEDULE_MIN_PERIOD_MS 2000    // Beacon paling sering sekali per periode ini walaupun node sedikit
+#define SCHEDULE_BEACON_SHARE 20       // Periode minimal sekian kali airtime beacon (beacon <= 5 % airtime)
+#define SCHEDULE_CONTENTION_MIN_MS 2000
+#define SCHEDULE_DRIFT_PPM 200         // Sisa kesalahan jam node setelah koreksi skew (RTC RC ESP32 saat deep sleep)
+#define SCHEDULE_SYNC_TIMEOUT_MS ((uint32_t)SCHEDULE_GUARD_MS * 1000000UL / SCHEDULE_DRIFT_PPM) // Jam sudah bisa bergeser sejauh guard
+#define SCHEDULE_MAX_MISSED 3          // Periode tanpa beacon yang masih boleh memakai slot proyeksi (jadwal stabil)
+#define SCHEDULE_SKEW_MAX_PPM 1000     // Selisih interval beacon lebih dari ini (atau lebih dari guard) dianggap beacon tertunda (LBT), bukan drift
+#define SCHEDULE_CONTENTION_BACKOFF_MAX 5 // Percobaan kontensi gagal ke-n memilih acak satu dari 2^n jendela berikutnya (maks 2^5)
+#define SCHEDULE_LBT_BACKOFF_MS 250    // Node tanpa slot menunggu acak sampai selama ini setelah kanal bebas; beacon tidak, jadi
+                                       // beacon selalu mendahului kiriman ALOHA yang tertahan listen-before-talk
+
+struct ScheduleSlot
+{
+  uint8_t address;
+  uint8_t units; // Panjang slot dalam satuan unitMs
+};
+
+struct ScheduleBeacon
+{
+  uint8_t number;
+  uint8_t unitMs;
+  uint16_t periodUnits;
+  uint8_t count;
+  ScheduleSlot slots[SCHEDULE_MAX_SLOTS];
+};
+
+inline uint32_t scheduleAirtimeMs(int packetLength, int spreadingFactor, float signalBandwidth, int codeDenominator)
+{
+  return (loraTimeOnAirUs(packetLength, spreadingFactor, signalBandwidth, codeDenominator) + 999) / 1000;
+}
+
+// Lama satu node memegang kanal: frame uplink (header 4 byte + payload), proses Receiver, lalu ACK
+inline uint32_t scheduleSlotMs(uint8_t frameLength, int spreadingFactor, float signalBandwidth, int codeDenominator)
+{
+  return scheduleAirtimeMs(4 + frameLength, spreadingFactor, signalBandwidth, codeDenominator) + SCHEDULE_GATEWAY_MS +
+         scheduleAirtimeMs(4 + ARQ_ACK_SIZE, spreadingFactor, signalBandwidth, codeDenominator) + 2 * SCHEDULE_GUARD_MS;
+}
+
+// Jendela kontensi minimal muat satu batch backlog terpanjang beserta ACK-nya
+inline uint32_t scheduleContentionMs(int spreadingFactor, float signalBandwidth, int codeDenominator)
+{
+  uint32_t batchMs = scheduleSlotMs(TELEMETRY_BATCH_MAX_SIZE, spreadingFactor, signalBandwidth, codeDenominator);
+  return batchMs > SCHEDULE_CONTENTION_MIN_MS ? batchMs : SCHEDULE_CONTENTION_MIN_MS;
+}
+
+inline size_t scheduleBeaconSize(uint8_t count)
+{
+  return SCHEDULE_BEACON_HEADER_SIZE + 2 * count + 2;
+}
+
+// Periode terpanjang (semua slot terisi frame telemetri terbesar). Node yang frame-nya sudah di-ACK (berarti
+// sudah terdaftar di Receiver) tapi belum mendengar beacon yang mencantumkannya berhenti ALOHA selama ini,
+// agar node yang belum terdaftar dan beacon itu sendiri tidak tenggelam dalam tabrakan
+inline uint32_t scheduleJoinWaitMs(int spreadingFactor, float signalBandwidth, int codeDenominator)
+{
+  return scheduleAirtimeMs(4 + scheduleBeaconSize(SCHEDULE_MAX_SLOTS), spreadingFactor, signalBandwidth, codeDenominator) + SCHEDULE_GUARD_MS +
+         SCHEDULE_MAX_SLOTS * scheduleSlotMs(TELEMETRY_FRAME_MAX_SIZE, spreadingFactor, signalBandwidth, codeDenominator) +
+         scheduleContentionMs(spreadingFactor, signalBandwidth, codeDenominator);
+}
+
+// Jumlah jendela kontensi yang dilewati sebelum mencoba lagi: acak 0..2^failures-1. Jendela kontensi hanya muat
+// beberapa frame, jadi tanpa backoff antar periode puluhan node yang belum punya slot akan terus bertabrakan di
+// jendela yang sama dan tidak ada yang berhasil mendaftar
+inline uint32_t scheduleContentionSkip(uint8_t failures, uint32_t randomValue)
+{
+  uint8_t exponent = failures < SCHEDULE_CONTENTION_BACKOFF_MAX ? failures : SCHEDULE_CONTENTION_BACKOFF_MAX;
+  return randomValue % (1UL << exponent);
+}
+
+inline uint32_t schedulePeriodMs(const ScheduleBeacon &beacon)
+{
+  return (uint32_t)beacon.unitMs * beacon.periodUnits;
+}
+
+// Slot node dilepas jika node tidak terdengar selama ini. Dengan banyak node periode bisa lebih panjang dari
+// REPORT_STALE_MS, jadi batasnya ikut periode: node yang melewatkan beberapa beacon tidak kehilangan slotnya
+inline uint32_t scheduleStaleMs(uint32_t periodMs, uint32_t staleMs)
+{
+  uint32_t missedMs = (SCHEDULE_MAX_MISSED + 1) * periodMs;
+  return missedMs > staleMs ? missedMs : staleMs;
+}
+
+inline size_t encodeScheduleBeacon(const ScheduleBeacon &beacon, uint8_t *buffer, size_t bufferSize)
+{
+  size_t size = scheduleBeaconSize(beacon.count);
+  if (beacon.count > SCHEDULE_MAX_SLOTS || bufferSize < size)
+    return 0;
+  buffer[0] = SCHEDULE_BEACON_VERSION;
+  buffer[1] = beacon.number;
+  buffer[2] = beacon.unitMs;
+  telemetryWriteInt16(&buffer[3], (int16_t)beacon.periodUnits);
+  buffer[5] = beacon.count;
+  for (uint8_t i = 0; i < beacon.count; i++)
+  {
+    buffer[SCHEDULE_BEACON_HEADER_SIZE + 2 * i] = beacon.slots[i].address;
+    buffer[SCHEDULE_BEACON_HEADER_SIZE + 2 * i + 1] = beacon.slots[i].units;
+  }
+  uint16_t crc = telemetryCrc16(buffer, size - 2);
+  buffer[size - 2] = crc & 0xFF;
+  buffer[size - 1] = crc >> 8;
+  return size;
+}
+
+inline bool decodeScheduleBeacon(const uint8_t *buffer, size_t length, ScheduleBeacon &beacon)
+{
+  if (length < scheduleBeaconSize(0) || buffer[0] != SCHEDULE_BEACON_VERSION)
+    return false;
+  uint8_t count = buffer[5];
+  if (count > SCHEDULE_MAX_SLOTS || length != scheduleBeaconSize(count))
+    return false;
+  uint16_t crc = buffer[length - 2] | (uint16_t)buffer[length - 1] << 8;
+  if (crc != telemetryCrc16(buffer, length - 2))
+    return false;
+  beacon.number = buffer[1];
+  beacon.unitMs = buffer[2];
+  beacon.periodUnits = (uint16_t)telemetryReadInt16(&buffer[3]);
+  beacon.count = count;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    beacon.slots[i].address = buffer[SCHEDULE_BEACON_HEADER_SIZE + 2 * i];
+    beacon.slots[i].units = buffer[SCHEDULE_BEACON_HEADER_SIZE + 2 * i + 1];
+  }
+  return beacon.unitMs > 0 && beacon.periodUnits > 0;
+}
+
+// Urutan slot di Receiver. Node baru ditambahkan di akhir dan node yang keluar dihapus tanpa mengacak urutan
+// node lain, jadi node yang melewatkan beacon hanya salah posisi jika ada node di depannya yang berubah.
+// Tanpa constructor; panggil reset() sebelum dipakai.
+class ScheduleTable
+{
+public:
+  void reset() { count = 0; }
+
+  // Node aktif dengan frame telemetri terakhir sepanjang frameLength byte; false jika tabel penuh
+  bool update(uint8_t address, uint8_t frameLength)
+  {
+    for (uint8_t i = 0; i < count; i++)
+    {
+      if (addresses[i] == address)
+      {
+        lengths[i] = frameLength;
+        return true;
+      }
+    }
+    if (count >= SCHEDULE_MAX_SLOTS)
+      return false;
+    addresses[count] = address;
+    lengths[count] = frameLength;
+    count++;
+    return true;
+  }
+
+  void remove(uint8_t address)
+  {
+    for (uint8_t i = 0; i < count; i++)
+    {
+      if (addresses[i] != address)
+        continue;
+      for (uint8_t j = i + 1; j < count; j++)
+      {
+        addresses[j - 1] = addresses[j];
+        lengths[j - 1] = lengths[j];
+      }
+      count--;
+      return;
+    }
+  }
+
+  uint8_t size() const { return count; }
+  uint8_t address(uint8_t index) const { return addresses[index]; }
+
+  // Beacon berikutnya: satuan waktu dipilih agar slot terpanjang muat di 1 byte, periode = beacon + guard +
+  // semua slot + jendela kontensi, minimal minPeriodMs dan SCHEDULE_BEACON_SHARE x airtime beacon
+  void build(ScheduleBeacon &beacon, uint8_t number, int spreadingFactor, float signalBandwidth, int codeDenominator,
+             uint32_t minPeriodMs) const
+  {
+    uint32_t longestMs = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+      uint32_t slotMs = scheduleSlotMs(lengths[i], spreadingFactor, signalBandwidth, codeDenominator);
+      longestMs = slotMs > longestMs ? slotMs : longestMs;
+    }
+    uint32_t unitMs = (longestMs + 254) / 255;
+    unitMs = unitMs < SCHEDULE_UNIT_MIN_MS ? SCHEDULE_UNIT_MIN_MS : unitMs > 255 ? 255 : unitMs;
+
+    beacon.number = number;
+    beacon.unitMs = (uint8_t)unitMs;
+    beacon.count = count;
+    uint32_t beaconMs = scheduleAirtimeMs(4 + scheduleBeaconSize(count), spreadingFactor, signalBandwidth, codeDenominator);
+    uint32_t periodMs = beaconMs + SCHEDULE_GUARD_MS;
+    for (uint8_t i = 0; i < count; i++)
+    {
+      uint32_t units = (scheduleSlotMs(lengths[i], spreadingFactor, signalBandwidth, codeDenominator) + unitMs - 1) / unitMs;
+      beacon.slots[i].address = addresses[i];
+      beacon.slots[i].units = (uint8_t)(units > 255 ? 255 : units);
+      periodMs += beacon.slots[i].units * unitMs;
+    }
+    periodMs += scheduleContentionMs(spreadingFactor, signalBandwidth, codeDenominator);
+    minPeriodMs = minPeriodMs > SCHEDULE_BEACON_SHARE * beaconMs ? minPeriodMs : SCHEDULE_BEACON_SHARE * beaconMs;
+    periodMs = periodMs > minPeriodMs ? periodMs : minPeriodMs;
+    uint32_t periodUnits = (periodMs + unitMs - 1) / unitMs;
+    beacon.periodUnits = (uint16_t)(periodUnits > 0xFFFF ? 0xFFFF : periodUnits);
+  }
+
+private:
+  uint8_t addresses[SCHEDULE_MAX_SLOTS];
+  uint8_t lengths[SCHEDULE_MAX_SLOTS]; // Payload frame telemetri terakhir node
+  uint8_t count;
+};
+
+// Jadwal dari sisi transmitter: posisi slot node ini menurut beacon terakhir, dalam jam lokal node (ms).
+// Jadwal diproyeksikan ke periode berikutnya selama beacon terlewat. Kecepatan jam lokal terhadap Receiver
+// (skew) diukur dari jarak dua beacon berturut-turut, jadi tidur panjang dengan RTC yang melenceng tidak
+// menggeser slot; sisa kesalahannya dibatasi SCHEDULE_SYNC_TIMEOUT_MS.
+// Tanpa constructor agar bisa disimpan di memori RTC; panggil reset() saat cold boot.
+class ScheduleSync
+{
+public:
+  void reset()
+  {
+    valid = false;
+    stable = false;
+    skewPpm = 0;
+    periodStartMs = 0;
+    periodLengthMs = 0;
+    slotOffsetMs = 0;
+    slotLengthMs = 0;
+    contentionOffsetMs = 0;
+    beacons = 0;
+  }
+
+  // Beacon diterima; endMs = jam lokal saat paket selesai diterima, beaconMs = time-on-air beacon
+  void onBeacon(const ScheduleBeacon &beacon, uint8_t address, uint32_t endMs, uint32_t beaconMs)
+  {
+    uint32_t start = endMs - beaconMs;
+    bool consecutive = valid && (uint8_t)(beacon.number - number) == 1;
+    uint32_t previousPeriodMs = periodLengthMs, previousOffsetMs = slotOffsetMs, previousLengthMs = slotLengthMs;
+    if (consecutive) // Interval nominal = periode beacon sebelumnya
+    {
+      int64_t errorMs = (int64_t)(int32_t)(start - periodStartMs) - (int64_t)periodLengthMs;
+      int32_t ppm = (int32_t)(errorMs * 1000000 / (int64_t)periodLengthMs);
+      // Beacon yang tertunda listen-before-talk datang ratusan ms terlambat; drift jam tidak pernah melebihi guard
+      if (errorMs > -SCHEDULE_GUARD_MS && errorMs < SCHEDULE_GUARD_MS && ppm > -SCHEDULE_SKEW_MAX_PPM && ppm < SCHEDULE_SKEW_MAX_PPM)
+        skewPpm += (ppm - skewPpm) / 4;
+    }
+
+    number = beacon.number;
+    periodStartMs = start;
+    periodLengthMs = schedulePeriodMs(beacon);
+    slotOffsetMs = 0;
+    slotLengthMs = 0;
+    uint32_t offset = beaconMs + SCHEDULE_GUARD_MS;
+    for (uint8_t i = 0; i < beacon.count; i++)
+    {
+      uint32_t length = (uint32_t)beacon.slots[i].units * beacon.unitMs;
+      if (beacon.slots[i].address == address)
+      {
+        slotOffsetMs = offset;
+        slotLengthMs = length;
+      }
+      offset += length;
+    }
+    contentionOffsetMs = offset;
+    stable = consecutive && periodLengthMs == previousPeriodMs && slotOffsetMs == previousOffsetMs && slotLengthMs == previousLengthMs;
+    valid = true;
+    beacons++;
+  }
+
+  // Beacon terakhir belum kedaluwarsa (kesalahan jam masih di dalam guard)
+  bool synced(uint32_t nowMs) const { return valid && nowMs - periodStartMs < SCHEDULE_SYNC_TIMEOUT_MS; }
+  // Node ini tercantum di beacon terakhir
+  bool hasSlot(uint32_t nowMs) const { return synced(nowMs) && slotLengthMs > 0; }
+  // Slot boleh dipakai pada periode yang memuat nowMs: periode beacon yang terdengar, atau proyeksi sampai
+  // SCHEDULE_MAX_MISSED periode jika dua beacon terakhir berurutan membawa jadwal yang sama. Saat susunan slot
+  // sedang berubah (node bergabung/keluar), slot proyeksi dari beacon lama bisa menimpa slot node lain.
+  bool slotUsable(uint32_t nowMs) const
+  {
+    if (!hasSlot(nowMs))
+      return false;
+    uint32_t periods = (nowMs - periodStartMs) / periodMs();
+    return periods == 0 || (stable && periods <= SCHEDULE_MAX_MISSED);
+  }
+  // Pernah mendengar beacon (jadwal mungkin sudah kedaluwarsa), untuk mencari beacon lagi
+  bool known() const { return valid; }
+
+  // Awal slot node ini pada periode yang memuat nowMs
+  uint32_t slotStart(uint32_t nowMs) const { return periodStart(nowMs) + local(slotOffsetMs); }
+
+  // Awal slot pertama yang belum lewat sejak nowMs
+  uint32_t nextSlot(uint32_t nowMs) const
+  {
+    uint32_t start = slotStart(nowMs);
+    return (int32_t)(nowMs - start) > 0 ? start + periodMs() : start;
+  }
+
+  // Dalam jendela mulai kirim slot yang boleh dipakai (guard pertama slot); start = awal slot tersebut
+  bool inSlot(uint32_t nowMs, uint32_t &start) const
+  {
+    start = slotStart(nowMs);
+    return slotUsable(nowMs) && (int32_t)(nowMs - start) >= 0 && nowMs - start < SCHEDULE_GUARD_MS;
+  }
+
+  // Jendela kontensi masih cukup untuk memegang kanal selama holdMs mulai nowMs
+  bool inContention(uint32_t nowMs, uint32_t holdMs) const
+  {
+    uint32_t offset = nowMs - periodStart(nowMs);
+    return offset >= local(contentionOffsetMs) && offset + holdMs + SCHEDULE_GUARD_MS <= periodMs();
+  }
+
+  // Awal jendela kontensi berikutnya
+  uint32_t nextContention(uint32_t nowMs) const
+  {
+    uint32_t start = periodStart(nowMs) + local(contentionOffsetMs);
+    return (int32_t)(nowMs - start) > 0 ? start + periodMs() : start;
+  }
+
+  // Perkiraan awal beacon berikutnya dan ketidakpastiannya (bertambah selama tidak mendengar beacon)
+  uint32_t nextBeacon(uint32_t nowMs) const { return periodStart(nowMs) + periodMs(); }
+  uint32_t marginMs(uint32_t nowMs) const
+  {
+    return SCHEDULE_GUARD_MS + (uint32_t)((uint64_t)(nowMs - periodStartMs) * SCHEDULE_DRIFT_PPM / 1000000);
+  }
+
+  // Radio perlu RX untuk beacon: belum sinkron, menjelang beacon berikutnya, atau beacon periode ini
+  // (sampai maxBeaconMs) belum terdengar
+  bool listenForBeacon(uint32_t nowMs, uint32_t maxBeaconMs) const
+  {
+    if (!synced(nowMs))
+      return true;
+    uint32_t start = periodStart(nowMs);
+    uint32_t offset = nowMs - start;
+    uint32_t margin = marginMs(nowMs);
+    if (offset + margin >= periodMs())
+      return true;
+    return start != periodStartMs && offset < maxBeaconMs + margin;
+  }
+
+  uint32_t periodMs() const { return local(periodLengthMs); }
+  uint32_t slotLength() const { return slotLengthMs; }
+  uint32_t slotOffset() const { return slotOffsetMs; }
+  bool isStable() const { return stable; }
+  uint32_t lastBeacon() const { return periodStartMs; } // Awal periode beacon terakhir (jam lokal)
+  uint8_t beaconNumber() const { return number; }
+  int32_t skew() const { return skewPpm; }
+  uint32_t beaconCount() const { return beacons; }
+
+private:
+  // Durasi jam Receiver ke jam lokal
+  uint32_t local(uint32_t ms) const { return ms + (int32_t)((int64_t)ms * skewPpm / 1000000); }
+
+  uint32_t periodStart(uint32_t nowMs) const
+  {
+    uint32_t elapsed = nowMs - periodStartMs;
+    uint32_t period = periodMs();
+    if ((int32_t)elapsed < 0 || period == 0) // Belum pernah mendengar beacon
+      return periodStartMs;
+    return periodStartMs + elapsed / period * period;
+  }
+
+  bool valid;
+  bool stable; // Dua beacon terakhir berurutan dengan periode dan slot node ini yang sama
+  uint8_t number;
+  int32_t skewPpm; // Jam lokal lebih cepat (+) atau lambat (-) dari Receiver
+  uint32_t periodStartMs;
+  uint32_t periodLengthMs;
+  uint32_t slotOffsetMs; // Dari awal periode, jam Receiver
+  uint32_t slotLengthMs; // 0 = node ini tidak punya slot
+  uint32_t contentionOffsetMs;
+  uint32_t beacons;
+};
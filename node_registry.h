@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// Tabel status per transmitter dengan kunci alamat LoRa pengirim. Alamat hanya 1 byte, jadi lookup memakai
+// indeks langsung 256 byte (alamat -> slot + 1, 0 = belum terdaftar): mencari node O(1) tanpa memindai tabel,
+// sehingga biaya per paket tetap sama berapa pun node di jaringan. Entri dialokasikan berurutan dan tidak
+// pernah dipindah (pointer dan indeks slot stabil untuk task lain yang membaca); saat tabel penuh, node baru
+// menggantikan entri yang paling lama tidak terdengar (pemindaian O(Capacity) hanya saat node baru datang).
+// Tidak bergantung pada Arduino sehingga bisa dipakai ulang oleh simulator host.
+//
+// Entry harus punya field `uint8_t address` dan `unsigned long lastSeenMs`; field lain diinisialisasi pemanggil
+// saat acquire() melaporkan entri baru. RAM kira-kira 256 + Capacity x sizeof(Entry) byte.
+// Tanpa constructor; panggil reset() sebelum dipakai.
+template <typename Entry, uint8_t Capacity>
+class NodeRegistry
+{
+  static_assert(Capacity > 0 && Capacity < 255, "slot + 1 harus muat di indeks 1 byte");
+
+public:
+  void reset()
+  {
+    memset(index, 0, sizeof(index));
+    used = 0;
+    evictions = 0;
+  }
+
+  // Entri node, NULL jika alamat belum pernah terdengar (atau sudah tergusur)
+  Entry *find(uint8_t address)
+  {
+    uint8_t slot = index[address];
+    return slot == 0 ? NULL : &entries[slot - 1];
+  }
+
+  // Entri node, dialokasikan jika belum ada; created = true jika entri baru atau menggusur node lain
+  Entry &acquire(uint8_t address, unsigned long nowMs, bool &created)
+  {
+    Entry *entry = find(address);
+    created = entry == NULL;
+    if (created)
+    {
+      uint8_t slot = used;
+      if (used < Capacity)
+      {
+        used++;
+      }
+      else
+      {
+        slot = 0;
+        for (uint8_t i = 1; i < Capacity; i++)
+        {
+          if ((long)(entries[i].lastSeenMs - entries[slot].lastSeenMs) < 0) // lebih lama (aman terhadap overflow millis)
+            slot = i;
+        }
+        index[entries[slot].address] = 0;
+        evictions++;
+      }
+      entry = &entries[slot];
+      entry->address = address;
+      index[address] = slot + 1;
+    }
+    entry->lastSeenMs = nowMs;
+    return *entry;
+  }
+
+  // Entri ke-slot (0..count()-1), untuk menampilkan atau memindai seluruh node
+  Entry &at(uint8_t slot) { return entries[slot]; }
+  uint8_t count() const { return used; }
+  uint8_t capacity() const { return Capacity; }
+  unsigned long evicted() const { return evictions; } // Node yang tergusur karena tabel penuh
+
+private:
+  uint8_t index[256]; // alamat -> slot + 1
+  Entry entries[Capacity];
+  uint8_t used;
+  unsigned long evictions;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+
+// Anggaran energi transmitter mode deep sleep: waktu tiap fase diukur di perangkat (atau build host),
+// muatan dihitung dari arus tipikal per fase di bawah ini. Struct tanpa constructor sehingga bisa
+// disimpan di memori RTC (RTC_DATA_ATTR) dan terakumulasi lintas siklus tidur.
+//
+// Arus tipikal (datasheet, bukan hasil ukur): ESP32 240 MHz tanpa WiFi/BT ~40 mA; SX1278 TX 17 dBm
+// (PA_BOOST) ~87 mA, RX ~11 mA, sleep 0.2 uA; DS18B20 konversi 1.5 mA, standby 1 uA; ESP32 deep sleep
+// dengan timer RTC ~10 uA. Modul dev board (regulator AMS1117, USB-UART) menambah beberapa mA saat tidur.
+
+#define POWER_CURRENT_BOOT_MA 40.0f     // Bootloader + inisialisasi aplikasi
+#define POWER_CURRENT_SENSING_MA 52.0f  // CPU + DMS + konversi DS18B20 + ADC
+#define POWER_CURRENT_TRANSMIT_MA 127.0f
+#define POWER_CURRENT_LISTEN_MA 51.0f
+#define POWER_CURRENT_BUZZER_MA 70.0f
+#define POWER_CURRENT_SLEEP_MA 0.015f
+#define POWER_CURRENT_ALWAYS_ON_MA 65.0f // Mode lama: CPU + backlight LCD + radio idle + sensor, sebagai pembanding
+#define POWER_BOOTLOADER_MS 250          // Waktu ROM + bootloader sebelum millis() mulai, tidak terukur dari aplikasi
+#define POWER_BATTERY_MAH 2000.0f        // Kapasitas baterai untuk estimasi umur
+
+enum PowerPhase : uint8_t
+{
+  PowerBoot,
+  PowerSensing,
+  PowerTransmit,
+  PowerListen,
+  PowerBuzzer,
+  PowerSleep,
+  PowerPhaseCount
+};
+
+inline float powerPhaseCurrentMa(PowerPhase phase)
+{
+  static const float current[PowerPhaseCount] = {POWER_CURRENT_BOOT_MA, POWER_CURRENT_SENSING_MA, POWER_CURRENT_TRANSMIT_MA,
+                                                 POWER_CURRENT_LISTEN_MA, POWER_CURRENT_BUZZER_MA, POWER_CURRENT_SLEEP_MA};
+  return current[phase];
+}
+
+inline const char *powerPhaseName(PowerPhase phase)
+{
+  static const char *name[PowerPhaseCount] = {"boot", "sensor", "tx", "rx", "buzzer", "tidur"};
+  return name[phase];
+}
+
+struct PowerBudget
+{
+  uint32_t wakeups;
+  uint32_t timeMs[PowerPhaseCount]; // Total waktu per fase sejak cold boot
+  float chargeMas[PowerPhaseCount]; // Total muatan per fase, mA x detik
+
+  void add(PowerPhase phase, uint32_t ms)
+  {
+    timeMs[phase] += ms;
+    chargeMas[phase] += powerPhaseCurrentMa(phase) * ms / 1000.0f;
+  }
+
+  uint32_t totalMs() const
+  {
+    uint32_t total = 0;
+    for (uint8_t p = 0; p < PowerPhaseCount; p++)
+      total += timeMs[p];
+    return total;
+  }
+
+  float totalMas() const
+  {
+    float total = 0;
+    for (uint8_t p = 0; p < PowerPhaseCount; p++)
+      total += chargeMas[p];
+    return total;
+  }
+
+  // Arus rata-rata seluruh siklus (aktif + tidur)
+  float averageCurrentMa() const
+  {
+    uint32_t total = totalMs();
+    return total ? totalMas() * 1000.0f / total : 0.0f;
+  }
+
+  float batteryDays(float capacityMah = POWER_BATTERY_MAH) const
+  {
+    float current = averageCurrentMa();
+    return current > 0 ? capacityMah / current / 24.0f : 0.0f;
+  }
+};
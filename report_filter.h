@@ -0,0 +1,137 @@
+#pragma once
+
+#include <stdint.h>
+#include "telemetry_frame.h"
+
+// Mode report-on-change: transmitter tetap mengambil sampel setiap updateRate, tapi frame hanya
+// dikirim jika salah satu nilai bergeser melewati deadband-nya dari nilai terakhir yang sudah
+// dikonfirmasi Receiver, atau jika sudah REPORT_HEARTBEAT_MS tanpa kiriman (heartbeat, tanda node hidup).
+// Perbandingan dilakukan pada nilai fixed point x100 di frame telemetri, sama dengan yang diterima Receiver,
+// sehingga nilai yang direkonstruksi Receiver (sample-and-hold) tidak pernah meleset lebih dari deadband.
+//
+// Referensi hanya diperbarui lewat confirm() setelah respons Receiver diterima: frame yang hilang
+// di udara otomatis dikirim ulang pada sampel berikutnya selama perubahannya masih melewati deadband.
+// Tidak bergantung pada Arduino sehingga dipakai juga oleh simulator (host/sim/lora_channel_sim.cpp).
+// Tanpa constructor agar bisa disimpan di memori RTC (RTC_DATA_ATTR) dan bertahan selama deep sleep;
+// panggil begin() saat cold boot. Waktu (nowMs) harus dari jam yang tetap berjalan selama tidur.
+
+#define REPORT_DEADBAND_TEMPERATURE 50 // 0.50 C (2 LSB DS18B20 10 bit), berlaku untuk suhu rata-rata dan tiap probe
+#define REPORT_DEADBAND_HUMIDITY 100   // 1.00 %
+#define REPORT_DEADBAND_PH 5           // 0.05
+#define REPORT_HEARTBEAT_MS 60000UL    // Kiriman maksimal berjarak sekian walaupun nilai tidak berubah
+#define REPORT_STALE_MS (2 * REPORT_HEARTBEAT_MS + 10000UL) // Receiver: node dianggap hilang setelah dua heartbeat terlewat
+
+enum ReportReason : uint8_t
+{
+  ReportSuppressed, // Semua nilai masih di dalam deadband
+  ReportFirst,      // Belum ada nilai yang dikonfirmasi Receiver
+  ReportChanged,    // Ada nilai yang melewati deadband, flag valid atau daftar probe berubah
+  ReportHeartbeat   // Tidak ada perubahan, tapi sudah REPORT_HEARTBEAT_MS sejak kiriman terakhir
+};
+
+struct ReportDeadband
+{
+  int16_t temperature; // 0.01 C, 0 = setiap sampel dikirim
+  int16_t humidity;    // 0.01 %
+  int16_t ph;          // 0.01
+  uint32_t heartbeatMs;
+};
+
+struct ReportStats
+{
+  uint32_t changes;     // Frame dikirim karena perubahan (termasuk frame pertama)
+  uint32_t heartbeats;  // Frame dikirim sebagai heartbeat
+  uint32_t suppressed;  // Sampel yang tidak dikirim
+  uint32_t confirmed;   // Frame yang dibalas Receiver
+};
+
+class ReportFilter
+{
+public:
+  void begin(const ReportDeadband &config)
+  {
+    deadband = config;
+    referenceMs = 0;
+    hasReference = false;
+    reportStats = ReportStats();
+  }
+
+  // Dipanggil sekali per sampel; menentukan apakah frame perlu dikirim dan mencatat statistiknya
+  ReportReason evaluate(const TelemetryFrame &frame, uint32_t nowMs)
+  {
+    ReportReason reason;
+    if (!hasReference)
+      reason = ReportFirst;
+    else if (changed(frame))
+      reason = ReportChanged;
+    else if (nowMs - referenceMs >= deadband.heartbeatMs)
+      reason = ReportHeartbeat;
+    else
+      reason = ReportSuppressed;
+
+    if (reason == ReportSuppressed)
+      reportStats.suppressed++;
+    else if (reason == ReportHeartbeat)
+      reportStats.heartbeats++;
+    else
+      reportStats.changes++;
+    return reason;
+  }
+
+  // Frame sudah diterima Receiver: menjadi referensi deadband dan heartbeat berikutnya
+  void confirm(const TelemetryFrame &frame, uint32_t nowMs)
+  {
+    reference = frame;
+    referenceMs = nowMs;
+    hasReference = true;
+    reportStats.confirmed++;
+  }
+
+  // Heartbeat terkirim tanpa menunggu respons (mode daya rendah): jadwal heartbeat berikutnya digeser,
+  // referensi deadband tetap nilai terakhir yang dikonfirmasi
+  void heartbeatSent(uint32_t nowMs) { referenceMs = nowMs; }
+
+  // Memaksa kiriman pada sampel berikutnya (misalnya setelah konfigurasi berubah)
+  void reset() { hasReference = false; }
+
+  const ReportStats &stats() const { return reportStats; }
+
+private:
+  static bool exceeds(int16_t value, int16_t previous, int16_t band)
+  {
+    int32_t delta = (int32_t)value - previous;
+    return (delta < 0 ? -delta : delta) >= band;
+  }
+
+  bool changed(const TelemetryFrame &frame) const
+  {
+    const uint8_t validMask = TelemetryTemperatureValid | TelemetryHumidityValid | TelemetryPhValid;
+    if ((frame.flags & validMask) != (reference.flags & validMask) || frame.probeCount != reference.probeCount)
+      return true;
+
+    if ((frame.flags & TelemetryTemperatureValid) && exceeds(frame.temperature, reference.temperature, deadband.temperature))
+      return true;
+    if ((frame.flags & TelemetryHumidityValid) && exceeds(frame.humidity, reference.humidity, deadband.humidity))
+      return true;
+    if ((frame.flags & TelemetryPhValid) && exceeds(frame.ph, reference.ph, deadband.ph))
+      return true;
+
+    // Probe urut ID (lihat scanTemperatureProbes), jadi cukup dibandingkan per indeks
+    for (uint8_t i = 0; i < frame.probeCount; i++)
+    {
+      int16_t value = frame.probeTemperature[i];
+      int16_t previous = reference.probeTemperature[i];
+      if (frame.probeId[i] != reference.probeId[i] || (value == TELEMETRY_PROBE_INVALID) != (previous == TELEMETRY_PROBE_INVALID))
+        return true;
+      if (value != TELEMETRY_PROBE_INVALID && exceeds(value, previous, deadband.temperature))
+        return true;
+    }
+    return false;
+  }
+
+  ReportDeadband deadband;
+  TelemetryFrame reference;
+  uint32_t referenceMs;
+  bool hasReference;
+  ReportStats reportStats;
+};
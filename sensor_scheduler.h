@@ -0,0 +1,228 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// Scheduler kooperatif berbasis deadline untuk job sensor, dijalankan dari satu task.
+// Job didaftarkan di timer wheel (SENSOR_SCHEDULER_WHEEL_SLOTS slot x SENSOR_SCHEDULER_TICK_MS):
+// menjadwalkan O(1), dan task cukup tidur sampai job terdekat (runDue() mengembalikan waktunya).
+//
+// Satu siklus job boleh terdiri dari beberapa langkah (misalnya request konversi DS18B20 lalu
+// baca 750 ms kemudian). Fungsi langkah mengembalikan jeda ms sampai langkah berikutnya, atau
+// SENSOR_JOB_CYCLE_DONE jika siklus selesai; siklus berikutnya dijadwalkan tepat satu periode
+// setelah deadline siklus ini (tidak drift). Jika siklus terlambat lebih dari satu periode,
+// deadline yang terlewat dilewati dan dihitung sebagai overrun.
+//
+// Statistik per job: jitter (mulai aktual - deadline) dan waktu eksekusi tiap langkah, dalam us.
+
+#define SENSOR_SCHEDULER_MAX_JOBS 8
+#define SENSOR_SCHEDULER_TICK_MS 10
+#define SENSOR_SCHEDULER_WHEEL_SLOTS 256 // 2.56 s per putaran wheel, cukup untuk periode sensor tanpa putaran tambahan
+#define SENSOR_JOB_CYCLE_DONE 0
+
+// phase: nomor langkah dalam siklus, 0 di awal siklus; boleh diubah oleh fungsi langkah
+typedef uint32_t (*SensorJobStep)(uint8_t &phase);
+
+struct SensorJobStats
+{
+  uint32_t steps;          // Jumlah langkah yang dijalankan
+  uint32_t cycles;         // Jumlah siklus selesai
+  uint32_t overruns;       // Deadline siklus yang terlewat
+  uint32_t jitterTotalUs;  // Untuk rata-rata jitter
+  uint32_t jitterMaxUs;
+  uint32_t runTotalUs;     // Untuk rata-rata waktu eksekusi
+  uint32_t runMaxUs;
+};
+
+struct SensorJob
+{
+  const char *name;
+  SensorJobStep step;
+  uint32_t periodMs;
+  uint8_t phase;
+  uint32_t cycleDueUs; // Deadline langkah pertama siklus yang sedang berjalan
+  uint32_t dueUs;      // Deadline langkah berikutnya
+  uint32_t dueTick;    // Tick wheel dari dueUs
+  uint8_t next;        // Job berikutnya di slot wheel yang sama
+  SensorJobStats stats;
+};
+
+class SensorScheduler
+{
+public:
+  typedef unsigned long (*Clock)(); // Sumber waktu us (micros() di board)
+
+  explicit SensorScheduler(Clock clockUs) : clockUs(clockUs)
+  {
+    memset(wheel, NoJob, sizeof(wheel));
+    cursorUs = clockUs();
+  }
+
+  // Mendaftarkan job; langkah pertamanya jatuh tempo firstDelayMs dari sekarang. Mengembalikan -1 jika penuh
+  int addJob(const char *name, SensorJobStep step, uint32_t periodMs, uint32_t firstDelayMs = 0)
+  {
+    if (jobCount >= SENSOR_SCHEDULER_MAX_JOBS)
+      return -1;
+
+    SensorJob &job = jobs[jobCount];
+    memset(&job, 0, sizeof(job));
+    job.name = name;
+    job.step = step;
+    job.periodMs = periodMs;
+    job.cycleDueUs = clockUs() + firstDelayMs * 1000;
+    schedule(jobCount, job.cycleDueUs);
+    return jobCount++;
+  }
+
+  // Menjalankan semua langkah job yang sudah jatuh tempo, mengembalikan ms sampai deadline berikutnya
+  uint32_t runDue()
+  {
+    uint32_t now = clockUs();
+
+    // Slot yang sudah lewat seluruhnya: semua isinya jatuh tempo
+    while ((int32_t)(now - cursorUs) >= (int32_t)TickUs)
+    {
+      runSlot(cursorTick, now, false);
+      cursorTick++;
+      cursorUs += TickUs;
+    }
+    // Slot saat ini: hanya job yang deadline-nya sudah lewat
+    runSlot(cursorTick, now, true);
+
+    return nextDelayMs();
+  }
+
+  // Periode baru berlaku mulai siklus berikutnya
+  void setPeriod(uint8_t index, uint32_t periodMs)
+  {
+    if (index < jobCount)
+      jobs[index].periodMs = periodMs;
+  }
+
+  uint8_t size() const { return jobCount; }
+  const SensorJob &job(uint8_t index) const { return jobs[index]; }
+
+  void resetStats()
+  {
+    for (uint8_t i = 0; i < jobCount; i++)
+      memset(&jobs[i].stats, 0, sizeof(SensorJobStats));
+  }
+
+private:
+  static const uint8_t NoJob = 0xFF;
+  static const uint32_t TickUs = SENSOR_SCHEDULER_TICK_MS * 1000UL;
+
+  void schedule(uint8_t index, uint32_t dueUs)
+  {
+    SensorJob &job = jobs[index];
+    int32_t ahead = (int32_t)(dueUs - cursorUs);
+    job.dueUs = dueUs;
+    job.dueTick = cursorTick + (ahead > 0 ? ahead / TickUs : 0);
+
+    uint8_t &slot = wheel[job.dueTick % SENSOR_SCHEDULER_WHEEL_SLOTS];
+    job.next = slot;
+    slot = index;
+  }
+
+  // Memindahkan job yang jatuh tempo dari slot ke daftar siap, lalu menjalankannya berurutan deadline.
+  // Job yang menjadwalkan ulang dirinya ke slot yang sama tidak ikut berjalan di putaran ini.
+  void runSlot(uint32_t tick, uint32_t now, bool checkDue)
+  {
+    uint8_t ready[SENSOR_SCHEDULER_MAX_JOBS];
+    uint8_t readyCount = 0;
+
+    uint8_t *link = &wheel[tick % SENSOR_SCHEDULER_WHEEL_SLOTS];
+    while (*link != NoJob)
+    {
+      SensorJob &job = jobs[*link];
+      bool due = (int32_t)(job.dueTick - tick) <= 0 && (!checkDue || (int32_t)(now - job.dueUs) >= 0);
+      if (!due)
+      {
+        link = &job.next;
+        continue;
+      }
+
+      // Sisipkan terurut deadline
+      uint8_t position = readyCount++;
+      while (position > 0 && (int32_t)(jobs[ready[position - 1]].dueUs - job.dueUs) > 0)
+      {
+        ready[position] = ready[position - 1];
+        position--;
+      }
+      ready[position] = *link;
+      *link = job.next;
+    }
+
+    for (uint8_t i = 0; i < readyCount; i++)
+      runStep(ready[i]);
+  }
+
+  void runStep(uint8_t index)
+  {
+    SensorJob &job = jobs[index];
+    uint32_t startUs = clockUs();
+    uint32_t delayMs = job.step(job.phase);
+    uint32_t endUs = clockUs();
+
+    uint32_t jitterUs = startUs - job.dueUs;
+    uint32_t runUs = endUs - startUs;
+    job.stats.steps++;
+    job.stats.jitterTotalUs += jitterUs;
+    job.stats.runTotalUs += runUs;
+    if (jitterUs > job.stats.jitterMaxUs)
+      job.stats.jitterMaxUs = jitterUs;
+    if (runUs > job.stats.runMaxUs)
+      job.stats.runMaxUs = runUs;
+
+    if (delayMs != SENSOR_JOB_CYCLE_DONE)
+    {
+      schedule(index, endUs + delayMs * 1000); // Jeda antar langkah dihitung dari akhir langkah (waktu fisik sensor)
+      return;
+    }
+
+    // Siklus berikutnya satu periode setelah deadline siklus ini
+    job.stats.cycles++;
+    job.phase = 0;
+    uint32_t periodUs = job.periodMs * 1000;
+    job.cycleDueUs += periodUs;
+    while ((int32_t)(endUs - job.cycleDueUs) > 0)
+    {
+      job.cycleDueUs += periodUs;
+      job.stats.overruns++;
+    }
+    schedule(index, job.cycleDueUs);
+  }
+
+  // Deadline terdekat: cari slot tidak kosong pertama dari cursor, maksimal satu putaran wheel
+  uint32_t nextDelayMs() const
+  {
+    uint32_t now = clockUs();
+    for (uint32_t offset = 0; offset < SENSOR_SCHEDULER_WHEEL_SLOTS; offset++)
+    {
+      uint32_t tick = cursorTick + offset;
+      bool found = false;
+      uint32_t earliestUs = 0;
+      for (uint8_t index = wheel[tick % SENSOR_SCHEDULER_WHEEL_SLOTS]; index != NoJob; index = jobs[index].next)
+      {
+        if (jobs[index].dueTick != tick)
+          continue; // Putaran wheel berikutnya
+        if (!found || (int32_t)(jobs[index].dueUs - earliestUs) < 0)
+          earliestUs = jobs[index].dueUs;
+        found = true;
+      }
+      if (found)
+      {
+        int32_t waitUs = (int32_t)(earliestUs - now);
+        return waitUs > 0 ? (waitUs + 999) / 1000 : 0;
+      }
+    }
+    return SENSOR_SCHEDULER_WHEEL_SLOTS * SENSOR_SCHEDULER_TICK_MS; // Tidak ada job dalam satu putaran
+  }
+
+  Clock clockUs;
+  SensorJob jobs[SENSOR_SCHEDULER_MAX_JOBS];
+  uint8_t jobCount = 0;
+  uint8_t wheel[SENSOR_SCHEDULER_WHEEL_SLOTS];
+  uint32_t cursorTick = 0;
+  uint32_t cursorUs;
+};
@@ -6,6 +6,8 @@ import json  # Untuk bekerja dengan data JSON
 import os  # Untuk berinteraksi dengan sistem operasi (misalnya, mendapatkan path file)
 import joblib  # Untuk memuat model machine learning yang sudah disimpan
 import socket  # Untuk mendapatkan informasi jaringan seperti alamat IP
+import time  # Untuk menghitung timestamp pembacaan pada update batch ThingSpeak
+import threading  # Untuk mengirim bulk update ThingSpeak yang ditunda di latar belakang
 
 # Inisialisasi aplikasi Flask
 app = Flask(__name__)
@@ -18,6 +20,10 @@ DIR = os.path.dirname(os.path.abspath(__file__))
 THINGSPEAK_WRITE_API_KEY = os.environ.get('THINGSPEAK_WRITE_API_KEY', '1Y04VEMCGE7G4GYE')
 # ID Channel ThingSpeak. Mengambil dari environment variable jika ada, jika tidak menggunakan nilai default.
 THINGSPEAK_CHANNEL_ID = os.environ.get('THINGSPEAK_CHANNEL_ID', '2977596')
+# Jarak minimal antar bulk update ThingSpeak (detik); akun gratis menjawab 500 jika lebih sering
+THINGSPEAK_BULK_INTERVAL_S = 15
+# Entri maksimal yang ditahan untuk bulk update berikutnya; yang tertua dibuang jika ThingSpeak lama tidak bisa dihubungi
+THINGSPEAK_BULK_MAX = 960
 # Batas minimal suhu yang dianggap layak (feasible)
 FEASIBLE_TEMP_MIN = 40.0
 # Batas maksimal suhu yang dianggap layak (feasible)
@@ -34,11 +40,19 @@ MODEL_FILE = os.path.join(DIR, 'knn_model.joblib')
 # Path ke file scaler yang digunakan untuk normalisasi data sebelum dimasukkan ke model
 SCALER_FILE = os.path.join(DIR, 'scaler.joblib')
 
+# Fitur model dengan profil suhu multi-probe (lihat FEATURE_COLUMNS di knn_model_training.py)
+PROFILE_FEATURE_COUNT = 5
+
 # --- Variabel Global ---
 # Variabel untuk menyimpan model KNN yang sudah dimuat
 knn_model = None
 # Variabel untuk menyimpan scaler yang sudah dimuat
 scaler = None
+# Entri ThingSpeak yang menunggu bulk update berikutnya, waktu kiriman terakhir dan timer kiriman yang terjadwal
+thingspeak_pending = []
+thingspeak_last_sent = 0.0
+thingspeak_timer = None
+thingspeak_lock = threading.Lock()
 
 # Fungsi untuk mendapatkan alamat IP server secara otomatis (terhubung ke internet)
 def get_ip():
@@ -98,6 +112,79 @@ def load_model_and_scaler():
 # Panggil fungsi untuk memuat model dan scaler saat aplikasi dimulai
 load_model_and_scaler()
 
+# Fungsi untuk menyusun baris fitur dari satu pembacaan sesuai fitur yang dipakai saat training
+def feature_row(reading):
+    """Model lama memakai [suhu, kelembaban, pH]; model profil suhu memakai
+    [suhu_min, suhu_rata2, suhu_max, kelembaban, pH]. Transmitter satu probe tidak mengirim
+    min/max, sehingga keduanya sama dengan suhu rata-rata."""
+    temperature = float(reading.get('temperature', 0))
+    humidity = float(reading.get('humidity', 0))
+    ph = float(reading.get('ph', 0))
+    if scaler is not None and scaler.n_features_in_ == PROFILE_FEATURE_COUNT:
+        temperature_min = float(reading.get('temperature_min', temperature))
+        temperature_max = float(reading.get('temperature_max', temperature))
+        return [temperature_min, temperature, temperature_max, humidity, ph]
+    return [temperature, humidity, ph]
+
+# Fungsi untuk menyusun field ThingSpeak satu pembacaan (field5/field6 = suhu probe terendah/tertinggi,
+# field7/field8 = alamat node pengirim dan RSSI-nya di Receiver agar data beberapa transmitter bisa dipisahkan)
+def thingspeak_fields(reading, prediction):
+    temperature = float(reading.get('temperature', 0))
+    fields = {
+        "field1": temperature,  # Data suhu (rata-rata probe) untuk field1 di ThingSpeak
+        "field2": float(reading.get('humidity', 0)),  # Data kelembaban untuk field2 di ThingSpeak
+        "field3": float(reading.get('ph', 0)),  # Data pH untuk field3 di ThingSpeak
+        "field4": prediction,  # Hasil prediksi untuk field4 di ThingSpeak
+        "field5": float(reading.get('temperature_min', temperature)),  # Suhu probe terendah
+        "field6": float(reading.get('temperature_max', temperature)),  # Suhu probe tertinggi
+    }
+    if 'sender' in reading:
+        fields["field7"] = int(reading['sender'])  # Alamat LoRa transmitter
+    if 'rssi' in reading:
+        fields["field8"] = int(reading['rssi'])  # RSSI paket di Receiver
+    return fields
+
+# Fungsi untuk menambahkan entri ke bulk update ThingSpeak berikutnya. Kiriman dibatasi satu per
+# THINGSPEAK_BULK_INTERVAL_S: batch yang datang lebih cepat digabung ke kiriman yang sudah terjadwal
+# (created_at tiap entri tetap waktu pembacaan), sehingga Receiver tidak menerima 500 lalu men-spool dan replay
+def thingspeak_bulk_update(updates):
+    global thingspeak_timer
+    with thingspeak_lock:
+        thingspeak_pending.extend(updates)
+        if len(thingspeak_pending) > THINGSPEAK_BULK_MAX:
+            print(f"ThingSpeak: {len(thingspeak_pending) - THINGSPEAK_BULK_MAX} entri tertua dibuang")
+            del thingspeak_pending[:len(thingspeak_pending) - THINGSPEAK_BULK_MAX]
+        if thingspeak_timer is None:
+            delay = max(0.0, thingspeak_last_sent + THINGSPEAK_BULK_INTERVAL_S - time.time())
+            thingspeak_timer = threading.Timer(delay, thingspeak_flush)
+            thingspeak_timer.daemon = True
+            thingspeak_timer.start()
+
+# Fungsi timer: mengirim semua entri yang menunggu dalam satu bulk update; jika gagal, entri dikembalikan ke
+# depan antrean dan dicoba lagi setelah THINGSPEAK_BULK_INTERVAL_S
+def thingspeak_flush():
+    global thingspeak_timer, thingspeak_last_sent
+    with thingspeak_lock:
+        updates = thingspeak_pending[:]
+        del thingspeak_pending[:]
+        thingspeak_last_sent = time.time()
+    thingspeak_url = f"https://api.thingspeak.com/channels/{THINGSPEAK_CHANNEL_ID}/bulk_update.json"
+    try:
+        response = requests.post(thingspeak_url, json={"write_api_key": THINGSPEAK_WRITE_API_KEY, "updates": updates})
+        response.raise_for_status() # Akan menghasilkan error jika status code HTTP adalah 4xx atau 5xx
+        print(f"ThingSpeak: bulk update {len(updates)} entri")
+    except requests.exceptions.RequestException as e:
+        print(f"Error sending to ThingSpeak: {e}")
+        with thingspeak_lock:
+            thingspeak_pending[:0] = updates
+            del thingspeak_pending[:max(0, len(thingspeak_pending) - THINGSPEAK_BULK_MAX)]
+    with thingspeak_lock:
+        thingspeak_timer = None
+        if thingspeak_pending:
+            thingspeak_timer = threading.Timer(THINGSPEAK_BULK_INTERVAL_S, thingspeak_flush)
+            thingspeak_timer.daemon = True
+            thingspeak_timer.start()
+
 # --- Endpoint API ---
 # Mendefinisikan route '/biodrying_data' yang menerima request POST
 @app.route('/biodrying_data', methods=['POST'])
@@ -120,13 +207,13 @@ def biodrying_data():
             return Response(json.dumps({'error': 'Model not loaded'}), status=503, mimetype='application/json') # 503 Service Unavailable
 
         # Melakukan scaling (normalisasi) pada data baru menggunakan scaler yang sudah dimuat
-        new_data_point_scaled = scaler.transform([[temperature, humidity, ph]])
+        new_data_point_scaled = scaler.transform([feature_row(data)])
         # Melakukan prediksi menggunakan model KNN pada data yang sudah di-scale
         prediction = int(knn_model.predict(new_data_point_scaled)[0]) # Ambil hasil prediksi pertama dan ubah ke integer
         # Memberikan label pada hasil prediksi (1 = Layak, 0 = Belum layak)
         prediction_label = "Layak" if prediction == 1 else "Belum Layak"
 
-        print(f"Data: Temp={temperature}, Humidity={humidity}, pH={ph}") # Mencetak data sensor yang diterima
+        print(f"Data: Temp={temperature}, Humidity={humidity}, pH={ph}, Probes={data.get('probes', [])}") # Mencetak data sensor yang diterima
         print(f"Model Prediction: {prediction} ({prediction_label})") # Mencetak hasil prediksi model
 
         # --- Logika Buzzer ---
@@ -147,12 +234,7 @@ def biodrying_data():
         # URL untuk mengirim data ke ThingSpeak
         thingspeak_url = f"https://api.thingspeak.com/update?api_key={THINGSPEAK_WRITE_API_KEY}"
         # Data (payload) yang akan dikirim ke ThingSpeak
-        payload = {
-            "field1": temperature,  # Data suhu untuk field1 di ThingSpeak
-            "field2": humidity,  # Data kelembaban untuk field2 di ThingSpeak
-            "field3": ph,  # Data pH untuk field3 di ThingSpeak
-            "field4": prediction,  # Hasil prediksi untuk field4 di ThingSpeak
-        }
+        payload = thingspeak_fields(data, prediction)
         try:
             # Mengirim data ke ThingSpeak menggunakan metode POST
             response = requests.post(thingspeak_url, data=payload)
@@ -172,6 +254,64 @@ def biodrying_data():
         print(f"Error: {e}")
         return Response(json.dumps({'error': 'Invalid data'}), status=400, mimetype='application/json') # 400 Bad Request
 
+# Mendefinisikan route '/biodrying_data/batch' yang menerima banyak pembacaan dalam satu request POST
+@app.route('/biodrying_data/batch', methods=['POST'])
+def biodrying_data_batch():
+    """Menerima array pembacaan {"readings": [{temperature, temperature_min, temperature_max, humidity, ph,
+    sender, rssi, age_ms, held|heartbeat|backlog, probes}, ...]},
+    held=true menandai sampel rekonstruksi Receiver (nilai terakhir node report-on-change yang masih berlaku),
+    backlog=true menandai pembacaan lama dari flash transmitter yang terkirim setelah link LoRa pulih
+    (age_unknown=true jika waktu pengambilannya tidak diketahui karena transmitter restart),
+    melakukan scaling dan prediksi KNN untuk seluruh batch sekaligus, menggabungkan semuanya ke bulk update
+    ThingSpeak berikutnya (paling sering sekali per THINGSPEAK_BULK_INTERVAL_S, lihat thingspeak_bulk_update),
+    lalu mengembalikan hasil per pembacaan dengan urutan yang sama."""
+    global knn_model, scaler # Menggunakan variabel global knn_model dan scaler
+
+    print(f"[Menerima Batch] -> {request.data}") # Mencetak data mentah yang diterima
+    try:
+        # Mengurai (parse) data JSON dan menyusun matriks fitur per pembacaan (lihat feature_row)
+        readings = json.loads(request.data)['readings']
+        features = [feature_row(r) for r in readings]
+
+        # Jika model atau scaler belum berhasil dimuat, kirim respons error
+        if knn_model is None or scaler is None:
+            return Response(json.dumps({'error': 'Model not loaded'}), status=503, mimetype='application/json') # 503 Service Unavailable
+
+        # Batch kosong tetap dijawab dengan daftar hasil kosong
+        if not features:
+            return Response(json.dumps({'results': []}), status=200, mimetype='application/json')
+
+        # Scaling dan prediksi satu kali untuk seluruh batch (vektorisasi), bukan satu baris per request
+        predictions = knn_model.predict(scaler.transform(features)).astype(int).tolist()
+        print(f"Batch {len(features)} pembacaan, prediksi: {predictions}") # Mencetak hasil prediksi model
+
+        # Logika buzzer sama dengan endpoint tunggal: buzzer ON jika prediksi 'feasible'
+        results = [{'classification': prediction, 'buzzer_on': prediction} for prediction in predictions]
+
+        # --- ThingSpeak Bulk Update ---
+        # Entri masuk bulk update berikutnya; waktu tiap entri dihitung dari umur pembacaan di Receiver
+        now = time.time()
+        updates = []
+        for reading, prediction in zip(readings, predictions):
+            created_at = now - float(reading.get('age_ms', 0)) / 1000.0
+            update = thingspeak_fields(reading, prediction)
+            update["created_at"] = time.strftime('%Y-%m-%dT%H:%M:%SZ', time.gmtime(created_at))
+            if reading.get('held'):
+                update["status"] = "held"  # Sampel rekonstruksi, bukan pengukuran baru
+            elif reading.get('backlog'):
+                # Pembacaan store-and-forward: created_at = waktu pengambilan, kecuali umurnya tidak diketahui
+                update["status"] = "backlog, waktu tidak diketahui" if reading.get('age_unknown') else "backlog"
+            updates.append(update)
+        thingspeak_bulk_update(updates)
+
+        # Mengirim respons sukses: satu hasil per pembacaan, urutan sama dengan request
+        return Response(json.dumps({'results': results}), status=200, mimetype='application/json') # 200 OK
+
+    except Exception as e:
+        # Jika terjadi error lain (misalnya, data JSON tidak valid), cetak error dan kirim respons error
+        print(f"Error: {e}")
+        return Response(json.dumps({'error': 'Invalid data'}), status=400, mimetype='application/json') # 400 Bad Request
+
 # Blok ini akan dieksekusi hanya jika skrip dijalankan secara langsung (bukan diimpor sebagai modul)
 if __name__ == '__main__':
     zeroconf = register_mdns() # Daftarkan layanan mDNS saat server dimulai
@@ -180,7 +320,8 @@ if __name__ == '__main__':
         # host="0.0.0.0" membuat server dapat diakses dari alamat IP manapun di jaringan
         # port=5000 adalah port yang digunakan server
         # debug=True mengaktifkan mode debug Flask (berguna saat pengembangan)
-        app.run(host="0.0.0.0", port=5000, debug=True)
+        # threaded=True membuat werkzeug memakai HTTP/1.1 sehingga koneksi keep-alive dari Receiver dipertahankan
+        app.run(host="0.0.0.0", port=5000, debug=True, threaded=True)
     except KeyboardInterrupt:
         # Jika server dihentikan dengan Ctrl+C (KeyboardInterrupt)
         print("Shutting down server...")
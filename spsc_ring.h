@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+// Ring buffer lock-free single-producer / single-consumer.
+// Producer (misalnya callback interrupt DIO0) mengisi slot langsung lewat beginPush()/commitPush(),
+// consumer (task) memproses slot di tempat lewat front()/pop(), jadi tidak ada copy ganda.
+// Kapasitas harus pangkat dua; indeks berjalan bebas dan di-mask saat mengakses slot.
+
+template <typename T, uint32_t Capacity>
+class SpscRing
+{
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Kapasitas SpscRing harus pangkat dua");
+
+public:
+  // --- Producer ---
+  // Mengembalikan slot kosong, atau NULL (dan menambah penghitung drop) jika ring penuh
+  T *beginPush()
+  {
+    uint32_t head = headIndex.load(std::memory_order_relaxed);
+    uint32_t tail = tailIndex.load(std::memory_order_acquire);
+    if (head - tail >= Capacity)
+    {
+      droppedCount.store(droppedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    return &slots[head & (Capacity - 1)];
+  }
+
+  void commitPush()
+  {
+    uint32_t head = headIndex.load(std::memory_order_relaxed) + 1;
+    headIndex.store(head, std::memory_order_release);
+
+    uint32_t used = head - tailIndex.load(std::memory_order_relaxed);
+    if (used > highWaterMark.load(std::memory_order_relaxed))
+      highWaterMark.store(used, std::memory_order_relaxed);
+  }
+
+  // --- Consumer ---
+  // Slot tertua yang belum diproses, atau NULL jika ring kosong
+  T *front()
+  {
+    uint32_t tail = tailIndex.load(std::memory_order_relaxed);
+    if (headIndex.load(std::memory_order_acquire) == tail)
+      return nullptr;
+    return &slots[tail & (Capacity - 1)];
+  }
+
+  void pop()
+  {
+    tailIndex.store(tailIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // --- Statistik (boleh dibaca dari task manapun) ---
+  uint32_t size() const { return headIndex.load(std::memory_order_acquire) - tailIndex.load(std::memory_order_acquire); }
+  uint32_t capacity() const { return Capacity; }
+  uint32_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+  uint32_t highWater() const { return highWaterMark.load(std::memory_order_relaxed); }
+
+private:
+  T slots[Capacity];
+  std::atomic<uint32_t> headIndex{0};
+  std::atomic<uint32_t> tailIndex{0};
+  std::atomic<uint32_t> droppedCount{0};
+  std::atomic<uint32_t> highWaterMark{0};
+};
@@ -0,0 +1,431 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// Frame biner telemetri Transmitter -> Receiver
+// Menggantikan payload JSON ({"humidity":..,"temperature":..,"ph":..} ~50 byte).
+// Versi 3, panjang 13 + 4 x jumlah probe suhu:
+//
+//  byte 0     : versi frame
+//  byte 1     : flags (lihat TelemetryFlag)
+//  byte 2..3  : suhu       int16 little endian, satuan 0.01 C (rata-rata probe yang valid)
+//  byte 4..5  : kelembapan int16 little endian, satuan 0.01 %
+//  byte 6..7  : pH         int16 little endian, satuan 0.01
+//  byte 8     : jumlah probe suhu N (0..TELEMETRY_MAX_PROBES)
+//  byte 9..10 : nomor urut ARQ uint16 little endian (lora_arq.h)
+//  per probe  : ID probe uint16 (2 byte serial ROM DS18B20 terbawah) + suhu int16 0.01 C,
+//               TELEMETRY_PROBE_INVALID jika probe gagal dibaca
+//  2 byte     : CRC-16/CCITT-FALSE dari seluruh byte sebelumnya, little endian
+//
+// Versi 2 (tanpa nomor urut, header 9 byte) dan versi 1 (10 byte, tanpa byte jumlah probe) tetap bisa
+// di-decode untuk transmitter lama; frame itu tidak ikut ARQ dan dijawab dengan respons JSON.
+//
+// Frame kompak (versi 4) untuk kiriman langsung transmitter, panjang 9 + 4 x jumlah probe (11 untuk satu probe
+// yang suhunya sama dengan rata-rata). Dikirim dengan CRC payload LoRa aktif, sehingga cukup CRC-8:
+//  byte 0     : TELEMETRY_COMPACT_TAG | jumlah probe N, atau TELEMETRY_COMPACT_SINGLE_PROBE jika satu probe
+//               dengan suhu sama dengan byte suhu frame (suhu probe tidak dikirim ulang)
+//  byte 1     : flags
+//  byte 2     : byte teratas nomor urut ARQ (byte terbawah = msgId di header paket)
+//  byte 3..7  : 40 bit little endian: suhu 15 bit (0.01 C + 55.00), kelembapan 14 bit (0.01 %), pH 11 bit (0.01);
+//               nilai di luar rentang dijenuhkan
+//  per probe  : ID probe uint16 + suhu int16 0.01 C, seperti versi 3
+//  1 byte     : CRC-8 (poly 0x07, init 0xFF) dari msgId lalu seluruh byte sebelumnya
+// Frame yang disimpan di flash (backlog transmitter, spool Receiver) tetap versi 3 dengan CRC-16 sendiri.
+//
+// Frame batch backlog (store-and-forward, pembacaan yang tersimpan di flash transmitter selama link putus):
+//  byte 0     : TELEMETRY_BATCH_VERSION
+//  byte 1     : jumlah record N (1..TELEMETRY_BATCH_MAX_RECORDS)
+//  byte 2..3  : nomor urut ARQ uint16 little endian
+//  per record : umur pembacaan saat frame dikirim, uint32 detik (TELEMETRY_AGE_UNKNOWN jika diambil sebelum
+//               transmitter restart), lalu frame versi 3 utuh seperti yang tersimpan di flash
+//  2 byte     : CRC-16/CCITT-FALSE dari seluruh byte sebelumnya
+
+#define TELEMETRY_FRAME_VERSION 3
+#define TELEMETRY_FRAME_V1_SIZE 10
+#define TELEMETRY_FRAME_V2_HEADER_SIZE 9
+#define TELEMETRY_FRAME_HEADER_SIZE 11
+#define TELEMETRY_PROBE_SIZE 4
+#define TELEMETRY_MAX_PROBES 8
+#define TELEMETRY_FRAME_MAX_SIZE (TELEMETRY_FRAME_HEADER_SIZE + TELEMETRY_MAX_PROBES * TELEMETRY_PROBE_SIZE + 2)
+#define TELEMETRY_PROBE_INVALID INT16_MIN
+#define TELEMETRY_FIXED_SCALE 100.0f
+#define TELEMETRY_BATCH_VERSION 0xB1
+#define TELEMETRY_BATCH_HEADER_SIZE 4
+#define TELEMETRY_BATCH_AGE_SIZE 4
+#define TELEMETRY_BATCH_MAX_RECORDS 8
+#define TELEMETRY_BATCH_MAX_SIZE 240 // Payload LoRa maksimal 255 byte termasuk header 4 byte
+#define TELEMETRY_AGE_UNKNOWN 0xFFFFFFFFUL
+#define TELEMETRY_COMPACT_VERSION 4
+#define TELEMETRY_COMPACT_TAG (TELEMETRY_COMPACT_VERSION << 4)
+#define TELEMETRY_COMPACT_SINGLE_PROBE 0x0F
+#define TELEMETRY_COMPACT_HEADER_SIZE 8
+#define TELEMETRY_COMPACT_MAX_SIZE (TELEMETRY_COMPACT_HEADER_SIZE + TELEMETRY_MAX_PROBES * TELEMETRY_PROBE_SIZE + 1)
+#define TELEMETRY_COMPACT_TEMPERATURE_OFFSET 5500
+
+enum TelemetryFlag
+{
+  TelemetryTemperatureValid = 1 << 0,
+  TelemetryHumidityValid = 1 << 1,
+  TelemetryPhValid = 1 << 2,
+  TelemetryHeartbeat = 1 << 3, // Frame dikirim karena heartbeat report-on-change, bukan karena perubahan nilai
+  TelemetryAdrCapable = 1 << 4, // Node menjalankan ADR (lora_adr.h) dan menerima perintah di belakang ACK
+  TelemetryAdrCommandMask = 7 << 5 // Nomor perintah ADR terakhir yang diterima node, 0 = belum ada
+};
+
+#define TELEMETRY_ADR_COMMAND_SHIFT 5
+
+struct TelemetryFrame
+{
+  uint8_t version;
+  uint8_t flags;
+  int16_t temperature; // 0.01 C
+  int16_t humidity;    // 0.01 %
+  int16_t ph;          // 0.01
+  uint8_t probeCount;
+  uint16_t seq; // Nomor urut ARQ, 0 untuk frame versi 1/2
+  uint16_t probeId[TELEMETRY_MAX_PROBES];
+  int16_t probeTemperature[TELEMETRY_MAX_PROBES]; // 0.01 C
+};
+
+inline size_t telemetryFrameSize(uint8_t probeCount, size_t headerSize = TELEMETRY_FRAME_HEADER_SIZE)
+{
+  return headerSize + probeCount * TELEMETRY_PROBE_SIZE + 2;
+}
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), versi bitwise agar tidak memakan flash untuk tabel
+inline uint16_t telemetryCrc16(const uint8_t *data, size_t length)
+{
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < length; i++)
+  {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+// Konversi nilai float ke fixed point dengan pembulatan dan saturasi int16
+inline int16_t telemetryToFixed(float value)
+{
+  float scaled = value * TELEMETRY_FIXED_SCALE;
+  scaled += (scaled >= 0.0f) ? 0.5f : -0.5f;
+  if (scaled > 32767.0f)
+    return 32767;
+  if (scaled < -32768.0f)
+    return -32768;
+  return (int16_t)scaled;
+}
+
+inline float telemetryFromFixed(int16_t value)
+{
+  return value / TELEMETRY_FIXED_SCALE;
+}
+
+inline void telemetryWriteInt16(uint8_t *buffer, int16_t value)
+{
+  buffer[0] = (uint16_t)value & 0xFF;
+  buffer[1] = (uint16_t)value >> 8;
+}
+
+inline int16_t telemetryReadInt16(const uint8_t *buffer)
+{
+  return (int16_t)(buffer[0] | (uint16_t)buffer[1] << 8);
+}
+
+// Mengisi frame dari nilai sensor; sensor yang tidak valid tetap dikirim tapi flag-nya dimatikan.
+// Probe suhu ditambahkan sesudahnya dengan addTelemetryProbe().
+inline TelemetryFrame makeTelemetryFrame(float temperature, float humidity, float ph, uint8_t flags)
+{
+  TelemetryFrame frame;
+  frame.version = TELEMETRY_FRAME_VERSION;
+  frame.flags = flags;
+  frame.temperature = telemetryToFixed(temperature);
+  frame.humidity = telemetryToFixed(humidity);
+  frame.ph = telemetryToFixed(ph);
+  frame.probeCount = 0;
+  frame.seq = 0;
+  return frame;
+}
+
+// Menambahkan satu probe suhu, mengembalikan false jika frame sudah berisi TELEMETRY_MAX_PROBES probe
+inline bool addTelemetryProbe(TelemetryFrame &frame, uint16_t id, float temperature, bool valid)
+{
+  if (frame.probeCount >= TELEMETRY_MAX_PROBES)
+    return false;
+  frame.probeId[frame.probeCount] = id;
+  frame.probeTemperature[frame.probeCount] = valid ? telemetryToFixed(temperature) : TELEMETRY_PROBE_INVALID;
+  frame.probeCount++;
+  return true;
+}
+
+// Menulis frame ke buffer, mengembalikan jumlah byte yang ditulis (0 jika buffer kurang)
+inline size_t encodeTelemetryFrame(const TelemetryFrame &frame, uint8_t *buffer, size_t bufferSize)
+{
+  uint8_t probeCount = frame.probeCount > TELEMETRY_MAX_PROBES ? TELEMETRY_MAX_PROBES : frame.probeCount;
+  size_t size = telemetryFrameSize(probeCount);
+  if (bufferSize < size)
+    return 0;
+
+  buffer[0] = TELEMETRY_FRAME_VERSION;
+  buffer[1] = frame.flags;
+  telemetryWriteInt16(&buffer[2], frame.temperature);
+  telemetryWriteInt16(&buffer[4], frame.humidity);
+  telemetryWriteInt16(&buffer[6], frame.ph);
+  buffer[8] = probeCount;
+  telemetryWriteInt16(&buffer[9], (int16_t)frame.seq);
+
+  uint8_t *probe = &buffer[TELEMETRY_FRAME_HEADER_SIZE];
+  for (uint8_t i = 0; i < probeCount; i++, probe += TELEMETRY_PROBE_SIZE)
+  {
+    telemetryWriteInt16(&probe[0], (int16_t)frame.probeId[i]);
+    telemetryWriteInt16(&probe[2], frame.probeTemperature[i]);
+  }
+
+  uint16_t crc = telemetryCrc16(buffer, size - 2);
+  buffer[size - 2] = crc & 0xFF;
+  buffer[size - 1] = crc >> 8;
+
+  return size;
+}
+
+// Membaca frame dari buffer; gagal jika panjang, versi atau CRC tidak sesuai
+inline bool decodeTelemetryFrame(const uint8_t *buffer, size_t length, TelemetryFrame &frame)
+{
+  if (length == 0)
+    return false; // Versi di buffer[0] belum boleh dibaca
+
+  size_t size;
+  size_t headerSize = buffer[0] == 2 ? TELEMETRY_FRAME_V2_HEADER_SIZE : TELEMETRY_FRAME_HEADER_SIZE;
+  if (length == TELEMETRY_FRAME_V1_SIZE && buffer[0] == 1)
+    size = TELEMETRY_FRAME_V1_SIZE;
+  else if (length > headerSize && (buffer[0] == 2 || buffer[0] == TELEMETRY_FRAME_VERSION) && buffer[8] <= TELEMETRY_MAX_PROBES)
+    size = telemetryFrameSize(buffer[8], headerSize);
+  else
+    return false;
+
+  if (length != size)
+    return false;
+
+  uint16_t crc = buffer[size - 2] | (uint16_t)buffer[size - 1] << 8;
+  if (crc != telemetryCrc16(buffer, size - 2))
+    return false;
+
+  frame.version = buffer[0];
+  frame.flags = buffer[1];
+  frame.temperature = telemetryReadInt16(&buffer[2]);
+  frame.humidity = telemetryReadInt16(&buffer[4]);
+  frame.ph = telemetryReadInt16(&buffer[6]);
+  frame.probeCount = frame.version == 1 ? 0 : buffer[8];
+  frame.seq = frame.version == TELEMETRY_FRAME_VERSION ? (uint16_t)telemetryReadInt16(&buffer[9]) : 0;
+
+  const uint8_t *probe = &buffer[headerSize];
+  for (uint8_t i = 0; i < frame.probeCount; i++, probe += TELEMETRY_PROBE_SIZE)
+  {
+    frame.probeId[i] = (uint16_t)telemetryReadInt16(&probe[0]);
+    frame.probeTemperature[i] = telemetryReadInt16(&probe[2]);
+  }
+  return true;
+}
+
+inline void telemetryWriteUint32(uint8_t *buffer, uint32_t value)
+{
+  telemetryWriteInt16(&buffer[0], (int16_t)(value & 0xFFFF));
+  telemetryWriteInt16(&buffer[2], (int16_t)(value >> 16));
+}
+
+inline uint32_t telemetryReadUint32(const uint8_t *buffer)
+{
+  return (uint16_t)telemetryReadInt16(&buffer[0]) | (uint32_t)(uint16_t)telemetryReadInt16(&buffer[2]) << 16;
+}
+
+// Memulai frame batch di buffer, mengembalikan panjang header; record ditambahkan dengan addTelemetryBatchRecord()
+inline size_t beginTelemetryBatch(uint8_t *buffer, uint16_t seq)
+{
+  buffer[0] = TELEMETRY_BATCH_VERSION;
+  buffer[1] = 0;
+  telemetryWriteInt16(&buffer[2], (int16_t)seq);
+  return TELEMETRY_BATCH_HEADER_SIZE;
+}
+
+// Menambahkan satu frame versi 3 yang sudah di-encode; false jika batch penuh (jumlah record atau
+// ruang untuk CRC di bufferSize)
+inline bool addTelemetryBatchRecord(uint8_t *buffer, size_t bufferSize, size_t &length, uint32_t ageSeconds, const uint8_t *frame,
+                                    size_t frameLength)
+{
+  if (buffer[1] >= TELEMETRY_BATCH_MAX_RECORDS || length + TELEMETRY_BATCH_AGE_SIZE + frameLength + 2 > bufferSize)
+    return false;
+  telemetryWriteUint32(&buffer[length], ageSeconds);
+  memcpy(&buffer[length + TELEMETRY_BATCH_AGE_SIZE], frame, frameLength);
+  length += TELEMETRY_BATCH_AGE_SIZE + frameLength;
+  buffer[1]++;
+  return true;
+}
+
+// Menutup frame batch dengan CRC, mengembalikan panjang total
+inline size_t finishTelemetryBatch(uint8_t *buffer, size_t length)
+{
+  uint16_t crc = telemetryCrc16(buffer, length);
+  buffer[length] = crc & 0xFF;
+  buffer[length + 1] = crc >> 8;
+  return length + 2;
+}
+
+// Panjang record batch yang dimulai di offset (umur + frame versi 3), 0 jika melewati batas payload
+inline size_t telemetryBatchRecordSize(const uint8_t *buffer, size_t payloadEnd, size_t offset)
+{
+  size_t frameStart = offset + TELEMETRY_BATCH_AGE_SIZE;
+  if (frameStart + TELEMETRY_FRAME_HEADER_SIZE > payloadEnd || buffer[frameStart + 8] > TELEMETRY_MAX_PROBES)
+    return 0;
+  size_t size = TELEMETRY_BATCH_AGE_SIZE + telemetryFrameSize(buffer[frameStart + 8]);
+  return offset + size <= payloadEnd ? size : 0;
+}
+
+// Memeriksa versi, CRC dan struktur frame batch; record dibaca dengan decodeTelemetryBatchRecord()
+// mulai dari offset TELEMETRY_BATCH_HEADER_SIZE
+inline bool decodeTelemetryBatch(const uint8_t *buffer, size_t length, uint8_t &count, uint16_t &seq)
+{
+  if (length < TELEMETRY_BATCH_HEADER_SIZE + 2 || buffer[0] != TELEMETRY_BATCH_VERSION || buffer[1] == 0 ||
+      buffer[1] > TELEMETRY_BATCH_MAX_RECORDS)
+    return false;
+  uint16_t crc = buffer[length - 2] | (uint16_t)buffer[length - 1] << 8;
+  if (crc != telemetryCrc16(buffer, length - 2))
+    return false;
+
+  size_t offset = TELEMETRY_BATCH_HEADER_SIZE;
+  for (uint8_t i = 0; i < buffer[1]; i++)
+  {
+    size_t size = telemetryBatchRecordSize(buffer, length - 2, offset);
+    if (size == 0)
+      return false;
+    offset += size;
+  }
+  if (offset != length - 2)
+    return false;
+  count = buffer[1];
+  seq = (uint16_t)telemetryReadInt16(&buffer[2]);
+  return true;
+}
+
+// Membaca satu record batch di offset, mengembalikan offset record berikutnya (0 jika frame di dalamnya rusak)
+inline size_t decodeTelemetryBatchRecord(const uint8_t *buffer, size_t length, size_t offset, uint32_t &ageSeconds, TelemetryFrame &frame)
+{
+  size_t size = telemetryBatchRecordSize(buffer, length - 2, offset);
+  if (size == 0 || !decodeTelemetryFrame(&buffer[offset + TELEMETRY_BATCH_AGE_SIZE], size - TELEMETRY_BATCH_AGE_SIZE, frame))
+    return 0;
+  ageSeconds = telemetryReadUint32(&buffer[offset]);
+  return offset + size;
+}
+
+// CRC-8 (poly 0x07, init 0xFF) frame kompak; msgId ikut dihitung karena membawa byte terbawah nomor urut
+inline uint8_t telemetryCrc8(uint8_t msgId, const uint8_t *data, size_t length)
+{
+  uint8_t crc = 0xFF;
+  for (size_t i = 0; i <= length; i++)
+  {
+    crc ^= i == 0 ? msgId : data[i - 1];
+    for (int bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+// Probe tunggal yang suhunya sudah terwakili oleh suhu frame (rata-rata dari satu probe), atau keduanya tidak valid
+inline bool telemetryProbeImplicit(const TelemetryFrame &frame)
+{
+  if (frame.probeCount != 1)
+    return false;
+  if (frame.flags & TelemetryTemperatureValid)
+    return frame.probeTemperature[0] == frame.temperature;
+  return frame.probeTemperature[0] == TELEMETRY_PROBE_INVALID;
+}
+
+inline size_t telemetryCompactFrameSize(uint8_t probeCount, bool implicitProbe = false)
+{
+  return TELEMETRY_COMPACT_HEADER_SIZE + probeCount * TELEMETRY_PROBE_SIZE - (implicitProbe ? 2 : 0) + 1;
+}
+
+inline size_t telemetryCompactFrameSize(const TelemetryFrame &frame)
+{
+  uint8_t probeCount = frame.probeCount > TELEMETRY_MAX_PROBES ? TELEMETRY_MAX_PROBES : frame.probeCount;
+  return telemetryCompactFrameSize(probeCount, telemetryProbeImplicit(frame));
+}
+
+inline uint32_t telemetryClampField(int32_t value, uint32_t max)
+{
+  return value < 0 ? 0 : (uint32_t)value > max ? max : (uint32_t)value;
+}
+
+// Menulis frame kompak ke buffer untuk dikirim dengan msgId = byte terbawah frame.seq; 0 jika buffer kurang
+inline size_t encodeCompactTelemetryFrame(const TelemetryFrame &frame, uint8_t *buffer, size_t bufferSize)
+{
+  uint8_t probeCount = frame.probeCount > TELEMETRY_MAX_PROBES ? TELEMETRY_MAX_PROBES : frame.probeCount;
+  bool implicitProbe = telemetryProbeImplicit(frame);
+  size_t size = telemetryCompactFrameSize(probeCount, implicitProbe);
+  if (bufferSize < size)
+    return 0;
+
+  buffer[0] = TELEMETRY_COMPACT_TAG | (implicitProbe ? TELEMETRY_COMPACT_SINGLE_PROBE : probeCount);
+  buffer[1] = frame.flags;
+  buffer[2] = frame.seq >> 8;
+  uint64_t values = telemetryClampField(frame.temperature + TELEMETRY_COMPACT_TEMPERATURE_OFFSET, 0x7FFF) |
+                    (uint64_t)telemetryClampField(frame.humidity, 0x3FFF) << 15 | (uint64_t)telemetryClampField(frame.ph, 0x7FF) << 29;
+  for (int i = 0; i < 5; i++)
+    buffer[3 + i] = values >> (8 * i);
+
+  uint8_t *probe = &buffer[TELEMETRY_COMPACT_HEADER_SIZE];
+  for (uint8_t i = 0; i < probeCount; i++, probe += TELEMETRY_PROBE_SIZE)
+  {
+    telemetryWriteInt16(&probe[0], (int16_t)frame.probeId[i]);
+    if (!implicitProbe)
+      telemetryWriteInt16(&probe[2], frame.probeTemperature[i]);
+  }
+
+  buffer[size - 1] = telemetryCrc8((uint8_t)frame.seq, buffer, size - 1);
+  return size;
+}
+
+// Membaca frame kompak dengan msgId dari header paket; gagal jika tag, panjang atau CRC tidak sesuai
+inline bool decodeCompactTelemetryFrame(const uint8_t *buffer, size_t length, uint8_t msgId, TelemetryFrame &frame)
+{
+  if (length == 0 || (buffer[0] & 0xF0) != TELEMETRY_COMPACT_TAG)
+    return false;
+  uint8_t probeCount = buffer[0] & 0x0F;
+  bool implicitProbe = probeCount == TELEMETRY_COMPACT_SINGLE_PROBE;
+  if (implicitProbe)
+    probeCount = 1;
+  else if (probeCount > TELEMETRY_MAX_PROBES)
+    return false;
+
+  size_t size = telemetryCompactFrameSize(probeCount, implicitProbe);
+  if (length != size || buffer[size - 1] != telemetryCrc8(msgId, buffer, size - 1))
+    return false;
+
+  uint64_t values = 0;
+  for (int i = 0; i < 5; i++)
+    values |= (uint64_t)buffer[3 + i] << (8 * i);
+  frame.version = TELEMETRY_COMPACT_VERSION;
+  frame.flags = buffer[1];
+  frame.seq = (uint16_t)buffer[2] << 8 | msgId;
+  frame.temperature = (int16_t)((values & 0x7FFF) - TELEMETRY_COMPACT_TEMPERATURE_OFFSET);
+  frame.humidity = (int16_t)(values >> 15 & 0x3FFF);
+  frame.ph = (int16_t)(values >> 29 & 0x7FF);
+  frame.probeCount = probeCount;
+
+  const uint8_t *probe = &buffer[TELEMETRY_COMPACT_HEADER_SIZE];
+  for (uint8_t i = 0; i < probeCount; i++, probe += TELEMETRY_PROBE_SIZE)
+  {
+    frame.probeId[i] = (uint16_t)telemetryReadInt16(&probe[0]);
+    if (implicitProbe)
+      frame.probeTemperature[i] = frame.flags & TelemetryTemperatureValid ? frame.temperature : TELEMETRY_PROBE_INVALID;
+    else
+      frame.probeTemperature[i] = telemetryReadInt16(&probe[2]);
+  }
+  return true;
+}
@@ -6,6 +6,24 @@
 #include <EEPROM.h>
 #include <DallasTemperature.h>
 #include <LiquidCrystal_I2C.h>
+#include <esp_adc/adc_continuous.h>
+#include <esp_sleep.h>
+#include <esp_partition.h>
+#include <driver/rtc_io.h>
+#include <sys/time.h>
+#include "telemetry_frame.h"
+#include "lora_arq.h"
+#include "lora_airtime.h"
+#include "spsc_ring.h"
+#include "adc_filter.h"
+#include "sensor_scheduler.h"
+#include "report_filter.h"
+#include "power_budget.h"
+#include "flash_log.h"
+#include "lora_schedule.h"
+#include "lora_adr.h"
+#include "lora_packet.h"
+#include "json_arena.h"
 
 String loraData;
 unsigned long lastSendTime = 0;
@@ -15,7 +33,7 @@ int loraRSSI;
 int connectedDevices;
 float humidity;
 int humidityAdc;
-float temperature;
+RTC_DATA_ATTR float temperature; // Referensi laju perubahan suhu (resolusi adaptif) lintas deep sleep
 
 // Definisi Pin
 // Pin LoRA
@@ -28,8 +46,35 @@ const int ds18b20Pin = 4;
 OneWire oneWire(ds18b20Pin);
 DallasTemperature temperatureSensor(&oneWire); // Inisialisasi sensor suhu DS18B20
 
+// Beberapa probe DS18B20 di bus yang sama dikonversi bersamaan (satu requestTemperatures() untuk semua)
+// lalu dibaca per alamat yang di-cache, jadi tambahan probe tidak menambah waktu tunggu konversi.
+// Resolusi adaptif: 12 bit (0.0625 C, 750 ms) saat suhu stabil; saat berubah cepat turun ke 10 bit
+// (0.25 C, 188 ms) dengan periode lebih pendek agar transien tetap terlacak.
+#define MAX_TEMPERATURE_PROBES TELEMETRY_MAX_PROBES // Semua probe dikirim di frame telemetri
+#define TEMPERATURE_RESOLUTION_STABLE 12
+#define TEMPERATURE_RESOLUTION_FAST 10
+#define TEMPERATURE_FAST_PERIOD_MS 500
+#define TEMPERATURE_FAST_DELTA_C 0.5f   // Perubahan antar pembacaan yang dianggap transien
+#define TEMPERATURE_SETTLE_READINGS 4   // Pembacaan stabil berturut-turut sebelum kembali ke 12 bit
+
+struct TemperatureProbes
+{
+  DeviceAddress address[MAX_TEMPERATURE_PROBES];
+  uint16_t id[MAX_TEMPERATURE_PROBES];   // ID probe di frame telemetri: 2 byte serial ROM terbawah
+  float celsius[MAX_TEMPERATURE_PROBES]; // DEVICE_DISCONNECTED_C jika probe gagal dibaca
+  uint8_t count;
+  bool rescan;                           // Ada probe yang hilang, bus di-scan ulang di siklus berikutnya
+  uint8_t resolution;
+  uint8_t stableReadings;
+  bool hasReading;
+};
+
+RTC_DATA_ATTR TemperatureProbes temperatureProbes; // Alamat probe tetap di-cache selama deep sleep, tanpa scan bus setiap bangun
+int temperatureJobIndex = -1;
+
 // Pin sensor humidity
 const int humiditySensorPin = 34;
+const adc_channel_t humidityAdcChannel = ADC_CHANNEL_6; // GPIO34 = ADC1 channel 6
 
 // Pin Push Button
 const int pbKiri = 25;
@@ -47,6 +92,81 @@ const int ledKiri = 26;
 const int DMSpin = 13;
 const int DMSIndicator = 2;
 const int DMSAdcPin = 35;
+const adc_channel_t phAdcChannel = ADC_CHANNEL_7; // GPIO35 = ADC1 channel 7
+
+// Akuisisi ADC continuous (DMA) kelembapan dan pH
+#define ADC_SAMPLE_RATE_HZ 20000              // Laju konversi burst (minimum driver ESP32)
+#define ADC_BURST_SAMPLES 64                  // Sampel per nilai keluaran (faktor desimasi)
+#define ADC_FILTER_MODE AdcFilterTrimmedMean  // Lihat adc_filter.h
+#define ADC_FRAME_BYTES (ADC_BURST_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES) // Ukuran frame DMA = satu burst (kelipatan 4 byte)
+#define ADC_READ_TIMEOUT_MS 100
+#define ADC_TRACE_DUMP 0                      // 1 = kirim sampel mentah ke Serial ("ADC,channel,raw") untuk direkam
+#define DMS_WARMUP_MS 1000                    // DMS dinyalakan sekian lama sebelum burst pH diambil
+
+// Periode job di scheduler sensor (sensor_scheduler.h)
+#define TEMPERATURE_PERIOD_MS 1500            // Request konversi DS18B20, dibaca setelah waktu konversi resolusi aktif
+#define HUMIDITY_PERIOD_MS 2000
+#define PH_PERIOD_MS 2000                     // Termasuk DMS_WARMUP_MS
+#define SENSOR_LOG_PERIOD_MS 1000             // Log nilai sensor ke Serial
+#define SCHEDULER_STATS_PERIOD_MS 30000       // Log jitter dan waktu eksekusi job
+
+// Report-on-change (report_filter.h): sampel diambil setiap updateRate, dikirim hanya jika melewati deadband atau heartbeat
+#define REPORT_ON_CHANGE 1                    // 0 = kirim setiap updateRate seperti sebelumnya
+
+#if REPORT_ON_CHANGE
+const ReportDeadband reportDeadband = {REPORT_DEADBAND_TEMPERATURE, REPORT_DEADBAND_HUMIDITY, REPORT_DEADBAND_PH, REPORT_HEARTBEAT_MS};
+#else
+const ReportDeadband reportDeadband = {0, 0, 0, 0}; // Deadband 0: setiap sampel dianggap berubah
+#endif
+RTC_DATA_ATTR ReportFilter reportFilter; // Referensi deadband bertahan selama deep sleep, begin() hanya saat cold boot
+
+// Jendela dengar respons dihitung dari time-on-air balasan Receiver pada SF/BW/CR aktif (responseWindowMs()),
+// bukan 2 detik tetap: pendek di SF7, dan cukup panjang di SF12 yang balasannya sendiri sudah > 2 detik.
+// Frame berikutnya boleh dikirim walaupun respons frame sebelumnya belum datang (pipelining); respons
+// berupa ACK ARQ (lora_arq.h) yang dicocokkan lewat nomor urut frame. Frame tanpa ACK dikirim ulang.
+#define RESPONSE_MAX_PACKET_SIZE (4 + ARQ_ACK_MAX_SIZE) // Header 4 byte + frame ACK + perintah ADR
+#define RESPONSE_GATEWAY_MS 100               // Proses Receiver sebelum membalas: task RX meng-ACK begitu frame diterima (antrian RX + listen-before-talk)
+#define RESPONSE_RESULT_WINDOW_MS 2000        // Setelah ACK: hasil server menyusul setelah batch uplink (maks 250 ms) + POST, jika berbeda
+#define RESPONSE_GUARD_MS 50                  // Perpindahan TX->RX kedua radio dan jitter loop
+#define RESPONSE_MAX_PENDING 4                // Frame yang boleh menunggu respons bersamaan
+#define LORA_RX_QUEUE_SIZE 4                  // Slot antrian paket dari interrupt DIO0 (pangkat dua)
+#define LBT_THRESHOLD_DBM -100                // RSSI kanal di atas ini: balasan Receiver sedang diterima (listen-before-talk)
+#define LBT_POLL_MS 5                         // Jarak pengecekan RSSI kanal saat menunggu
+
+// MAC slot terjadwal (lora_schedule.h): setelah mendengar beacon Receiver, node yang tercantum hanya mengirim di
+// awal slotnya (sekali per periode, kiriman ulang didahulukan) dan radio hanya RX menjelang beacon atau saat
+// menunggu ACK. Node yang belum tercantum dan batch backlog memakai jendela kontensi di akhir periode; tanpa
+// beacon (Receiver lama atau sinkronisasi hilang) transmitter kembali ALOHA seperti sebelumnya.
+#define SCHEDULE_ENABLED 1
+#define SCHEDULE_WAKE_LEAD_MS 150             // Mode daya rendah: bangun sekian lebih awal dari slot/beacon (jitter boot)
+#define SCHEDULE_LEAD_INITIAL_MS 4000         // Perkiraan boot + sensing sebelum siklus daya rendah pertama terukur
+
+// Adaptive data rate (lora_adr.h): SF dan daya TX mengikuti perintah Receiver yang menumpang di ACK; SF/daya di
+// EEPROM (halaman LCD) hanya titik awal setelah cold boot atau setelah diubah manual. Tanpa ACK terlalu lama,
+// node mencoba usulan SF yang tersimpan, daya maksimum, lalu SF berikutnya sampai terdengar lagi.
+#define ADR_ENABLED 1
+
+// Store-and-forward (flash_log.h): frame yang tidak mendapat ACK (kiriman ulang habis atau tergeser dari slot
+// tunggu) disimpan di log cincin pada partisi data mentah, lalu dikirim ulang dalam frame batch (beberapa
+// pembacaan beserta umurnya per paket) begitu ACK berikutnya menandakan link LoRa sudah pulih.
+#define BACKLOG_ENABLED 1
+#define BACKLOG_SECTORS 16                      // 16 x 4 KB partisi spiffs: 945 pembacaan pasti tertampung
+#define BACKLOG_DRAIN_ORDER FlashLogOldestFirst // FlashLogNewestFirst: kondisi terbaru sampai lebih dulu
+#define BACKLOG_DRAIN_INTERVAL_MS 1000          // Jarak antar batch saat drain, kanal tetap longgar untuk frame baru
+#define BACKLOG_RATE_WINDOW_MS 60000            // Laju drain di LCD: pembacaan backlog yang di-ACK per menit
+
+// Mode daya rendah: setelah cold boot atau tombol tengah, mode interaktif (LCD, menu, task FreeRTOS) berjalan
+// sampai LOW_POWER_AWAKE_MS tanpa tombol ditekan, lalu deep sleep. Timer RTC membangunkan transmitter setiap
+// updateRate untuk satu siklus singkat tanpa LCD/task: sampel sensor, kirim jika perlu, tidur lagi.
+#define LOW_POWER_MODE 0                      // 1 = deep sleep di antara pengiriman
+#define LOW_POWER_AWAKE_MS 60000
+#define LOW_POWER_MIN_SLEEP_MS 1000           // Tidur minimal walaupun siklus bangun lebih lama dari updateRate
+#define LOW_POWER_REPORT_WAKEUPS 10           // Tabel anggaran daya per fase dicetak setiap sekian kali bangun
+
+RTC_DATA_ATTR PowerBudget powerBudget;        // Akumulasi waktu/muatan per fase (power_budget.h)
+RTC_DATA_ATTR uint32_t lastSleepMs;           // Lama deep sleep terakhir, dicatat saat bangun
+unsigned long cycleStartMs;                   // Siklus daya rendah dimulai langsung setelah bangun beacon (millis()), 0 = setelah boot
+unsigned long lastInteractionMs;              // Tombol terakhir ditekan (mode interaktif)
 
 int phADC;
 float lastPHRead;
@@ -67,6 +187,12 @@ byte pauseChar[] = {
     B00000,
     B00000};
 
+// Alamat LoRa: Receiver (gateway) tetap di RECEIVER_ADDRESS, setiap transmitter di lapangan butuh alamat unik
+// karena Receiver menyimpan status dan jendela ARQ per alamat pengirim. Alamat node disimpan di EEPROM dan bisa
+// diubah dari LCD (halaman Alamat Node); EEPROM kosong atau isi tidak valid memakai NODE_ADDRESS_DEFAULT.
+#define RECEIVER_ADDRESS 0x02
+#define NODE_ADDRESS_DEFAULT 0x01
+
 // Definisi Lora Parameter
 struct LoraParameter
 {
@@ -78,18 +204,117 @@ struct LoraParameter
 
 LoraParameter loraParameter;
 
+// Paket LoRa mentah yang disalin dari FIFO radio oleh interrupt DIO0, diproses di loop()
+struct LoraPacket
+{
+  uint8_t data[255];
+  uint8_t length;
+  int16_t rssi;
+  unsigned long receivedAtMs; // millis() saat interrupt (akhir paket), untuk awal periode beacon TDMA
+};
+
+SpscRing<LoraPacket, LORA_RX_QUEUE_SIZE> loraRxQueue;
+
+// Respons JSON Receiver lama ({"classification":..,"buzzer_on":..}) di-parse di arena statis, bukan heap
+#define RESPONSE_JSON_ARENA_SIZE JSON_ARENA_SIZE(1, 256)
+JsonArena<RESPONSE_JSON_ARENA_SIZE> responseJsonArena;
+TaskHandle_t loopTaskHandle; // Dibangunkan interrupt saat paket masuk
+
+// Frame yang sudah dikirim dan masih menunggu ACK Receiver, atau menunggu giliran kirim ulang
+struct PendingResponse
+{
+  bool active;
+  bool batch;                // Frame batch backlog (isi di backlogBatch), bukan pembacaan baru
+  uint8_t attempts;          // Kiriman ulang yang sudah dilakukan
+  uint8_t maxRetries;        // ARQ_MAX_RETRIES, 0 di slot TDMA mode daya rendah (slot berikutnya baru satu periode lagi)
+  bool retryPending;         // Jendela dengar habis tanpa ACK, kirim ulang pada retryAtMs
+  TelemetryFrame frame;      // Berisi nomor urut ARQ; dikonfirmasi ke report filter saat ACK datang
+  uint32_t capturedMs;       // rtcMillis() saat sampel diambil, disimpan ke backlog jika frame tidak di-ACK
+  unsigned long firstSentMs; // Kiriman pertama, untuk latensi ACK
+  unsigned long sentMs;      // Akhir TX terakhir
+  unsigned long deadlineMs;  // Akhir jendela dengar kiriman terakhir
+  unsigned long retryAtMs;
+};
+
+struct ArqStats
+{
+  unsigned long frames;        // Frame baru yang dikirim
+  unsigned long retransmits;   // Kiriman ulang
+  unsigned long acked;         // Frame yang tercakup ACK
+  unsigned long dropped;       // Frame tanpa ACK: kiriman ulang habis atau slot tunggu penuh (masuk backlog jika aktif)
+  unsigned long duplicateAcks; // ACK yang menandai frame sudah pernah diterima (ACK sebelumnya hilang)
+};
+
+PendingResponse pendingResponses[RESPONSE_MAX_PENDING];
+bool radioListening; // Radio dalam mode RX karena ada frame yang menunggu respons atau menjelang beacon TDMA
+ArqStats arqStats;
+RTC_DATA_ATTR uint16_t arqSeq;      // Nomor urut frame berikutnya, acak saat cold boot (lihat ArqWindow)
+RTC_DATA_ATTR ArqCongestion arqCongestion; // Jendela dengar terakhir yang tidak dijawab: backoff kiriman ulang saat kanal jenuh
+unsigned long resultListenUntilMs;  // Radio tetap RX menunggu pesan hasil server sampai saat ini (mode interaktif)
+bool resultListening;
+uint16_t confirmedSeq;              // Frame terbaru yang sudah dikonfirmasi ke report filter
+bool hasConfirmedSeq;
+bool linkUp = true;                 // ACK terakhir diterima (false setelah frame hilang): backlog hanya dikirim saat link hidup
+
+RTC_DATA_ATTR ScheduleSync scheduleSync;      // Slot node ini menurut beacon terakhir, jam rtcMillis() (tetap berjalan saat deep sleep)
+RTC_DATA_ATTR uint8_t contentionFailures;     // Kiriman tanpa slot yang tidak di-ACK berturut-turut (backoff antar jendela kontensi)
+RTC_DATA_ATTR bool scheduleJoinWaited;        // Sudah menahan ALOHA menunggu beacon setelah ACK (Receiver tanpa beacon: sekali saja)
+RTC_DATA_ATTR uint32_t scheduleJoinUntilMs;
+RTC_DATA_ATTR uint32_t usedSlotStartMs;       // Slot yang sudah dipakai, satu kiriman per slot
+RTC_DATA_ATTR bool scheduleBeaconWake;        // Mode daya rendah: bangun berikutnya hanya untuk mendengar beacon
+RTC_DATA_ATTR uint32_t scheduleLeadMs;        // Mode daya rendah: bangun sampai siap kirim (boot + sensing), terukur
+RTC_DATA_ATTR uint32_t lastSampleRtcMs;       // Mode daya rendah: sampel terakhir, jarak ke sampel berikutnya setelah bangun beacon
+bool contentionPlanned;                       // Waktu kirim di jendela kontensi sudah dipilih
+uint32_t contentionTxAtMs;
+
+RTC_DATA_ATTR AdrLink adrLink; // SF/daya radio menurut perintah ADR terakhir, clear() saat cold boot
+
+// Partisi data mentah sebagai Storage flash_log.h
+struct PartitionStorage
+{
+  const esp_partition_t *partition;
+
+  bool read(uint32_t offset, void *data, size_t size) { return esp_partition_read(partition, offset, data, size) == ESP_OK; }
+  bool write(uint32_t offset, const void *data, size_t size) { return esp_partition_write(partition, offset, data, size) == ESP_OK; }
+  bool eraseSector(uint32_t offset) { return esp_partition_erase_range(partition, offset, FLASH_LOG_SECTOR_SIZE) == ESP_OK; }
+};
+
+// Record backlog yang sedang dikirim dalam satu frame batch; di-consume dari flash setelah batch di-ACK
+struct BacklogBatch
+{
+  FlashLogRecord records[TELEMETRY_BATCH_MAX_RECORDS];
+  uint8_t count;
+};
+
+PartitionStorage backlogStorage;
+FlashLog<PartitionStorage> backlog;
+bool backlogFailed;                       // Partisi tidak ada atau gagal dipulihkan, backlog nonaktif sampai restart
+BacklogBatch backlogBatch;
+RTC_DATA_ATTR uint16_t backlogClockBoot;  // Nomor boot log saat cold boot: record sejak itu memakai jam rtcMillis() yang sama
+RTC_DATA_ATTR bool backlogClockValid;
+RTC_DATA_ATTR bool backlogPending;        // Log berisi pembacaan yang belum terkirim (mode daya rendah tanpa membaca flash)
+unsigned long lastDrainMs;
+unsigned long drainRateStartMs;           // Awal jendela laju drain
+uint32_t drainRateStartConsumed;
+uint32_t backlogDrainPerMinute;           // Ditampilkan di LCD
+
 // Definisi fungsi
 void onLoraReceiveCallback(int packetSize);
-void sendLoraMessage(String message);
+bool processLoraResponse(const LoraPacket &packet, ArqAck &ack, bool &legacy);
+void sendLoraMessage(const uint8_t *payload, size_t length, uint8_t msgId);
 void centerText(const char *text, int row);
+bool backlogBegin();
+bool storeBacklog(const PendingResponse &pending);
+void consumeBacklogBatch();
+uint32_t loraAirtimeMs(size_t length);
+bool processScheduleBeacon(const LoraPacket &packet);
+bool scheduleTxAllowed(size_t frameLength, bool &slot);
+unsigned long sampleIntervalMs();
 
 // definisi rtos
-TaskHandle_t taskUpdateSensorHandler;
+TaskHandle_t taskSensorSchedulerHandler;
 TaskHandle_t taskParameterUpdateHandler;
 TaskHandle_t tasklcdUpdateHandler;
-TaskHandle_t taskUpdateHumidityHandler;
-TaskHandle_t taskUpdatePhSensor;
-TaskHandle_t taskUpdate;
 
 SemaphoreHandle_t loraSendSemaphore;
 SemaphoreHandle_t lcdUpdateSemaphore;
@@ -97,10 +322,8 @@ SemaphoreHandle_t lcdUpdateSemaphore;
 // definisi fungsi rtos
 void updateParameterTask(void *pvParameter);
 void updateLcdTask(void *pvParameter);
-void updateSensorTask(void *pvParameter);
-void readHumiditySensor(void *pvParameter);
-void readPhSensor(void *pvParameter);
-void update(void *pvParameter);
+void sensorSchedulerTask(void *pvParameter);
+uint8_t scanTemperatureProbes();
 
 // data dari server
 struct ServerResponse
@@ -109,9 +332,9 @@ struct ServerResponse
   bool buzzerOn;
 };
 
-ServerResponse serverResponse;
+RTC_DATA_ATTR ServerResponse serverResponse; // Status terakhir tetap tampil setelah bangun oleh tombol
 
-bool buzzerLastState = false;
+RTC_DATA_ATTR bool buzzerLastState = false;
 unsigned long activateBuzzerUntil = 0;
 const unsigned long buzzerActiveTime = 3000;
 
@@ -134,10 +357,12 @@ enum LcdScreen
   LoraTxPower,
   LoraSpreadingFactor,
   LoraDenominator,
-  LoraSignalBandwith
+  LoraSignalBandwith,
+  LoraBacklog,
+  NodeAddress
 };
 
-#define LcdScreenPage 8
+#define LcdScreenPage 10
 
 enum PushButtonAction
 {
@@ -164,24 +389,39 @@ LoraSettingParameter loraSettingParameter;
 const float loraBandwidth[] = {7.8E3, 10.4E3, 15.6E3, 20.8E3, 31.25E3, 41.7E3, 62.5E3, 125E3, 250E3, 500E3};
 int bandwidthSelector = 0;
 
-int addresses[5] = {};
+int addresses[6] = {};
+int nodeAddress; // Alamat node yang sedang diedit di LCD, diterapkan saat disimpan
 
 #define EEPROM_SIZE 512
 #define ESP_BOOT_DELAY 1500
 
-void setup()
+// 0x00 dan 0xFF (broadcast) dicadangkan, alamat Receiver tidak boleh dipakai node
+bool isValidNodeAddress(int address)
 {
-  Serial.begin(115200);
+  return address > 0x00 && address < 0xFF && address != RECEIVER_ADDRESS;
+}
 
-  // Setting DMS Sensor PH
-  analogReadResolution(10);
-  pinMode(DMSpin, OUTPUT);
-  pinMode(DMSIndicator, OUTPUT);
-  digitalWrite(DMSpin, HIGH);
+// Alamat node berikutnya/sebelumnya untuk tombol LCD, melewati alamat Receiver
+int stepNodeAddress(int address, int step)
+{
+  int next = address + step;
+  if (next == RECEIVER_ADDRESS)
+    next += step;
+  return isValidNodeAddress(next) ? next : address;
+}
 
-  while (!Serial)
-    ;
+// Jam dinding dari RTC: tetap berjalan selama deep sleep (millis() mulai dari 0 setiap bangun),
+// dipakai untuk jadwal heartbeat report filter
+uint32_t rtcMillis()
+{
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return (uint32_t)now.tv_sec * 1000UL + now.tv_usec / 1000;
+}
 
+// Membaca updateRate dan parameter LoRa dari EEPROM
+void loadSettings()
+{
   EEPROM.begin(EEPROM_SIZE);
 
   int addr = 0;
@@ -199,6 +439,9 @@ void setup()
   addr += sizeof(loraSettingParameter.codeDenominator);
 
   addresses[4] = addr;
+  addr += sizeof(loraSettingParameter.signalBandwidth);
+
+  addresses[5] = addr;
 
   // Debugging: Print stored addresses
   Serial.println("EEPROM Address Mapping:");
@@ -212,6 +455,8 @@ void setup()
   Serial.println(addresses[3]);
   Serial.print("signalBandwith: ");
   Serial.println(addresses[4]);
+  Serial.print("nodeAddress: ");
+  Serial.println(addresses[5]);
 
   // Load saved values from EEPROM
   EEPROM.get(addresses[0], updateRate);
@@ -219,6 +464,9 @@ void setup()
   EEPROM.get(addresses[2], loraSettingParameter.spreadingFactor);
   EEPROM.get(addresses[3], loraSettingParameter.codeDenominator);
   EEPROM.get(addresses[4], loraSettingParameter.signalBandwidth);
+  nodeAddress = EEPROM.read(addresses[5]);
+  if (!isValidNodeAddress(nodeAddress))
+    nodeAddress = NODE_ADDRESS_DEFAULT;
 
   Serial.println("\nLoaded EEPROM Values:");
   Serial.print("updateRate: ");
@@ -231,8 +479,95 @@ void setup()
   Serial.println(loraSettingParameter.codeDenominator);
   Serial.print("signalBandwith: ");
   Serial.println(loraSettingParameter.signalBandwidth);
+  Serial.printf("nodeAddress: 0x%02X\n", nodeAddress);
+
+#if ADR_ENABLED
+  // SF dan daya yang dipilih ADR menggantikan nilai EEPROM selama link masih berjalan (termasuk lintas deep sleep)
+  if (!adrLink.loaded())
+    adrLink.begin(constrain(loraSettingParameter.spreadingFactor, ADR_SF_MIN, ADR_SF_MAX),
+                  constrain(loraSettingParameter.txPower, ADR_POWER_MIN_DBM, ADR_POWER_MAX_DBM));
+  adrLink.service(rtcMillis()); // Jadwal ganti SF yang lewat selama deep sleep
+  loraSettingParameter.spreadingFactor = adrLink.spreadingFactor;
+  loraSettingParameter.txPower = adrLink.txPower;
+  Serial.printf("ADR: SF%u, %d dBm\n", adrLink.spreadingFactor, adrLink.txPower);
+#endif
+}
+
+void configureLora()
+{
+  LoRa.setPins(ss, rst, dio0); // setup LoRa transceiver module
+
+  // Konfigurasi Address Lokal dan Destinasi
+  loraParameter.loraLocalAddress = nodeAddress;
+  loraParameter.loraDestination = RECEIVER_ADDRESS;
+}
+
+// Parameter modulasi diterapkan setelah LoRa.begin(): begin() me-reset modul sehingga pengaturan sebelumnya hilang.
+// EEPROM kosong memakai default library, sama seperti Receiver
+void applyLoraSettings()
+{
+  if (loraSettingParameter.txPower > 0)
+    LoRa.setTxPower(loraSettingParameter.txPower);
+  if (loraSettingParameter.spreadingFactor > 0)
+    LoRa.setSpreadingFactor(loraSettingParameter.spreadingFactor);
+  if (loraSettingParameter.codeDenominator > 0)
+    LoRa.setCodingRate4(loraSettingParameter.codeDenominator);
+  if (loraSettingParameter.signalBandwidth > 0)
+    LoRa.setSignalBandwidth(loraSettingParameter.signalBandwidth);
+  LoRa.enableCrc(); // CRC payload di radio: frame telemetri kompak hanya membawa CRC-8
+}
+
+void lowPowerCycle();
+void scheduleBeaconCycle();
+uint32_t scheduleSleepMs(uint32_t sleepMs, uint32_t minSleepMs);
+bool scheduleWaitSlot(size_t frameLength);
+void scheduleJoinListen();
+
+void setup()
+{
+  Serial.begin(115200);
+
+  // Setting DMS Sensor PH (ADC dikonfigurasi oleh sensorSchedulerTask)
+  pinMode(DMSpin, OUTPUT);
+  pinMode(DMSIndicator, OUTPUT);
+  digitalWrite(DMSpin, HIGH);
+
+  while (!Serial)
+    ;
+
+  loopTaskHandle = xTaskGetCurrentTaskHandle(); // setup() dan loop() berjalan di task yang sama
+
+  esp_sleep_wakeup_cause_t wakeupCause = esp_sleep_get_wakeup_cause();
+  if (wakeupCause == ESP_SLEEP_WAKEUP_UNDEFINED) // Cold boot: state di memori RTC belum ada
+  {
+    reportFilter.begin(reportDeadband);
+    arqSeq = (uint16_t)esp_random(); // Receiver mengenali restart dari nomor urut yang melompat jauh
+    arqCongestion.reset();
+    scheduleSync.reset();
+    contentionFailures = 0;
+    scheduleJoinWaited = false;
+    scheduleBeaconWake = false;
+    scheduleLeadMs = SCHEDULE_LEAD_INITIAL_MS;
+    lastSampleRtcMs = rtcMillis();
+    adrLink.clear();
+  }
+#if LOW_POWER_MODE
+  if (wakeupCause == ESP_SLEEP_WAKEUP_TIMER)
+  {
+#if SCHEDULE_ENABLED
+    if (scheduleBeaconWake)
+      scheduleBeaconCycle(); // Tidak kembali, diakhiri deep sleep
+#endif
+    lowPowerCycle(); // Tidak kembali, diakhiri deep sleep
+  }
+  lastInteractionMs = millis(); // Cold boot atau tombol tengah: mode interaktif
+#endif
+
+  loadSettings();
 
   temperatureSensor.begin();
+  temperatureSensor.setWaitForConversion(false); // Menunggu konversi dijadwalkan scheduler, bukan memblokir
+  scanTemperatureProbes();
 
   Lcd.init();      // Inisialisasi LCD
   Lcd.backlight(); // Menyalakan Backlight LCD
@@ -248,11 +583,7 @@ void setup()
 
   Serial.println("LoRa Sender");
 
-  LoRa.setPins(ss, rst, dio0); // setup LoRa transceiver module
-  LoRa.setTxPower(loraSettingParameter.txPower);
-  LoRa.setSpreadingFactor(loraSettingParameter.spreadingFactor);
-  LoRa.setCodingRate4(loraSettingParameter.codeDenominator);
-  LoRa.setSignalBandwidth(loraSettingParameter.signalBandwidth);
+  configureLora();
 
   Lcd.clear();
   centerText("LoRA", 0);
@@ -265,18 +596,19 @@ void setup()
     Serial.println(".");
     delay(500);
   }
+  applyLoraSettings();
+
+  LoRa.onReceive(onLoraReceiveCallback); // Respons diterima lewat interrupt DIO0 selama radio dalam mode RX
 
   Lcd.clear();
   centerText("LoRA", 0);
   centerText("Terinisialisasi", 1);
   delay(ESP_BOOT_DELAY);
 
-  // Konfigurasi Address Lokal dan Destinasi
-  loraParameter.loraLocalAddress = 0x01;
-  loraParameter.loraDestination = 0x02;
-
   Serial.println("LoRa Initializing OK!");
 
+  backlogBegin(); // Sisa backlog dari sebelum restart dikirim begitu ACK pertama datang
+
   // Konfigurasi Pin
   pinMode(pbKiri, INPUT_PULLUP);
   pinMode(pbTengah, INPUT_PULLUP);
@@ -284,7 +616,6 @@ void setup()
   pinMode(ledKanan, OUTPUT);
   pinMode(ledKiri, OUTPUT);
   pinMode(buzzerPin, OUTPUT);
-  pinMode(humiditySensorPin, INPUT);
 
   // Ketika memulai perangkat bunyikan buzzer sekali
   //  digitalWrite(buzzerPin, HIGH);
@@ -310,20 +641,12 @@ void setup()
       &taskParameterUpdateHandler);
 
   xTaskCreate(
-      update,
-      "Update Task",
-      2048,
-      NULL,
-      1,
-      &taskUpdate);
-
-  xTaskCreate(
-      updateSensorTask,
-      "Sensor Update",
-      2048,
+      sensorSchedulerTask,
+      "Sensor Scheduler",
+      3072,
       NULL,
       1,
-      &taskUpdateSensorHandler);
+      &taskSensorSchedulerHandler);
 
   xTaskCreate(
       updateLcdTask,
@@ -332,109 +655,271 @@ void setup()
       NULL,
       1,
       &tasklcdUpdateHandler);
+}
 
-  xTaskCreate(
-      readHumiditySensor,
-      "Read Humidity Task",
-      2048,
-      NULL,
-      1,
-      &taskUpdateHumidityHandler);
+adc_continuous_handle_t adcHandle;
 
-  xTaskCreate(
-      readPhSensor,
-      "Read PH Sensor Task",
-      2048,
-      NULL,
-      1,
-      &taskUpdatePhSensor);
+void adcContinuousBegin()
+{
+  adc_continuous_handle_cfg_t handleConfig = {};
+  handleConfig.max_store_buf_size = ADC_FRAME_BYTES * 4;
+  handleConfig.conv_frame_size = ADC_FRAME_BYTES;
+  ESP_ERROR_CHECK(adc_continuous_new_handle(&handleConfig, &adcHandle));
 }
 
-void update(void *pv)
+// Satu burst ADC continuous (DMA) pada satu channel: pola channel dikonfigurasi, ADC berjalan
+// sampai burst penuh lalu dihentikan. Mengembalikan nilai hasil filter dalam skala 10 bit kalibrasi.
+bool adcCaptureBurst(adc_channel_t channel, float &adc10)
 {
-  while (1)
+  static uint8_t frame[ADC_FRAME_BYTES];
+  static AdcBurst<ADC_BURST_SAMPLES> burst;
+
+  adc_digi_pattern_config_t pattern = {};
+  pattern.atten = ADC_ATTEN_DB_12; // Rentang penuh ~0..3.1 V
+  pattern.channel = channel;
+  pattern.unit = ADC_UNIT_1;
+  pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+  adc_continuous_config_t config = {};
+  config.pattern_num = 1;
+  config.adc_pattern = &pattern;
+  config.sample_freq_hz = ADC_SAMPLE_RATE_HZ;
+  config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+  config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+  if (adc_continuous_config(adcHandle, &config) != ESP_OK)
+    return false;
+
+  burst.reset();
+  adc_continuous_start(adcHandle);
+  while (!burst.full())
   {
-    float hMinMax = map(humidityAdc, 930, 214, 3, 40);
-    Serial.printf("hAdc: %d hum: %2.2f htest: %2.2f phAdc: %d ph: %2.2f\n", humidityAdc, humidity, hMinMax, phADC, PH);
-    vTaskDelay(1000);
+    uint32_t length = 0;
+    if (adc_continuous_read(adcHandle, frame, sizeof(frame), &length, ADC_READ_TIMEOUT_MS) != ESP_OK)
+    {
+      Serial.println("ADC continuous read timeout");
+      break;
+    }
+
+    const adc_digi_output_data_t *samples = (const adc_digi_output_data_t *)frame;
+    for (uint32_t i = 0; i < length / SOC_ADC_DIGI_RESULT_BYTES; i++)
+    {
+      if (samples[i].type1.channel != channel)
+        continue;
+      burst.push(samples[i].type1.data);
+#if ADC_TRACE_DUMP
+      Serial.printf("ADC,%u,%u\n", (unsigned)channel, (unsigned)samples[i].type1.data);
+#endif
+    }
   }
+  adc_continuous_stop(adcHandle);
+  adc_continuous_flush_pool(adcHandle); // Buang sisa konversi agar burst berikutnya dimulai dari data baru
+
+  if (burst.count == 0)
+    return false;
+  adc10 = burst.filtered(ADC_FILTER_MODE) / 4.0f; // Sampel 12 bit diturunkan ke skala 10 bit kalibrasi
+  return true;
 }
 
-void readPhSensor(void *pvParameter)
+// Kalibrasi kelembapan dan pH memakai skala ADC 10 bit (nilai oversampling boleh berpecahan)
+void updateHumidity(float adc)
 {
-  while (1)
+  humidityAdc = lroundf(adc);
+  adc = (adc <= 100) ? 100 : adc;
+  humidity = -0.0998 * adc + 101.68;
+  humidity = min(max(humidity, 0.0f), 100.0f);
+}
+
+void updatePh(float adc)
+{
+  phADC = lroundf(adc);
+  //  -0.0255x + 12.89
+  PH = (-0.0255 * adc) + 12.89;
+
+  if (PH < 0.0f || PH > 14.0)
   {
-    // Membaca data ph
-    digitalWrite(DMSpin, LOW);        // aktifkan DMS
-    digitalWrite(DMSIndicator, HIGH); // led indikator built-in ESP32 menyala
-    vTaskDelay(pdMS_TO_TICKS(1000));  // wait DMS capture data
+    PH = lastPHRead;
+  }
+  else if (PH != lastPHRead)
+  {
+    lastPHRead = PH;
+  }
+}
 
-    phADC = analogRead(DMSAdcPin);
-    //  -0.0255x + 12.89 
-    PH = (-0.0255 * phADC) + 12.89 ;
+// --- Job scheduler sensor ---
+// Tiap job hanya mengerjakan satu langkah singkat lalu kembali; menunggu (konversi DS18B20,
+// warm-up DMS) dijadwalkan sebagai jeda ke langkah berikutnya sehingga tidak memblokir job lain.
+SensorScheduler sensorScheduler(micros);
 
-    if (PH < 0.0f || PH > 14.0)
+// Mencari probe DS18B20 di bus dan menyimpan alamatnya, mengembalikan jumlah probe
+uint8_t scanTemperatureProbes()
+{
+  TemperatureProbes &probes = temperatureProbes;
+  uint8_t found = temperatureSensor.getDeviceCount();
+  probes.count = 0;
+  probes.rescan = false;
+  for (uint8_t i = 0; i < found && probes.count < MAX_TEMPERATURE_PROBES; i++)
+  {
+    DeviceAddress address;
+    if (!temperatureSensor.getAddress(address, i))
+      continue;
+
+    // Urutkan berdasarkan ID agar urutan probe di frame tetap sama walaupun urutan pencarian bus berubah
+    uint16_t id = address[1] | (uint16_t)address[2] << 8;
+    uint8_t position = probes.count++;
+    while (position > 0 && probes.id[position - 1] > id)
     {
-      PH = lastPHRead;
+      memcpy(probes.address[position], probes.address[position - 1], sizeof(DeviceAddress));
+      probes.id[position] = probes.id[position - 1];
+      position--;
     }
-    else if (PH != lastPHRead)
+    memcpy(probes.address[position], address, sizeof(DeviceAddress));
+    probes.id[position] = id;
+    probes.celsius[position] = DEVICE_DISCONNECTED_C;
+  }
+
+  probes.resolution = TEMPERATURE_RESOLUTION_STABLE;
+  probes.stableReadings = 0;
+  temperatureSensor.setResolution(probes.resolution);
+  if (temperatureJobIndex >= 0)
+    sensorScheduler.setPeriod(temperatureJobIndex, TEMPERATURE_PERIOD_MS);
+
+  Serial.printf("[Suhu] %u probe DS18B20 ditemukan\n", probes.count);
+  return probes.count;
+}
+
+// Pindah resolusi dan periode job suhu sesuai laju perubahan suhu
+void adaptTemperatureResolution(float delta)
+{
+  TemperatureProbes &probes = temperatureProbes;
+  uint8_t resolution = probes.resolution;
+  if (fabsf(delta) >= TEMPERATURE_FAST_DELTA_C)
+  {
+    probes.stableReadings = 0;
+    resolution = TEMPERATURE_RESOLUTION_FAST;
+  }
+  else if (++probes.stableReadings >= TEMPERATURE_SETTLE_READINGS)
+  {
+    resolution = TEMPERATURE_RESOLUTION_STABLE;
+  }
+
+  if (resolution == probes.resolution)
+    return;
+  probes.resolution = resolution;
+  temperatureSensor.setResolution(resolution); // Berlaku untuk semua probe di bus
+  sensorScheduler.setPeriod(temperatureJobIndex, resolution == TEMPERATURE_RESOLUTION_FAST ? TEMPERATURE_FAST_PERIOD_MS : TEMPERATURE_PERIOD_MS);
+  Serial.printf("[Suhu] resolusi %u bit (delta %.2f C)\n", resolution, delta);
+}
+
+uint32_t temperatureJob(uint8_t &phase)
+{
+  TemperatureProbes &probes = temperatureProbes;
+  if (phase == 0)
+  {
+    if ((probes.count == 0 || probes.rescan) && scanTemperatureProbes() == 0)
     {
-      lastPHRead = PH;
+      temperature = DEVICE_DISCONNECTED_C;
+      return SENSOR_JOB_CYCLE_DONE; // Coba scan lagi di siklus berikutnya
     }
+    temperatureSensor.requestTemperatures(); // Satu konversi untuk semua probe di bus
+    phase = 1;
+    return temperatureSensor.millisToWaitForConversion(probes.resolution);
+  }
 
-    digitalWrite(DMSpin, HIGH);
-    digitalWrite(DMSIndicator, LOW);
-    vTaskDelay(pdMS_TO_TICKS(1000));
+  // Baca tiap probe langsung per alamat (tanpa pencarian ulang bus seperti getTempCByIndex)
+  float sum = 0;
+  uint8_t valid = 0;
+  for (uint8_t i = 0; i < probes.count; i++)
+  {
+    probes.celsius[i] = temperatureSensor.getTempC(probes.address[i]);
+    if (probes.celsius[i] != DEVICE_DISCONNECTED_C)
+    {
+      sum += probes.celsius[i];
+      valid++;
+    }
   }
+
+  probes.rescan = valid < probes.count; // Probe yang hilang tetap dikirim sebagai tidak valid sampai scan ulang
+  if (valid == 0)
+  {
+    temperature = DEVICE_DISCONNECTED_C;
+    return SENSOR_JOB_CYCLE_DONE;
+  }
+
+  float mean = sum / valid;
+  if (probes.hasReading && temperature != DEVICE_DISCONNECTED_C) // Setelah siklus tanpa probe valid tidak ada selisih yang bermakna
+    adaptTemperatureResolution(mean - temperature);
+  temperature = mean;
+  probes.hasReading = true;
+  return SENSOR_JOB_CYCLE_DONE;
 }
 
-void readHumiditySensor(void *pvParameter)
+uint32_t humidityJob(uint8_t & /*phase*/)
 {
-  while (1)
+  float adc;
+  if (adcCaptureBurst(humidityAdcChannel, adc))
+    updateHumidity(adc);
+  return SENSOR_JOB_CYCLE_DONE;
+}
+
+uint32_t phJob(uint8_t &phase)
+{
+  if (phase == 0)
   {
-    // Membaca data kelembapan
-    // humidity = map(analogRead(humiditySensorPin), 1023, 0, 0, 100);
-    humidityAdc = analogRead(humiditySensorPin);
-
-    // unsigned int dist = abs(humidityAdc - 1023);
-
-    // if (dist < 5)
-    // {
-    //   humidity = 0.0f;
-    // }
-    // else
-    // {
-    humidityAdc = (humidityAdc <= 100) ? 100 : humidityAdc;
-    humidity = -0.0998 * (humidityAdc) + 101.68;
-    humidity = min(max(humidity, 0.0f), 100.0f);
-
-    //   // Data > 50%
-    //   if (humidityAdc <= 300)
-    //   {
-    //     humidity = map(humidityAdc, 300, 250, 50, 90);
-    //     if (humidity >= 100)
-    //     {
-    //       humidity = 100;
-    //     }
-    //   }
-    // }
-
-    vTaskDelay(pdMS_TO_TICKS(2000));
+    digitalWrite(DMSpin, LOW);        // aktifkan DMS
+    digitalWrite(DMSIndicator, HIGH); // led indikator built-in ESP32 menyala
+    phase = 1;
+    return DMS_WARMUP_MS; // wait DMS capture data
   }
+
+  float adc;
+  if (adcCaptureBurst(phAdcChannel, adc))
+    updatePh(adc);
+  digitalWrite(DMSpin, HIGH);
+  digitalWrite(DMSIndicator, LOW);
+  return SENSOR_JOB_CYCLE_DONE;
 }
 
-// fungsi untuk update sensor
-void updateSensorTask(void *pvParameter)
+uint32_t sensorLogJob(uint8_t & /*phase*/)
 {
-  while (1)
+  float hMinMax = map(humidityAdc, 930, 214, 3, 40);
+  Serial.printf("hAdc: %d hum: %2.2f htest: %2.2f phAdc: %d ph: %2.2f suhu: %2.2f (%u probe)\n", humidityAdc, humidity, hMinMax, phADC, PH,
+                temperature, temperatureProbes.count);
+  return SENSOR_JOB_CYCLE_DONE;
+}
+
+uint32_t schedulerStatsJob(uint8_t & /*phase*/)
+{
+  for (uint8_t i = 0; i < sensorScheduler.size(); i++)
   {
-    // meminta data suhu dari sensor DS18B20
-    temperatureSensor.requestTemperatures();
+    const SensorJob &job = sensorScheduler.job(i);
+    if (job.stats.steps == 0)
+      continue;
+    Serial.printf("[Scheduler] %-6s siklus %lu, overrun %lu, jitter avg %lu us max %lu us, eksekusi avg %lu us max %lu us\n",
+                  job.name, (unsigned long)job.stats.cycles, (unsigned long)job.stats.overruns,
+                  (unsigned long)(job.stats.jitterTotalUs / job.stats.steps), (unsigned long)job.stats.jitterMaxUs,
+                  (unsigned long)(job.stats.runTotalUs / job.stats.steps), (unsigned long)job.stats.runMaxUs);
+  }
+  sensorScheduler.resetStats();
+  return SENSOR_JOB_CYCLE_DONE;
+}
 
-    // membaca data suhu
-    temperature = temperatureSensor.getTempCByIndex(0);
+// Satu task untuk semua sensor: tidur sampai deadline job terdekat, jalankan job yang jatuh tempo
+void sensorSchedulerTask(void *pvParameter)
+{
+  adcContinuousBegin();
 
-    vTaskDelay(pdMS_TO_TICKS(750));
+  // Awal job digeser agar burst ADC dan log tidak jatuh di tick yang sama
+  temperatureJobIndex = sensorScheduler.addJob("suhu", temperatureJob, TEMPERATURE_PERIOD_MS);
+  sensorScheduler.addJob("hum", humidityJob, HUMIDITY_PERIOD_MS, 20);
+  sensorScheduler.addJob("ph", phJob, PH_PERIOD_MS, 40);
+  sensorScheduler.addJob("log", sensorLogJob, SENSOR_LOG_PERIOD_MS, 1000);
+  sensorScheduler.addJob("stats", schedulerStatsJob, SCHEDULER_STATS_PERIOD_MS, SCHEDULER_STATS_PERIOD_MS);
+
+  while (1)
+  {
+    uint32_t waitMs = sensorScheduler.runDue();
+    if (waitMs > 0)
+      vTaskDelay(pdMS_TO_TICKS(waitMs));
   }
 }
 
@@ -444,6 +929,10 @@ void updateParameterTask(void *pvParameter)
   while (1)
   {
     buttonState = !digitalRead(pbKiri) | !digitalRead(pbTengah) << 1 | !digitalRead(pbKanan) << 2;
+    if (buttonState != 0)
+    {
+      lastInteractionMs = millis(); // Menunda deep sleep selama tombol masih dipakai
+    }
 
     bool pbKiriDitekan = buttonState != lastButtonState && buttonState == 1 << 0;
     bool pbTengahDitekan = buttonState != lastButtonState && buttonState == 1 << 1;
@@ -500,6 +989,11 @@ void updateParameterTask(void *pvParameter)
           loraSettingParameter.signalBandwidth = loraBandwidth[bandwidthSelector];
           break;
         }
+        case LcdScreen::NodeAddress:
+        {
+          nodeAddress = stepNodeAddress(nodeAddress, -1);
+          break;
+        }
         }
       }
       else
@@ -511,7 +1005,8 @@ void updateParameterTask(void *pvParameter)
     // PB Tengah ditekan
     if (pbTengahDitekan)
     {
-      if (lcdMenu == LcdScreen::UpdateRateSetting || lcdMenu == LcdScreen::LoraTxPower || lcdMenu == LcdScreen::LoraSpreadingFactor || lcdMenu == LcdScreen::LoraDenominator || lcdMenu == LcdScreen::LoraSignalBandwith)
+      if (lcdMenu == LcdScreen::UpdateRateSetting || lcdMenu == LcdScreen::LoraTxPower || lcdMenu == LcdScreen::LoraSpreadingFactor || lcdMenu == LcdScreen::LoraDenominator || lcdMenu == LcdScreen::LoraSignalBandwith ||
+          lcdMenu == LcdScreen::NodeAddress)
       {
         lcdClicked ^= true;
       }
@@ -566,6 +1061,9 @@ void updateParameterTask(void *pvParameter)
 
           EEPROM.put(addresses[1], loraSettingParameter.txPower);
           EEPROM.commit();
+#if ADR_ENABLED
+          adrLink.begin(loraSettingParameter.spreadingFactor, loraSettingParameter.txPower); // Nilai manual jadi titik awal ADR
+#endif
           Lcd.clear();
 
           LoRa.setTxPower(loraSettingParameter.txPower);
@@ -588,6 +1086,9 @@ void updateParameterTask(void *pvParameter)
 
           EEPROM.put(addresses[2], loraSettingParameter.spreadingFactor);
           EEPROM.commit();
+#if ADR_ENABLED
+          adrLink.begin(loraSettingParameter.spreadingFactor, loraSettingParameter.txPower); // Nilai manual jadi titik awal ADR
+#endif
           Lcd.clear();
 
           LoRa.setSpreadingFactor(loraSettingParameter.spreadingFactor);
@@ -643,6 +1144,28 @@ void updateParameterTask(void *pvParameter)
         }
         break;
       }
+      // Alamat node: frame berikutnya sudah memakai alamat baru, Receiver mencatatnya sebagai node baru
+      case LcdScreen::NodeAddress:
+      {
+        if (!lcdClicked)
+        {
+          xSemaphoreTake(lcdUpdateSemaphore, portMAX_DELAY);
+
+          EEPROM.write(addresses[5], nodeAddress);
+          EEPROM.commit();
+          Lcd.clear();
+
+          loraParameter.loraLocalAddress = nodeAddress;
+
+          centerText("Menyimpan Data", 0);
+          delay(1000);
+
+          Lcd.clear();
+
+          xSemaphoreGive(lcdUpdateSemaphore);
+        }
+        break;
+      }
       }
     }
 
@@ -698,6 +1221,11 @@ void updateParameterTask(void *pvParameter)
           loraSettingParameter.signalBandwidth = loraBandwidth[bandwidthSelector];
           break;
         }
+        case LcdScreen::NodeAddress:
+        {
+          nodeAddress = stepNodeAddress(nodeAddress, 1);
+          break;
+        }
         }
       }
       else
@@ -803,6 +1331,33 @@ void updateLcdTask(void *pvParameter)
         }
         break;
       }
+      case LcdScreen::LoraBacklog:
+      {
+        // Kedalaman backlog di flash dan laju drain per menit (baris ditulis penuh agar angka lama terhapus)
+        Lcd.setCursor(0, 0);
+        if (!backlog.isReady())
+          Lcd.printf("Backlog %-8s", backlogFailed ? "error" : "-");
+        else
+          Lcd.printf("Backlog %-8lu", (unsigned long)backlog.count());
+        Lcd.setCursor(0, 1);
+        Lcd.printf("Drain %4lu/mnt  ", (unsigned long)backlogDrainPerMinute);
+        break;
+      }
+      case LcdScreen::NodeAddress:
+      {
+        char address[8];
+        snprintf(address, sizeof(address), "0x%02X", nodeAddress);
+        centerText("Alamat Node", 0);
+        centerText(address, 1);
+        if (lcdClicked)
+        {
+          Lcd.setCursor(0, 1);
+          Lcd.print("<");
+          Lcd.setCursor(15, 1);
+          Lcd.print(">");
+        }
+        break;
+      }
       case LcdScreen::UpdateRateSetting:
       {
         centerText("Update Rate", 0);
@@ -893,49 +1448,82 @@ void updateLcdTask(void *pvParameter)
   }
 }
 
-void onLoraReceiveCallback(int packetSize)
+// Callback interrupt DIO0: hanya menyalin paket dari FIFO radio ke antrian (satu burst SPI, tanpa heap), diproses
+// di loop()
+void IRAM_ATTR onLoraReceiveCallback(int packetSize)
 {
-  
+  LoraPacket *slot = loraRxQueue.beginPush();
+  if (slot != NULL) // Antrian penuh: paket dibuang, FIFO ditimpa paket berikutnya
+  {
+    int length = packetSize < (int)sizeof(slot->data) ? packetSize : (int)sizeof(slot->data);
+    loraReadFifo(ss, slot->data, length);
+    slot->length = length;
+    slot->rssi = LoRa.packetRssi();
+    slot->receivedAtMs = millis();
+    loraRxQueue.commitPush();
+  }
 
+  BaseType_t higherPriorityTaskWoken = pdFALSE;
+  vTaskNotifyGiveFromISR(loopTaskHandle, &higherPriorityTaskWoken);
+  portYIELD_FROM_ISR(higherPriorityTaskWoken);
+}
 
-  if (packetSize == 0)
-    return; 
+// Mengembalikan true jika paket adalah respons Receiver yang valid untuk transmitter ini. Respons berupa
+// frame ACK ARQ; respons JSON dari Receiver lama (legacy = true) hanya membawa byte msgId di ack.seq.
+// Header dan payload dibaca di tempat dari slot antrian (view), tanpa salinan ke heap.
+bool processLoraResponse(const LoraPacket &packet, ArqAck &ack, bool &legacy)
+{
+  LoraPacketView view;
+  if (!parseLoraPacket(packet.data, packet.length, view))
+    return false;
 
   digitalWrite(ledKanan, HIGH); // RX LED ON
 
-  int recipient = LoRa.read();
-  byte sender = LoRa.read();
-  byte incomingMsgId = LoRa.read();
-  byte incomingLength = LoRa.read();
-  String incoming = "";
-  while (LoRa.available())
-  {
-    incoming += (char)LoRa.read();
-  }
+  int recipient = view.recipient;
+  byte incomingMsgId = view.msgId;
 
-  if (incomingLength != incoming.length())
+  if (!view.lengthValid())
   {
     Serial.println("[LoRa RX] Length mismatch!");
     digitalWrite(ledKanan, LOW); // RX LED OFF
-    return;
+    return false;
   }
   if (recipient != loraParameter.loraLocalAddress)
   {
     Serial.println("[LoRa RX] Invalid recipient!");
     digitalWrite(ledKanan, LOW); // RX LED OFF
-    return;
+    return false;
   }
 
   // --- Pemrosesan Respons yang Valid ---
-Serial.print("[Data Respons LoRa Diterima] -> "); // Menunjukkan bahwa ini adalah data respons
-Serial.println(incoming);                         // Mencetak isi data respons yang diterima ke Serial Monitor
-
+  Serial.print("[Data Respons LoRa Diterima] -> "); // Menunjukkan bahwa ini adalah data respons
+  Serial.write(view.payload, view.payloadLength);   // Mencetak isi data respons yang diterima ke Serial Monitor
+  Serial.println();
 
-  loraRSSI = LoRa.packetRssi(); // Menyimpan nilai RSSI dari respons
+  loraRSSI = packet.rssi; // RSSI yang dicatat interrupt saat respons diterima
 
+  legacy = view.payloadLength == 0 || view.payload[0] != ARQ_ACK_VERSION;
+  if (!legacy)
+  {
+    if (!decodeArqAck(view.payload, view.payloadLength, ack))
+    {
+      Serial.println("[LoRa RX] Frame ACK tidak valid (CRC)");
+      digitalWrite(ledKanan, LOW); // RX LED OFF
+      return false;
+    }
+    serverResponse.classification = ack.flags & ArqAckClassification;
+    serverResponse.buzzerOn = ack.flags & ArqAckBuzzer;
+    Serial.printf("[LoRa RX] ACK seq %u bitmap %04x: Class=%d, Buzzer=%d%s\n", ack.seq, ack.received, serverResponse.classification,
+                  serverResponse.buzzerOn, (ack.flags & ArqAckDuplicate) ? " (duplikat)" : (ack.flags & ArqAckResult) ? " (hasil)" : "");
+    digitalWrite(ledKanan, LOW); // RX LED OFF
+    return true;
+  }
+  ack.flags = 0;
+  ack.seq = incomingMsgId;
+  ack.received = 0;
 
-  JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, incoming);
+  JsonDocument doc(&responseJsonArena); // Hanya Receiver lama yang masih menjawab dengan JSON
+  DeserializationError error = deserializeJson(doc, (const char *)view.payload, view.payloadLength);
 
   if (error)
   {
@@ -954,11 +1542,11 @@ Serial.println(incoming);                         // Mencetak isi data respons y
   }
 
   digitalWrite(ledKanan, LOW); // RX LED OFF after processing
+  return true;
 }
 
-unsigned long msgId = 0;
-
-void sendLoraMessage(String message)
+// msgId header = byte terbawah nomor urut ARQ frame (nomor lengkap ada di dalam frame telemetri)
+void sendLoraMessage(const uint8_t *payload, size_t length, uint8_t msgId)
 {
   digitalWrite(ledKiri, HIGH); // Turn on TX LED
 
@@ -971,20 +1559,18 @@ void sendLoraMessage(String message)
     LoRa.write(loraParameter.loraDestination);  // add destination address
     LoRa.write(loraParameter.loraLocalAddress); // add sender address
     LoRa.write(msgId);                          // add message ID
-    LoRa.write(message.length());               // add payload length
-    LoRa.print(message);                        // add payload
+    LoRa.write(length);                         // add payload length
+    LoRa.write(payload, length);                // add payload
 
     if (LoRa.endPacket())
-{ // menyelesaikan paket dan mengirimkannya (secara blocking)
-  // Serial.print("[Data LoRa Dikirim] -> ");
-  // Serial.println(message);
-}
-
+    { // menyelesaikan paket dan mengirimkannya (secara blocking)
+      // Serial.print("[Data LoRa Dikirim] -> ");
+      // Serial.println(message);
+    }
     else
     {
       Serial.println("[LoRa TX ERROR] Failed to send packet!");
       // // Pertimbangkan bagaimana menangani kegagalan pengiriman (TX) – apakah perlu dicoba ulang? Dicatat (log)?
-
     }
   }
   else
@@ -993,11 +1579,6 @@ void sendLoraMessage(String message)
   }
 
   digitalWrite(ledKiri, LOW); // // Matikan LED TX segera setelah percobaan pengiriman
-
-
-  msgId++; // Increment message ID
-
-  
 }
 // Fungsi untuk menampilkan teks di tengah LCD
 void centerText(const char *text, int row)
@@ -1009,69 +1590,1013 @@ void centerText(const char *text, int row)
   Lcd.print(text);
 }
 
-void loop()
+// Frame telemetri dari nilai sensor terakhir
+TelemetryFrame buildTelemetryFrame()
 {
-  // // Periksa apakah saat ini waktunya untuk memulai siklus kirim & terima
+  uint8_t flags = TelemetryHumidityValid | TelemetryPhValid;
+  if (temperature != DEVICE_DISCONNECTED_C)
+  {
+    flags |= TelemetryTemperatureValid;
+  }
 
-  if (millis() - lastSendTime > updateRate && !paused)
+  TelemetryFrame frame = makeTelemetryFrame(temperature, humidity, PH, flags);
+  for (uint8_t i = 0; i < temperatureProbes.count; i++)
   {
-    // --- Phase 1: Send Sensor Data ---
-    JsonDocument doc;
-    String serializedJson;
+    float celsius = temperatureProbes.celsius[i];
+    addTelemetryProbe(frame, temperatureProbes.id[i], celsius, celsius != DEVICE_DISCONNECTED_C);
+  }
+  return frame;
+}
 
-    // // Pastikan nilai sensor masih cukup baru (tugas pembacaan sensor harus berjalan)
+// Jendela dengar respons: time-on-air balasan Receiver pada setting LoRa aktif + waktu proses Receiver
+unsigned long responseWindowMs()
+{
+  int spreadingFactor = constrain(loraSettingParameter.spreadingFactor, 6, 12);
+  int codeDenominator = constrain(loraSettingParameter.codeDenominator, 5, 8);
+  float signalBandwidth = max(loraSettingParameter.signalBandwidth, loraBandwidth[0]);
+  uint32_t replyUs = loraTimeOnAirUs(RESPONSE_MAX_PACKET_SIZE, spreadingFactor, signalBandwidth, codeDenominator);
+  return (replyUs + 999) / 1000 + RESPONSE_GATEWAY_MS + RESPONSE_GUARD_MS;
+}
 
-    doc["humidity"] = humidity;
-    doc["temperature"] = temperature;
-    doc["ph"] = PH;
+// Setting LoRa aktif dalam rentang yang valid untuk perhitungan time-on-air
+struct AirtimeSetting
+{
+  int spreadingFactor;
+  float signalBandwidth;
+  int codeDenominator;
+};
 
-    serializeJson(doc, serializedJson);
+AirtimeSetting airtimeSetting()
+{
+  AirtimeSetting setting;
+  setting.spreadingFactor = constrain(loraSettingParameter.spreadingFactor, 6, 12);
+  setting.signalBandwidth = max(loraSettingParameter.signalBandwidth, loraBandwidth[0]);
+  setting.codeDenominator = constrain(loraSettingParameter.codeDenominator, 5, 8);
+  return setting;
+}
 
-    Serial.println("------------------------------");
-    Serial.printf("[%lu] Starting Send cycle...\n", millis());
-    sendLoraMessage(serializedJson); // Call the send function
+// Time-on-air (ms) paket LoRa sepanjang length byte termasuk header pada setting aktif
+uint32_t loraAirtimeMs(size_t length)
+{
+  AirtimeSetting setting = airtimeSetting();
+  return scheduleAirtimeMs(length, setting.spreadingFactor, setting.signalBandwidth, setting.codeDenominator);
+}
 
-    // // --- Fase 2: Menunggu Respons ---
+#if SCHEDULE_ENABLED
+// Beacon TDMA dari Receiver (broadcast 0xFF). Awal beacon dihitung mundur dari saat interrupt (akhir paket)
+// dengan time-on-air-nya, di jam rtcMillis() yang sama dengan yang dipakai untuk menunggu slot setelah deep sleep.
+// Mengembalikan true jika paket adalah beacon (valid atau tidak), sehingga tidak diproses sebagai respons
+bool processScheduleBeacon(const LoraPacket &packet)
+{
+  LoraPacketView view;
+  if (!parseLoraPacket(packet.data, packet.length, view) || view.payloadLength == 0 || view.recipient != 0xFF ||
+      view.sender != RECEIVER_ADDRESS || view.payload[0] != SCHEDULE_BEACON_VERSION)
+    return false;
 
-    Serial.println("[LoRa] TX Done. Switching to RX mode for response...");
-    LoRa.receive(); // Explicitly enter receive mode to listen
+  ScheduleBeacon beacon;
+  if (!view.lengthValid() || !decodeScheduleBeacon(view.payload, view.payloadLength, beacon))
+  {
+    Serial.println("[TDMA] Beacon tidak valid (panjang/CRC)");
+    return true;
+  }
+  uint32_t endMs = rtcMillis() - (millis() - packet.receivedAtMs);
+  scheduleSync.onBeacon(beacon, loraParameter.loraLocalAddress, endMs, loraAirtimeMs(packet.length));
+  scheduleJoinWaited = false; // Sinkron lagi: penahanan ALOHA boleh dipakai lagi jika sinkronisasi hilang
+  contentionPlanned = false;  // Jendela kontensi dipilih ulang dari beacon baru
+
+  if (scheduleSync.slotLength() > 0)
+    Serial.printf("[TDMA] Beacon #%u: slot %lu ms pada +%lu ms, periode %lu ms, skew %ld ppm%s\n", beacon.number,
+                  (unsigned long)scheduleSync.slotLength(), (unsigned long)scheduleSync.slotOffset(), (unsigned long)scheduleSync.periodMs(),
+                  (long)scheduleSync.skew(), scheduleSync.isStable() ? "" : " (jadwal berubah)");
+  else
+    Serial.printf("[TDMA] Beacon #%u: belum punya slot (%u node terjadwal), periode %lu ms\n", beacon.number, beacon.count,
+                  (unsigned long)scheduleSync.periodMs());
+  return true;
+}
 
-    const unsigned long responseTimeout = 2000; // Wait up to 2000ms (2 seconds) for a response
-    unsigned long listenStartTime = millis();
-    bool responseReceived = false;
+// Waktu kirim di jendela kontensi: acak di dalam jendela, dan jendelanya dipilih dengan backoff eksponensial
+// antar periode setelah kiriman tanpa ACK. Dipilih sekali lalu ditunggu, tidak diundi ulang setiap loop
+bool contentionTxDue(uint32_t nowMs, uint32_t holdMs)
+{
+  if (!contentionPlanned)
+  {
+    AirtimeSetting setting = airtimeSetting();
+    uint32_t windowMs = scheduleContentionMs(setting.spreadingFactor, setting.signalBandwidth, setting.codeDenominator);
+    uint32_t skip = scheduleContentionSkip(contentionFailures, esp_random());
+    bool inWindow = scheduleSync.inContention(nowMs, holdMs);
+    if (inWindow && skip == 0)
+    {
+      contentionTxAtMs = nowMs;
+    }
+    else
+    {
+      uint32_t offsetMs = windowMs > holdMs ? esp_random() % (windowMs - holdMs) : 0;
+      contentionTxAtMs = scheduleSync.nextContention(nowMs) + (inWindow ? skip - 1 : skip) * scheduleSync.periodMs() + offsetMs;
+    }
+    contentionPlanned = true;
+  }
+  if ((int32_t)(nowMs - contentionTxAtMs) < 0)
+    return false;
+  contentionPlanned = false;
+  return scheduleSync.inContention(nowMs, holdMs); // Terlewat (loop tertahan): pilih ulang
+}
+
+// Boleh mengirim frame sepanjang frameLength sekarang? slot = true jika di awal slot node ini (kanal milik node
+// ini, tanpa listen-before-talk). Frame yang lebih panjang dari slot (batch backlog) memakai jendela kontensi
+bool scheduleTxAllowed(size_t frameLength, bool &slot)
+{
+  slot = false;
+  uint32_t nowMs = rtcMillis();
+  AirtimeSetting setting = airtimeSetting();
+  uint32_t holdMs = scheduleSlotMs(frameLength, setting.spreadingFactor, setting.signalBandwidth, setting.codeDenominator);
+  if (scheduleSync.hasSlot(nowMs) && holdMs <= scheduleSync.slotLength())
+  {
+    uint32_t startMs;
+    if (!scheduleSync.inSlot(nowMs, startMs) || startMs == usedSlotStartMs)
+      return false;
+    usedSlotStartMs = startMs;
+    slot = true;
+    return true;
+  }
+  if (scheduleSync.synced(nowMs))
+    return contentionTxDue(nowMs, holdMs);
+  return (int32_t)(nowMs - scheduleJoinUntilMs) >= 0; // Belum sinkron: ALOHA, kecuali menunggu beacon setelah ACK
+}
+
+// Jarak antar sampel: node dengan slot mengambil sampel di slot pertama setelah updateRate dikurangi setengah
+// periode, sehingga laju rata-rata tetap updateRate walaupun slot hanya datang sekali per periode
+unsigned long sampleIntervalMs()
+{
+  uint32_t periodMs = scheduleSync.hasSlot(rtcMillis()) ? scheduleSync.periodMs() : 0;
+  return updateRate > periodMs / 2 ? updateRate - periodMs / 2 : 0;
+}
+#else
+bool scheduleTxAllowed(size_t frameLength, bool &slot)
+{
+  slot = false;
+  return true;
+}
+
+unsigned long sampleIntervalMs()
+{
+  return updateRate;
+}
+#endif
+
+#if ADR_ENABLED
+// Pengaturan ADR yang berubah diterapkan ke radio yang sedang berjalan (tanpa EEPROM.commit())
+void applyAdrSettings(uint8_t previousSf)
+{
+  loraSettingParameter.spreadingFactor = adrLink.spreadingFactor;
+  loraSettingParameter.txPower = adrLink.txPower;
+  LoRa.setSpreadingFactor(adrLink.spreadingFactor);
+  LoRa.setTxPower(adrLink.txPower);
+  if (radioListening)
+    LoRa.receive();
+  Serial.printf("[ADR] SF%u, %d dBm\n", adrLink.spreadingFactor, adrLink.txPower);
+#if SCHEDULE_ENABLED
+  if (adrLink.spreadingFactor != previousSf)
+    scheduleSync.reset(); // Slot lama dihitung dari airtime SF sebelumnya, tunggu beacon pada SF baru
+#endif
+}
+
+// Perintah ADR di belakang ACK diterapkan atau disimpan sampai waktu ganti SF
+void processAdrCommand(const LoraPacket &packet, const ArqAck &ack)
+{
+  AdrCommand command;
+  if (!(ack.flags & ArqAckCommand) || !decodeAdrCommand(&packet.data[LORA_PACKET_HEADER_SIZE + ARQ_ACK_SIZE], packet.length - LORA_PACKET_HEADER_SIZE - ARQ_ACK_SIZE, command))
+    return;
+  if (command.id == adrLink.commandId && command.switchInS == ADR_SWITCH_UNSCHEDULED)
+    return; // Perintah yang sama diulang karena konfirmasinya belum sampai
+  uint8_t sf = adrLink.spreadingFactor;
+  if (adrLink.onCommand(command, rtcMillis()))
+    applyAdrSettings(sf);
+  else if (adrLink.pendingSf != 0)
+    Serial.printf("[ADR] Perintah #%u: SF%u %d dBm %s\n", command.id, command.spreadingFactor, command.txPower,
+                  adrLink.switchScheduled ? "dijadwalkan" : "diusulkan");
+}
+
+// Jadwal ganti SF yang sudah tiba
+void serviceAdrSwitch()
+{
+  uint8_t sf = adrLink.spreadingFactor;
+  if (adrLink.service(rtcMillis()))
+    applyAdrSettings(sf);
+}
+#endif
 
-    while (millis() - listenStartTime < responseTimeout)
+// Memproses paket dari antrian interrupt: setiap frame yang tercakup ACK selesai, dan frame terbaru di
+// antaranya dikonfirmasi ke report filter. Mengembalikan jumlah frame yang terkonfirmasi.
+uint8_t serviceLoraResponses()
+{
+  uint8_t confirmed = 0;
+  LoraPacket *packet;
+  while ((packet = loraRxQueue.front()) != NULL)
+  {
+    ArqAck ack;
+    bool legacy;
+#if ADR_ENABLED
+    if (packet->length >= 4 && packet->data[1] == RECEIVER_ADDRESS)
+      adrLink.onHeard(); // Receiver terdengar pada SF ini, termasuk beacon dan ACK untuk node lain
+#endif
+#if SCHEDULE_ENABLED
+    if (processScheduleBeacon(*packet))
+    {
+      loraRxQueue.pop();
+      continue;
+    }
+#endif
+    if (processLoraResponse(*packet, ack, legacy))
     {
-      int packetSize = LoRa.parsePacket();
-      if (packetSize)
+#if ADR_ENABLED
+      if (!legacy)
+        processAdrCommand(*packet, ack);
+#endif
+      PendingResponse *newest = NULL;
+      uint8_t confirmedBefore = confirmed;
+      for (uint8_t i = 0; i < RESPONSE_MAX_PENDING; i++)
       {
-        Serial.printf("[%lu] Received response packet!\n", millis());
-        onLoraReceiveCallback(packetSize); // Process the received packet
-        responseReceived = true;
-        break; // Exit the listening loop once response is received
+        PendingResponse &pending = pendingResponses[i];
+        if (!pending.active)
+          continue;
+        bool covered = legacy ? (uint8_t)pending.frame.seq == (uint8_t)ack.seq : arqAcked(ack, pending.frame.seq);
+        if (!covered)
+          continue;
+        pending.active = false;
+        confirmed++;
+        Serial.printf("[%lu] ACK seq %u setelah %lu ms, %u kiriman ulang\n", millis(), pending.frame.seq, millis() - pending.firstSentMs,
+                      pending.attempts);
+        if (pending.batch)
+        {
+          consumeBacklogBatch(); // Batch backlog tidak menyentuh report filter
+          continue;
+        }
+        arqStats.acked++;
+        if (newest == NULL || (int16_t)(pending.frame.seq - newest->frame.seq) > 0)
+          newest = &pending;
       }
-      // Briefly yield to allow other tasks/RTOS functions
-      vTaskDelay(pdMS_TO_TICKS(5));
+      linkUp = true;
+      if (confirmed > confirmedBefore)
+        arqCongestion.onAnswered();
+      if (!legacy && (ack.flags & ArqAckResult))
+        resultListening = false; // Hasil server sudah sampai
+#if !LOW_POWER_MODE
+      else if (!legacy && newest != NULL && !(ack.flags & ArqAckDuplicate))
+      {
+        // Hasil server pembacaan ini menyusul setelah POST jika berbeda dari hasil di ACK; mode daya rendah
+        // tidak menunggu dan menerima hasilnya di ACK frame berikutnya
+        resultListening = true;
+        resultListenUntilMs = millis() + RESPONSE_RESULT_WINDOW_MS;
+      }
+#endif
+#if SCHEDULE_ENABLED
+      contentionFailures = 0;
+      if (!scheduleSync.synced(rtcMillis()) && !scheduleJoinWaited)
+      {
+        // Receiver sudah mendaftarkan node ini: ALOHA ditahan sampai beacon yang mencantumkannya datang, agar
+        // node lain yang belum terdaftar tidak terus bertabrakan dengan node ini
+        AirtimeSetting setting = airtimeSetting();
+        scheduleJoinWaited = true;
+        scheduleJoinUntilMs = rtcMillis() + scheduleJoinWaitMs(setting.spreadingFactor, setting.signalBandwidth, setting.codeDenominator);
+      }
+#endif
+
+      // Referensi deadband tidak boleh mundur ke frame lama yang ACK-nya baru datang
+      if (newest != NULL && (!hasConfirmedSeq || (int16_t)(newest->frame.seq - confirmedSeq) > 0))
+      {
+        reportFilter.confirm(newest->frame, rtcMillis()); // Receiver sudah memegang nilai ini, jadi referensi deadband berikutnya
+        confirmedSeq = newest->frame.seq;
+        hasConfirmedSeq = true;
+      }
+      if (ack.flags & ArqAckDuplicate)
+        arqStats.duplicateAcks++;
+      if (newest == NULL && !(ack.flags & ArqAckResult))
+        Serial.printf("[LoRa RX] ACK seq %u tidak ditunggu (terlambat/node lain)\n", ack.seq);
     }
+    loraRxQueue.pop();
+  }
+  return confirmed;
+}
 
-    // --- Phase 3: Handle Timeout / Go Idle ---
-    if (!responseReceived)
+// Mencatat frame baru yang akan dikirim dan memberinya nomor urut; slot penuh menggantikan frame tertua,
+// yang disimpan ke backlog
+PendingResponse &addPendingResponse(const TelemetryFrame &frame)
+{
+  PendingResponse *slot = &pendingResponses[0];
+  for (uint8_t i = 0; i < RESPONSE_MAX_PENDING; i++)
+  {
+    if (!pendingResponses[i].active)
     {
-      Serial.printf("[%lu] No response received within timeout.\n", millis());
-      
-      loraRSSI = 0; 
+      slot = &pendingResponses[i];
+      break;
     }
+    if ((int16_t)(pendingResponses[i].frame.seq - slot->frame.seq) < 0)
+      slot = &pendingResponses[i];
+  }
+  if (slot->active)
+  {
+    if (!slot->batch)
+      arqStats.dropped++;
+    Serial.printf("[ARQ] Slot penuh, seq %u %s\n", slot->frame.seq, storeBacklog(*slot) ? "disimpan ke backlog" : "dibuang");
+  }
+  slot->active = true;
+  slot->batch = false;
+  slot->attempts = 0;
+  slot->maxRetries = ARQ_MAX_RETRIES;
+  slot->retryPending = false;
+  slot->frame = frame;
+  slot->frame.seq = arqSeq++;
+  slot->capturedMs = rtcMillis();
+  arqStats.frames++;
+  return *slot;
+}
 
-    Serial.println("[LoRa] Listening period over. Idling LoRa module.");
-    LoRa.idle(); // Put LoRa module to sleep/idle until the next send cycle
+// Memulihkan log backlog dari partisi saat pertama dipakai; false jika partisi tidak ada atau tidak bisa dipakai
+bool backlogBegin()
+{
+#if BACKLOG_ENABLED
+  if (backlog.isReady())
+    return true;
+  if (backlogFailed)
+    return false;
+
+  backlogStorage.partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, NULL);
+  if (backlogStorage.partition == NULL || backlogStorage.partition->size < BACKLOG_SECTORS * FLASH_LOG_SECTOR_SIZE ||
+      !backlog.begin(&backlogStorage, BACKLOG_SECTORS))
+  {
+    backlogFailed = true;
+    Serial.println("[Backlog] Partisi spiffs tidak tersedia, store-and-forward nonaktif");
+    return false;
+  }
+  if (!backlogClockValid) // Cold boot: jam rtcMillis() mulai dari nol, umur record boot sebelumnya tidak diketahui
+  {
+    backlogClockBoot = backlog.boot();
+    backlogClockValid = true;
+  }
+  backlogPending = backlog.count() > 0;
+  drainRateStartConsumed = 0;
+  Serial.printf("[Backlog] %lu pembacaan belum terkirim (kapasitas %lu), slot rusak dilewati %lu\n", (unsigned long)backlog.count(),
+                (unsigned long)backlog.capacity(), (unsigned long)backlog.stats().corrupt);
+  return true;
+#else
+  return false;
+#endif
+}
 
- // Perbarui lastSendTime hanya SETELAH seluruh siklus selesai
+// Menyimpan frame yang tidak mendapat ACK ke flash; batch backlog tidak disimpan ulang (record-nya masih di flash)
+bool storeBacklog(const PendingResponse &pending)
+{
+  if (pending.batch)
+    return false;
+  if (!backlogBegin())
+    return false;
+  uint8_t frameBuffer[TELEMETRY_FRAME_MAX_SIZE];
+  size_t frameLength = encodeTelemetryFrame(pending.frame, frameBuffer, sizeof(frameBuffer));
+  bool stored = backlog.append(frameBuffer, frameLength, pending.capturedMs);
+  backlogPending = backlog.count() > 0;
+  return stored;
+}
 
-    lastSendTime = millis();
+// Umur record saat dikirim, detik; tidak diketahui untuk record dari sebelum cold boot terakhir
+uint32_t backlogAgeSeconds(const FlashLogRecord &record)
+{
+  if ((int16_t)(record.boot - backlogClockBoot) < 0)
+    return TELEMETRY_AGE_UNKNOWN;
+  return (rtcMillis() - record.capturedMs) / 1000;
+}
+
+// Mengisi frame batch dari backlogBatch dengan umur terkini (dihitung ulang setiap kiriman ulang). Record yang
+// tidak muat di TELEMETRY_BATCH_MAX_SIZE dikeluarkan dari batch ini dan ikut batch berikutnya
+size_t encodeBacklogBatch(uint16_t seq, uint8_t *buffer)
+{
+  size_t length = beginTelemetryBatch(buffer, seq);
+  uint8_t added = 0;
+  while (added < backlogBatch.count)
+  {
+    const FlashLogRecord &record = backlogBatch.records[added];
+    if (!addTelemetryBatchRecord(buffer, TELEMETRY_BATCH_MAX_SIZE, length, backlogAgeSeconds(record), record.data, record.length))
+      break;
+    added++;
+  }
+  backlogBatch.count = added;
+  return finishTelemetryBatch(buffer, length);
+}
+
+bool backlogBatchInFlight()
+{
+  for (uint8_t i = 0; i < RESPONSE_MAX_PENDING; i++)
+  {
+    if (pendingResponses[i].active && pendingResponses[i].batch)
+      return true;
+  }
+  return false;
+}
+
+// Mengambil batch berikutnya dari flash ke slot tunggu yang kosong (tidak menggeser frame baru); NULL jika
+// backlog kosong, batch sebelumnya belum selesai, atau semua slot terpakai
+PendingResponse *addBacklogBatch()
+{
+  if (!backlogPending || !backlogBegin() || backlogBatchInFlight())
+    return NULL;
+
+  PendingResponse *slot = NULL;
+  for (uint8_t i = 0; i < RESPONSE_MAX_PENDING && slot == NULL; i++)
+  {
+    if (!pendingResponses[i].active)
+      slot = &pendingResponses[i];
+  }
+  if (slot == NULL)
+    return NULL;
+
+  backlogBatch.count = backlog.peek(BACKLOG_DRAIN_ORDER, backlogBatch.records, TELEMETRY_BATCH_MAX_RECORDS);
+  backlogPending = backlogBatch.count > 0;
+  if (backlogBatch.count == 0)
+    return NULL;
+
+  slot->active = true;
+  slot->batch = true;
+  slot->attempts = 0;
+  slot->maxRetries = ARQ_MAX_RETRIES;
+  slot->retryPending = false;
+  slot->frame.seq = arqSeq++;
+  return slot;
+}
+
+// Batch di-ACK Receiver: record-nya ditandai terkirim di flash
+void consumeBacklogBatch()
+{
+  for (uint8_t i = 0; i < backlogBatch.count; i++)
+    backlog.consume(backlogBatch.records[i]);
+  Serial.printf("[Backlog] %u pembacaan terkirim, sisa %lu\n", backlogBatch.count, (unsigned long)backlog.count());
+  backlogBatch.count = 0;
+  backlogPending = backlog.count() > 0;
+}
+
+// Laju drain untuk LCD: pembacaan backlog yang di-ACK selama BACKLOG_RATE_WINDOW_MS terakhir
+void updateBacklogRate()
+{
+  if (millis() - drainRateStartMs < BACKLOG_RATE_WINDOW_MS)
+    return;
+  uint32_t consumed = backlog.stats().consumed;
+  backlogDrainPerMinute = (uint64_t)(consumed - drainRateStartConsumed) * 60000 / (millis() - drainRateStartMs);
+  drainRateStartConsumed = consumed;
+  drainRateStartMs = millis();
+}
+
+// Mengirim (ulang) frame sebuah slot dan membuka jendela dengarnya
+void transmitPending(PendingResponse &slot)
+{
+  uint8_t frameBuffer[TELEMETRY_BATCH_MAX_SIZE];
+#if ADR_ENABLED
+  if (!slot.batch)
+    slot.frame.flags = (slot.frame.flags & ~(TelemetryAdrCapable | TelemetryAdrCommandMask)) | adrLink.frameFlags(); // Kiriman ulang membawa status terbaru
+#endif
+  size_t frameLength = slot.batch ? encodeBacklogBatch(slot.frame.seq, frameBuffer)
+                                  : encodeCompactTelemetryFrame(slot.frame, frameBuffer, sizeof(frameBuffer));
+  sendLoraMessage(frameBuffer, frameLength, (uint8_t)slot.frame.seq);
+
+  slot.sentMs = millis();
+  if (slot.attempts == 0)
+    slot.firstSentMs = slot.sentMs;
+  slot.deadlineMs = slot.sentMs + responseWindowMs();
+  slot.retryPending = false;
+}
+
+// Frame yang jendela dengarnya lewat dijadwalkan kirim ulang dengan backoff, atau dianggap hilang setelah
+// ARQ_MAX_RETRIES kiriman ulang. Mengembalikan true jika masih ada frame yang menunggu
+bool expirePendingResponses()
+{
+  bool waiting = false;
+  for (uint8_t i = 0; i < RESPONSE_MAX_PENDING; i++)
+  {
+    PendingResponse &pending = pendingResponses[i];
+    if (!pending.active)
+      continue;
+    if (!pending.retryPending && (long)(millis() - pending.deadlineMs) >= 0)
+    {
+      arqCongestion.onUnanswered();
+#if SCHEDULE_ENABLED
+      if (!scheduleSync.hasSlot(rtcMillis()) && contentionFailures < 255)
+        contentionFailures++;
+#endif
+#if ADR_ENABLED
+      uint8_t sf = adrLink.spreadingFactor;
+      if (adrLink.onUnanswered())
+      {
+        Serial.printf("[ADR] %u kiriman tanpa ACK, coba pengaturan lain\n", ADR_LINK_LOST_TX);
+        applyAdrSettings(sf);
+      }
+#endif
+      if (pending.attempts >= pending.maxRetries)
+      {
+        pending.active = false;
+        if (!pending.batch)
+          arqStats.dropped++;
+        Serial.printf("[%lu] Tidak ada ACK untuk seq %u setelah %u kiriman ulang, %s\n", millis(), pending.frame.seq, pending.attempts,
+                      pending.batch ? "batch tetap di backlog" : storeBacklog(pending) ? "disimpan ke backlog" : "frame hilang");
+        loraRSSI = 0;
+        linkUp = false;
+        continue;
+      }
+      pending.retryPending = true;
+      pending.retryAtMs = millis() + arqCongestion.backoffMs(pending.attempts, esp_random());
+#if SCHEDULE_ENABLED
+      if (scheduleSync.hasSlot(rtcMillis()))
+        pending.retryAtMs = millis(); // Slot berikutnya sudah menjadi jarak kiriman ulang
+#endif
+    }
+    waiting = true;
+  }
+  return waiting;
+}
+
+// Frame yang sudah waktunya dikirim ulang, NULL jika tidak ada
+PendingResponse *dueRetransmission()
+{
+  for (uint8_t i = 0; i < RESPONSE_MAX_PENDING; i++)
+  {
+    PendingResponse &pending = pendingResponses[i];
+    if (pending.active && pending.retryPending && (long)(millis() - pending.retryAtMs) >= 0)
+      return &pending;
+  }
+  return NULL;
+}
+
+// Listen-before-talk selama masih ada frame yang menunggu respons: frame baru ditahan selama radio mendengar
+// sinyal (biasanya balasan Receiver untuk frame sebelumnya) agar balasan itu tidak terpotong oleh TX.
+// Paling lama satu time-on-air balasan; radio standby tidak mengukur RSSI, jadi hanya saat RX.
+// TDMA: setelah kanal bebas node menunggu acak sampai SCHEDULE_LBT_BACKOFF_MS, agar beacon Receiver (tanpa
+// backoff) mendahului kiriman ALOHA yang tertahan dan beberapa node yang tertahan tidak mengirim bersamaan
+void waitChannelClear()
+{
+  if (!radioListening)
+    return;
+  unsigned long maxWaitMs = responseWindowMs() - RESPONSE_GATEWAY_MS;
+  unsigned long start = millis();
+  bool busy = false;
+  while (LoRa.rssi() > LBT_THRESHOLD_DBM && millis() - start < maxWaitMs)
+  {
+    busy = true;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LBT_POLL_MS));
+    serviceLoraResponses();
+  }
+#if SCHEDULE_ENABLED
+  if (busy)
+  {
+    unsigned long backoffMs = esp_random() % SCHEDULE_LBT_BACKOFF_MS;
+    start = millis();
+    while (millis() - start < backoffMs)
+    {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LBT_POLL_MS));
+      serviceLoraResponses();
+    }
+  }
+#endif
+}
+
+// Mengirim frame sebuah slot dan menunggu ACK-nya termasuk kiriman ulang ARQ (mode daya rendah). CPU tidur sampai
+// interrupt DIO0, akhir jendela dengar, atau akhir backoff. Waktu TX dan RX dicatat ke anggaran daya.
+bool sendWithArq(PendingResponse &slot, bool waitAck)
+{
+  while (1)
+  {
+    unsigned long phaseStart = millis();
+    waitChannelClear();
+    transmitPending(slot);
+    powerBudget.add(PowerTransmit, millis() - phaseStart);
+    if (!waitAck)
+    {
+      slot.active = false;
+      return false;
+    }
+
+    phaseStart = millis();
+    LoRa.receive();
+    radioListening = true;
+    bool acked = false;
+    while (1)
+    {
+      if (serviceLoraResponses() > 0)
+      {
+        acked = true;
+        break;
+      }
+      if (!expirePendingResponses())
+        break; // Kiriman ulang habis
+      if (slot.retryPending && (long)(millis() - slot.retryAtMs) >= 0)
+        break;
+      long remainingMs = (long)((slot.retryPending ? slot.retryAtMs : slot.deadlineMs) - millis());
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(max(remainingMs, 1L)));
+    }
+    powerBudget.add(PowerListen, millis() - phaseStart);
+    if (!slot.active)
+      return acked;
+
+    slot.attempts++;
+    arqStats.retransmits++;
+  }
+}
+
+bool sendWithArq(const TelemetryFrame &frame, bool waitAck)
+{
+  return sendWithArq(addPendingResponse(frame), waitAck);
+}
+
+// Radio dan DMS dimatikan lalu deep sleep; bangun oleh timer RTC (siklus daya rendah) atau
+// tombol tengah (mode interaktif). Pull-up internal tombol tidak aktif selama deep sleep,
+// jadi pull-up RTC GPIO dinyalakan agar pin tidak mengambang.
+void enterDeepSleep(uint32_t sleepMs)
+{
+  sleepMs = max(sleepMs, (uint32_t)LOW_POWER_MIN_SLEEP_MS);
+  lastSleepMs = sleepMs;
+
+  LoRa.sleep();
+  digitalWrite(DMSpin, HIGH); // DMS mati
+  digitalWrite(DMSIndicator, LOW);
+
+  Serial.printf("[Daya] deep sleep %lu ms\n", (unsigned long)sleepMs);
+  Serial.flush();
+  esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000ULL);
+  rtc_gpio_pullup_en((gpio_num_t)pbTengah);
+  esp_sleep_enable_ext0_wakeup((gpio_num_t)pbTengah, LOW); // Tombol aktif LOW
+  esp_deep_sleep_start();
+}
+
+// Ringkasan anggaran daya: waktu dan muatan bangun ini, lalu akumulasi sejak cold boot per fase
+void printPowerBudget(const PowerBudget &before)
+{
+  Serial.printf("[Daya] bangun #%lu:", (unsigned long)powerBudget.wakeups);
+  for (uint8_t p = 0; p < PowerSleep; p++)
+  {
+    PowerPhase phase = (PowerPhase)p;
+    Serial.printf(" %s %lu ms", powerPhaseName(phase), (unsigned long)(powerBudget.timeMs[p] - before.timeMs[p]));
+  }
+  Serial.printf(", %.1f mAs\n", powerBudget.totalMas() - before.totalMas());
+
+  if (powerBudget.wakeups % LOW_POWER_REPORT_WAKEUPS != 0)
+    return;
+
+  uint32_t totalMs = powerBudget.totalMs();
+  float totalMas = powerBudget.totalMas();
+  Serial.printf("[Daya] %-6s %10s %6s %10s %6s\n", "fase", "waktu ms", "waktu", "mAs", "muatan");
+  for (uint8_t p = 0; p < PowerPhaseCount; p++)
+  {
+    PowerPhase phase = (PowerPhase)p;
+    Serial.printf("[Daya] %-6s %10lu %5.1f%% %10.2f %5.1f%%\n", powerPhaseName(phase), (unsigned long)powerBudget.timeMs[p],
+                  totalMs ? 100.0f * powerBudget.timeMs[p] / totalMs : 0.0f, powerBudget.chargeMas[p],
+                  totalMas > 0 ? 100.0f * powerBudget.chargeMas[p] / totalMas : 0.0f);
+  }
+  Serial.printf("[Daya] arus rata-rata %.3f mA, baterai %.0f mAh: %.1f hari (selalu aktif %.3f mA: %.1f hari)\n",
+                powerBudget.averageCurrentMa(), POWER_BATTERY_MAH, powerBudget.batteryDays(), POWER_CURRENT_ALWAYS_ON_MA,
+                POWER_BATTERY_MAH / POWER_CURRENT_ALWAYS_ON_MA / 24.0f);
+}
+
+// Satu siklus setelah bangun oleh timer RTC, tanpa LCD dan task FreeRTOS: job sensor yang sama dengan
+// mode interaktif dijalankan sekali lewat scheduler (konversi DS18B20 berjalan selama warm-up DMS),
+// frame dikirim jika lolos report filter, respons ditunggu hanya untuk frame yang perlu dikonfirmasi,
+// lalu tidur lagi. Waktu tiap fase dicatat ke powerBudget.
+void lowPowerCycle()
+{
+  PowerBudget before = powerBudget;
+  powerBudget.wakeups++;
+  powerBudget.add(PowerSleep, lastSleepMs);
+
+  pinMode(ledKanan, OUTPUT);
+  pinMode(ledKiri, OUTPUT);
+  pinMode(buzzerPin, OUTPUT);
+  loadSettings();
+  temperatureSensor.begin();
+  temperatureSensor.setWaitForConversion(false);
+  adcContinuousBegin();
+
+  unsigned long phaseStart = millis();
+  powerBudget.add(PowerBoot, cycleStartMs ? phaseStart - cycleStartMs : POWER_BOOTLOADER_MS + phaseStart);
+
+  // --- Sensor: tunggu satu siklus penuh setiap job ---
+  temperatureJobIndex = sensorScheduler.addJob("suhu", temperatureJob, TEMPERATURE_PERIOD_MS);
+  int humidityJobIndex = sensorScheduler.addJob("hum", humidityJob, HUMIDITY_PERIOD_MS);
+  int phJobIndex = sensorScheduler.addJob("ph", phJob, PH_PERIOD_MS);
+  while (1)
+  {
+    uint32_t waitMs = sensorScheduler.runDue();
+    if (sensorScheduler.job(temperatureJobIndex).stats.cycles > 0 && sensorScheduler.job(humidityJobIndex).stats.cycles > 0 &&
+        sensorScheduler.job(phJobIndex).stats.cycles > 0)
+      break;
+    if (waitMs > 0)
+      delay(waitMs);
+  }
+  uint8_t phase = 0;
+  sensorLogJob(phase);
+  unsigned long phaseEnd = millis();
+  powerBudget.add(PowerSensing, phaseEnd - phaseStart);
+#if SCHEDULE_ENABLED
+  if (cycleStartMs == 0)
+    scheduleLeadMs = POWER_BOOTLOADER_MS + phaseEnd + SCHEDULE_WAKE_LEAD_MS; // Bangun berikutnya sekian sebelum slot
+  lastSampleRtcMs = rtcMillis();
+#endif
+
+  // --- Kirim dan dengar respons ---
+  TelemetryFrame frame = buildTelemetryFrame();
+  ReportReason reason = reportFilter.evaluate(frame, rtcMillis());
+  if (reason != ReportSuppressed)
+  {
+    configureLora();
+    if (LoRa.begin(433E6))
+    {
+      applyLoraSettings();
+      LoRa.onReceive(onLoraReceiveCallback);
+      bool slotTx = false;
+#if SCHEDULE_ENABLED
+      slotTx = scheduleWaitSlot(telemetryCompactFrameSize(frame));
+#endif
+      if (reason == ReportHeartbeat)
+      {
+        // Heartbeat hanya tanda hidup dengan nilai di dalam deadband: jendela dengar dan kiriman ulang
+        // dilewati, referensi deadband tetap nilai terakhir yang dikonfirmasi
+        frame.flags |= TelemetryHeartbeat;
+        sendWithArq(frame, false);
+        reportFilter.heartbeatSent(rtcMillis());
+      }
+      else
+      {
+        PendingResponse &pending = addPendingResponse(frame);
+        if (slotTx)
+          pending.maxRetries = 0; // Slot berikutnya baru satu periode lagi: tanpa ACK, frame masuk backlog
+        bool responseReceived = sendWithArq(pending, true);
+        phaseEnd = millis();
+
+        if (responseReceived)
+        {
+          if (serverResponse.buzzerOn && !buzzerLastState)
+          {
+            digitalWrite(buzzerPin, HIGH);
+            delay(buzzerActiveTime);
+            digitalWrite(buzzerPin, LOW);
+            powerBudget.add(PowerBuzzer, millis() - phaseEnd);
+          }
+          buzzerLastState = serverResponse.buzzerOn;
+
+          // Link hidup: satu batch backlog per bangun, sisa backlog menyusul di bangun berikutnya. Batch tidak
+          // muat di slot TDMA; bangun berikutnya diarahkan ke jendela kontensi (scheduleSleepMs)
+          PendingResponse *batch = slotTx ? NULL : addBacklogBatch();
+          if (batch != NULL)
+            sendWithArq(*batch, true);
+        }
+      }
+#if SCHEDULE_ENABLED
+      scheduleJoinListen();
+#endif
+    }
+    else
+    {
+      Serial.println("LoRa gagal diinisialisasi");
+    }
+  }
+
+  const ReportStats &reportStats = reportFilter.stats();
+  Serial.printf("[Daya] laporan %s, seq %u, terkirim %lu, heartbeat %lu, ditahan %lu, kirim ulang %lu, hilang %lu, backlog %lu\n",
+                reason == ReportSuppressed ? "ditahan" : reason == ReportHeartbeat ? "heartbeat" : "berubah", arqSeq,
+                (unsigned long)reportStats.changes, (unsigned long)reportStats.heartbeats, (unsigned long)reportStats.suppressed,
+                arqStats.retransmits, arqStats.dropped, (unsigned long)backlog.count());
+  printPowerBudget(before);
+
+  uint32_t awakeMs = POWER_BOOTLOADER_MS + millis();
+  uint32_t sleepMs = updateRate > awakeMs ? updateRate - awakeMs : 0;
+#if SCHEDULE_ENABLED
+  sleepMs = scheduleSleepMs(sleepMs, LOW_POWER_MIN_SLEEP_MS);
+#endif
+  enterDeepSleep(sleepMs);
+}
+
+#if SCHEDULE_ENABLED
+// Mode daya rendah: lama deep sleep berikutnya. Node dengan slot bangun scheduleLeadMs sebelum slot pertama
+// setelah sampel berikutnya jatuh tempo (sebelum jendela kontensi jika backlog menunggu). Slot hanya boleh
+// diproyeksikan SCHEDULE_MAX_MISSED periode dari jadwal yang stabil; lebih dari itu node bangun sebentar untuk
+// beacon dulu (scheduleBeaconCycle). Node tanpa slot tidur sleepMs seperti tanpa jadwal
+uint32_t scheduleSleepMs(uint32_t sleepMs, uint32_t minSleepMs)
+{
+  uint32_t nowMs = rtcMillis();
+  scheduleBeaconWake = false;
+  if (!scheduleSync.hasSlot(nowMs))
+    return sleepMs;
+
+  uint32_t periodMs = scheduleSync.periodMs();
+  uint32_t dueMs = sleepMs > periodMs / 2 ? sleepMs - periodMs / 2 : 0;
+  dueMs = nowMs + max(dueMs, minSleepMs) + scheduleLeadMs;
+  uint32_t targetMs = backlogPending ? scheduleSync.nextContention(dueMs) : scheduleSync.nextSlot(dueMs);
+  if (scheduleSync.slotUsable(targetMs))
+    return targetMs - scheduleLeadMs - nowMs;
+
+  uint32_t beaconLeadMs = POWER_BOOTLOADER_MS + SCHEDULE_WAKE_LEAD_MS;
+  uint32_t beaconMs = scheduleSync.nextBeacon(nowMs + LOW_POWER_MIN_SLEEP_MS + beaconLeadMs + scheduleSync.marginMs(nowMs));
+  scheduleBeaconWake = true;
+  return beaconMs - scheduleSync.marginMs(beaconMs) - beaconLeadMs - nowMs;
+}
+
+// Mode daya rendah: radio hanya RX sebentar setelah kirim, jadi node yang belum sinkron hampir tidak pernah
+// mendengar beacon. Selama penahanan ALOHA setelah ACK pertama (scheduleJoinUntilMs) radio tetap RX sampai beacon
+// terdengar; sekali per hilangnya sinkronisasi, jadi Receiver tanpa beacon hanya memakan satu jendela dengar
+void scheduleJoinListen()
+{
+  if (scheduleSync.synced(rtcMillis()) || (int32_t)(rtcMillis() - scheduleJoinUntilMs) >= 0)
+    return;
+  unsigned long listenStart = millis();
+  LoRa.receive();
+  while (!scheduleSync.synced(rtcMillis()) && (int32_t)(rtcMillis() - scheduleJoinUntilMs) < 0)
+  {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+    serviceLoraResponses();
+  }
+  powerBudget.add(PowerListen, millis() - listenStart);
+  Serial.printf("[TDMA] Menunggu beacon %lu ms: %s\n", millis() - listenStart, scheduleSync.synced(rtcMillis()) ? "sinkron" : "tidak terdengar");
+}
+
+// Mode daya rendah: menunggu awal slot node ini jika slot itu jatuh dalam scheduleLeadMs ke depan (bangun sudah
+// dijadwalkan tepat sebelum slot). false jika tidak ada slot yang bisa ditunggu; frame lalu dikirim tanpa jadwal
+bool scheduleWaitSlot(size_t frameLength)
+{
+  uint32_t nowMs = rtcMillis();
+  if (!scheduleSync.hasSlot(nowMs))
+    return false;
+  uint32_t startMs = scheduleSync.nextSlot(nowMs);
+  if (!scheduleSync.slotUsable(startMs) || startMs - nowMs > scheduleLeadMs)
+    return false;
+
+  unsigned long waitStart = millis();
+  delay(startMs - nowMs);
+  powerBudget.add(PowerBoot, millis() - waitStart); // CPU menunggu, radio standby
+  bool slot;
+  return scheduleTxAllowed(frameLength, slot) && slot;
+}
+
+// Bangun hanya untuk beacon: radio RX sampai beacon terdengar atau lewat perkiraan waktunya, lalu tidur sampai
+// slot (atau langsung siklus kirim jika slot periode ini sudah dekat)
+void scheduleBeaconCycle()
+{
+  PowerBudget before = powerBudget;
+  powerBudget.wakeups++;
+  powerBudget.add(PowerSleep, lastSleepMs);
+  pinMode(ledKanan, OUTPUT);
+  pinMode(ledKiri, OUTPUT);
+  loadSettings();
+  unsigned long phaseStart = millis();
+  powerBudget.add(PowerBoot, POWER_BOOTLOADER_MS + phaseStart);
+
+  configureLora();
+  if (LoRa.begin(433E6))
+  {
+    applyLoraSettings();
+    LoRa.onReceive(onLoraReceiveCallback);
+    LoRa.receive();
+    uint32_t nowMs = rtcMillis();
+    uint32_t untilMs = scheduleSync.nextBeacon(nowMs) - nowMs;
+    if (untilMs > scheduleSync.periodMs() / 2)
+      untilMs = 0; // Bangun sedikit terlambat: beacon periode ini sedang di udara
+    uint32_t listenMs = untilMs + 2 * scheduleSync.marginMs(nowMs) + loraAirtimeMs(4 + SCHEDULE_BEACON_MAX_SIZE);
+    uint32_t beacons = scheduleSync.beaconCount();
+    while (scheduleSync.beaconCount() == beacons && millis() - phaseStart < listenMs)
+    {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+      serviceLoraResponses();
+    }
+    powerBudget.add(PowerListen, millis() - phaseStart);
+    if (scheduleSync.beaconCount() == beacons)
+      Serial.println("[TDMA] Beacon tidak terdengar");
+  }
+  else
+  {
+    Serial.println("LoRa gagal diinisialisasi");
+  }
+  printPowerBudget(before);
+
+  uint32_t elapsedMs = rtcMillis() - lastSampleRtcMs;
+  uint32_t sleepMs = scheduleSleepMs(updateRate > elapsedMs ? updateRate - elapsedMs : 0, 0);
+  if (!scheduleBeaconWake && sleepMs < LOW_POWER_MIN_SLEEP_MS)
+  {
+    lastSleepMs = 0;
+    cycleStartMs = millis();
+    lowPowerCycle(); // Slot periode ini terlalu dekat untuk tidur dulu; tidak kembali
+  }
+  enterDeepSleep(sleepMs);
+}
+#endif
+
+void loop()
+{
+  // --- Respons: diproses begitu interrupt DIO0 menyalin paket, tanpa polling parsePacket() ---
+  serviceLoraResponses();
+#if ADR_ENABLED
+  serviceAdrSwitch();
+#endif
+  bool waiting = expirePendingResponses();
+
+  // Kiriman ulang ARQ didahulukan dari sampel baru
+  PendingResponse *retry = paused ? NULL : dueRetransmission();
+  bool slotTx = false; // TDMA: kiriman di awal slot sendiri, tanpa listen-before-talk
+  if (retry != NULL && !scheduleTxAllowed(retry->batch ? TELEMETRY_BATCH_MAX_SIZE : telemetryCompactFrameSize(retry->frame), slotTx))
+    retry = NULL;
+  if (retry != NULL)
+  {
+    retry->attempts++;
+    arqStats.retransmits++;
+    if (!slotTx)
+      waitChannelClear();
+    transmitPending(*retry);
+    Serial.printf("[LoRa] Kirim ulang %sseq %u (%u/%u)\n", retry->batch ? "batch " : "", retry->frame.seq, retry->attempts, retry->maxRetries);
+    LoRa.receive();
+    waiting = true;
+  }
+
+  // // Periksa apakah saat ini waktunya untuk memulai siklus kirim
+  // Siklus berikutnya tidak menunggu respons frame sebelumnya: frame itu tetap ditunggu sampai jendelanya habis
+
+  else if (millis() - lastSendTime > sampleIntervalMs() && !paused && scheduleTxAllowed(telemetryCompactFrameSize(temperatureProbes.count), slotTx))
+  {
+    // --- Phase 1: Send Sensor Data ---
+    // Frame kompak (9 byte + 4 byte per probe suhu) menggantikan JSON (~50 byte) agar airtime per sampel jauh lebih kecil
+
+    // // Pastikan nilai sensor masih cukup baru (tugas pembacaan sensor harus berjalan)
+    TelemetryFrame frame = buildTelemetryFrame();
+
+    // Sampel yang masih di dalam deadband tidak dikirim: radio tetap idle sampai sampel berikutnya
+    ReportReason reason = reportFilter.evaluate(frame, rtcMillis());
+    if (reason == ReportSuppressed)
+    {
+      lastSendTime = millis();
+      return;
+    }
+    if (reason == ReportHeartbeat)
+    {
+      frame.flags |= TelemetryHeartbeat;
+    }
+
+    const ReportStats &reportStats = reportFilter.stats();
     Serial.println("------------------------------");
+    Serial.printf("[%lu] Starting Send cycle (%s)... terkirim %lu, heartbeat %lu, ditahan %lu, kirim ulang %lu, hilang %lu\n", millis(),
+                  reason == ReportHeartbeat ? "heartbeat" : "berubah", (unsigned long)reportStats.changes,
+                  (unsigned long)reportStats.heartbeats, (unsigned long)reportStats.suppressed, arqStats.retransmits, arqStats.dropped);
+    PendingResponse &slot = addPendingResponse(frame);
+    if (!slotTx)
+      waitChannelClear();
+    transmitPending(slot); // Call the send function
+
+    // // --- Fase 2: Menunggu Respons (non-blocking) ---
+    Serial.printf("[LoRa] TX Done seq %u. RX %lu ms untuk respons\n", slot.frame.seq, responseWindowMs());
+    LoRa.receive(); // Radio tetap RX sampai semua frame yang menunggu terjawab atau habis jendelanya
+    waiting = true;
 
+    lastSendTime = millis();
   } // Akhir dari pemeriksaan interval waktu
 
+  // Store-and-forward: selama link hidup, backlog di flash dikirim satu batch per BACKLOG_DRAIN_INTERVAL_MS
+  else if (linkUp && backlogPending && !paused && millis() - lastDrainMs >= BACKLOG_DRAIN_INTERVAL_MS &&
+           scheduleTxAllowed(TELEMETRY_BATCH_MAX_SIZE, slotTx))
+  {
+    lastDrainMs = millis();
+    PendingResponse *batch = addBacklogBatch();
+    if (batch != NULL)
+    {
+      waitChannelClear();
+      transmitPending(*batch);
+      Serial.printf("[Backlog] Batch seq %u: %u pembacaan, sisa %lu\n", batch->frame.seq, backlogBatch.count, (unsigned long)backlog.count());
+      LoRa.receive();
+      waiting = true;
+    }
+  }
+  updateBacklogRate();
+
+  // --- Phase 3: Go Idle ---
+  if (resultListening && (long)(millis() - resultListenUntilMs) >= 0)
+    resultListening = false;
+  bool listening = waiting || resultListening;
+#if SCHEDULE_ENABLED
+  listening = listening || scheduleSync.listenForBeacon(rtcMillis(), loraAirtimeMs(4 + SCHEDULE_BEACON_MAX_SIZE));
+  if (listening && !radioListening)
+    LoRa.receive(); // Menjelang beacon TDMA
+#endif
+  if (!listening && radioListening)
+  {
+    Serial.println("[LoRa] Listening period over. Idling LoRa module.");
+    LoRa.idle(); // Put LoRa module to sleep/idle until the next send cycle
+    Serial.println("------------------------------");
+  }
+  radioListening = listening;
+
+#if LOW_POWER_MODE
+  if (millis() - lastInteractionMs > LOW_POWER_AWAKE_MS)
+  {
+    Serial.println("[Daya] Tidak ada tombol ditekan, masuk mode daya rendah");
+    xSemaphoreTake(lcdUpdateSemaphore, portMAX_DELAY); // Task LCD tidak menulis lagi sebelum tidur
+    Lcd.clear();
+    Lcd.noBacklight();
+#if SCHEDULE_ENABLED
+    enterDeepSleep(scheduleSleepMs(updateRate, LOW_POWER_MIN_SLEEP_MS));
+#else
+    enterDeepSleep(updateRate);
+#endif
+  }
+#endif
+
 
   //  Jika dijeda, tangani indikator jeda (pertahankan bagian ini)
 
@@ -1087,6 +2612,6 @@ void loop()
     
   }
 
-  
-  vTaskDelay(pdMS_TO_TICKS(10));
+
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10)); // Bangun lebih awal jika interrupt DIO0 menyalin paket
 }
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "telemetry_frame.h"
+#include "json_arena.h"
+
+// Ukuran batch uplink Receiver dan buffer/arena JSON-nya, dipakai bersama Receiver.cpp dan soak test
+// (host/test/json_soak_test.cpp) agar keduanya selalu menguji ukuran yang sama.
+//
+// Dokumen JSON memakai arena statis (json_arena.h) dan diserialisasi ke buffer tetap, bukan heap. Batch live
+// dan replay spool memakai buffer yang sama, jadi ukurannya untuk kasus terburuk batch terbesar: setiap pembacaan
+// dengan TELEMETRY_MAX_PROBES probe dan semua field terisi nilai terpanjang. Respons server dibaca langsung dari
+// stream HTTP ke arena yang sama (request sudah dilepas), tanpa salinan String.
+
+#define UPLINK_BATCH_SIZE 8    // Maksimal pembacaan dalam satu POST batch
+#define SPOOL_REPLAY_BATCH 16  // Pembacaan spool per POST replay
+
+#define UPLINK_MAX_READINGS (SPOOL_REPLAY_BATCH > UPLINK_BATCH_SIZE ? SPOOL_REPLAY_BATCH : UPLINK_BATCH_SIZE)
+#define UPLINK_JSON_READING_MAX_SIZE 260 // Satu pembacaan tanpa isi probes, angka float 16 karakter
+#define UPLINK_JSON_PROBE_MAX_SIZE 44    // {"id":65535,"temperature":..},
+#define UPLINK_JSON_MAX_SIZE(readings) (16 + (readings) * (UPLINK_JSON_READING_MAX_SIZE + TELEMETRY_MAX_PROBES * UPLINK_JSON_PROBE_MAX_SIZE))
+#define UPLINK_JSON_READING_SLOTS 14     // Elemen + 11 member, lebih 2 untuk slot ekstensi
+#define UPLINK_JSON_PROBE_SLOTS 4        // Elemen + 2 member, lebih 1 untuk slot ekstensi
+#define UPLINK_JSON_SLOTS(readings) (4 + (readings) * (UPLINK_JSON_READING_SLOTS + TELEMETRY_MAX_PROBES * UPLINK_JSON_PROBE_SLOTS))
+
+#define UPLINK_BODY_MAX_SIZE 10240 // Body POST satu batch terserialisasi
+#define UPLINK_JSON_ARENA_SIZE JSON_ARENA_SIZE(JSON_ARENA_POOLS(UPLINK_JSON_SLOTS(UPLINK_MAX_READINGS)), 1024) // Request batch, lalu respons server (tidak bersamaan)
+#define LEGACY_JSON_ARENA_SIZE JSON_ARENA_SIZE(1, 256) // Payload JSON transmitter lama: tiga field
+#define LEGACY_RESPONSE_MAX_SIZE 64 // {"classification":..,"buzzer_on":..}
+
+static_assert(UPLINK_BODY_MAX_SIZE >= UPLINK_JSON_MAX_SIZE(UPLINK_MAX_READINGS), "Body uplink tidak muat batch terbesar");